@@ -12,7 +12,7 @@ public class CppToolsEditor : ModuleRules
         PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "AssetTools", "ApplicationCore" });
 
         PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore", "UnrealEd", "GameProjectGeneration", "LevelEditor",
-            "Projects", "MainFrame", "AppFramework", "EditorStyle" , "EngineSettings", "SourceControl", "DesktopPlatform" });
+            "Projects", "MainFrame", "AppFramework", "EditorStyle" , "EngineSettings", "SourceControl", "DesktopPlatform", "Json", "DirectoryWatcher" });
       
     }
 }
\ No newline at end of file
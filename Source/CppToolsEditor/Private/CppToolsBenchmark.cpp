@@ -0,0 +1,471 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsBenchmark.h"
+
+#include "CppToolsUtil.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/ScopeExit.h"
+#include "Templates/Atomic.h"
+#include "Misc/FileHelper.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsBenchmark, Log, All);
+
+namespace CppToolsBenchmarkImpl
+{
+    /**
+     * Forwards every call to the wrapped allocator while counting the allocations made by the measuring thread only, so work
+     * done by other threads during a measurement is not counted. Only the measuring thread writes the counters.
+     */
+    class FCountingMalloc : public FMalloc
+    {
+    public:
+
+        explicit FCountingMalloc(FMalloc* InInnerMalloc)
+            : InnerMalloc(InInnerMalloc)
+        {
+        }
+
+        /** Resets the counters and starts counting the allocations of the calling thread. */
+        void BeginCounting()
+        {
+            NumAllocations = 0;
+            AllocatedBytes = 0;
+            CountingThreadId = FPlatformTLS::GetCurrentThreadId();
+        }
+
+        void EndCounting()
+        {
+            CountingThreadId = 0;
+        }
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+        {
+            CountAllocation(Count);
+            return InnerMalloc->Malloc(Count, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            CountAllocation(Count);
+            return InnerMalloc->Realloc(Original, Count, Alignment);
+        }
+
+        virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+        virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+        virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+        virtual const TCHAR* GetDescriptiveName() override { return TEXT("CppToolsBenchmarkCountingMalloc"); }
+
+        int64 NumAllocations = 0;
+        int64 AllocatedBytes = 0;
+
+    private:
+
+        void CountAllocation(SIZE_T Count)
+        {
+            if (FPlatformTLS::GetCurrentThreadId() == CountingThreadId)
+            {
+                NumAllocations++;
+                AllocatedBytes += Count;
+            }
+        }
+
+        FMalloc* InnerMalloc;
+        TAtomic<uint32> CountingThreadId { 0 };
+
+    };
+
+    /**
+     * Gets the counting allocator wrapping the allocator in use when it is first needed. It is never destroyed, so threads
+     * that read GMalloc while it was installed can still call it safely after it has been swapped out again.
+     */
+    static FCountingMalloc& GetCountingMalloc()
+    {
+        static FCountingMalloc* CountingMalloc = new FCountingMalloc(GMalloc);
+        return *CountingMalloc;
+    }
+
+    static const TCHAR* BuildFileHeader = TEXT(
+        "using UnrealBuildTool;\n"
+        "using System.IO;\n"
+        "\n"
+        "public class BenchmarkModule : ModuleRules\n"
+        "{\n"
+        "\tpublic BenchmarkModule(ReadOnlyTargetRules Target) : base(Target)\n"
+        "\t{\n");
+
+    static const TCHAR* BuildFileFooter = TEXT(
+        "\t}\n"
+        "}\n");
+}
+
+void CppToolsBenchmark::RunBenchmarks(const FString& Filter, float IterationScale, TArray<FCppToolsBenchmarkResult>& OutResults)
+{
+    auto Run = [&Filter, IterationScale, &OutResults](const FString& Name, int32 Iterations, int64 BytesPerIteration, TFunctionRef<void()> Function)
+    {
+        if (!Filter.IsEmpty() && !Name.Contains(Filter)) return;
+
+        UE_LOG(LogCppToolsBenchmark, Display, TEXT("Running %s..."), *Name);
+        const FCppToolsBenchmarkResult& Result = OutResults.Add_GetRef(Measure(Name, FMath::Max(1, FMath::RoundToInt(Iterations * IterationScale)),
+            BytesPerIteration, Function));
+        UE_LOG(LogCppToolsBenchmark, Display, TEXT("%s: %.3f ms, %.2f MB/s, %.1f allocations (%.0f bytes) per iteration"), *Result.Name,
+            Result.SecondsPerIteration * 1000.0, Result.GetThroughput(), Result.AllocationsPerIteration, Result.AllocatedBytesPerIteration);
+    };
+
+    // --- StripCStyleComments ---
+
+    const FString CommentedBuildFile = MakeBuildFileFixture(5000, true);
+    Run(TEXT("StripCStyleComments/BuildFile_5000"), 10, CommentedBuildFile.Len() * sizeof(TCHAR), [&CommentedBuildFile]()
+    {
+        CppToolsUtil::StripCStyleComments(CommentedBuildFile);
+    });
+
+    const FString NestedComments = MakeNestedCommentFixture(500);
+    Run(TEXT("StripCStyleComments/NestedComments_500"), 10, NestedComments.Len() * sizeof(TCHAR), [&NestedComments]()
+    {
+        CppToolsUtil::StripCStyleComments(NestedComments);
+    });
+
+    // The regex comment pattern this replaced backtracked exponentially on this input, so it is kept at the size that pattern
+    // could finish to keep results comparable
+    const FString UnterminatedComment = MakeUnterminatedCommentFixture(20);
+    Run(TEXT("StripCStyleComments/UnterminatedComment_20"), 5, UnterminatedComment.Len() * sizeof(TCHAR), [&UnterminatedComment]()
+    {
+        CppToolsUtil::StripCStyleComments(UnterminatedComment);
+    });
+
+    // --- ParseStringList ---
+
+    TArray<FString> DependencyNames;
+    for (int32 I = 0; I < 5000; I++)
+    {
+        DependencyNames.Add(FString::Printf(TEXT("Dependency%d"), I));
+    }
+    const FString DependencyList = CppToolsUtil::CombineStringList(DependencyNames, true, true);
+    Run(TEXT("ParseStringList/Dependencies_5000"), 20, DependencyList.Len() * sizeof(TCHAR), [&DependencyList]()
+    {
+        CppToolsUtil::ParseStringList(DependencyList);
+    });
+    Run(TEXT("ParseStringListViews/Dependencies_5000"), 20, DependencyList.Len() * sizeof(TCHAR), [&DependencyList]()
+    {
+        TArray<FStringView> Views;
+        CppToolsUtil::ParseStringListViews(FStringView(*DependencyList, DependencyList.Len()), Views);
+    });
+
+    const FString UnterminatedStringList = MakeUnterminatedStringListFixture(5000);
+    Run(TEXT("ParseStringList/UnterminatedQuote_5000"), 20, UnterminatedStringList.Len() * sizeof(TCHAR), [&UnterminatedStringList]()
+    {
+        CppToolsUtil::ParseStringList(UnterminatedStringList);
+    });
+
+    // --- CombineStringList ---
+
+    Run(TEXT("CombineStringList/Dependencies_5000"), 50, DependencyList.Len() * sizeof(TCHAR), [&DependencyNames]()
+    {
+        CppToolsUtil::CombineStringList(DependencyNames, true, true);
+    });
+
+    // --- ParseModuleDependencies and InsertDependencyIntoBuildFile ---
+
+    const FString BuildFile = MakeBuildFileFixture(5000, false);
+    Run(TEXT("ParseModuleDependencies/BuildFile_5000"), 10, BuildFile.Len() * sizeof(TCHAR), [&BuildFile]()
+    {
+        CppToolsUtil::ParseModuleDependencies(BuildFile, true);
+    });
+    Run(TEXT("ParseModuleDependencies/CommentedBuildFile_5000"), 10, CommentedBuildFile.Len() * sizeof(TCHAR), [&CommentedBuildFile]()
+    {
+        CppToolsUtil::ParseModuleDependencies(CommentedBuildFile, true);
+    });
+    Run(TEXT("ParseModuleDependencyViews/BuildFile_5000"), 10, BuildFile.Len() * sizeof(TCHAR), [&BuildFile]()
+    {
+        TArray<FStringView> Views;
+        CppToolsUtil::ParseModuleDependencyViews(FStringView(*BuildFile, BuildFile.Len()), true, Views);
+    });
+
+    const FString SmallBuildFile = MakeBuildFileFixture(1000, true);
+    Run(TEXT("InsertDependencyIntoBuildFile/BuildFile_1000"), 10, SmallBuildFile.Len() * sizeof(TCHAR), [&SmallBuildFile]()
+    {
+        FString Contents = SmallBuildFile;
+        CppToolsUtil::InsertDependencyIntoBuildFile(Contents, TEXT("NewDependency"), false);
+    });
+
+    // --- GetModuleDependencies and InsertDependencyIntoModule against a synthetic project ---
+
+    const FString SyntheticRoot = FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir() / TEXT("CppTools") / TEXT("Benchmark"));
+    const int32 NumPlugins = 300;
+    const int32 ModulesPerPlugin = 3;
+    if (MakeSyntheticPluginTree(SyntheticRoot, NumPlugins, ModulesPerPlugin, 50))
+    {
+        // These follow the same steps as the module functions do for a plugin target: find the .Build.cs file within the
+        // plugin, then read, parse and write it
+        int32 NextPlugin = 0;
+        Run(TEXT("GetModuleDependencies/SyntheticPlugins_300"), 100, 0, [&SyntheticRoot, &NextPlugin, NumPlugins]()
+        {
+            const FString PluginDir = SyntheticRoot / FString::Printf(TEXT("Plugin%d"), NextPlugin);
+            const FString ModuleName = FString::Printf(TEXT("Plugin%dModule0"), NextPlugin);
+            NextPlugin = (NextPlugin + 1) % NumPlugins;
+
+            FString BuildFilePath;
+            FString Contents;
+            if (CppToolsUtil::FindFileInProject(ModuleName + TEXT(".Build.cs"), PluginDir, BuildFilePath)
+                && CppToolsUtil::LoadFileToString(Contents, BuildFilePath))
+            {
+                TArray<FStringView> Views;
+                CppToolsUtil::ParseModuleDependencyViews(FStringView(*Contents, Contents.Len()), true, Views);
+            }
+        });
+
+        NextPlugin = 0;
+        Run(TEXT("InsertDependencyIntoModule/SyntheticPlugins_300"), 50, 0, [&SyntheticRoot, &NextPlugin, NumPlugins]()
+        {
+            const FString PluginDir = SyntheticRoot / FString::Printf(TEXT("Plugin%d"), NextPlugin);
+            const FString ModuleName = FString::Printf(TEXT("Plugin%dModule1"), NextPlugin);
+            NextPlugin = (NextPlugin + 1) % NumPlugins;
+
+            FString BuildFilePath;
+            FString Contents;
+            if (CppToolsUtil::FindFileInProject(ModuleName + TEXT(".Build.cs"), PluginDir, BuildFilePath)
+                && CppToolsUtil::LoadFileToString(Contents, BuildFilePath)
+                && CppToolsUtil::InsertDependencyIntoBuildFile(Contents, TEXT("NewDependency"), false))
+            {
+                CppToolsUtil::SaveStringToFile(Contents, BuildFilePath);
+            }
+        });
+
+        Run(TEXT("FindFileInProject/SyntheticPlugins_300"), 20, 0, [&SyntheticRoot, NumPlugins]()
+        {
+            FString BuildFilePath;
+            CppToolsUtil::FindFileInProject(FString::Printf(TEXT("Plugin%dModule2.Build.cs"), NumPlugins - 1), SyntheticRoot, BuildFilePath);
+        });
+
+        IFileManager::Get().DeleteDirectory(*SyntheticRoot, false, true);
+    }
+    else
+    {
+        UE_LOG(LogCppToolsBenchmark, Warning, TEXT("Failed to create the synthetic project in '%s', skipping the module benchmarks"), *SyntheticRoot);
+    }
+}
+
+FString CppToolsBenchmark::GetBaselineFile()
+{
+    return CppToolsUtil::CppToolsContentDir() / TEXT("Editor") / TEXT("Benchmarks") / TEXT("Baseline.json");
+}
+
+bool CppToolsBenchmark::LoadBaseline(TMap<FString, FCppToolsBenchmarkResult>& OutBaseline, float& OutTolerance)
+{
+    FString BaselineText;
+    TSharedPtr<FJsonObject> Baseline;
+    if (!FFileHelper::LoadFileToString(BaselineText, *GetBaselineFile())) return false;
+
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(BaselineText);
+    if (!FJsonSerializer::Deserialize(Reader, Baseline) || !Baseline.IsValid()) return false;
+
+    double Tolerance;
+    if (Baseline->TryGetNumberField(TEXT("Tolerance"), Tolerance))
+    {
+        OutTolerance = static_cast<float>(Tolerance);
+    }
+
+    const TSharedPtr<FJsonObject>* Results;
+    if (Baseline->TryGetObjectField(TEXT("Results"), Results))
+    {
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Entry : (*Results)->Values)
+        {
+            const TSharedPtr<FJsonObject>& ResultObject = Entry.Value->AsObject();
+            if (!ResultObject.IsValid()) continue;
+
+            FCppToolsBenchmarkResult& Result = OutBaseline.Add(Entry.Key);
+            Result.Name = Entry.Key;
+            Result.SecondsPerIteration = ResultObject->GetNumberField(TEXT("SecondsPerIteration"));
+            Result.AllocationsPerIteration = ResultObject->GetNumberField(TEXT("AllocationsPerIteration"));
+            Result.AllocatedBytesPerIteration = ResultObject->GetNumberField(TEXT("AllocatedBytesPerIteration"));
+        }
+    }
+    return true;
+}
+
+bool CppToolsBenchmark::SaveBaseline(const TArray<FCppToolsBenchmarkResult>& Results, float Tolerance)
+{
+    TSharedRef<FJsonObject> ResultsObject = MakeShareable(new FJsonObject);
+    for (const FCppToolsBenchmarkResult& Result : Results)
+    {
+        TSharedRef<FJsonObject> ResultObject = MakeShareable(new FJsonObject);
+        ResultObject->SetNumberField(TEXT("SecondsPerIteration"), Result.SecondsPerIteration);
+        ResultObject->SetNumberField(TEXT("AllocationsPerIteration"), Result.AllocationsPerIteration);
+        ResultObject->SetNumberField(TEXT("AllocatedBytesPerIteration"), Result.AllocatedBytesPerIteration);
+        ResultsObject->SetObjectField(Result.Name, ResultObject);
+    }
+
+    TSharedRef<FJsonObject> Baseline = MakeShareable(new FJsonObject);
+    Baseline->SetNumberField(TEXT("Tolerance"), Tolerance);
+    Baseline->SetObjectField(TEXT("Results"), ResultsObject);
+
+    FString BaselineText;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&BaselineText);
+    FJsonSerializer::Serialize(Baseline, Writer);
+    return FFileHelper::SaveStringToFile(BaselineText, *GetBaselineFile());
+}
+
+TArray<FString> CppToolsBenchmark::FindRegressions(const TArray<FCppToolsBenchmarkResult>& Results, const TMap<FString, FCppToolsBenchmarkResult>& Baseline,
+    float Tolerance, TArray<FString>& OutMissingBaselines)
+{
+    TArray<FString> Regressions;
+    for (const FCppToolsBenchmarkResult& Result : Results)
+    {
+        const FCppToolsBenchmarkResult* BaselineResult = Baseline.Find(Result.Name);
+        if (BaselineResult == nullptr)
+        {
+            OutMissingBaselines.Add(Result.Name);
+            continue;
+        }
+
+        if (Result.SecondsPerIteration > BaselineResult->SecondsPerIteration * (1.0 + Tolerance))
+        {
+            Regressions.Add(FString::Printf(TEXT("%s took %.3f ms per iteration, the baseline is %.3f ms"), *Result.Name,
+                Result.SecondsPerIteration * 1000.0, BaselineResult->SecondsPerIteration * 1000.0));
+        }
+        if (Result.AllocationsPerIteration > BaselineResult->AllocationsPerIteration * (1.0 + Tolerance))
+        {
+            Regressions.Add(FString::Printf(TEXT("%s made %.1f allocations per iteration, the baseline is %.1f"), *Result.Name,
+                Result.AllocationsPerIteration, BaselineResult->AllocationsPerIteration));
+        }
+    }
+    return Regressions;
+}
+
+FString CppToolsBenchmark::MakeBuildFileFixture(int32 NumDependencies, bool bWithComments)
+{
+    using namespace CppToolsBenchmarkImpl;
+
+    FString Result = BuildFileHeader;
+
+    // Split the dependencies between the public and private lists
+    const int32 NumPublic = (NumDependencies + 1) / 2;
+    for (int32 List = 0; List < 2; List++)
+    {
+        Result += List == 0 ? TEXT("\t\tPublicDependencyModuleNames.AddRange(new string[] {\n") : TEXT("\t\tPrivateDependencyModuleNames.AddRange(new string[] {\n");
+
+        const int32 First = List == 0 ? 0 : NumPublic;
+        const int32 Last = List == 0 ? NumPublic : NumDependencies;
+        for (int32 I = First; I < Last; I++)
+        {
+            if (bWithComments && I % 10 == 0)
+            {
+                Result += FString::Printf(TEXT("\t\t\t// \"CommentedDependency%d\",\n"), I);
+                Result += FString::Printf(TEXT("\t\t\t/* \"BlockCommentedDependency%d\", */\n"), I);
+            }
+            Result += FString::Printf(TEXT("\t\t\t\"Dependency%d\"%s\n"), I, I < Last - 1 ? TEXT(",") : TEXT(""));
+        }
+
+        Result += TEXT("\t\t});\n\n");
+    }
+
+    if (bWithComments)
+    {
+        Result += TEXT("\t\t/*\n\t\tPublicDependencyModuleNames.AddRange(new string[] { \"DisabledDependency\" });\n\t\t*/\n");
+    }
+
+    Result += BuildFileFooter;
+    return Result;
+}
+
+FString CppToolsBenchmark::MakeNestedCommentFixture(int32 Depth)
+{
+    FString Result;
+    for (int32 Level = 0; Level < Depth; Level++)
+    {
+        // Block comment openers inside block comments, line comments containing closers, and closers inside line comments
+        Result += TEXT("int Value");
+        Result.AppendInt(Level);
+        Result += TEXT(" = 0; /* level ");
+        Result.AppendInt(Level);
+        for (int32 Nested = 0; Nested < Level % 16; Nested++)
+        {
+            Result += TEXT(" /* // nested");
+        }
+        Result += TEXT(" */ // trailing */ /* comment\n");
+    }
+    return Result;
+}
+
+FString CppToolsBenchmark::MakeUnterminatedCommentFixture(int32 Length)
+{
+    return TEXT("int Value = 0; /*") + FString::ChrN(Length, TEXT('*'));
+}
+
+FString CppToolsBenchmark::MakeUnterminatedStringListFixture(int32 NumStrings)
+{
+    FString Result;
+    for (int32 I = 0; I < NumStrings; I++)
+    {
+        Result += FString::Printf(TEXT("\"Dependency%d\", "), I);
+    }
+    Result += TEXT("\"Unterminated") + FString::ChrN(NumStrings, TEXT('a'));
+    return Result;
+}
+
+bool CppToolsBenchmark::MakeSyntheticPluginTree(const FString& RootDir, int32 NumPlugins, int32 ModulesPerPlugin, int32 DependenciesPerModule)
+{
+    IFileManager::Get().DeleteDirectory(*RootDir, false, true);
+
+    const FString BuildFile = MakeBuildFileFixture(DependenciesPerModule, true);
+    for (int32 Plugin = 0; Plugin < NumPlugins; Plugin++)
+    {
+        const FString PluginName = FString::Printf(TEXT("Plugin%d"), Plugin);
+        for (int32 Module = 0; Module < ModulesPerPlugin; Module++)
+        {
+            const FString ModuleName = PluginName + FString::Printf(TEXT("Module%d"), Module);
+            const FString ModuleDir = RootDir / PluginName / TEXT("Source") / ModuleName;
+
+            if (!FFileHelper::SaveStringToFile(BuildFile.Replace(TEXT("BenchmarkModule"), *ModuleName), *(ModuleDir / ModuleName + TEXT(".Build.cs")))
+                || !FFileHelper::SaveStringToFile(TEXT("#pragma once\n"), *(ModuleDir / TEXT("Public") / ModuleName + TEXT(".h")))
+                || !FFileHelper::SaveStringToFile(TEXT("#include \"") + ModuleName + TEXT(".h\"\n"), *(ModuleDir / TEXT("Private") / ModuleName + TEXT(".cpp"))))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+FCppToolsBenchmarkResult CppToolsBenchmark::Measure(const FString& Name, int32 Iterations, int64 BytesPerIteration, TFunctionRef<void()> Function)
+{
+    using namespace CppToolsBenchmarkImpl;
+
+    // Warm up caches and any lazily initialized state
+    Function();
+
+    FCountingMalloc& CountingMalloc = GetCountingMalloc();
+    FMalloc* PreviousMalloc = GMalloc;
+    GMalloc = &CountingMalloc;
+    CountingMalloc.BeginCounting();
+    ON_SCOPE_EXIT
+    {
+        CountingMalloc.EndCounting();
+        GMalloc = PreviousMalloc;
+    };
+
+    const double StartTime = FPlatformTime::Seconds();
+    for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+    {
+        Function();
+    }
+    const double EndTime = FPlatformTime::Seconds();
+
+    FCppToolsBenchmarkResult Result;
+    Result.Name = Name;
+    Result.Iterations = Iterations;
+    Result.SecondsPerIteration = (EndTime - StartTime) / Iterations;
+    Result.BytesPerIteration = BytesPerIteration;
+    Result.AllocationsPerIteration = static_cast<double>(CountingMalloc.NumAllocations) / Iterations;
+    Result.AllocatedBytesPerIteration = static_cast<double>(CountingMalloc.AllocatedBytes) / Iterations;
+    return Result;
+}
@@ -0,0 +1,554 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsBinaryCache.h"
+
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/SecureHash.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsBinaryCache"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsBinaryCache, Log, All);
+
+namespace CppToolsBinaryCacheImpl
+{
+    /** Bump this whenever the layout of cache entries or the contents of the hash change. */
+    static const TCHAR* CacheVersion = TEXT("1");
+
+    static const TCHAR* ManifestFileName = TEXT("Manifest.json");
+
+    static void UpdateHash(FSHA1& Hasher, const FString& Value)
+    {
+        const FTCHARToUTF8 Converted(*Value);
+        Hasher.Update(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+        // Separate values so that "ab" + "c" and "a" + "bc" hash differently
+        const uint8 Separator = 0;
+        Hasher.Update(&Separator, 1);
+    }
+
+    /** The suffix of a file restored from the cache before it replaces the file of the module. */
+    static const TCHAR* StagedSuffix = TEXT(".cpptools-restore");
+    /** The suffix a replaced file is renamed to, as a running editor may still have it loaded. */
+    static const TCHAR* ReplacedSuffix = TEXT(".cpptools-old");
+
+    /**
+     * Moves a staged file over the file it restores. The existing file is never written to, since the editor may have it mapped:
+     * it is renamed out of the way first, which the platforms allow for loaded binaries, and deleted once nothing holds it. On
+     * failure the existing file is left in place and the staged file is left for the caller to delete.
+     */
+    static bool SwapInStagedFile(const FString& Filename, bool& bOutReplacedExisting)
+    {
+        IFileManager& FileManager = IFileManager::Get();
+        const FString ReplacedFile = Filename + ReplacedSuffix;
+        bOutReplacedExisting = FileManager.FileExists(*Filename);
+        if (bOutReplacedExisting)
+        {
+            FileManager.Delete(*ReplacedFile, false, true, true);
+            if (FileManager.FileExists(*ReplacedFile) || !FileManager.Move(*ReplacedFile, *Filename, true, true, false, true))
+            {
+                return false;
+            }
+        }
+        if (FileManager.Move(*Filename, *(Filename + StagedSuffix), true, true, false, true)) return true;
+
+        if (bOutReplacedExisting)
+        {
+            FileManager.Move(*Filename, *ReplacedFile, true, true, false, true);
+        }
+        return false;
+    }
+
+    /** Undoes a swap, deleting the restored file and moving the file it replaced back. */
+    static void UndoSwap(const FString& Filename, bool bReplacedExisting)
+    {
+        IFileManager& FileManager = IFileManager::Get();
+        FileManager.Delete(*Filename, false, true, true);
+        if (bReplacedExisting)
+        {
+            FileManager.Move(*Filename, *(Filename + ReplacedSuffix), true, true, false, true);
+        }
+    }
+
+    static FString FinalizeHash(FSHA1& Hasher)
+    {
+        uint8 Digest[FSHA1::DigestSize];
+        Hasher.Final();
+        Hasher.GetHash(Digest);
+        return BytesToHex(Digest, FSHA1::DigestSize);
+    }
+}
+
+bool CppToolsBinaryCache::IsEnabled()
+{
+    bool bEnabled = true;
+    GConfig->GetBool(TEXT("CppTools"), TEXT("bEnableBinaryCache"), bEnabled, GEditorPerProjectIni);
+    return bEnabled;
+}
+
+FString CppToolsBinaryCache::GetCacheDirectory()
+{
+    FString CacheDirectory;
+    if (!GConfig->GetString(TEXT("CppTools"), TEXT("BinaryCacheDirectory"), CacheDirectory, GEditorPerProjectIni) || CacheDirectory.IsEmpty())
+    {
+        CacheDirectory = FPaths::Combine(FPlatformProcess::UserSettingsDir(), TEXT("CppTools"), TEXT("BinaryCache"));
+    }
+    return FPaths::ConvertRelativePathToFull(CacheDirectory);
+}
+
+FString CppToolsBinaryCache::ComputeModuleHash(const FString& ModuleName, TSharedPtr<IPlugin> Target)
+{
+    TMap<FString, FString> HashedModules;
+    return ComputeModuleHash(ModuleName, Target, HashedModules);
+}
+
+FString CppToolsBinaryCache::ComputeModuleHash(const FString& ModuleName, TSharedPtr<IPlugin> Target, TMap<FString, FString>& HashedModules)
+{
+    using namespace CppToolsBinaryCacheImpl;
+
+    if (const FString* ExistingHash = HashedModules.Find(ModuleName))
+    {
+        return *ExistingHash;
+    }
+    // Guard against dependency cycles, the module's own hash is filled in once it is known
+    HashedModules.Add(ModuleName, FString());
+
+    CPPTOOLS_TRACE_SCOPE(HashModule);
+
+    FString BuildFilePath;
+    if (!CppToolsUtil::GetModuleBuildFilePath(ModuleName, Target, BuildFilePath))
+    {
+        HashedModules.Remove(ModuleName);
+        return FString();
+    }
+
+    FSHA1 Hasher;
+
+    // Engine and toolchain
+    UpdateHash(Hasher, CacheVersion);
+    UpdateHash(Hasher, FEngineVersion::Current().ToString());
+    UpdateHash(Hasher, FPlatformMisc::GetUBTPlatform());
+    UpdateHash(Hasher, FPlatformMisc::GetUBTTargetName());
+    UpdateHash(Hasher, FModuleManager::Get().GetUBTConfiguration());
+#if defined(_MSC_FULL_VER)
+    UpdateHash(Hasher, FString::Printf(TEXT("MSVC %d"), _MSC_FULL_VER));
+#elif defined(__VERSION__)
+    UpdateHash(Hasher, ANSI_TO_TCHAR(__VERSION__));
+#endif
+
+    // Sources and .Build.cs, in a stable order
+    const FString ModuleDir = FPaths::GetPath(BuildFilePath);
+    TArray<FString> SourceFiles;
+    IFileManager::Get().FindFilesRecursive(SourceFiles, *ModuleDir, TEXT("*"), true, false, false);
+    SourceFiles.Sort();
+
+    TArray<uint8> FileData;
+    for (const FString& SourceFile : SourceFiles)
+    {
+        FString RelativePath = SourceFile;
+        FPaths::MakePathRelativeTo(RelativePath, *(ModuleDir / TEXT("")));
+        UpdateHash(Hasher, RelativePath);
+
+        FileData.Reset();
+        CPPTOOLS_TRACE_FILE_SCOPE(ReadFile, SourceFile);
+        if (FFileHelper::LoadFileToArray(FileData, *SourceFile))
+        {
+            Hasher.Update(FileData.GetData(), FileData.Num());
+        }
+    }
+
+    // Resolved dependencies, including the hashes of any that are part of this project
+    TArray<FString> Dependencies = CppToolsUtil::GetModuleDependencies(ModuleName, Target, true);
+    Dependencies.Sort();
+    for (const FString& Dependency : Dependencies)
+    {
+        UpdateHash(Hasher, Dependency);
+
+        TSharedPtr<IPlugin> DependencyTarget;
+        FString DependencyBuildFilePath;
+        if (FindProjectModule(Dependency, DependencyTarget, DependencyBuildFilePath))
+        {
+            UpdateHash(Hasher, ComputeModuleHash(Dependency, DependencyTarget, HashedModules));
+        }
+    }
+
+    const FString Hash = FinalizeHash(Hasher);
+    HashedModules.Add(ModuleName, Hash);
+    return Hash;
+}
+
+bool CppToolsBinaryCache::StoreModule(const FString& ModuleName, TSharedPtr<IPlugin> Target, FText& OutFailReason)
+{
+    using namespace CppToolsBinaryCacheImpl;
+
+    CPPTOOLS_TRACE_SCOPE(StoreModule);
+
+    const FString Hash = ComputeModuleHash(ModuleName, Target);
+    if (Hash.IsEmpty())
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+        OutFailReason = FText::Format(LOCTEXT("ModuleNotFound", "Could not find the .Build.cs file for module \"{ModuleName}\""), Args);
+        return false;
+    }
+
+    const FString EntryDir = GetCacheDirectory() / Hash;
+    if (FPaths::FileExists(EntryDir / ManifestFileName))
+    {
+        // Already cached, but the binaries still need their stamp to be recognized as matching the entry
+        FFileHelper::SaveStringToFile(Hash, *GetModuleStampFile(ModuleName, Target));
+        return true;
+    }
+
+    TArray<FString> OutputFiles;
+    GatherModuleOutputs(ModuleName, Target, OutputFiles);
+    if (OutputFiles.Num() == 0)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+        OutFailReason = FText::Format(LOCTEXT("NoModuleOutputs", "Module \"{ModuleName}\" has not been built"), Args);
+        return false;
+    }
+
+    const FString RootDir = GetTargetRootDir(Target);
+    TArray<TSharedPtr<FJsonValue>> FileValues;
+    for (const FString& OutputFile : OutputFiles)
+    {
+        if (IFileManager::Get().Copy(*(EntryDir / OutputFile), *(RootDir / OutputFile), true, true) != COPY_OK)
+        {
+            IFileManager::Get().DeleteDirectory(*EntryDir, false, true);
+
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("FileName"), FText::FromString(RootDir / OutputFile));
+            OutFailReason = FText::Format(LOCTEXT("FailedToCopyToCache", "Failed to copy \"{FileName}\" into the binary cache"), Args);
+            return false;
+        }
+        FileValues.Add(MakeShareable(new FJsonValueString(OutputFile)));
+    }
+
+    TSharedRef<FJsonObject> Manifest = MakeShareable(new FJsonObject);
+    Manifest->SetStringField(TEXT("Module"), ModuleName);
+    Manifest->SetStringField(TEXT("Hash"), Hash);
+    Manifest->SetArrayField(TEXT("Files"), FileValues);
+
+    FString ModuleFileName;
+    if (GetModulesManifestEntry(ModuleName, Target, ModuleFileName))
+    {
+        Manifest->SetStringField(TEXT("ModuleFileName"), ModuleFileName);
+    }
+
+    // The manifest is written last, an entry without one is incomplete and is never restored
+    FString ManifestText;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ManifestText);
+    FJsonSerializer::Serialize(Manifest, Writer);
+    if (!FFileHelper::SaveStringToFile(ManifestText, *(EntryDir / ManifestFileName)))
+    {
+        IFileManager::Get().DeleteDirectory(*EntryDir, false, true);
+        OutFailReason = LOCTEXT("FailedToWriteCacheManifest", "Failed to write the binary cache manifest");
+        return false;
+    }
+
+    FFileHelper::SaveStringToFile(Hash, *GetModuleStampFile(ModuleName, Target));
+
+    UE_LOG(LogCppToolsBinaryCache, Log, TEXT("Stored module '%s' (%d files) in the binary cache as %s"), *ModuleName, OutputFiles.Num(), *Hash);
+    return true;
+}
+
+bool CppToolsBinaryCache::TryRestoreModule(const FString& ModuleName, TSharedPtr<IPlugin> Target)
+{
+    using namespace CppToolsBinaryCacheImpl;
+
+    if (!IsEnabled()) return false;
+
+    CPPTOOLS_TRACE_SCOPE(RestoreModule);
+
+    const FString Hash = ComputeModuleHash(ModuleName, Target);
+    if (Hash.IsEmpty()) return false;
+
+    const FString EntryDir = GetCacheDirectory() / Hash;
+
+    FString ManifestText;
+    if (!FFileHelper::LoadFileToString(ManifestText, *(EntryDir / ManifestFileName)))
+    {
+        return false;
+    }
+
+    TSharedPtr<FJsonObject> Manifest;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ManifestText);
+    if (!FJsonSerializer::Deserialize(Reader, Manifest) || !Manifest.IsValid())
+    {
+        UE_LOG(LogCppToolsBinaryCache, Warning, TEXT("Ignoring corrupt binary cache entry %s"), *EntryDir);
+        return false;
+    }
+
+    // Every file is copied next to the file it replaces first, so nothing is touched unless the whole entry could be copied
+    const FString RootDir = GetTargetRootDir(Target);
+    TArray<FString> OutputFiles;
+    for (const TSharedPtr<FJsonValue>& FileValue : Manifest->GetArrayField(TEXT("Files")))
+    {
+        const FString OutputFile = RootDir / FileValue->AsString();
+        OutputFiles.Add(OutputFile);
+        if (IFileManager::Get().Copy(*(OutputFile + StagedSuffix), *(EntryDir / FileValue->AsString()), true, true) != COPY_OK)
+        {
+            UE_LOG(LogCppToolsBinaryCache, Warning, TEXT("Failed to restore '%s' from the binary cache"), *OutputFile);
+            for (const FString& StagedFile : OutputFiles)
+            {
+                IFileManager::Get().Delete(*(StagedFile + StagedSuffix), false, true, true);
+            }
+            return false;
+        }
+    }
+
+    TArray<bool> ReplacedExisting;
+    ReplacedExisting.SetNumZeroed(OutputFiles.Num());
+    for (int32 I = 0; I < OutputFiles.Num(); I++)
+    {
+        if (!SwapInStagedFile(OutputFiles[I], ReplacedExisting[I]))
+        {
+            // Leave the module as it was, so it is compiled normally instead of from a mix of old and restored files
+            UE_LOG(LogCppToolsBinaryCache, Warning, TEXT("Failed to restore '%s' from the binary cache"), *OutputFiles[I]);
+            for (int32 J = 0; J < I; J++)
+            {
+                UndoSwap(OutputFiles[J], ReplacedExisting[J]);
+            }
+            for (int32 J = I; J < OutputFiles.Num(); J++)
+            {
+                IFileManager::Get().Delete(*(OutputFiles[J] + StagedSuffix), false, true, true);
+            }
+            return false;
+        }
+    }
+
+    FString ModuleFileName;
+    if (Manifest->TryGetStringField(TEXT("ModuleFileName"), ModuleFileName))
+    {
+        SetModulesManifestEntry(ModuleName, Target, ModuleFileName);
+    }
+
+    FFileHelper::SaveStringToFile(Hash, *GetModuleStampFile(ModuleName, Target));
+
+    UE_LOG(LogCppToolsBinaryCache, Log, TEXT("Restored module '%s' from the binary cache (%s)"), *ModuleName, *Hash);
+    return true;
+}
+
+int32 CppToolsBinaryCache::SyncProjectModules()
+{
+    if (!IsEnabled()) return 0;
+
+    CPPTOOLS_TRACE_SESSION(TEXT("SyncBinaryCache"));
+    CPPTOOLS_TRACE_SCOPE(SyncProjectModules);
+
+    TArray<TPair<FString, TSharedPtr<IPlugin>>> Modules;
+    for (const FModuleContextInfo& Module : CppToolsUtil::GetProjectModules())
+    {
+        Modules.Emplace(Module.ModuleName, nullptr);
+    }
+    for (const TSharedPtr<IPlugin>& Plugin : CppToolsUtil::GetProjectPlugins())
+    {
+        for (const FModuleContextInfo& Module : CppToolsUtil::GetPluginModules(Plugin))
+        {
+            Modules.Emplace(Module.ModuleName, Plugin);
+        }
+    }
+
+    int32 NumRestored = 0;
+    for (const TPair<FString, TSharedPtr<IPlugin>>& Module : Modules)
+    {
+        DeleteReplacedFiles(Module.Key, Module.Value);
+
+        const FString Hash = ComputeModuleHash(Module.Key, Module.Value);
+        if (Hash.IsEmpty()) continue;
+
+        // Only binaries stamped with the current hash are known to match it and may be cached
+        if (IsModuleStampCurrent(Module.Key, Module.Value, Hash))
+        {
+            FText FailReason;
+            if (!StoreModule(Module.Key, Module.Value, FailReason))
+            {
+                UE_LOG(LogCppToolsBinaryCache, Verbose, TEXT("Did not cache module '%s': %s"), *Module.Key, *FailReason.ToString());
+            }
+        }
+        else if (TryRestoreModule(Module.Key, Module.Value))
+        {
+            NumRestored++;
+        }
+        else if (AreModuleBinariesNewerThanSources(Module.Key, Module.Value))
+        {
+            // Binaries built outside of CppTools may have been built against other versions of the dependencies, so they are kept but not cached
+            UE_LOG(LogCppToolsBinaryCache, Verbose, TEXT("Module '%s' was built outside of CppTools and is not cached"), *Module.Key);
+        }
+    }
+
+    return NumRestored;
+}
+
+bool CppToolsBinaryCache::FindProjectModule(const FString& ModuleName, TSharedPtr<IPlugin>& OutTarget, FString& OutBuildFilePath)
+{
+    if (CppToolsUtil::GetModuleBuildFilePath(ModuleName, nullptr, OutBuildFilePath))
+    {
+        OutTarget = nullptr;
+        return true;
+    }
+    for (const TSharedPtr<IPlugin>& Plugin : CppToolsUtil::GetProjectPlugins())
+    {
+        if (CppToolsUtil::GetModuleBuildFilePath(ModuleName, Plugin, OutBuildFilePath))
+        {
+            OutTarget = Plugin;
+            return true;
+        }
+    }
+    return false;
+}
+
+FString CppToolsBinaryCache::GetTargetRootDir(const TSharedPtr<IPlugin>& Target)
+{
+    return FPaths::ConvertRelativePathToFull(Target.IsValid() ? Target->GetBaseDir() : FPaths::ProjectDir());
+}
+
+void CppToolsBinaryCache::GatherModuleOutputs(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, TArray<FString>& OutFiles)
+{
+    const FString RootDir = GetTargetRootDir(Target) / TEXT("");
+
+    // Binaries are named <Target>-<Module>[-<Platform>-<Configuration>].<Extension>, optionally with a lib prefix
+    const FString BinariesDir = RootDir / TEXT("Binaries") / FPlatformProcess::GetBinariesSubdirectory();
+    TArray<FString> BinaryFiles;
+    IFileManager::Get().FindFiles(BinaryFiles, *(BinariesDir / TEXT("*")), true, false);
+
+    const FString NameWithExtension = TEXT("-") + ModuleName + TEXT(".");
+    const FString NameWithSuffix = TEXT("-") + ModuleName + TEXT("-");
+    for (const FString& BinaryFile : BinaryFiles)
+    {
+        if (BinaryFile.Contains(NameWithExtension, ESearchCase::CaseSensitive) || BinaryFile.Contains(NameWithSuffix, ESearchCase::CaseSensitive))
+        {
+            FString RelativePath = BinariesDir / BinaryFile;
+            FPaths::MakePathRelativeTo(RelativePath, *RootDir);
+            OutFiles.Add(RelativePath);
+        }
+    }
+
+    // Intermediates live in <Target>/<Configuration>/<Module> and <Target>/Inc/<Module> folders
+    const FString IntermediateDir = RootDir / TEXT("Intermediate") / TEXT("Build") / FPlatformMisc::GetUBTPlatform();
+    TArray<FString> IntermediateFiles;
+    IFileManager::Get().FindFilesRecursive(IntermediateFiles, *IntermediateDir, TEXT("*"), true, false, false);
+
+    const FString ModuleFolder = TEXT("/") + ModuleName + TEXT("/");
+    for (FString& IntermediateFile : IntermediateFiles)
+    {
+        FPaths::MakePathRelativeTo(IntermediateFile, *RootDir);
+        if (IntermediateFile.Contains(ModuleFolder, ESearchCase::CaseSensitive))
+        {
+            OutFiles.Add(IntermediateFile);
+        }
+    }
+}
+
+void CppToolsBinaryCache::DeleteReplacedFiles(const FString& ModuleName, const TSharedPtr<IPlugin>& Target)
+{
+    using namespace CppToolsBinaryCacheImpl;
+
+    // Files the editor still has loaded fail to delete and are tried again on the next sync
+    const FString BinariesDir = GetTargetRootDir(Target) / TEXT("Binaries") / FPlatformProcess::GetBinariesSubdirectory();
+    TArray<FString> ReplacedFiles;
+    IFileManager::Get().FindFiles(ReplacedFiles, *(BinariesDir / TEXT("*") + ReplacedSuffix), true, false);
+    // Binaries are named like in GatherModuleOutputs, so other modules starting with the same name are not matched
+    const FString NameWithExtension = TEXT("-") + ModuleName + TEXT(".");
+    const FString NameWithSuffix = TEXT("-") + ModuleName + TEXT("-");
+    for (const FString& ReplacedFile : ReplacedFiles)
+    {
+        if (ReplacedFile.Contains(NameWithExtension, ESearchCase::CaseSensitive) || ReplacedFile.Contains(NameWithSuffix, ESearchCase::CaseSensitive))
+        {
+            IFileManager::Get().Delete(*(BinariesDir / ReplacedFile), false, true, true);
+        }
+    }
+}
+
+FString CppToolsBinaryCache::GetModuleStampFile(const FString& ModuleName, const TSharedPtr<IPlugin>& Target)
+{
+    return GetTargetRootDir(Target) / TEXT("Intermediate") / TEXT("CppTools") / TEXT("BinaryCache") / ModuleName + TEXT(".hash");
+}
+
+bool CppToolsBinaryCache::IsModuleStampCurrent(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, const FString& Hash)
+{
+    FString Stamp;
+    return FFileHelper::LoadFileToString(Stamp, *GetModuleStampFile(ModuleName, Target)) && Stamp == Hash;
+}
+
+bool CppToolsBinaryCache::AreModuleBinariesNewerThanSources(const FString& ModuleName, const TSharedPtr<IPlugin>& Target)
+{
+    FString ModuleFileName;
+    if (!GetModulesManifestEntry(ModuleName, Target, ModuleFileName)) return false;
+
+    const FString BinaryFile = GetTargetRootDir(Target) / TEXT("Binaries") / FPlatformProcess::GetBinariesSubdirectory() / ModuleFileName;
+    const FDateTime BinaryTimeStamp = IFileManager::Get().GetTimeStamp(*BinaryFile);
+    if (BinaryTimeStamp == FDateTime::MinValue()) return false;
+
+    FString BuildFilePath;
+    if (!CppToolsUtil::GetModuleBuildFilePath(ModuleName, Target, BuildFilePath)) return false;
+
+    TArray<FString> SourceFiles;
+    IFileManager::Get().FindFilesRecursive(SourceFiles, *FPaths::GetPath(BuildFilePath), TEXT("*"), true, false, false);
+    for (const FString& SourceFile : SourceFiles)
+    {
+        if (IFileManager::Get().GetTimeStamp(*SourceFile) > BinaryTimeStamp)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FString CppToolsBinaryCache::GetModulesManifestPath(const TSharedPtr<IPlugin>& Target)
+{
+    // Only the manifest of the configuration the editor is running uses an unsuffixed name
+    return GetTargetRootDir(Target) / TEXT("Binaries") / FPlatformProcess::GetBinariesSubdirectory() / FPlatformMisc::GetUBTTargetName() + TEXT(".modules");
+}
+
+bool CppToolsBinaryCache::GetModulesManifestEntry(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, FString& OutFileName)
+{
+    FString Text;
+    TSharedPtr<FJsonObject> Manifest;
+    if (!FFileHelper::LoadFileToString(Text, *GetModulesManifestPath(Target))) return false;
+
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+    if (!FJsonSerializer::Deserialize(Reader, Manifest) || !Manifest.IsValid()) return false;
+
+    const TSharedPtr<FJsonObject>* Modules;
+    return Manifest->TryGetObjectField(TEXT("Modules"), Modules) && (*Modules)->TryGetStringField(ModuleName, OutFileName);
+}
+
+bool CppToolsBinaryCache::SetModulesManifestEntry(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, const FString& FileName)
+{
+    const FString ManifestPath = GetModulesManifestPath(Target);
+
+    FString Text;
+    TSharedPtr<FJsonObject> Manifest;
+    if (FFileHelper::LoadFileToString(Text, *ManifestPath))
+    {
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+        FJsonSerializer::Deserialize(Reader, Manifest);
+    }
+    if (!Manifest.IsValid())
+    {
+        Manifest = MakeShareable(new FJsonObject);
+    }
+
+    const TSharedPtr<FJsonObject>* ExistingModules;
+    TSharedPtr<FJsonObject> Modules = Manifest->TryGetObjectField(TEXT("Modules"), ExistingModules) ? *ExistingModules : MakeShareable(new FJsonObject);
+    Modules->SetStringField(ModuleName, FileName);
+    Manifest->SetObjectField(TEXT("Modules"), Modules);
+
+    Text.Reset();
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+    FJsonSerializer::Serialize(Manifest.ToSharedRef(), Writer);
+    return FFileHelper::SaveStringToFile(Text, *ManifestPath);
+}
+
+#undef LOCTEXT_NAMESPACE
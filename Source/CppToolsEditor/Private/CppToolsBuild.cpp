@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsBuild.h"
+
+#include "CppToolsTrace.h"
+#include "CppToolsUtil.h"
+
+#include "DesktopPlatformModule.h"
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/FeedbackContext.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsBuild"
+
+FString CppToolsBuild::GetTargetArguments()
+{
+    const FString ProjectFileName = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*FPaths::GetProjectFilePath());
+    return FString::Printf(TEXT("%s %s %s -Project=\"%s\""), FPlatformMisc::GetUBTTargetName(),
+        FModuleManager::Get().GetUBTConfiguration(), FPlatformMisc::GetUBTPlatform(), *ProjectFileName);
+}
+
+FString CppToolsBuild::GetBuildArguments()
+{
+    return GetTargetArguments() + TEXT(" -Progress -NoHotReloadFromIDE");
+}
+
+bool CppToolsBuild::GetGameTargetArguments(FString& OutArguments, FText& OutFailReason)
+{
+    const FString TargetFile = CppToolsUtil::GetPrimaryTargetFilePath(false);
+    if (!IFileManager::Get().FileExists(*TargetFile))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(TargetFile));
+        OutFailReason = FText::Format(LOCTEXT("MissingGameTarget", "Full builds are measured on the game target, but \"{FullFileName}\" does not exist"), Args);
+        return false;
+    }
+
+    const FString ProjectFileName = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*FPaths::GetProjectFilePath());
+    OutArguments = FString::Printf(TEXT("%s %s %s -Project=\"%s\""), FApp::GetProjectName(), FModuleManager::Get().GetUBTConfiguration(),
+        FPlatformMisc::GetUBTPlatform(), *ProjectFileName);
+    return true;
+}
+
+bool CppToolsBuild::RunUnrealBuildTool(const FString& ExtraArguments, double& OutSeconds, FText& OutFailReason)
+{
+    FString Arguments = GetBuildArguments();
+    if (!ExtraArguments.IsEmpty())
+    {
+        Arguments += TEXT(" ") + ExtraArguments;
+    }
+    return RunUnrealBuildToolWithArguments(Arguments, OutSeconds, OutFailReason);
+}
+
+bool CppToolsBuild::RunGameTargetBuild(const FString& ExtraArguments, double& OutSeconds, FText& OutFailReason)
+{
+    FString Arguments;
+    if (!GetGameTargetArguments(Arguments, OutFailReason)) return false;
+
+    Arguments += TEXT(" -Progress");
+    if (!ExtraArguments.IsEmpty())
+    {
+        Arguments += TEXT(" ") + ExtraArguments;
+    }
+    return RunUnrealBuildToolWithArguments(Arguments, OutSeconds, OutFailReason);
+}
+
+bool CppToolsBuild::RunUnrealBuildToolWithArguments(const FString& Arguments, double& OutSeconds, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(UnrealBuildTool);
+
+    const double StartTime = FPlatformTime::Seconds();
+    const bool bSucceeded = FDesktopPlatformModule::Get()->RunUnrealBuildTool(LOCTEXT("Compiling", "Compiling..."), FPaths::RootDir(), Arguments, GWarn);
+    OutSeconds = FPlatformTime::Seconds() - StartTime;
+
+    if (!bSucceeded)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Arguments"), FText::FromString(Arguments));
+        OutFailReason = FText::Format(LOCTEXT("UnrealBuildToolFailed", "Unreal Build Tool failed with the arguments: {Arguments}"), Args);
+    }
+    return bSucceeded;
+}
+
+bool CppToolsBuild::BuildModules(const TArray<FString>& ModuleNames, double& OutSeconds, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(BuildModules);
+
+    OutSeconds = 0.0;
+    if (ModuleNames.Num() == 0) return true;
+
+    FString ModuleArguments;
+    for (const FString& ModuleName : ModuleNames)
+    {
+        if (!ModuleArguments.IsEmpty()) ModuleArguments += TEXT(" ");
+        ModuleArguments += FString::Printf(TEXT("-Module=%s"), *ModuleName);
+    }
+    return RunUnrealBuildTool(ModuleArguments, OutSeconds, OutFailReason);
+}
+
+bool CppToolsBuild::MeasureFullBuild(double& OutSeconds, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(MeasureFullBuild);
+
+    // The current target's binaries are loaded by the running editor or commandlet, so the game target is cleaned and built instead
+    FString GameTargetArguments;
+    if (!GetGameTargetArguments(GameTargetArguments, OutFailReason)) return false;
+
+    double CleanSeconds;
+    return RunUnrealBuildToolWithArguments(GameTargetArguments + TEXT(" -Clean"), CleanSeconds, OutFailReason)
+        && RunGameTargetBuild(FString(), OutSeconds, OutFailReason);
+}
+
+bool CppToolsBuild::MeasureIncrementalBuild(const TArray<FString>& ChangedFiles, double& OutSeconds, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(MeasureIncrementalBuild);
+
+    // Make sure the game target is up to date first, so only the touched files are compiled
+    double WarmupSeconds;
+    if (!RunGameTargetBuild(FString(), WarmupSeconds, OutFailReason)) return false;
+
+    const FDateTime Now = FDateTime::UtcNow();
+    for (const FString& ChangedFile : ChangedFiles)
+    {
+        IFileManager::Get().SetTimeStamp(*ChangedFile, Now);
+    }
+
+    return RunGameTargetBuild(FString(), OutSeconds, OutFailReason);
+}
+
+bool CppToolsBuild::MeasureModuleBuild(const FString& ModuleName, const TArray<FString>& ChangedFiles, double& OutSeconds, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(MeasureModuleBuild);
+
+    const FString ModuleArgument = FString::Printf(TEXT("-Module=%s"), *ModuleName);
+
+    // The module is built for the game target, as the current target's binaries are loaded. The first build brings the module up
+    // to date, the second measures the overhead of a build with nothing to do.
+    double WarmupSeconds;
+    double OverheadSeconds;
+    if (!RunGameTargetBuild(ModuleArgument, WarmupSeconds, OutFailReason) || !RunGameTargetBuild(ModuleArgument, OverheadSeconds, OutFailReason))
+    {
+        return false;
+    }
+
+    const FDateTime Now = FDateTime::UtcNow();
+    for (const FString& ChangedFile : ChangedFiles)
+    {
+        IFileManager::Get().SetTimeStamp(*ChangedFile, Now);
+    }
+
+    if (!RunGameTargetBuild(ModuleArgument, OutSeconds, OutFailReason)) return false;
+    OutSeconds = FMath::Max(0.0, OutSeconds - OverheadSeconds);
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
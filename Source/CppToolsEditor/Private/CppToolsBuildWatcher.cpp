@@ -0,0 +1,463 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsBuildWatcher.h"
+
+#include "CppToolsBuild.h"
+#include "CppToolsModuleGraph.h"
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "DesktopPlatformModule.h"
+#include "DirectoryWatcherModule.h"
+#include "Containers/Ticker.h"
+#include "HAL/FileManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/ScopedSlowTask.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsBuildWatcher"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsBuildWatcher, Log, All);
+
+namespace CppToolsBuildWatcherImpl
+{
+    /** How often the watcher checks for modules to build and reads the output of the running build. */
+    static const float TickInterval = 0.25f;
+
+    static bool IsSourceFile(const FString& Filename)
+    {
+        static const TCHAR* SourceExtensions[] = { TEXT(".h"), TEXT(".hpp"), TEXT(".inl"), TEXT(".cpp"), TEXT(".c"), TEXT(".Build.cs") };
+        for (const TCHAR* Extension : SourceExtensions)
+        {
+            if (Filename.EndsWith(Extension)) return true;
+        }
+        return false;
+    }
+
+    /** Checks if a line of build output is a compiler or linker error, as MSVC and clang print them. */
+    static bool IsErrorLine(const FString& Line)
+    {
+        return Line.Contains(TEXT(": error")) || Line.Contains(TEXT(": fatal error")) || Line.StartsWith(TEXT("ERROR:"));
+    }
+
+    static IDirectoryWatcher* GetDirectoryWatcher()
+    {
+        FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+        return DirectoryWatcherModule ? DirectoryWatcherModule->Get() : nullptr;
+    }
+
+    /** Picks a suffix that none of the modules' binaries has yet, from the same range hot reload picks its suffixes from. */
+    static int32 GetUniqueModuleSuffix(const TArray<TSharedPtr<FCppToolsWatchedModule>>& Modules)
+    {
+        int32 Suffix = FMath::RandRange(1000, 9999);
+        for (int32 Attempt = 0; Attempt < 100; Attempt++, Suffix = FMath::RandRange(1000, 9999))
+        {
+            const bool bTaken = Modules.ContainsByPredicate([Suffix](const TSharedPtr<FCppToolsWatchedModule>& Module)
+            {
+                const FString BinariesDir = (Module->Plugin.IsValid() ? Module->Plugin->GetBaseDir() : FPaths::ProjectDir())
+                    / TEXT("Binaries") / FPlatformProcess::GetBinariesSubdirectory();
+                TArray<FString> Binaries;
+                IFileManager::Get().FindFiles(Binaries, *(BinariesDir / FString::Printf(TEXT("*-%s-%d.*"), *Module->Name, Suffix)), true, false);
+                return Binaries.Num() > 0;
+            });
+            if (!bTaken) break;
+        }
+        return Suffix;
+    }
+
+    /** Gets the command line that runs Unreal Build Tool directly, so it can be started with a lower priority than the editor. */
+    static void GetUnrealBuildToolCommand(const FString& Arguments, FString& OutExecutable, FString& OutArguments)
+    {
+        OutExecutable = FDesktopPlatformModule::Get()->GetUnrealBuildToolExecutableFilename(FPaths::RootDir());
+        OutArguments = Arguments;
+#if PLATFORM_MAC || PLATFORM_LINUX
+        // Unreal Build Tool runs on Mono outside of Windows
+        const FString ScriptPath = FPaths::ConvertRelativePathToFull(FPaths::EngineDir() / (PLATFORM_MAC ? TEXT("Build/BatchFiles/Mac/RunMono.sh") : TEXT("Build/BatchFiles/Linux/RunMono.sh")));
+        OutArguments = FString::Printf(TEXT("\"%s\" \"%s\" %s"), *ScriptPath, *OutExecutable, *Arguments);
+        OutExecutable = TEXT("/bin/sh");
+#endif
+    }
+}
+
+FCppToolsBuildWatcher::~FCppToolsBuildWatcher()
+{
+    Stop();
+}
+
+bool FCppToolsBuildWatcher::IsEnabledInSettings()
+{
+    bool bEnabled = false;
+    GConfig->GetBool(TEXT("CppTools"), TEXT("bEnableBuildWatcher"), bEnabled, GEditorPerProjectIni);
+    return bEnabled;
+}
+
+void FCppToolsBuildWatcher::SetEnabledInSettings(bool bEnabled)
+{
+    GConfig->SetBool(TEXT("CppTools"), TEXT("bEnableBuildWatcher"), bEnabled, GEditorPerProjectIni);
+    GConfig->Flush(false, GEditorPerProjectIni);
+}
+
+int32 FCppToolsBuildWatcher::GetMaxJobs()
+{
+    int32 MaxJobs = FPlatformMisc::NumberOfCoresIncludingHyperthreads() / 4;
+    GConfig->GetInt(TEXT("CppTools"), TEXT("BuildWatcherMaxJobs"), MaxJobs, GEditorPerProjectIni);
+    return FMath::Max(1, MaxJobs);
+}
+
+double FCppToolsBuildWatcher::GetDelaySeconds()
+{
+    double DelaySeconds = 2.0;
+    GConfig->GetDouble(TEXT("CppTools"), TEXT("BuildWatcherDelaySeconds"), DelaySeconds, GEditorPerProjectIni);
+    return FMath::Max(0.0, DelaySeconds);
+}
+
+void FCppToolsBuildWatcher::Start()
+{
+    using namespace CppToolsBuildWatcherImpl;
+
+    if (IsRunning()) return;
+
+    IndexModules();
+
+    TArray<FString> SourceDirectories;
+    SourceDirectories.Add(FPaths::ConvertRelativePathToFull(FPaths::GameSourceDir()));
+    for (const TSharedPtr<IPlugin>& Plugin : CppToolsUtil::GetProjectPlugins())
+    {
+        const FString PluginSourceDirectory = FPaths::ConvertRelativePathToFull(Plugin->GetBaseDir() / TEXT("Source"));
+        if (FPaths::DirectoryExists(PluginSourceDirectory))
+        {
+            SourceDirectories.Add(PluginSourceDirectory);
+        }
+    }
+
+    IDirectoryWatcher* DirectoryWatcher = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")).Get();
+    for (const FString& SourceDirectory : SourceDirectories)
+    {
+        FDelegateHandle Handle;
+        if (DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(SourceDirectory,
+            IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FCppToolsBuildWatcher::OnDirectoryChanged), Handle))
+        {
+            WatchedDirectories.Add(SourceDirectory, Handle);
+        }
+        else
+        {
+            UE_LOG(LogCppToolsBuildWatcher, Warning, TEXT("Failed to watch %s"), *SourceDirectory);
+        }
+    }
+
+    TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCppToolsBuildWatcher::Tick), TickInterval);
+
+    UE_LOG(LogCppToolsBuildWatcher, Log, TEXT("Watching %d modules in %d source directories"), Modules.Num(), WatchedDirectories.Num());
+    StateChangedEvent.Broadcast();
+}
+
+void FCppToolsBuildWatcher::Stop()
+{
+    using namespace CppToolsBuildWatcherImpl;
+
+    if (!IsRunning()) return;
+
+    // The directory watcher may already be unloaded when the editor shuts down
+    if (IDirectoryWatcher* DirectoryWatcher = GetDirectoryWatcher())
+    {
+        for (const TPair<FString, FDelegateHandle>& WatchedDirectory : WatchedDirectories)
+        {
+            DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedDirectory.Key, WatchedDirectory.Value);
+        }
+    }
+    WatchedDirectories.Reset();
+
+    FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+    TickerHandle.Reset();
+
+    if (IsBuilding())
+    {
+        UE_LOG(LogCppToolsBuildWatcher, Log, TEXT("Cancelling the background build of %d modules"), BuildingModules.Num());
+        FPlatformProcess::TerminateProc(BuildProcess, true);
+        CloseBuildProcess();
+        BuildingModules.Reset();
+    }
+
+    Modules.Reset();
+    ModulesByPath.Reset();
+    StateChangedEvent.Broadcast();
+}
+
+bool FCppToolsBuildWatcher::WaitForBuild()
+{
+    if (!IsRunning()) return true;
+
+    FScopedSlowTask SlowTask(0, LOCTEXT("WaitingForBuild", "Waiting for the background build to finish..."));
+    SlowTask.MakeDialogDelayed(0.5f);
+
+    bool bSucceeded = true;
+    while (true)
+    {
+        if (!IsBuilding())
+        {
+            const bool bHasPending = Modules.ContainsByPredicate([](const TSharedPtr<FCppToolsWatchedModule>& Module)
+            {
+                return Module->State == ECppToolsWatchedModuleState::Pending;
+            });
+            if (!bHasPending) break;
+
+            StartBuild();
+            if (!IsBuilding())
+            {
+                bSucceeded = false;
+                break;
+            }
+        }
+
+        while (FPlatformProcess::IsProcRunning(BuildProcess))
+        {
+            ReadBuildOutput();
+            FPlatformProcess::Sleep(0.1f);
+        }
+        ReadBuildOutput();
+
+        int32 ReturnCode = 0;
+        FPlatformProcess::GetProcReturnCode(BuildProcess, &ReturnCode);
+        bSucceeded &= ReturnCode == 0;
+        FinishBuild(ReturnCode == 0);
+    }
+    return bSucceeded;
+}
+
+TSharedPtr<FCppToolsWatchedModule> FCppToolsBuildWatcher::FindModuleForFile(const FString& Filename) const
+{
+    FString FullFilename = FPaths::ConvertRelativePathToFull(Filename);
+    FPaths::NormalizeFilename(FullFilename);
+    for (const TSharedPtr<FCppToolsWatchedModule>& Module : ModulesByPath)
+    {
+        if (FullFilename.StartsWith(Module->Path)) return Module;
+    }
+    return nullptr;
+}
+
+void FCppToolsBuildWatcher::IndexModules()
+{
+    CPPTOOLS_TRACE_SCOPE(IndexModules);
+
+    Modules.Reset();
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        // Modules the editor target does not build cannot be built with it either
+        if (!CppToolsModuleGraph::IsModuleTypeInTarget(Module.Key.ModuleType, true)) continue;
+
+        TSharedPtr<FCppToolsWatchedModule> WatchedModule = MakeShareable(new FCppToolsWatchedModule);
+        WatchedModule->Name = Module.Key.ModuleName;
+        WatchedModule->Plugin = Module.Value;
+        WatchedModule->Path = Module.Key.ModuleSourcePath;
+        FPaths::NormalizeDirectoryName(WatchedModule->Path);
+        WatchedModule->Path /= TEXT("");
+        Modules.Add(WatchedModule);
+    }
+    Modules.Sort([](const TSharedPtr<FCppToolsWatchedModule>& A, const TSharedPtr<FCppToolsWatchedModule>& B) { return A->Name < B->Name; });
+
+    ModulesByPath = Modules;
+    ModulesByPath.Sort([](const TSharedPtr<FCppToolsWatchedModule>& A, const TSharedPtr<FCppToolsWatchedModule>& B) { return A->Path.Len() > B->Path.Len(); });
+}
+
+void FCppToolsBuildWatcher::OnDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+    using namespace CppToolsBuildWatcherImpl;
+
+    const double Now = FPlatformTime::Seconds();
+    bool bStateChanged = false;
+    for (const FFileChangeData& Change : Changes)
+    {
+        if (!IsSourceFile(Change.Filename)) continue;
+
+        TSharedPtr<FCppToolsWatchedModule> Module = FindModuleForFile(Change.Filename);
+        if (!Module.IsValid()) continue;
+
+        Module->LastChangeTime = Now;
+        // A module saved while it builds is built again once the build finishes
+        if (Module->State != ECppToolsWatchedModuleState::Pending && Module->State != ECppToolsWatchedModuleState::Building)
+        {
+            Module->State = ECppToolsWatchedModuleState::Pending;
+            bStateChanged = true;
+        }
+    }
+
+    if (bStateChanged)
+    {
+        StateChangedEvent.Broadcast();
+    }
+}
+
+bool FCppToolsBuildWatcher::Tick(float DeltaTime)
+{
+    if (IsBuilding())
+    {
+        ReadBuildOutput();
+        if (!FPlatformProcess::IsProcRunning(BuildProcess))
+        {
+            ReadBuildOutput();
+            int32 ReturnCode = 0;
+            FPlatformProcess::GetProcReturnCode(BuildProcess, &ReturnCode);
+            FinishBuild(ReturnCode == 0);
+        }
+        return true;
+    }
+
+    // Leave the build to the editor while it compiles for a hot reload
+    IHotReloadInterface* HotReload = FModuleManager::GetModulePtr<IHotReloadInterface>(TEXT("HotReload"));
+    if (HotReload && HotReload->IsCurrentlyCompiling()) return true;
+
+    // Wait for every pending module to stop changing, so saving several files builds them together
+    double LastChangeTime = 0.0;
+    bool bHasPending = false;
+    for (const TSharedPtr<FCppToolsWatchedModule>& Module : Modules)
+    {
+        if (Module->State != ECppToolsWatchedModuleState::Pending) continue;
+        bHasPending = true;
+        LastChangeTime = FMath::Max(LastChangeTime, Module->LastChangeTime);
+    }
+
+    if (bHasPending && FPlatformTime::Seconds() - LastChangeTime >= GetDelaySeconds())
+    {
+        StartBuild();
+    }
+    return true;
+}
+
+void FCppToolsBuildWatcher::StartBuild()
+{
+    using namespace CppToolsBuildWatcherImpl;
+
+    for (const TSharedPtr<FCppToolsWatchedModule>& Module : Modules)
+    {
+        if (Module->State != ECppToolsWatchedModuleState::Pending) continue;
+
+        Module->State = ECppToolsWatchedModuleState::Building;
+        Module->Message.Reset();
+        BuildingModules.Add(Module);
+    }
+    if (BuildingModules.Num() == 0) return;
+
+    FString Arguments = CppToolsBuild::GetTargetArguments();
+    // Wait for other instances of Unreal Build Tool instead of failing, and leave the rest of the machine to the editor. The build never
+    // hot reloads into the running editor on its own; that is left to the user.
+    Arguments += FString::Printf(TEXT(" -WaitMutex -NoHotReloadFromIDE -MaxParallelActions=%d"), GetMaxJobs());
+    // The editor has the modules' binaries loaded, so they are linked under new names with a suffix the way hot reload does, and the
+    // target's .modules manifest points to them from then on
+    const int32 Suffix = GetUniqueModuleSuffix(BuildingModules);
+    for (const TSharedPtr<FCppToolsWatchedModule>& Module : BuildingModules)
+    {
+        Arguments += FString::Printf(TEXT(" -ModuleWithSuffix=%s,%d"), *Module->Name, Suffix);
+    }
+
+    FString Executable;
+    FString CommandLine;
+    GetUnrealBuildToolCommand(Arguments, Executable, CommandLine);
+
+    FPlatformProcess::CreatePipe(ReadPipe, WritePipe);
+    // A priority modifier of -1 runs the build below normal priority, which the compilers it starts inherit
+    BuildProcess = FPlatformProcess::CreateProc(*Executable, *CommandLine, false, true, true, nullptr, -1, nullptr, WritePipe);
+    BuildStartTime = FPlatformTime::Seconds();
+    FirstBuildError.Reset();
+
+    if (!BuildProcess.IsValid())
+    {
+        FirstBuildError = FString::Printf(TEXT("Failed to start %s"), *Executable);
+        FinishBuild(false);
+        return;
+    }
+
+    UE_LOG(LogCppToolsBuildWatcher, Log, TEXT("Building %d modules in the background: %s"), BuildingModules.Num(), *Arguments);
+    StateChangedEvent.Broadcast();
+}
+
+void FCppToolsBuildWatcher::ReadBuildOutput()
+{
+    using namespace CppToolsBuildWatcherImpl;
+
+    FString Output = PartialOutputLine + FPlatformProcess::ReadPipe(ReadPipe);
+    PartialOutputLine.Reset();
+
+    int32 LineStart = 0;
+    int32 LineEnd;
+    while ((LineEnd = Output.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, LineStart)) != INDEX_NONE)
+    {
+        FString Line = Output.Mid(LineStart, LineEnd - LineStart).TrimStartAndEnd();
+        LineStart = LineEnd + 1;
+        if (!IsErrorLine(Line)) continue;
+
+        UE_LOG(LogCppToolsBuildWatcher, Warning, TEXT("%s"), *Line);
+
+        // Errors in the sources of a module start with the path of the file
+        FString NormalizedLine = Line;
+        FPaths::NormalizeFilename(NormalizedLine);
+        const TSharedPtr<FCppToolsWatchedModule>* Module = BuildingModules.FindByPredicate([&NormalizedLine](const TSharedPtr<FCppToolsWatchedModule>& BuildingModule)
+        {
+            return NormalizedLine.Contains(BuildingModule->Path);
+        });
+        if (Module)
+        {
+            if ((*Module)->Message.IsEmpty()) (*Module)->Message = Line;
+        }
+        else if (FirstBuildError.IsEmpty())
+        {
+            FirstBuildError = Line;
+        }
+    }
+    PartialOutputLine = Output.Mid(LineStart);
+}
+
+void FCppToolsBuildWatcher::FinishBuild(bool bSucceeded)
+{
+    const double BuildSeconds = FPlatformTime::Seconds() - BuildStartTime;
+    CloseBuildProcess();
+
+    const FDateTime Now = FDateTime::Now();
+    for (const TSharedPtr<FCppToolsWatchedModule>& Module : BuildingModules)
+    {
+        Module->LastBuildTime = Now;
+        Module->LastBuildSeconds = BuildSeconds;
+        if (bSucceeded)
+        {
+            Module->State = ECppToolsWatchedModuleState::UpToDate;
+            Module->Message.Reset();
+        }
+        else
+        {
+            Module->State = ECppToolsWatchedModuleState::Failed;
+            if (Module->Message.IsEmpty())
+            {
+                Module->Message = FirstBuildError.IsEmpty() ? TEXT("Unreal Build Tool failed") : FirstBuildError;
+            }
+        }
+
+        if (Module->LastChangeTime > BuildStartTime)
+        {
+            Module->State = ECppToolsWatchedModuleState::Pending;
+        }
+    }
+
+    UE_LOG(LogCppToolsBuildWatcher, Log, TEXT("Background build of %d modules %s in %.1f seconds"), BuildingModules.Num(),
+        bSucceeded ? TEXT("succeeded") : TEXT("failed"), BuildSeconds);
+    if (!bSucceeded)
+    {
+        CppToolsUtil::PushNotification(FText::Format(LOCTEXT("BuildFailed", "Background build of {0} modules failed"), BuildingModules.Num()),
+            SNotificationItem::CS_Fail);
+    }
+
+    BuildingModules.Reset();
+    StateChangedEvent.Broadcast();
+}
+
+void FCppToolsBuildWatcher::CloseBuildProcess()
+{
+    if (BuildProcess.IsValid())
+    {
+        FPlatformProcess::CloseProc(BuildProcess);
+    }
+    FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+    ReadPipe = nullptr;
+    WritePipe = nullptr;
+    PartialOutputLine.Reset();
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsBuildWatcherPanel.h"
+
+#include "EditorStyleSet.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/SBoxPanel.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsBuildWatcherPanel"
+
+namespace CppToolsBuildWatcherPanelImpl
+{
+    static const FName ModuleColumn(TEXT("Module"));
+    static const FName PluginColumn(TEXT("Plugin"));
+    static const FName StateColumn(TEXT("State"));
+    static const FName LastBuildColumn(TEXT("LastBuild"));
+    static const FName MessageColumn(TEXT("Message"));
+
+    static FText GetStateText(ECppToolsWatchedModuleState State)
+    {
+        switch (State)
+        {
+        case ECppToolsWatchedModuleState::Pending: return LOCTEXT("Pending", "Pending");
+        case ECppToolsWatchedModuleState::Building: return LOCTEXT("Building", "Building");
+        case ECppToolsWatchedModuleState::Failed: return LOCTEXT("Failed", "Failed");
+        default: return LOCTEXT("UpToDate", "Up to date");
+        }
+    }
+
+    static FSlateColor GetStateColor(ECppToolsWatchedModuleState State)
+    {
+        switch (State)
+        {
+        case ECppToolsWatchedModuleState::Pending: return FLinearColor(0.9f, 0.7f, 0.2f);
+        case ECppToolsWatchedModuleState::Building: return FLinearColor(0.3f, 0.6f, 1.0f);
+        case ECppToolsWatchedModuleState::Failed: return FLinearColor(1.0f, 0.3f, 0.3f);
+        default: return FSlateColor::UseForeground();
+        }
+    }
+}
+
+/** A row of the module list, with one cell per column. Cells read the module as they paint, so they follow its state. */
+class SCppToolsBuildWatcherRow : public SMultiColumnTableRow<TSharedPtr<FCppToolsWatchedModule>>
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsBuildWatcherRow) {}
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FCppToolsWatchedModule> InModule)
+    {
+        Module = InModule;
+        SMultiColumnTableRow<TSharedPtr<FCppToolsWatchedModule>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+    }
+
+    virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+    {
+        using namespace CppToolsBuildWatcherPanelImpl;
+
+        TSharedPtr<FCppToolsWatchedModule> RowModule = Module;
+        if (ColumnName == ModuleColumn)
+        {
+            return SNew(STextBlock)
+                .Text(FText::FromString(Module->Name))
+                .ToolTipText(FText::FromString(Module->Path));
+        }
+        if (ColumnName == PluginColumn)
+        {
+            return SNew(STextBlock)
+                .Text(Module->Plugin.IsValid() ? FText::FromString(Module->Plugin->GetName()) : LOCTEXT("GameProject", "Game"));
+        }
+        if (ColumnName == StateColumn)
+        {
+            return SNew(STextBlock)
+                .Text_Lambda([RowModule]() { return GetStateText(RowModule->State); })
+                .ColorAndOpacity_Lambda([RowModule]() { return GetStateColor(RowModule->State); });
+        }
+        if (ColumnName == LastBuildColumn)
+        {
+            return SNew(STextBlock)
+                .Text_Lambda([RowModule]()
+                {
+                    if (RowModule->LastBuildTime == FDateTime()) return FText::GetEmpty();
+
+                    FNumberFormattingOptions Options;
+                    Options.SetMaximumFractionalDigits(1);
+                    return FText::Format(LOCTEXT("LastBuild", "{0} ({1} s)"), FText::AsTime(RowModule->LastBuildTime),
+                        FText::AsNumber(RowModule->LastBuildSeconds, &Options));
+                });
+        }
+        return SNew(STextBlock)
+            .Text_Lambda([RowModule]() { return FText::FromString(RowModule->Message); })
+            .ToolTipText_Lambda([RowModule]() { return FText::FromString(RowModule->Message); });
+    }
+
+private:
+
+    TSharedPtr<FCppToolsWatchedModule> Module;
+
+};
+
+SCppToolsBuildWatcherPanel::~SCppToolsBuildWatcherPanel()
+{
+    if (Watcher)
+    {
+        Watcher->OnStateChanged().Remove(StateChangedHandle);
+    }
+}
+
+void SCppToolsBuildWatcherPanel::Construct(const FArguments& InArgs)
+{
+    using namespace CppToolsBuildWatcherPanelImpl;
+
+    Watcher = InArgs._Watcher;
+    check(Watcher);
+    StateChangedHandle = Watcher->OnStateChanged().AddSP(this, &SCppToolsBuildWatcherPanel::Refresh);
+
+    ChildSlot
+    [
+        SNew(SBorder)
+        .Padding(8)
+        .BorderImage(FEditorStyle::GetBrush("Docking.Tab.ContentAreaBrush"))
+        [
+            SNew(SVerticalBox)
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 8)
+            [
+                SNew(SHorizontalBox)
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .VAlign(VAlign_Center)
+                [
+                    SNew(SCheckBox)
+                    .ToolTipText(LOCTEXT("EnabledToolTip", "Builds the modules whose sources are saved in the background, with lowered priority, so they are up to date by the time the editor restarts or you trigger a hot reload. The binaries are linked under new names, so the ones the editor has loaded are never replaced"))
+                    .IsChecked_Lambda([this]() { return Watcher->IsRunning() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+                    .OnCheckStateChanged(this, &SCppToolsBuildWatcherPanel::OnEnabledChanged)
+                    [
+                        SNew(STextBlock)
+                        .Text(LOCTEXT("Enabled", "Build edited modules in the background"))
+                    ]
+                ]
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.0f)
+                .VAlign(VAlign_Center)
+                .HAlign(HAlign_Right)
+                [
+                    SNew(STextBlock)
+                    .Text(this, &SCppToolsBuildWatcherPanel::GetSummaryText)
+                ]
+            ]
+
+            + SVerticalBox::Slot()
+            .FillHeight(1.0f)
+            [
+                SAssignNew(ModuleList, SListView<TSharedPtr<FCppToolsWatchedModule>>)
+                .ListItemsSource(&Modules)
+                .OnGenerateRow(this, &SCppToolsBuildWatcherPanel::MakeModuleRow)
+                .HeaderRow
+                (
+                    SNew(SHeaderRow)
+                    + SHeaderRow::Column(ModuleColumn).DefaultLabel(LOCTEXT("ModuleColumn", "Module")).FillWidth(1.5f)
+                    + SHeaderRow::Column(PluginColumn).DefaultLabel(LOCTEXT("PluginColumn", "Plugin")).FillWidth(1.0f)
+                    + SHeaderRow::Column(StateColumn).DefaultLabel(LOCTEXT("StateColumn", "State")).FillWidth(0.8f)
+                    + SHeaderRow::Column(LastBuildColumn).DefaultLabel(LOCTEXT("LastBuildColumn", "Last Build")).FillWidth(1.0f)
+                    + SHeaderRow::Column(MessageColumn).DefaultLabel(LOCTEXT("MessageColumn", "Error")).FillWidth(3.0f)
+                )
+            ]
+        ]
+    ];
+
+    Refresh();
+}
+
+void SCppToolsBuildWatcherPanel::Refresh()
+{
+    // The rows follow the state of their module, so only starting or stopping the watcher changes the list
+    if (Modules != Watcher->GetModules())
+    {
+        Modules = Watcher->GetModules();
+        ModuleList->RequestListRefresh();
+    }
+}
+
+void SCppToolsBuildWatcherPanel::OnEnabledChanged(ECheckBoxState NewState)
+{
+    const bool bEnabled = NewState == ECheckBoxState::Checked;
+    FCppToolsBuildWatcher::SetEnabledInSettings(bEnabled);
+    if (bEnabled)
+    {
+        Watcher->Start();
+    }
+    else
+    {
+        Watcher->Stop();
+    }
+}
+
+FText SCppToolsBuildWatcherPanel::GetSummaryText() const
+{
+    if (!Watcher->IsRunning())
+    {
+        return LOCTEXT("NotWatching", "Not watching");
+    }
+
+    int32 NumPending = 0;
+    int32 NumBuilding = 0;
+    int32 NumFailed = 0;
+    for (const TSharedPtr<FCppToolsWatchedModule>& Module : Modules)
+    {
+        NumPending += Module->State == ECppToolsWatchedModuleState::Pending;
+        NumBuilding += Module->State == ECppToolsWatchedModuleState::Building;
+        NumFailed += Module->State == ECppToolsWatchedModuleState::Failed;
+    }
+    return FText::Format(LOCTEXT("Summary", "Watching {0} modules: {1} pending, {2} building, {3} failed. Builds use up to {4} parallel actions."),
+        Modules.Num(), NumPending, NumBuilding, NumFailed, FCppToolsBuildWatcher::GetMaxJobs());
+}
+
+TSharedRef<ITableRow> SCppToolsBuildWatcherPanel::MakeModuleRow(TSharedPtr<FCppToolsWatchedModule> Module, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(SCppToolsBuildWatcherRow, OwnerTable, Module);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,1218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsCommandlet.h"
+
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+#include "CppToolsBenchmark.h"
+#include "CppToolsBuild.h"
+#include "CppToolsConsolidation.h"
+#include "CppToolsCriticalPath.h"
+#include "CppToolsExportAudit.h"
+#include "CppToolsIWYU.h"
+#include "CppToolsManifest.h"
+#include "CppToolsMemoryTags.h"
+#include "CppToolsModuleGraph.h"
+#include "CppToolsModuleTemplates.h"
+#include "CppToolsPCH.h"
+#include "CppToolsRefactor.h"
+#include "CppToolsTimeTrace.h"
+#include "CppToolsUnityConfig.h"
+
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsCommandlet"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsCommandlet, Log, All);
+
+namespace CppToolsCommandletImpl
+{
+    /** Converts the strings into JSON string values. */
+    static TArray<TSharedPtr<FJsonValue>> MakeStringValues(const TArray<FString>& Strings)
+    {
+        TArray<TSharedPtr<FJsonValue>> Values;
+        for (const FString& String : Strings)
+        {
+            Values.Add(MakeShareable(new FJsonValueString(String)));
+        }
+        return Values;
+    }
+}
+
+UCppToolsCommandlet::UCppToolsCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+    ShowErrorCount = true;
+}
+
+int32 UCppToolsCommandlet::Main(const FString& Params)
+{
+    Operations.Add(TEXT("GenerateModule"), &UCppToolsCommandlet::GenerateModule);
+    Operations.Add(TEXT("AddDependency"), &UCppToolsCommandlet::AddDependency);
+    Operations.Add(TEXT("RefactorDependencies"), &UCppToolsCommandlet::RefactorDependencies);
+    Operations.Add(TEXT("UpdateTargets"), &UCppToolsCommandlet::UpdateTargets);
+    Operations.Add(TEXT("Analyze"), &UCppToolsCommandlet::Analyze);
+    Operations.Add(TEXT("UpdateFwdHeaders"), &UCppToolsCommandlet::UpdateFwdHeaders);
+    Operations.Add(TEXT("FindDeadModules"), &UCppToolsCommandlet::FindDeadModules);
+    Operations.Add(TEXT("AnalyzeTargets"), &UCppToolsCommandlet::AnalyzeTargets);
+    Operations.Add(TEXT("AuditExports"), &UCppToolsCommandlet::AuditExports);
+    Operations.Add(TEXT("ConsolidateModules"), &UCppToolsCommandlet::ConsolidateModules);
+    Operations.Add(TEXT("ReconcileManifest"), &UCppToolsCommandlet::ReconcileManifest);
+    Operations.Add(TEXT("ConfigureUnity"), &UCppToolsCommandlet::ConfigureUnity);
+    Operations.Add(TEXT("UpdatePCH"), &UCppToolsCommandlet::UpdatePCH);
+    Operations.Add(TEXT("ConvertToIWYU"), &UCppToolsCommandlet::ConvertToIWYU);
+    Operations.Add(TEXT("CriticalPath"), &UCppToolsCommandlet::CriticalPath);
+    Operations.Add(TEXT("TimeTrace"), &UCppToolsCommandlet::TimeTrace);
+    Operations.Add(TEXT("Benchmark"), &UCppToolsCommandlet::Benchmark);
+    Operations.Add(TEXT("GenerateSyntheticProject"), &UCppToolsCommandlet::GenerateSyntheticProject);
+    Operations.Add(TEXT("ScaleTest"), &UCppToolsCommandlet::ScaleTest);
+
+    TArray<FString> Tokens;
+    TArray<FString> Switches;
+    TMap<FString, FString> ParamsMap;
+    ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+    // Gather the operations to run, either from the input file or from the command line
+    TArray<TSharedRef<FJsonObject>> OperationArguments;
+    if (const FString* InputFile = ParamsMap.Find(TEXT("Input")))
+    {
+        FString InputText;
+        TSharedPtr<FJsonObject> Input;
+        if (!FFileHelper::LoadFileToString(InputText, **InputFile))
+        {
+            UE_LOG(LogCppToolsCommandlet, Error, TEXT("Failed to read input file '%s'"), **InputFile);
+            return 1;
+        }
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(InputText);
+        if (!FJsonSerializer::Deserialize(Reader, Input) || !Input.IsValid())
+        {
+            UE_LOG(LogCppToolsCommandlet, Error, TEXT("Failed to parse input file '%s'"), **InputFile);
+            return 1;
+        }
+
+        const TArray<TSharedPtr<FJsonValue>>* InputOperations;
+        if (Input->TryGetArrayField(TEXT("Operations"), InputOperations))
+        {
+            for (const TSharedPtr<FJsonValue>& InputOperation : *InputOperations)
+            {
+                const TSharedPtr<FJsonObject>* OperationObject;
+                if (InputOperation->TryGetObject(OperationObject))
+                {
+                    OperationArguments.Add(OperationObject->ToSharedRef());
+                }
+            }
+        }
+        else
+        {
+            OperationArguments.Add(Input.ToSharedRef());
+        }
+    }
+    else
+    {
+        TSharedRef<FJsonObject> Arguments = MakeShareable(new FJsonObject);
+        for (const TPair<FString, FString>& Param : ParamsMap)
+        {
+            Arguments->SetStringField(Param.Key, Param.Value);
+        }
+        for (const FString& Switch : Switches)
+        {
+            Arguments->SetBoolField(Switch, true);
+        }
+        OperationArguments.Add(Arguments);
+    }
+
+    bool bSucceeded = true;
+    TArray<TSharedPtr<FJsonValue>> Results;
+    for (const TSharedRef<FJsonObject>& Arguments : OperationArguments)
+    {
+        TSharedRef<FJsonObject> Result = MakeShareable(new FJsonObject);
+        bSucceeded &= RunOperation(Arguments, *Result);
+        Results.Add(MakeShareable(new FJsonValueObject(Result)));
+    }
+
+    TSharedRef<FJsonObject> Output = MakeShareable(new FJsonObject);
+    Output->SetBoolField(TEXT("Success"), bSucceeded);
+    Output->SetArrayField(TEXT("Results"), Results);
+
+    FString OutputText;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputText);
+    FJsonSerializer::Serialize(Output, Writer);
+
+    if (const FString* OutputFile = ParamsMap.Find(TEXT("Output")))
+    {
+        if (!FFileHelper::SaveStringToFile(OutputText, **OutputFile))
+        {
+            UE_LOG(LogCppToolsCommandlet, Error, TEXT("Failed to write output file '%s'"), **OutputFile);
+            return 1;
+        }
+    }
+    else
+    {
+        GLog->Flush();
+        FPlatformMisc::LocalPrint(*OutputText);
+        FPlatformMisc::LocalPrint(LINE_TERMINATOR);
+    }
+
+    return bSucceeded ? 0 : 1;
+}
+
+bool UCppToolsCommandlet::RunOperation(const TSharedRef<FJsonObject>& Arguments, FJsonObject& OutResult)
+{
+    const FString OperationName = GetStringArgument(*Arguments, TEXT("Operation"));
+    OutResult.SetStringField(TEXT("Operation"), OperationName);
+
+    FText FailReason;
+    bool bSucceeded = false;
+
+    if (const FOperation* Operation = Operations.Find(OperationName))
+    {
+        CPPTOOLS_TRACE_SESSION(OperationName);
+        UE_LOG(LogCppToolsCommandlet, Display, TEXT("Running operation %s"), *OperationName);
+        bSucceeded = (this->**Operation)(*Arguments, OutResult, FailReason);
+    }
+    else
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Operation"), FText::FromString(OperationName));
+        FailReason = FText::Format(LOCTEXT("UnknownOperation", "Unknown operation \"{Operation}\""), Args);
+    }
+
+    OutResult.SetBoolField(TEXT("Success"), bSucceeded);
+    if (!bSucceeded)
+    {
+        OutResult.SetStringField(TEXT("Error"), FailReason.ToString());
+        UE_LOG(LogCppToolsCommandlet, Error, TEXT("%s failed: %s"), *OperationName, *FailReason.ToString());
+    }
+    return bSucceeded;
+}
+
+bool UCppToolsCommandlet::GenerateModule(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    TSharedPtr<IPlugin> Target;
+    if (!GetTargetArgument(Arguments, Target, OutFailReason)) return false;
+
+    const TArray<FString> ModuleNames = GetListArgument(Arguments, TEXT("Name"));
+    if (ModuleNames.Num() == 0)
+    {
+        OutFailReason = LOCTEXT("NoModuleName", "No module name was specified");
+        return false;
+    }
+
+    const EHostType::Type Type = EHostType::FromString(*GetStringArgument(Arguments, TEXT("Type"), TEXT("Runtime")));
+    if (Type == EHostType::Max)
+    {
+        OutFailReason = LOCTEXT("InvalidModuleType", "Invalid module type");
+        return false;
+    }
+
+    const ELoadingPhase::Type LoadingPhase = ELoadingPhase::FromString(*GetStringArgument(Arguments, TEXT("LoadingPhase"),
+        Type == EHostType::Editor ? TEXT("PostEngineInit") : TEXT("Default")));
+    if (LoadingPhase == ELoadingPhase::Max)
+    {
+        OutFailReason = LOCTEXT("InvalidLoadingPhase", "Invalid loading phase");
+        return false;
+    }
+
+    ECppToolsModuleTemplate ModuleTemplate;
+    if (!CppToolsModuleTemplates::FromString(GetStringArgument(Arguments, TEXT("Template"), TEXT("Basic")), ModuleTemplate))
+    {
+        OutFailReason = LOCTEXT("InvalidModuleTemplate", "Invalid module template");
+        return false;
+    }
+
+    const bool bUsePCH = GetBoolArgument(Arguments, TEXT("UsePCH"));
+    const bool bGenerateFwdHeader = GetBoolArgument(Arguments, TEXT("FwdHeader"));
+    const bool bAddLLMTag = GetBoolArgument(Arguments, TEXT("LLMTag"));
+    TMap<FString, int32> UsedLLMTags;
+    if (bAddLLMTag)
+    {
+        UsedLLMTags = CppToolsMemoryTags::GetProjectTags();
+    }
+
+    TArray<TSharedPtr<FJsonValue>> CreatedFileValues;
+    for (const FString& ModuleName : ModuleNames)
+    {
+        if (!CppToolsUtil::IsValidNewModuleName(ModuleName, OutFailReason)) return false;
+
+        // Each module of the batch gets its own tag, as the descriptors may not list the modules created before it yet
+        int32 LLMTagIndex = INDEX_NONE;
+        if (bAddLLMTag)
+        {
+            LLMTagIndex = CppToolsMemoryTags::FindFreeTagIndex(UsedLLMTags);
+            if (LLMTagIndex == INDEX_NONE)
+            {
+                OutFailReason = LOCTEXT("NoFreeLLMTag", "Every LLM project tag is used by a module already");
+                return false;
+            }
+            UsedLLMTags.Add(ModuleName, LLMTagIndex);
+        }
+
+        TArray<FString> CreatedFiles;
+        const GameProjectUtils::EAddCodeToProjectResult Result = CppToolsUtil::GenerateModule(CppToolsUtil::GetNewModulePath(ModuleName, Target),
+            Target, ModuleName, Type, LoadingPhase, bUsePCH, CreatedFiles, OutFailReason, bGenerateFwdHeader, LLMTagIndex, ModuleTemplate);
+
+        for (const FString& CreatedFile : CreatedFiles)
+        {
+            CreatedFileValues.Add(MakeShareable(new FJsonValueString(CreatedFile)));
+        }
+        if (Result != GameProjectUtils::EAddCodeToProjectResult::Succeeded)
+        {
+            OutResult.SetArrayField(TEXT("CreatedFiles"), CreatedFileValues);
+            return false;
+        }
+    }
+
+    OutResult.SetArrayField(TEXT("CreatedFiles"), CreatedFileValues);
+    return true;
+}
+
+bool UCppToolsCommandlet::AddDependency(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    TSharedPtr<IPlugin> Target;
+    if (!GetTargetArgument(Arguments, Target, OutFailReason)) return false;
+
+    const FString ModuleName = GetStringArgument(Arguments, TEXT("Module"));
+    const FString DependencyName = GetStringArgument(Arguments, TEXT("Dependency"));
+    if (ModuleName.IsEmpty() || DependencyName.IsEmpty())
+    {
+        OutFailReason = LOCTEXT("MissingDependencyArguments", "Both a Module and a Dependency must be specified");
+        return false;
+    }
+
+    return CppToolsUtil::InsertDependencyIntoModule(ModuleName, Target, DependencyName, OutFailReason, GetBoolArgument(Arguments, TEXT("Private")));
+}
+
+bool UCppToolsCommandlet::RefactorDependencies(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    FCppToolsDependencyChange Change;
+    if (!CppToolsRefactor::ChangeTypeFromString(GetStringArgument(Arguments, TEXT("Change"), TEXT("Add")), Change.Type))
+    {
+        OutFailReason = LOCTEXT("InvalidChange", "Invalid Change, expected Add, Remove, Move or Replace");
+        return false;
+    }
+    Change.Dependency = GetStringArgument(Arguments, TEXT("Dependency"));
+    Change.Replacement = GetStringArgument(Arguments, TEXT("Replacement"));
+    Change.bPrivate = GetBoolArgument(Arguments, TEXT("Private"));
+    Change.ModuleNames = GetListArgument(Arguments, TEXT("Module"));
+    for (const FString& TypeName : GetListArgument(Arguments, TEXT("Type")))
+    {
+        const EHostType::Type Type = EHostType::FromString(*TypeName);
+        if (Type == EHostType::Max)
+        {
+            OutFailReason = LOCTEXT("InvalidModuleType", "Invalid module type");
+            return false;
+        }
+        Change.ModuleTypes.Add(Type);
+    }
+
+    TArray<FCppToolsFileEdit> Edits;
+    if (!CppToolsRefactor::PreviewChange(Change, Edits, OutFailReason)) return false;
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const FCppToolsFileEdit& Edit : Edits)
+    {
+        ModuleValues.Add(MakeShareable(new FJsonValueString(Edit.ModuleName)));
+    }
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+    OutResult.SetStringField(TEXT("Diff"), CppToolsRefactor::JoinDiffs(Edits));
+
+    const bool bApply = GetBoolArgument(Arguments, TEXT("Apply"));
+    if (bApply && !CppToolsRefactor::ApplyEdits(Edits, OutFailReason)) return false;
+
+    OutResult.SetNumberField(TEXT("Written"), bApply ? Edits.Num() : 0);
+    return true;
+}
+
+bool UCppToolsCommandlet::UpdateTargets(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    const FString ModuleName = GetStringArgument(Arguments, TEXT("Module"));
+    if (ModuleName.IsEmpty())
+    {
+        OutFailReason = LOCTEXT("NoTargetModule", "No Module was specified");
+        return false;
+    }
+
+    return CppToolsUtil::InsertDependencyIntoTarget(ModuleName, GetBoolArgument(Arguments, TEXT("Editor")), OutFailReason);
+}
+
+bool UCppToolsCommandlet::Analyze(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    const TArray<TPair<FModuleContextInfo, TSharedPtr<IPlugin>>> Modules = CppToolsUtil::GetProjectAndPluginModules();
+
+    const TArray<FString> ModuleFilter = GetListArgument(Arguments, TEXT("Module"));
+    const FString PluginFilter = GetStringArgument(Arguments, TEXT("Plugin"));
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : Modules)
+    {
+        if (ModuleFilter.Num() > 0 && !ModuleFilter.Contains(Module.Key.ModuleName)) continue;
+        if (!PluginFilter.IsEmpty() && (!Module.Value.IsValid() || Module.Value->GetName() != PluginFilter)) continue;
+
+        const TArray<FString> PublicDependencies = CppToolsUtil::GetModuleDependencies(Module.Key.ModuleName, Module.Value, false);
+        TArray<FString> PrivateDependencies = CppToolsUtil::GetModuleDependencies(Module.Key.ModuleName, Module.Value, true);
+        PrivateDependencies.RemoveAll([&PublicDependencies](const FString& Dependency) { return PublicDependencies.Contains(Dependency); });
+
+        TArray<TSharedPtr<FJsonValue>> PublicValues;
+        for (const FString& Dependency : PublicDependencies)
+        {
+            PublicValues.Add(MakeShareable(new FJsonValueString(Dependency)));
+        }
+        TArray<TSharedPtr<FJsonValue>> PrivateValues;
+        for (const FString& Dependency : PrivateDependencies)
+        {
+            PrivateValues.Add(MakeShareable(new FJsonValueString(Dependency)));
+        }
+
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Name"), Module.Key.ModuleName);
+        ModuleObject->SetStringField(TEXT("Plugin"), Module.Value.IsValid() ? Module.Value->GetName() : FString());
+        ModuleObject->SetStringField(TEXT("Type"), EHostType::ToString(Module.Key.ModuleType));
+        ModuleObject->SetStringField(TEXT("Path"), Module.Key.ModuleSourcePath);
+        ModuleObject->SetArrayField(TEXT("PublicDependencies"), PublicValues);
+        ModuleObject->SetArrayField(TEXT("PrivateDependencies"), PrivateValues);
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+    return true;
+}
+
+bool UCppToolsCommandlet::UpdateFwdHeaders(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    const TArray<FString> ModuleNames = GetListArgument(Arguments, TEXT("Module"));
+    if (ModuleNames.Num() == 0)
+    {
+        const int32 NumUpdated = CppToolsUtil::UpdateProjectFwdHeaders(OutFailReason);
+        OutResult.SetNumberField(TEXT("Updated"), FMath::Max(0, NumUpdated));
+        return NumUpdated != INDEX_NONE;
+    }
+
+    TSharedPtr<IPlugin> Target;
+    if (!GetTargetArgument(Arguments, Target, OutFailReason)) return false;
+
+    for (const FString& ModuleName : ModuleNames)
+    {
+        if (!CppToolsUtil::UpdateModuleFwdHeader(ModuleName, Target, OutFailReason)) return false;
+    }
+    OutResult.SetNumberField(TEXT("Updated"), ModuleNames.Num());
+    return true;
+}
+
+bool UCppToolsCommandlet::FindDeadModules(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    const FCppToolsDeadModuleReport Report = CppToolsModuleGraph::FindDeadModules(GetListArgument(Arguments, TEXT("Roots")));
+
+    using namespace CppToolsCommandletImpl;
+
+    TArray<TSharedPtr<FJsonValue>> TargetValues;
+    for (const FCppToolsTargetInfo& Target : Report.Targets)
+    {
+        TSharedRef<FJsonObject> TargetObject = MakeShareable(new FJsonObject);
+        TargetObject->SetStringField(TEXT("Name"), Target.Name);
+        TargetObject->SetArrayField(TEXT("Modules"), MakeStringValues(Report.TargetModules.FindRef(Target.Name)));
+        TargetObject->SetArrayField(TEXT("LiveModules"), MakeStringValues(Report.LiveModules.FindRef(Target.Name)));
+        TargetValues.Add(MakeShareable(new FJsonValueObject(TargetObject)));
+    }
+    OutResult.SetArrayField(TEXT("Targets"), TargetValues);
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const TPair<FString, FCppToolsModuleNode>& Module : Report.Modules)
+    {
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Name"), Module.Key);
+        ModuleObject->SetStringField(TEXT("Plugin"), Module.Value.Plugin.IsValid() ? Module.Value.Plugin->GetName() : FString());
+        ModuleObject->SetBoolField(TEXT("Dead"), Report.DeadModules.Contains(Module.Key));
+        ModuleObject->SetStringField(TEXT("RootReason"), Module.Value.RootReason);
+        ModuleObject->SetArrayField(TEXT("UnusedDependencies"), MakeStringValues(Module.Value.UnusedDependencies));
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+    OutResult.SetArrayField(TEXT("DeadModules"), MakeStringValues(Report.DeadModules));
+
+    if (GetBoolArgument(Arguments, TEXT("Cleanup")))
+    {
+        return CppToolsModuleGraph::RemoveDeadModules(Report, GetBoolArgument(Arguments, TEXT("RemoveUnusedDependencies")), OutFailReason);
+    }
+    return true;
+}
+
+bool UCppToolsCommandlet::AnalyzeTargets(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    const FString Platform = GetStringArgument(Arguments, TEXT("Platform"), FPlatformMisc::GetUBTPlatform());
+    const FCppToolsTargetMembershipReport Report = CppToolsModuleGraph::AnalyzeTargetMembership(Platform);
+
+    using namespace CppToolsCommandletImpl;
+
+    OutResult.SetStringField(TEXT("Platform"), Report.Platform);
+
+    TArray<TSharedPtr<FJsonValue>> TargetValues;
+    for (const FCppToolsTargetInfo& Target : Report.Targets)
+    {
+        TSharedRef<FJsonObject> TargetObject = MakeShareable(new FJsonObject);
+        TargetObject->SetStringField(TEXT("Name"), Target.Name);
+        TargetObject->SetStringField(TEXT("Type"), Target.Type);
+        TargetObject->SetArrayField(TEXT("UnneededModules"), MakeStringValues(Report.UnneededModules.FindRef(Target.Name)));
+        TargetValues.Add(MakeShareable(new FJsonValueObject(TargetObject)));
+    }
+    OutResult.SetArrayField(TEXT("Targets"), TargetValues);
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const TPair<FString, TArray<FString>>& Module : Report.ModuleTargets)
+    {
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Name"), Module.Key);
+        ModuleObject->SetStringField(TEXT("Type"), EHostType::ToString(Report.Modules[Module.Key].Type));
+        ModuleObject->SetArrayField(TEXT("Targets"), MakeStringValues(Module.Value));
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+
+    TArray<TSharedPtr<FJsonValue>> IssueValues;
+    for (const FCppToolsTargetMembershipIssue& Issue : Report.Issues)
+    {
+        TSharedRef<FJsonObject> IssueObject = MakeShareable(new FJsonObject);
+        IssueObject->SetStringField(TEXT("Target"), Issue.Target);
+        IssueObject->SetStringField(TEXT("Module"), Issue.Module);
+        IssueObject->SetStringField(TEXT("Kind"), Issue.Kind);
+        IssueObject->SetStringField(TEXT("Reason"), Issue.Reason);
+        IssueObject->SetBoolField(TEXT("Fixable"), Issue.bFixable);
+        IssueValues.Add(MakeShareable(new FJsonValueObject(IssueObject)));
+    }
+    OutResult.SetArrayField(TEXT("Issues"), IssueValues);
+
+    TArray<FCppToolsFileEdit> Edits;
+    if (!CppToolsModuleGraph::PlanTargetMembershipFixes(Report, Edits, OutFailReason)) return false;
+    OutResult.SetStringField(TEXT("Diff"), CppToolsRefactor::JoinDiffs(Edits));
+
+    const bool bApply = GetBoolArgument(Arguments, TEXT("Apply"));
+    if (bApply && !CppToolsRefactor::ApplyEdits(Edits, OutFailReason)) return false;
+
+    OutResult.SetNumberField(TEXT("Written"), bApply ? Edits.Num() : 0);
+    return true;
+}
+
+bool UCppToolsCommandlet::AuditExports(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    FCppToolsExportAuditSettings Settings;
+    Settings.Platform = GetStringArgument(Arguments, TEXT("Platform"), Settings.Platform);
+    Settings.MaxReferencedFraction = static_cast<float>(GetNumberArgument(Arguments, TEXT("MaxReferencedFraction"), Settings.MaxReferencedFraction));
+
+    // The plugin filter is turned into a module filter, as every module's imports are read either way
+    TArray<FString> ModuleFilter = GetListArgument(Arguments, TEXT("Module"));
+    const FString PluginFilter = GetStringArgument(Arguments, TEXT("Plugin"));
+    if (!PluginFilter.IsEmpty())
+    {
+        const TArray<FString> RequestedModules = ModuleFilter;
+        ModuleFilter.Reset();
+        for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+        {
+            if (!Module.Value.IsValid() || Module.Value->GetName() != PluginFilter) continue;
+            if (RequestedModules.Num() > 0 && !RequestedModules.Contains(Module.Key.ModuleName)) continue;
+
+            ModuleFilter.Add(Module.Key.ModuleName);
+        }
+        if (ModuleFilter.Num() == 0)
+        {
+            OutFailReason = LOCTEXT("NoExportAuditModules", "The plugin has no matching modules");
+            return false;
+        }
+    }
+
+    const TArray<FCppToolsModuleExports> Results = CppToolsExportAudit::AuditModules(ModuleFilter, Settings);
+    if (Results.Num() == 0)
+    {
+        OutFailReason = FText::Format(LOCTEXT("NoSharedObjects", "No shared objects were found in the {0} binaries of the project"), FText::FromString(Settings.Platform));
+        return false;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const FCppToolsModuleExports& Result : Results)
+    {
+        TArray<TSharedPtr<FJsonValue>> ClassValues;
+        for (const FCppToolsExportedClass& Class : Result.Classes)
+        {
+            TArray<TSharedPtr<FJsonValue>> MemberValues;
+            for (const FString& Member : Class.ReferencedMembers)
+            {
+                MemberValues.Add(MakeShareable(new FJsonValueString(Member)));
+            }
+
+            TSharedRef<FJsonObject> ClassObject = MakeShareable(new FJsonObject);
+            ClassObject->SetStringField(TEXT("Name"), Class.Name);
+            ClassObject->SetStringField(TEXT("Header"), Class.Header);
+            ClassObject->SetBoolField(TEXT("Reflected"), Class.bReflected);
+            ClassObject->SetNumberField(TEXT("Exports"), Class.NumExports);
+            ClassObject->SetNumberField(TEXT("ReferencedExports"), Class.NumReferencedExports);
+            ClassObject->SetArrayField(TEXT("ReferencedMembers"), MemberValues);
+            ClassObject->SetStringField(TEXT("Proposal"), Class.Proposal);
+            ClassValues.Add(MakeShareable(new FJsonValueObject(ClassObject)));
+        }
+
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Module"), Result.ModuleName);
+        ModuleObject->SetStringField(TEXT("Binary"), Result.Binary);
+        ModuleObject->SetNumberField(TEXT("Exports"), Result.NumExports);
+        ModuleObject->SetNumberField(TEXT("UnreferencedExports"), Result.NumUnreferencedExports);
+        ModuleObject->SetArrayField(TEXT("Classes"), ClassValues);
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+    return true;
+}
+
+bool UCppToolsCommandlet::ConsolidateModules(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    FCppToolsConsolidationSettings Settings;
+    Settings.Platform = GetStringArgument(Arguments, TEXT("Platform"), Settings.Platform);
+    Settings.MaxCodeBytes = static_cast<int64>(GetNumberArgument(Arguments, TEXT("MaxCodeBytes"), Settings.MaxCodeBytes));
+    Settings.MillisecondsPerModule = GetNumberArgument(Arguments, TEXT("MillisecondsPerModule"), Settings.MillisecondsPerModule);
+    Settings.MicrosecondsPerRelocation = GetNumberArgument(Arguments, TEXT("MicrosecondsPerRelocation"), Settings.MicrosecondsPerRelocation);
+    Settings.MicrosecondsPerImport = GetNumberArgument(Arguments, TEXT("MicrosecondsPerImport"), Settings.MicrosecondsPerImport);
+
+    const FCppToolsConsolidationReport Report = CppToolsConsolidation::Analyze(Settings);
+    if (Report.LoadCosts.Num() == 0)
+    {
+        OutFailReason = FText::Format(LOCTEXT("NoConsolidationBinaries", "No shared objects were found in the {0} binaries of the project"), FText::FromString(Settings.Platform));
+        return false;
+    }
+
+    using namespace CppToolsCommandletImpl;
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const FCppToolsModuleLoadCost& Cost : Report.LoadCosts)
+    {
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Module"), Cost.ModuleName);
+        ModuleObject->SetStringField(TEXT("Binary"), Cost.Binary);
+        ModuleObject->SetNumberField(TEXT("FileBytes"), Cost.LoadInfo.FileBytes);
+        ModuleObject->SetNumberField(TEXT("CodeBytes"), Cost.LoadInfo.CodeBytes);
+        ModuleObject->SetNumberField(TEXT("Relocations"), Cost.LoadInfo.NumRelocations);
+        ModuleObject->SetNumberField(TEXT("Imports"), Cost.NumImports);
+        ModuleObject->SetNumberField(TEXT("Exports"), Cost.NumExports);
+        ModuleObject->SetNumberField(TEXT("EstimatedMilliseconds"), Cost.EstimatedMilliseconds);
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+    OutResult.SetNumberField(TEXT("TotalMilliseconds"), Report.TotalMilliseconds);
+
+    TArray<TSharedPtr<FJsonValue>> ClusterValues;
+    for (const FCppToolsModuleCluster& Cluster : Report.Clusters)
+    {
+        TSharedRef<FJsonObject> ClusterObject = MakeShareable(new FJsonObject);
+        ClusterObject->SetStringField(TEXT("TargetModule"), Cluster.TargetModule);
+        ClusterObject->SetArrayField(TEXT("Modules"), MakeStringValues(Cluster.Modules));
+        ClusterObject->SetStringField(TEXT("Plugin"), Cluster.Plugin.IsValid() ? Cluster.Plugin->GetName() : FString());
+        ClusterObject->SetStringField(TEXT("Type"), EHostType::ToString(Cluster.Type));
+        ClusterObject->SetStringField(TEXT("LoadingPhase"), ELoadingPhase::ToString(Cluster.LoadingPhase));
+        ClusterObject->SetNumberField(TEXT("CodeBytes"), Cluster.CodeBytes);
+        ClusterObject->SetNumberField(TEXT("InternalImports"), Cluster.NumInternalImports);
+        ClusterObject->SetNumberField(TEXT("EstimatedSavingsMilliseconds"), Cluster.EstimatedSavingsMilliseconds);
+        ClusterValues.Add(MakeShareable(new FJsonValueObject(ClusterObject)));
+    }
+    OutResult.SetArrayField(TEXT("Clusters"), ClusterValues);
+
+    TArray<FString> MergedClusters;
+    for (const FString& ModuleName : GetListArgument(Arguments, TEXT("Merge")))
+    {
+        const FCppToolsModuleCluster* Cluster = CppToolsConsolidation::FindCluster(Report, ModuleName);
+        if (Cluster == nullptr)
+        {
+            OutFailReason = FText::Format(LOCTEXT("NoCluster", "{0} is not part of a cluster of modules to merge"), FText::FromString(ModuleName));
+            return false;
+        }
+        if (MergedClusters.Contains(Cluster->TargetModule)) continue;
+
+        if (!CppToolsConsolidation::MergeCluster(Report, *Cluster, OutFailReason)) return false;
+        MergedClusters.Add(Cluster->TargetModule);
+    }
+    OutResult.SetArrayField(TEXT("Merged"), MakeStringValues(MergedClusters));
+    return true;
+}
+
+bool UCppToolsCommandlet::ReconcileManifest(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    const FString ManifestPath = GetStringArgument(Arguments, TEXT("Manifest"), CppToolsManifest::GetDefaultManifestPath());
+    OutResult.SetStringField(TEXT("Manifest"), ManifestPath);
+
+    FCppToolsManifest Manifest;
+    if (GetBoolArgument(Arguments, TEXT("Capture")))
+    {
+        if (!CppToolsManifest::CaptureManifest(Manifest, OutFailReason) || !CppToolsManifest::WriteManifest(ManifestPath, Manifest, OutFailReason)) return false;
+        OutResult.SetNumberField(TEXT("Modules"), Manifest.Modules.Num());
+        return true;
+    }
+
+    FCppToolsManifestPlan Plan;
+    if (!CppToolsManifest::ReadManifest(ManifestPath, Manifest, OutFailReason) || !CppToolsManifest::PlanReconcile(Manifest, Plan, OutFailReason)) return false;
+
+    using namespace CppToolsCommandletImpl;
+
+    TArray<FString> ChangedModules;
+    Plan.ChangedModules.GetKeys(ChangedModules);
+    ChangedModules.Sort();
+    OutResult.SetArrayField(TEXT("ChangedModules"), MakeStringValues(ChangedModules));
+    OutResult.SetArrayField(TEXT("UnlistedModules"), MakeStringValues(Plan.UnlistedModules));
+    OutResult.SetStringField(TEXT("Diff"), Plan.GetDiff());
+
+    const bool bApply = GetBoolArgument(Arguments, TEXT("Apply"));
+    TArray<FString> BuiltModules;
+    if (bApply && !CppToolsManifest::ApplyPlan(Plan, GetBoolArgument(Arguments, TEXT("Build"), true), BuiltModules, OutFailReason)) return false;
+
+    OutResult.SetNumberField(TEXT("Written"), bApply ? Plan.CreatedFiles.Num() + Plan.Edits.Num() : 0);
+    OutResult.SetArrayField(TEXT("BuiltModules"), MakeStringValues(BuiltModules));
+    return true;
+}
+
+bool UCppToolsCommandlet::ConfigureUnity(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    FCppToolsUnitySettings Settings;
+    Settings.HistoryDays = static_cast<int32>(GetNumberArgument(Arguments, TEXT("Days"), Settings.HistoryDays));
+    Settings.MinEditsForHotFile = static_cast<int32>(GetNumberArgument(Arguments, TEXT("MinEdits"), Settings.MinEditsForHotFile));
+    Settings.DisableUnityHotFraction = static_cast<float>(GetNumberArgument(Arguments, TEXT("HotFraction"), Settings.DisableUnityHotFraction));
+    Settings.ColdModuleMinSourceFiles = static_cast<int32>(GetNumberArgument(Arguments, TEXT("ColdMinFiles"), Settings.ColdModuleMinSourceFiles));
+    const bool bApply = GetBoolArgument(Arguments, TEXT("Apply"));
+    const bool bMeasure = GetBoolArgument(Arguments, TEXT("Measure"));
+    const int32 NumTouchedFiles = static_cast<int32>(GetNumberArgument(Arguments, TEXT("TouchFiles"), 3));
+
+    TMap<FString, int32> Edits;
+    if (!CppToolsUnityConfig::ReadGitChurn(FPaths::ProjectDir(), Settings.HistoryDays, Edits, OutFailReason)) return false;
+
+    const TArray<FCppToolsUnityPlan> Plans = CppToolsUnityConfig::PlanProjectModules(Edits, Settings);
+
+    // The incremental builds touch the most frequently edited files of the project, as those are the edits being iterated on
+    TArray<TPair<FString, int32>> ProjectHotFiles;
+    TArray<TSharedPtr<FJsonValue>> PlanValues;
+    for (const FCppToolsUnityPlan& Plan : Plans)
+    {
+        TArray<TSharedPtr<FJsonValue>> HotFileValues;
+        for (int32 I = 0; I < Plan.HotFiles.Num(); I++)
+        {
+            HotFileValues.Add(MakeShareable(new FJsonValueString(Plan.HotFiles[I])));
+            ProjectHotFiles.Emplace(Plan.HotFiles[I], Plan.HotFileEdits[I]);
+        }
+
+        TSharedRef<FJsonObject> PlanObject = MakeShareable(new FJsonObject);
+        PlanObject->SetStringField(TEXT("Module"), Plan.ModuleName);
+        PlanObject->SetNumberField(TEXT("SourceFiles"), Plan.NumSourceFiles);
+        PlanObject->SetBoolField(TEXT("bUseUnity"), Plan.bUseUnity);
+        PlanObject->SetNumberField(TEXT("MinSourceFilesForUnityBuildOverride"), Plan.MinSourceFilesForUnityBuild);
+        PlanObject->SetArrayField(TEXT("HotFiles"), HotFileValues);
+        PlanValues.Add(MakeShareable(new FJsonValueObject(PlanObject)));
+    }
+    OutResult.SetArrayField(TEXT("Modules"), PlanValues);
+
+    ProjectHotFiles.Sort([](const TPair<FString, int32>& A, const TPair<FString, int32>& B) { return A.Value > B.Value; });
+    TArray<FString> TouchedFiles;
+    for (int32 I = 0; I < FMath::Min(NumTouchedFiles, ProjectHotFiles.Num()); I++)
+    {
+        TouchedFiles.Add(ProjectHotFiles[I].Key);
+    }
+
+    auto Measure = [&OutResult, &TouchedFiles](const FString& Prefix, FText& OutMeasureFailReason)
+    {
+        double FullBuildSeconds;
+        double IncrementalBuildSeconds;
+        if (!CppToolsBuild::MeasureFullBuild(FullBuildSeconds, OutMeasureFailReason)
+            || !CppToolsBuild::MeasureIncrementalBuild(TouchedFiles, IncrementalBuildSeconds, OutMeasureFailReason))
+        {
+            return false;
+        }
+        OutResult.SetNumberField(Prefix + TEXT("FullBuildSeconds"), FullBuildSeconds);
+        OutResult.SetNumberField(Prefix + TEXT("IncrementalBuildSeconds"), IncrementalBuildSeconds);
+        return true;
+    };
+
+    if (bMeasure && !Measure(TEXT("Before"), OutFailReason)) return false;
+
+    if (bApply)
+    {
+        for (const FCppToolsUnityPlan& Plan : Plans)
+        {
+            if (!CppToolsUnityConfig::ApplyPlan(Plan, OutFailReason)) return false;
+        }
+
+        if (bMeasure && !Measure(TEXT("After"), OutFailReason)) return false;
+    }
+    return true;
+}
+
+bool UCppToolsCommandlet::UpdatePCH(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    FCppToolsPCHSettings Settings;
+    Settings.MinIncludeFraction = static_cast<float>(GetNumberArgument(Arguments, TEXT("MinIncludeFraction"), Settings.MinIncludeFraction));
+    Settings.MaxHeaders = static_cast<int32>(GetNumberArgument(Arguments, TEXT("MaxHeaders"), Settings.MaxHeaders));
+    Settings.MinSourceFiles = static_cast<int32>(GetNumberArgument(Arguments, TEXT("MinSourceFiles"), Settings.MinSourceFiles));
+    Settings.MinEditsForUnstableHeader = static_cast<int32>(GetNumberArgument(Arguments, TEXT("MinEdits"), Settings.MinEditsForUnstableHeader));
+    Settings.MaxDrift = static_cast<float>(GetNumberArgument(Arguments, TEXT("MaxDrift"), Settings.MaxDrift));
+    Settings.MinBuildGain = static_cast<float>(GetNumberArgument(Arguments, TEXT("MinBuildGain"), Settings.MinBuildGain));
+    const int32 HistoryDays = static_cast<int32>(GetNumberArgument(Arguments, TEXT("Days"), 30));
+
+    const TArray<FString> ModuleFilter = GetListArgument(Arguments, TEXT("Module"));
+    const FString PluginFilter = GetStringArgument(Arguments, TEXT("Plugin"));
+
+    // Without a git history every header counts as stable
+    TMap<FString, int32> Edits;
+    FText GitFailReason;
+    if (!CppToolsUnityConfig::ReadGitChurn(FPaths::ProjectDir(), HistoryDays, Edits, GitFailReason))
+    {
+        UE_LOG(LogCppToolsCommandlet, Warning, TEXT("%s"), *GitFailReason.ToString());
+    }
+
+    FCppToolsHeaderIndex HeaderIndex;
+    HeaderIndex.Build(CppToolsPCH::GetIncludeSearchDirectories());
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        if (ModuleFilter.Num() > 0 && !ModuleFilter.Contains(Module.Key.ModuleName)) continue;
+        if (!PluginFilter.IsEmpty() && (!Module.Value.IsValid() || Module.Value->GetName() != PluginFilter)) continue;
+
+        FCppToolsPCHResult Result;
+        if (!CppToolsPCH::UpdateModulePCH(Module.Key.ModuleName, Module.Value, HeaderIndex, Edits, Settings, Result, OutFailReason))
+        {
+            return false;
+        }
+
+        TArray<TSharedPtr<FJsonValue>> IncludeValues;
+        for (const FCppToolsIncludeProfileEntry& Entry : Result.Profile)
+        {
+            TSharedRef<FJsonObject> IncludeObject = MakeShareable(new FJsonObject);
+            IncludeObject->SetStringField(TEXT("Include"), Entry.Include);
+            IncludeObject->SetNumberField(TEXT("Size"), Entry.Size);
+            IncludeObject->SetNumberField(TEXT("IncludingFiles"), Entry.NumIncludingFiles);
+            IncludeValues.Add(MakeShareable(new FJsonValueObject(IncludeObject)));
+        }
+
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Module"), Result.ModuleName);
+        ModuleObject->SetStringField(TEXT("Status"), Result.Status);
+        ModuleObject->SetStringField(TEXT("Reason"), Result.Reason);
+        ModuleObject->SetNumberField(TEXT("Drift"), Result.Drift);
+        ModuleObject->SetArrayField(TEXT("Includes"), IncludeValues);
+        if (Result.bMeasured)
+        {
+            ModuleObject->SetNumberField(TEXT("SecondsWithoutPCH"), Result.SecondsWithoutPCH);
+            ModuleObject->SetNumberField(TEXT("SecondsWithPCH"), Result.SecondsWithPCH);
+        }
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+    return true;
+}
+
+bool UCppToolsCommandlet::ConvertToIWYU(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    const TArray<FString> ModuleFilter = GetListArgument(Arguments, TEXT("Module"));
+    const FString PluginFilter = GetStringArgument(Arguments, TEXT("Plugin"));
+    if (ModuleFilter.Num() == 0)
+    {
+        OutFailReason = LOCTEXT("NoIWYUModule", "No Module was specified");
+        return false;
+    }
+
+    FCppToolsIWYUSettings Settings;
+    const TArray<FString> MonolithicHeaders = GetListArgument(Arguments, TEXT("MonolithicHeaders"));
+    if (MonolithicHeaders.Num() > 0)
+    {
+        Settings.MonolithicHeaders = MonolithicHeaders;
+    }
+    const bool bApply = GetBoolArgument(Arguments, TEXT("Apply"));
+    const bool bCheckHeaders = GetBoolArgument(Arguments, TEXT("CheckHeaders"));
+    const bool bMeasure = GetBoolArgument(Arguments, TEXT("Measure"));
+
+    FCppToolsHeaderIndex HeaderIndex;
+    HeaderIndex.Build(CppToolsPCH::GetIncludeSearchDirectories());
+    FCppToolsSymbolIndex SymbolIndex;
+    SymbolIndex.Build(Settings.MonolithicHeaders, HeaderIndex);
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        if (!ModuleFilter.Contains(Module.Key.ModuleName)) continue;
+        if (!PluginFilter.IsEmpty() && (!Module.Value.IsValid() || Module.Value->GetName() != PluginFilter)) continue;
+
+        FCppToolsIWYUResult Result;
+        if (!CppToolsIWYU::ConvertModule(Module.Key.ModuleName, Module.Value, HeaderIndex, SymbolIndex, Settings, bApply, bCheckHeaders, bMeasure,
+            Result, OutFailReason))
+        {
+            return false;
+        }
+
+        TArray<TSharedPtr<FJsonValue>> FileValues;
+        for (const FCppToolsFileEdit& Edit : Result.Edits)
+        {
+            FileValues.Add(MakeShareable(new FJsonValueString(Edit.Filename)));
+        }
+
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Module"), Result.ModuleName);
+        ModuleObject->SetArrayField(TEXT("Files"), FileValues);
+        ModuleObject->SetStringField(TEXT("Diff"), CppToolsRefactor::JoinDiffs(Result.Edits));
+        ModuleObject->SetNumberField(TEXT("Written"), bApply ? Result.Edits.Num() : 0);
+        if (Result.bCheckedHeaders)
+        {
+            TArray<TSharedPtr<FJsonValue>> HeaderValues;
+            for (const FString& Header : Result.NonSelfContainedHeaders)
+            {
+                HeaderValues.Add(MakeShareable(new FJsonValueString(Header)));
+            }
+            ModuleObject->SetNumberField(TEXT("CheckedHeaders"), Result.NumCheckedHeaders);
+            ModuleObject->SetArrayField(TEXT("NonSelfContainedHeaders"), HeaderValues);
+            ModuleObject->SetBoolField(TEXT("SourcesFailed"), Result.bSourcesFailed);
+        }
+        if (bApply && bMeasure)
+        {
+            ModuleObject->SetNumberField(TEXT("SecondsBefore"), Result.SecondsBefore);
+            ModuleObject->SetNumberField(TEXT("SecondsAfter"), Result.SecondsAfter);
+        }
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+    return true;
+}
+
+bool UCppToolsCommandlet::CriticalPath(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    FCppToolsCriticalPathSettings Settings;
+    const TArray<FString> CoreCounts = GetListArgument(Arguments, TEXT("Cores"));
+    if (CoreCounts.Num() > 0)
+    {
+        Settings.Cores.Reset();
+        for (const FString& CoreCount : CoreCounts)
+        {
+            Settings.Cores.Add(FMath::Max(1, FCString::Atoi(*CoreCount)));
+        }
+    }
+    Settings.TargetCores = static_cast<int32>(GetNumberArgument(Arguments, TEXT("TargetCores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads()));
+    Settings.SplitParts = static_cast<int32>(GetNumberArgument(Arguments, TEXT("SplitParts"), Settings.SplitParts));
+    Settings.MinSplitFraction = static_cast<float>(GetNumberArgument(Arguments, TEXT("MinSplitFraction"), Settings.MinSplitFraction));
+    Settings.MaxSuggestions = static_cast<int32>(GetNumberArgument(Arguments, TEXT("MaxSuggestions"), Settings.MaxSuggestions));
+    Settings.SecondsPerKilobyte = GetNumberArgument(Arguments, TEXT("SecondsPerKilobyte"), Settings.SecondsPerKilobyte);
+
+    TMap<FString, FCppToolsModuleBuildTask> Tasks = CppToolsCriticalPath::ReadBuildTasks(Settings.SecondsPerKilobyte);
+    if (GetBoolArgument(Arguments, TEXT("Measure")) && !CppToolsCriticalPath::MeasureBuildTasks(Tasks, OutFailReason)) return false;
+
+    const FCppToolsCriticalPathReport Report = CppToolsCriticalPath::Analyze(Tasks, Settings);
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const TPair<FString, FCppToolsModuleBuildTask>& Task : Report.Tasks)
+    {
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Name"), Task.Key);
+        ModuleObject->SetNumberField(TEXT("Seconds"), Task.Value.Seconds);
+        ModuleObject->SetBoolField(TEXT("Measured"), Task.Value.bMeasured);
+        ModuleObject->SetNumberField(TEXT("EarliestFinish"), Task.Value.EarliestFinish);
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+
+    TArray<TSharedPtr<FJsonValue>> PathValues;
+    for (const FString& ModuleName : Report.CriticalPath)
+    {
+        PathValues.Add(MakeShareable(new FJsonValueString(ModuleName)));
+    }
+    OutResult.SetArrayField(TEXT("CriticalPath"), PathValues);
+    OutResult.SetNumberField(TEXT("CriticalPathSeconds"), Report.CriticalPathSeconds);
+    OutResult.SetNumberField(TEXT("TotalSeconds"), Report.TotalSeconds);
+
+    TArray<TSharedPtr<FJsonValue>> ParallelismValues;
+    for (const FCppToolsParallelism& Parallelism : Report.Parallelism)
+    {
+        TSharedRef<FJsonObject> ParallelismObject = MakeShareable(new FJsonObject);
+        ParallelismObject->SetNumberField(TEXT("Cores"), Parallelism.Cores);
+        ParallelismObject->SetNumberField(TEXT("Seconds"), Parallelism.Seconds);
+        ParallelismObject->SetNumberField(TEXT("Speedup"), Parallelism.Speedup);
+        ParallelismObject->SetNumberField(TEXT("Efficiency"), Parallelism.Efficiency);
+        ParallelismValues.Add(MakeShareable(new FJsonValueObject(ParallelismObject)));
+    }
+    OutResult.SetArrayField(TEXT("Parallelism"), ParallelismValues);
+
+    TArray<TSharedPtr<FJsonValue>> SuggestionValues;
+    for (const FCppToolsSplitSuggestion& Suggestion : Report.Suggestions)
+    {
+        TSharedRef<FJsonObject> SuggestionObject = MakeShareable(new FJsonObject);
+        SuggestionObject->SetStringField(TEXT("Module"), Suggestion.ModuleName);
+        SuggestionObject->SetNumberField(TEXT("ModuleSeconds"), Suggestion.ModuleSeconds);
+        SuggestionObject->SetNumberField(TEXT("Parts"), Suggestion.Parts);
+        SuggestionObject->SetNumberField(TEXT("SecondsBefore"), Suggestion.SecondsBefore);
+        SuggestionObject->SetNumberField(TEXT("SecondsAfter"), Suggestion.SecondsAfter);
+        SuggestionObject->SetNumberField(TEXT("ProjectedSpeedup"), Suggestion.GetProjectedSpeedup());
+        SuggestionValues.Add(MakeShareable(new FJsonValueObject(SuggestionObject)));
+    }
+    OutResult.SetArrayField(TEXT("SplitSuggestions"), SuggestionValues);
+    return true;
+}
+
+bool UCppToolsCommandlet::TimeTrace(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    if (GetBoolArgument(Arguments, TEXT("Build")))
+    {
+        double BuildSeconds;
+        if (!CppToolsTimeTrace::BuildWithTimeTrace(BuildSeconds, OutFailReason)) return false;
+        OutResult.SetNumberField(TEXT("BuildSeconds"), BuildSeconds);
+    }
+
+    const TArray<FString> ModuleFilter = GetListArgument(Arguments, TEXT("Module"));
+    const int32 MaxEntries = static_cast<int32>(GetNumberArgument(Arguments, TEXT("Top"), 10));
+
+    auto MakeEntryValues = [](const TArray<FCppToolsTimeTraceEntry>& Entries)
+    {
+        TArray<TSharedPtr<FJsonValue>> Values;
+        for (const FCppToolsTimeTraceEntry& Entry : Entries)
+        {
+            TSharedRef<FJsonObject> EntryObject = MakeShareable(new FJsonObject);
+            EntryObject->SetStringField(TEXT("Name"), Entry.Name);
+            EntryObject->SetNumberField(TEXT("Milliseconds"), Entry.Milliseconds);
+            EntryObject->SetNumberField(TEXT("Count"), Entry.Count);
+            Values.Add(MakeShareable(new FJsonValueObject(EntryObject)));
+        }
+        return Values;
+    };
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const FCppToolsModuleCompileProfile& Profile : CppToolsTimeTrace::IngestTraces(MaxEntries))
+    {
+        if (ModuleFilter.Num() > 0 && !ModuleFilter.Contains(Profile.ModuleName)) continue;
+
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Module"), Profile.ModuleName);
+        ModuleObject->SetNumberField(TEXT("TranslationUnits"), Profile.NumTranslationUnits);
+        ModuleObject->SetNumberField(TEXT("TotalMilliseconds"), Profile.TotalMilliseconds);
+        ModuleObject->SetNumberField(TEXT("FrontendMilliseconds"), Profile.FrontendMilliseconds);
+        ModuleObject->SetNumberField(TEXT("BackendMilliseconds"), Profile.BackendMilliseconds);
+        ModuleObject->SetStringField(TEXT("SlowestTranslationUnit"), Profile.SlowestTranslationUnit);
+        ModuleObject->SetNumberField(TEXT("SlowestTranslationUnitMilliseconds"), Profile.SlowestTranslationUnitMilliseconds);
+        ModuleObject->SetArrayField(TEXT("Headers"), MakeEntryValues(Profile.Headers));
+        ModuleObject->SetArrayField(TEXT("Templates"), MakeEntryValues(Profile.Templates));
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+    OutResult.SetArrayField(TEXT("Modules"), ModuleValues);
+    return true;
+}
+
+bool UCppToolsCommandlet::Benchmark(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    TMap<FString, FCppToolsBenchmarkResult> Baseline;
+    float Tolerance = 0.25f;
+    CppToolsBenchmark::LoadBaseline(Baseline, Tolerance);
+    Tolerance = static_cast<float>(GetNumberArgument(Arguments, TEXT("Tolerance"), Tolerance));
+
+    TArray<FCppToolsBenchmarkResult> Results;
+    CppToolsBenchmark::RunBenchmarks(GetStringArgument(Arguments, TEXT("Filter")),
+        static_cast<float>(GetNumberArgument(Arguments, TEXT("IterationScale"), 1.0)), Results);
+
+    TArray<TSharedPtr<FJsonValue>> ResultValues;
+    for (const FCppToolsBenchmarkResult& Result : Results)
+    {
+        TSharedRef<FJsonObject> ResultObject = MakeShareable(new FJsonObject);
+        ResultObject->SetStringField(TEXT("Name"), Result.Name);
+        ResultObject->SetNumberField(TEXT("Iterations"), Result.Iterations);
+        ResultObject->SetNumberField(TEXT("SecondsPerIteration"), Result.SecondsPerIteration);
+        ResultObject->SetNumberField(TEXT("Throughput"), Result.GetThroughput());
+        ResultObject->SetNumberField(TEXT("AllocationsPerIteration"), Result.AllocationsPerIteration);
+        ResultObject->SetNumberField(TEXT("AllocatedBytesPerIteration"), Result.AllocatedBytesPerIteration);
+        ResultValues.Add(MakeShareable(new FJsonValueObject(ResultObject)));
+    }
+    OutResult.SetArrayField(TEXT("Benchmarks"), ResultValues);
+
+    if (GetBoolArgument(Arguments, TEXT("UpdateBaseline")))
+    {
+        if (!CppToolsBenchmark::SaveBaseline(Results, Tolerance))
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("BaselineFile"), FText::FromString(CppToolsBenchmark::GetBaselineFile()));
+            OutFailReason = FText::Format(LOCTEXT("FailedToSaveBaseline", "Failed to save the benchmark baseline to {BaselineFile}"), Args);
+            return false;
+        }
+        return true;
+    }
+
+    TArray<FString> MissingBaselines;
+    const TArray<FString> Regressions = CppToolsBenchmark::FindRegressions(Results, Baseline, Tolerance, MissingBaselines);
+    TArray<TSharedPtr<FJsonValue>> RegressionValues;
+    for (const FString& Regression : Regressions)
+    {
+        RegressionValues.Add(MakeShareable(new FJsonValueString(Regression)));
+    }
+    OutResult.SetArrayField(TEXT("Regressions"), RegressionValues);
+
+    // A benchmark without a baseline has nothing to regress against, so it is only reported
+    TArray<TSharedPtr<FJsonValue>> MissingBaselineValues;
+    for (const FString& MissingBaseline : MissingBaselines)
+    {
+        UE_LOG(LogCppToolsCommandlet, Warning, TEXT("%s has no baseline, record one with -UpdateBaseline"), *MissingBaseline);
+        MissingBaselineValues.Add(MakeShareable(new FJsonValueString(MissingBaseline)));
+    }
+    OutResult.SetArrayField(TEXT("MissingBaselines"), MissingBaselineValues);
+
+    if (Regressions.Num() > 0)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Regressions"), FText::FromString(FString::Join(Regressions, TEXT("\n"))));
+        OutFailReason = FText::Format(LOCTEXT("BenchmarkRegressions", "Benchmarks regressed against the baseline:\n{Regressions}"), Args);
+        return false;
+    }
+    return true;
+}
+
+bool UCppToolsCommandlet::GenerateSyntheticProject(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    FCppToolsSyntheticProjectSettings Settings;
+    if (!GetSyntheticProjectArguments(Arguments, Settings, OutFailReason)) return false;
+    Settings.NumPlugins = static_cast<int32>(GetNumberArgument(Arguments, TEXT("Plugins"), Settings.NumPlugins));
+
+    TArray<FCppToolsSyntheticModule> Modules;
+    if (!CppToolsScaleTest::GenerateSyntheticProject(Settings, Modules, OutFailReason)) return false;
+
+    OutResult.SetStringField(TEXT("Root"), Settings.RootDir);
+    OutResult.SetNumberField(TEXT("Plugins"), Settings.NumPlugins);
+    OutResult.SetNumberField(TEXT("Modules"), Modules.Num());
+    return true;
+}
+
+bool UCppToolsCommandlet::ScaleTest(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason)
+{
+    FCppToolsSyntheticProjectSettings Settings;
+    if (!GetSyntheticProjectArguments(Arguments, Settings, OutFailReason)) return false;
+
+    TArray<int32> PluginCounts;
+    for (const FString& PluginCount : GetListArgument(Arguments, TEXT("Plugins")))
+    {
+        PluginCounts.Add(FCString::Atoi(*PluginCount));
+    }
+    if (PluginCounts.Num() == 0)
+    {
+        PluginCounts = { 10, 50, 100, 250, 500 };
+    }
+
+    TArray<FCppToolsScaleMeasurement> Measurements;
+    if (!CppToolsScaleTest::RunScaleTest(Settings, PluginCounts, Measurements, OutFailReason)) return false;
+
+    TArray<TSharedPtr<FJsonValue>> MeasurementValues;
+    for (const FCppToolsScaleMeasurement& Measurement : Measurements)
+    {
+        TSharedRef<FJsonObject> MeasurementObject = MakeShareable(new FJsonObject);
+        MeasurementObject->SetStringField(TEXT("Stage"), Measurement.Stage);
+        MeasurementObject->SetNumberField(TEXT("Plugins"), Measurement.NumPlugins);
+        MeasurementObject->SetNumberField(TEXT("Modules"), Measurement.NumModules);
+        MeasurementObject->SetNumberField(TEXT("Samples"), Measurement.Samples);
+        MeasurementObject->SetNumberField(TEXT("MeanSeconds"), Measurement.GetMeanSeconds());
+        MeasurementObject->SetNumberField(TEXT("MaxSeconds"), Measurement.MaxSeconds);
+        MeasurementValues.Add(MakeShareable(new FJsonValueObject(MeasurementObject)));
+    }
+    OutResult.SetArrayField(TEXT("Measurements"), MeasurementValues);
+
+    const FString CsvFile = GetStringArgument(Arguments, TEXT("Csv"), CppToolsScaleTest::GetResultsDirectory()
+        / FString::Printf(TEXT("ScaleTest-%s.csv"), *FDateTime::Now().ToString()));
+    if (!CppToolsScaleTest::SaveMeasurements(Measurements, CsvFile))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("CsvFile"), FText::FromString(CsvFile));
+        OutFailReason = FText::Format(LOCTEXT("FailedToSaveMeasurements", "Failed to write the measurements to {CsvFile}"), Args);
+        return false;
+    }
+    OutResult.SetStringField(TEXT("Csv"), FPaths::ConvertRelativePathToFull(CsvFile));
+    return true;
+}
+
+FString UCppToolsCommandlet::GetStringArgument(const FJsonObject& Arguments, const FString& Name, const FString& Default)
+{
+    FString Value;
+    return Arguments.TryGetStringField(Name, Value) ? Value : Default;
+}
+
+TArray<FString> UCppToolsCommandlet::GetListArgument(const FJsonObject& Arguments, const FString& Name)
+{
+    TArray<FString> Values;
+    if (!Arguments.TryGetStringArrayField(Name, Values))
+    {
+        GetStringArgument(Arguments, Name).ParseIntoArray(Values, TEXT(","), true);
+    }
+    for (FString& Value : Values)
+    {
+        Value.TrimStartAndEndInline();
+    }
+    return Values;
+}
+
+bool UCppToolsCommandlet::GetBoolArgument(const FJsonObject& Arguments, const FString& Name, bool bDefault)
+{
+    bool bValue;
+    if (Arguments.TryGetBoolField(Name, bValue))
+    {
+        return bValue;
+    }
+    FString Value;
+    if (Arguments.TryGetStringField(Name, Value))
+    {
+        return Value.ToBool();
+    }
+    return bDefault;
+}
+
+double UCppToolsCommandlet::GetNumberArgument(const FJsonObject& Arguments, const FString& Name, double Default)
+{
+    double Value;
+    if (Arguments.TryGetNumberField(Name, Value))
+    {
+        return Value;
+    }
+    FString StringValue;
+    if (Arguments.TryGetStringField(Name, StringValue) && StringValue.IsNumeric())
+    {
+        return FCString::Atod(*StringValue);
+    }
+    return Default;
+}
+
+bool UCppToolsCommandlet::GetTargetArgument(const FJsonObject& Arguments, TSharedPtr<IPlugin>& OutTarget, FText& OutFailReason)
+{
+    const FString PluginName = GetStringArgument(Arguments, TEXT("Plugin"));
+    if (PluginName.IsEmpty())
+    {
+        OutTarget = nullptr;
+        return true;
+    }
+
+    OutTarget = CppToolsUtil::FindProjectPlugin(PluginName);
+    if (!OutTarget.IsValid())
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("PluginName"), FText::FromString(PluginName));
+        OutFailReason = FText::Format(LOCTEXT("PluginNotFound", "Could not find plugin \"{PluginName}\" in this project"), Args);
+        return false;
+    }
+    return true;
+}
+
+bool UCppToolsCommandlet::GetSyntheticProjectArguments(const FJsonObject& Arguments, FCppToolsSyntheticProjectSettings& OutSettings,
+    FText& OutFailReason)
+{
+    OutSettings.RootDir = FPaths::ConvertRelativePathToFull(GetStringArgument(Arguments, TEXT("Root"), CppToolsScaleTest::GetDefaultRootDir()));
+    if (!CppToolsScaleTest::IsValidRootDir(OutSettings.RootDir, OutFailReason)) return false;
+    OutSettings.ModulesPerPlugin = static_cast<int32>(GetNumberArgument(Arguments, TEXT("ModulesPerPlugin"), OutSettings.ModulesPerPlugin));
+    OutSettings.MaxDependencies = static_cast<int32>(GetNumberArgument(Arguments, TEXT("MaxDependencies"), OutSettings.MaxDependencies));
+    OutSettings.FilesPerModule = static_cast<int32>(GetNumberArgument(Arguments, TEXT("FilesPerModule"), OutSettings.FilesPerModule));
+    OutSettings.LinesPerFile = static_cast<int32>(GetNumberArgument(Arguments, TEXT("LinesPerFile"), OutSettings.LinesPerFile));
+    OutSettings.Seed = static_cast<int32>(GetNumberArgument(Arguments, TEXT("Seed"), OutSettings.Seed));
+
+    const FString ShapeName = GetStringArgument(Arguments, TEXT("Shape"), CppToolsScaleTest::GetDependencyShapeName(OutSettings.Shape));
+    if (!CppToolsScaleTest::ParseDependencyShape(ShapeName, OutSettings.Shape))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Shape"), FText::FromString(ShapeName));
+        OutFailReason = FText::Format(LOCTEXT("InvalidDependencyShape", "Invalid dependency shape \"{Shape}\", expected Chain, Tree or RandomDAG"), Args);
+        return false;
+    }
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,308 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsCompileHotSpots.h"
+
+#include "CppToolsUtil.h"
+
+#include "EditorStyleSet.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/Layout/SSplitter.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Views/SHeaderRow.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsCompileHotSpots"
+
+namespace CppToolsCompileHotSpotsImpl
+{
+    static const FName ModuleColumn(TEXT("Module"));
+    static const FName TranslationUnitsColumn(TEXT("TranslationUnits"));
+    static const FName TotalColumn(TEXT("Total"));
+    static const FName FrontendColumn(TEXT("Frontend"));
+    static const FName BackendColumn(TEXT("Backend"));
+    static const FName SlowestColumn(TEXT("Slowest"));
+
+    static const FName NameColumn(TEXT("Name"));
+    static const FName TimeColumn(TEXT("Time"));
+    static const FName CountColumn(TEXT("Count"));
+
+    static FText FormatMilliseconds(double Milliseconds)
+    {
+        FNumberFormattingOptions Options;
+        Options.SetMaximumFractionalDigits(1);
+        return FText::Format(LOCTEXT("Milliseconds", "{0} ms"), FText::AsNumber(Milliseconds, &Options));
+    }
+}
+
+/** A row of the module list, with one cell per column. */
+class SCppToolsModuleProfileRow : public SMultiColumnTableRow<TSharedPtr<FCppToolsModuleCompileProfile>>
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsModuleProfileRow) {}
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FCppToolsModuleCompileProfile> InModule)
+    {
+        Module = InModule;
+        SMultiColumnTableRow<TSharedPtr<FCppToolsModuleCompileProfile>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+    }
+
+    virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+    {
+        using namespace CppToolsCompileHotSpotsImpl;
+
+        FText Text;
+        if (ColumnName == ModuleColumn)
+        {
+            Text = FText::FromString(Module->ModuleName);
+        }
+        else if (ColumnName == TranslationUnitsColumn)
+        {
+            Text = FText::AsNumber(Module->NumTranslationUnits);
+        }
+        else if (ColumnName == TotalColumn)
+        {
+            Text = FormatMilliseconds(Module->TotalMilliseconds);
+        }
+        else if (ColumnName == FrontendColumn)
+        {
+            Text = FormatMilliseconds(Module->FrontendMilliseconds);
+        }
+        else if (ColumnName == BackendColumn)
+        {
+            Text = FormatMilliseconds(Module->BackendMilliseconds);
+        }
+        else if (ColumnName == SlowestColumn)
+        {
+            Text = FText::Format(LOCTEXT("SlowestTranslationUnit", "{0} ({1})"), FText::FromString(Module->SlowestTranslationUnit),
+                FormatMilliseconds(Module->SlowestTranslationUnitMilliseconds));
+        }
+
+        return SNew(STextBlock).Text(Text);
+    }
+
+private:
+
+    TSharedPtr<FCppToolsModuleCompileProfile> Module;
+
+};
+
+/** A row of the header or template list, with one cell per column. */
+class SCppToolsTimeTraceEntryRow : public SMultiColumnTableRow<TSharedPtr<FCppToolsTimeTraceEntry>>
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsTimeTraceEntryRow) {}
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FCppToolsTimeTraceEntry> InEntry)
+    {
+        Entry = InEntry;
+        SMultiColumnTableRow<TSharedPtr<FCppToolsTimeTraceEntry>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+    }
+
+    virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+    {
+        using namespace CppToolsCompileHotSpotsImpl;
+
+        FText Text;
+        if (ColumnName == NameColumn)
+        {
+            Text = FText::FromString(Entry->Name);
+        }
+        else if (ColumnName == TimeColumn)
+        {
+            Text = FormatMilliseconds(Entry->Milliseconds);
+        }
+        else if (ColumnName == CountColumn)
+        {
+            Text = FText::AsNumber(Entry->Count);
+        }
+
+        return SNew(STextBlock)
+            .Text(Text)
+            .ToolTipText(FText::FromString(Entry->Name));
+    }
+
+private:
+
+    TSharedPtr<FCppToolsTimeTraceEntry> Entry;
+
+};
+
+void SCppToolsCompileHotSpots::Construct(const FArguments& InArgs)
+{
+    using namespace CppToolsCompileHotSpotsImpl;
+
+    MaxEntries = InArgs._MaxEntries;
+
+    auto MakeEntryHeaderRow = [](const FText& NameLabel)
+    {
+        return SNew(SHeaderRow)
+            + SHeaderRow::Column(NameColumn).DefaultLabel(NameLabel).FillWidth(4.0f)
+            + SHeaderRow::Column(TimeColumn).DefaultLabel(LOCTEXT("TimeColumn", "Time")).FillWidth(1.0f)
+            + SHeaderRow::Column(CountColumn).DefaultLabel(LOCTEXT("CountColumn", "Count")).FillWidth(0.6f);
+    };
+
+    ChildSlot
+    [
+        SNew(SBorder)
+        .Padding(8)
+        .BorderImage(FEditorStyle::GetBrush("Docking.Tab.ContentAreaBrush"))
+        [
+            SNew(SVerticalBox)
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 8)
+            [
+                SNew(SHorizontalBox)
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.0f)
+                .VAlign(VAlign_Center)
+                [
+                    SNew(STextBlock)
+                    .Text(LOCTEXT("HotSpotsDescription", "Compile times from the clang -ftime-trace files of the last traced build. Select a module to see its most expensive headers and templates."))
+                    .AutoWrapText(true)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("Build", "Build With Time Trace"))
+                    .ToolTipText(LOCTEXT("BuildTooltip", "Rebuilds the current target with -ftime-trace, which only clang supports"))
+                    .OnClicked(this, &SCppToolsCompileHotSpots::BuildClicked)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("Refresh", "Refresh"))
+                    .OnClicked(this, &SCppToolsCompileHotSpots::RefreshClicked)
+                ]
+            ]
+
+            + SVerticalBox::Slot()
+            .FillHeight(1.0f)
+            [
+                SNew(SSplitter)
+                .Orientation(Orient_Vertical)
+
+                + SSplitter::Slot()
+                [
+                    SAssignNew(ModuleList, SListView<TSharedPtr<FCppToolsModuleCompileProfile>>)
+                    .ListItemsSource(&Modules)
+                    .SelectionMode(ESelectionMode::Single)
+                    .OnGenerateRow(this, &SCppToolsCompileHotSpots::MakeModuleRow)
+                    .OnSelectionChanged(this, &SCppToolsCompileHotSpots::OnModuleSelected)
+                    .HeaderRow
+                    (
+                        SNew(SHeaderRow)
+                        + SHeaderRow::Column(ModuleColumn).DefaultLabel(LOCTEXT("ModuleColumn", "Module")).FillWidth(1.5f)
+                        + SHeaderRow::Column(TranslationUnitsColumn).DefaultLabel(LOCTEXT("TranslationUnitsColumn", "Translation Units")).FillWidth(0.8f)
+                        + SHeaderRow::Column(TotalColumn).DefaultLabel(LOCTEXT("TotalColumn", "Total")).FillWidth(1.0f)
+                        + SHeaderRow::Column(FrontendColumn).DefaultLabel(LOCTEXT("FrontendColumn", "Frontend")).FillWidth(1.0f)
+                        + SHeaderRow::Column(BackendColumn).DefaultLabel(LOCTEXT("BackendColumn", "Backend")).FillWidth(1.0f)
+                        + SHeaderRow::Column(SlowestColumn).DefaultLabel(LOCTEXT("SlowestColumn", "Slowest Translation Unit")).FillWidth(2.0f)
+                    )
+                ]
+
+                + SSplitter::Slot()
+                [
+                    SNew(SSplitter)
+                    .Orientation(Orient_Horizontal)
+
+                    + SSplitter::Slot()
+                    [
+                        SAssignNew(HeaderList, SListView<TSharedPtr<FCppToolsTimeTraceEntry>>)
+                        .ListItemsSource(&Headers)
+                        .OnGenerateRow(this, &SCppToolsCompileHotSpots::MakeEntryRow)
+                        .HeaderRow(MakeEntryHeaderRow(LOCTEXT("HeaderColumn", "Header")))
+                    ]
+
+                    + SSplitter::Slot()
+                    [
+                        SAssignNew(TemplateList, SListView<TSharedPtr<FCppToolsTimeTraceEntry>>)
+                        .ListItemsSource(&Templates)
+                        .OnGenerateRow(this, &SCppToolsCompileHotSpots::MakeEntryRow)
+                        .HeaderRow(MakeEntryHeaderRow(LOCTEXT("TemplateColumn", "Template Instantiation")))
+                    ]
+                ]
+            ]
+        ]
+    ];
+
+    Refresh();
+}
+
+void SCppToolsCompileHotSpots::Refresh()
+{
+    Modules.Reset();
+    for (FCppToolsModuleCompileProfile& Profile : CppToolsTimeTrace::IngestTraces(MaxEntries))
+    {
+        Modules.Add(MakeShareable(new FCppToolsModuleCompileProfile(MoveTemp(Profile))));
+    }
+
+    Headers.Reset();
+    Templates.Reset();
+    ModuleList->RequestListRefresh();
+    HeaderList->RequestListRefresh();
+    TemplateList->RequestListRefresh();
+}
+
+FReply SCppToolsCompileHotSpots::RefreshClicked()
+{
+    Refresh();
+    return FReply::Handled();
+}
+
+FReply SCppToolsCompileHotSpots::BuildClicked()
+{
+    double BuildSeconds;
+    FText FailReason;
+    if (!CppToolsTimeTrace::BuildWithTimeTrace(BuildSeconds, FailReason))
+    {
+        CppToolsUtil::PushNotification(FailReason, SNotificationItem::CS_Fail);
+    }
+    Refresh();
+    return FReply::Handled();
+}
+
+void SCppToolsCompileHotSpots::OnModuleSelected(TSharedPtr<FCppToolsModuleCompileProfile> Module, ESelectInfo::Type SelectInfo)
+{
+    Headers.Reset();
+    Templates.Reset();
+    if (Module.IsValid())
+    {
+        for (const FCppToolsTimeTraceEntry& Header : Module->Headers)
+        {
+            Headers.Add(MakeShareable(new FCppToolsTimeTraceEntry(Header)));
+        }
+        for (const FCppToolsTimeTraceEntry& Template : Module->Templates)
+        {
+            Templates.Add(MakeShareable(new FCppToolsTimeTraceEntry(Template)));
+        }
+    }
+    HeaderList->RequestListRefresh();
+    TemplateList->RequestListRefresh();
+}
+
+TSharedRef<ITableRow> SCppToolsCompileHotSpots::MakeModuleRow(TSharedPtr<FCppToolsModuleCompileProfile> Module, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(SCppToolsModuleProfileRow, OwnerTable, Module);
+}
+
+TSharedRef<ITableRow> SCppToolsCompileHotSpots::MakeEntryRow(TSharedPtr<FCppToolsTimeTraceEntry> Entry, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(SCppToolsTimeTraceEntryRow, OwnerTable, Entry);
+}
+
+#undef LOCTEXT_NAMESPACE
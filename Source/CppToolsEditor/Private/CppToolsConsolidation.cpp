@@ -0,0 +1,523 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsConsolidation.h"
+
+#include "CppToolsDescriptorSession.h"
+#include "CppToolsFileTransaction.h"
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Internationalization/Regex.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsConsolidation"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsConsolidation, Log, All);
+
+namespace CppToolsConsolidationImpl
+{
+    /** The extensions of the files a merge moves, which are the only files a module directory should hold besides its .Build.cs. */
+    static const TCHAR* SourceExtensions[] = { TEXT("h"), TEXT("hpp"), TEXT("inl"), TEXT("cpp"), TEXT("c"), TEXT("cc") };
+
+    /** Checks the sources of a module for startup code, which cannot be merged, and for reflected types, which need redirects. */
+    static void ScanModuleSources(const FString& ModulePath, bool& bOutStartupCode, bool& bOutReflectedTypes)
+    {
+        bOutStartupCode = false;
+        bOutReflectedTypes = false;
+
+        const FRegexPattern StartupPattern(TEXT("::(?:StartupModule|ShutdownModule)\\s*\\(\\s*\\)\\s*(?:override\\s*)?\\{([^\\}]*)\\}"));
+        const FRegexPattern ReflectedTypePattern(TEXT("\\b(?:UCLASS|USTRUCT|UENUM|UINTERFACE)\\s*\\("));
+        TArray<FString> Files;
+        IFileManager::Get().FindFilesRecursive(Files, *ModulePath, TEXT("*.h"), true, false, false);
+        IFileManager::Get().FindFilesRecursive(Files, *ModulePath, TEXT("*.cpp"), true, false, false);
+        for (const FString& File : Files)
+        {
+            FString Contents;
+            if (!CppToolsUtil::LoadFileToString(Contents, File)) continue;
+            Contents = CppToolsUtil::StripCStyleComments(Contents);
+
+            FRegexMatcher StartupMatcher(StartupPattern, Contents);
+            while (StartupMatcher.FindNext())
+            {
+                bOutStartupCode |= !StartupMatcher.GetCaptureGroup(1).TrimStartAndEnd().IsEmpty();
+            }
+            FRegexMatcher ReflectedTypeMatcher(ReflectedTypePattern, Contents);
+            bOutReflectedTypes |= ReflectedTypeMatcher.FindNext();
+        }
+    }
+
+    /** Checks if any of the modules can be reached from the dependencies of a module that is not one of them. */
+    static bool ReachesAny(const TMap<FString, FCppToolsModuleNode>& Modules, const FString& Start, const TSet<FString>& Targets)
+    {
+        TSet<FString> Reached;
+        TArray<FString> Pending = { Start };
+        while (Pending.Num() > 0)
+        {
+            const FString ModuleName = Pending.Pop(false);
+            if (Targets.Contains(ModuleName)) return true;
+
+            bool bAlreadyReached;
+            Reached.Add(ModuleName, &bAlreadyReached);
+            if (bAlreadyReached) continue;
+
+            if (const FCppToolsModuleNode* Module = Modules.Find(ModuleName))
+            {
+                Pending.Append(Module->Dependencies);
+            }
+        }
+        return false;
+    }
+
+    /** Replaces every match of a pattern in the contents. Returns true if the contents changed. */
+    static bool ReplaceMatches(FString& Contents, const FRegexPattern& Pattern, const FString& Replacement)
+    {
+        TArray<TPair<int32, int32>> Matches;
+        FRegexMatcher Matcher(Pattern, Contents);
+        while (Matcher.FindNext())
+        {
+            Matches.Emplace(Matcher.GetMatchBeginning(), Matcher.GetMatchEnding());
+        }
+        for (int32 I = Matches.Num() - 1; I >= 0; I--)
+        {
+            Contents = Contents.Left(Matches[I].Key) + Replacement + Contents.Mid(Matches[I].Value);
+        }
+        return Matches.Num() > 0;
+    }
+
+    /** Adds package redirects to the [CoreRedirects] section of the contents of an .ini file, adding the section if it is missing. */
+    static void AddPackageRedirects(FString& Contents, const TArray<FString>& Redirects)
+    {
+        FString Lines;
+        for (const FString& Redirect : Redirects)
+        {
+            Lines += Redirect + LINE_TERMINATOR;
+        }
+
+        const int32 SectionIndex = Contents.Find(TEXT("[CoreRedirects]"), ESearchCase::CaseSensitive);
+        if (SectionIndex == INDEX_NONE)
+        {
+            if (!Contents.IsEmpty() && !Contents.EndsWith(TEXT("\n")))
+            {
+                Contents += LINE_TERMINATOR;
+            }
+            Contents += FString(LINE_TERMINATOR) + TEXT("[CoreRedirects]") + LINE_TERMINATOR + Lines;
+            return;
+        }
+
+        const int32 LineEnd = Contents.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, SectionIndex);
+        if (LineEnd == INDEX_NONE)
+        {
+            Contents += LINE_TERMINATOR + Lines;
+        }
+        else
+        {
+            Contents.InsertAt(LineEnd + 1, Lines);
+        }
+    }
+}
+
+FCppToolsConsolidationReport CppToolsConsolidation::Analyze(const FCppToolsConsolidationSettings& Settings)
+{
+    CPPTOOLS_TRACE_SCOPE(AnalyzeConsolidation);
+    using namespace CppToolsConsolidationImpl;
+
+    FCppToolsConsolidationReport Report;
+    Report.Modules = CppToolsModuleGraph::BuildGraph();
+    const TMap<FString, FModuleDescriptor> Descriptors = CppToolsModuleGraph::GetModuleDescriptors(Report.Modules);
+
+    TArray<FString> ModuleNames;
+    Report.Modules.GetKeys(ModuleNames);
+    ModuleNames.Sort();
+
+    // The shared objects are read in parallel, as a project with many modules has as many binaries
+    TArray<FCppToolsModuleLoadCost> Costs;
+    TArray<TArray<FCppToolsElfSymbol>> Symbols;
+    TArray<bool> StartupCode;
+    TArray<bool> Measured;
+    Costs.SetNum(ModuleNames.Num());
+    Symbols.SetNum(ModuleNames.Num());
+    StartupCode.SetNum(ModuleNames.Num());
+    Measured.SetNum(ModuleNames.Num());
+    ParallelFor(ModuleNames.Num(), [&](int32 Index)
+    {
+        const FCppToolsModuleNode& Module = Report.Modules[ModuleNames[Index]];
+        FCppToolsModuleLoadCost& Cost = Costs[Index];
+        Cost.ModuleName = Module.Name;
+        Cost.Binary = CppToolsExportAudit::FindModuleBinary(Module.Name, Module.Plugin, Settings.Platform);
+        Measured[Index] = false;
+
+        bool bReflectedTypes;
+        ScanModuleSources(Module.Path, StartupCode[Index], bReflectedTypes);
+        if (Cost.Binary.IsEmpty()) return;
+
+        FText FailReason;
+        if (!CppToolsExportAudit::ReadLoadInfo(Cost.Binary, Cost.LoadInfo, FailReason) || !CppToolsExportAudit::ReadDynamicSymbols(Cost.Binary, Symbols[Index], FailReason))
+        {
+            UE_LOG(LogCppToolsConsolidation, Warning, TEXT("%s"), *FailReason.ToString());
+            return;
+        }
+        for (const FCppToolsElfSymbol& Symbol : Symbols[Index])
+        {
+            (Symbol.bDefined ? Cost.NumExports : Cost.NumImports)++;
+        }
+        Cost.EstimatedMilliseconds = Settings.MillisecondsPerModule + Cost.LoadInfo.NumRelocations * Settings.MicrosecondsPerRelocation / 1000.0
+            + Cost.NumImports * Settings.MicrosecondsPerImport / 1000.0;
+        Measured[Index] = true;
+    });
+
+    TMap<FString, int32> ModuleIndices;
+    TMap<FString, int32> DefiningModules;
+    for (int32 Index = 0; Index < ModuleNames.Num(); Index++)
+    {
+        ModuleIndices.Add(ModuleNames[Index], Index);
+        if (!Measured[Index]) continue;
+
+        Report.LoadCosts.Add(Costs[Index]);
+        Report.TotalMilliseconds += Costs[Index].EstimatedMilliseconds;
+        for (const FCppToolsElfSymbol& Symbol : Symbols[Index])
+        {
+            if (Symbol.bDefined)
+            {
+                DefiningModules.Add(Symbol.Name, Index);
+            }
+        }
+    }
+    Report.LoadCosts.Sort([](const FCppToolsModuleLoadCost& A, const FCppToolsModuleLoadCost& B) { return A.EstimatedMilliseconds > B.EstimatedMilliseconds; });
+
+    // Modules can only be merged with modules they would load alongside anyway, so they are grouped by everything that decides that
+    TMap<FString, TArray<FString>> Groups;
+    for (int32 Index = 0; Index < ModuleNames.Num(); Index++)
+    {
+        const FCppToolsModuleNode& Module = Report.Modules[ModuleNames[Index]];
+        const FModuleDescriptor* Descriptor = Descriptors.Find(Module.Name);
+        if (!Measured[Index] || StartupCode[Index] || Descriptor == nullptr) continue;
+        if (Costs[Index].LoadInfo.CodeBytes > Settings.MaxCodeBytes) continue;
+        if (!Module.RootReason.IsEmpty() && Module.RootReason.StartsWith(TEXT("Primary"))) continue;
+
+        const FString GroupKey = FString::Printf(TEXT("%s|%s|%s|%s|%s"), Module.Plugin.IsValid() ? *Module.Plugin->GetName() : TEXT(""),
+            EHostType::ToString(Module.Type), ELoadingPhase::ToString(Descriptor->LoadingPhase),
+            *FString::Join(Descriptor->WhitelistPlatforms, TEXT(",")), *FString::Join(Descriptor->BlacklistPlatforms, TEXT(",")));
+        Groups.FindOrAdd(GroupKey).Add(Module.Name);
+    }
+
+    for (const TPair<FString, TArray<FString>>& Group : Groups)
+    {
+        // Modules are tightly coupled if one includes the other's headers through a dependency
+        TSet<FString> Unvisited(Group.Value);
+        for (const FString& Start : Group.Value)
+        {
+            if (!Unvisited.Contains(Start)) continue;
+
+            TArray<FString> Component;
+            TArray<FString> Pending = { Start };
+            Unvisited.Remove(Start);
+            while (Pending.Num() > 0)
+            {
+                const FString ModuleName = Pending.Pop(false);
+                Component.Add(ModuleName);
+                for (const FString& Other : Group.Value)
+                {
+                    if (!Unvisited.Contains(Other)) continue;
+
+                    const FCppToolsModuleNode& Module = Report.Modules[ModuleName];
+                    const FCppToolsModuleNode& OtherModule = Report.Modules[Other];
+                    const bool bUses = Module.Dependencies.Contains(Other) && !Module.UnusedDependencies.Contains(Other);
+                    const bool bUsedBy = OtherModule.Dependencies.Contains(ModuleName) && !OtherModule.UnusedDependencies.Contains(ModuleName);
+                    if (bUses || bUsedBy)
+                    {
+                        Unvisited.Remove(Other);
+                        Pending.Add(Other);
+                    }
+                }
+            }
+            if (Component.Num() < 2) continue;
+
+            // A module outside the cluster that depends on one of its modules and is depended on by another would form a cycle
+            const TSet<FString> Members(Component);
+            bool bCycle = false;
+            for (const FString& Member : Component)
+            {
+                for (const FString& Dependency : Report.Modules[Member].Dependencies)
+                {
+                    if (!Members.Contains(Dependency) && ReachesAny(Report.Modules, Dependency, Members))
+                    {
+                        bCycle = true;
+                    }
+                }
+            }
+            if (bCycle)
+            {
+                UE_LOG(LogCppToolsConsolidation, Log, TEXT("Not merging %s, as it would form a dependency cycle"), *FString::Join(Component, TEXT(", ")));
+                continue;
+            }
+
+            FCppToolsModuleCluster& Cluster = Report.Clusters.AddDefaulted_GetRef();
+            Component.Sort();
+            Cluster.Modules = Component;
+            const FCppToolsModuleNode& First = Report.Modules[Component[0]];
+            Cluster.Plugin = First.Plugin;
+            Cluster.Type = First.Type;
+            Cluster.LoadingPhase = Descriptors[Component[0]].LoadingPhase;
+
+            int32 MostDependents = -1;
+            int64 TargetCodeBytes = -1;
+            for (const FString& Member : Component)
+            {
+                const int32 Index = ModuleIndices[Member];
+                Cluster.CodeBytes += Costs[Index].LoadInfo.CodeBytes;
+
+                int32 Dependents = 0;
+                for (const FString& Other : Component)
+                {
+                    Dependents += Report.Modules[Other].Dependencies.Contains(Member) ? 1 : 0;
+                }
+                if (Dependents > MostDependents || (Dependents == MostDependents && Costs[Index].LoadInfo.CodeBytes > TargetCodeBytes))
+                {
+                    Cluster.TargetModule = Member;
+                    MostDependents = Dependents;
+                    TargetCodeBytes = Costs[Index].LoadInfo.CodeBytes;
+                }
+
+                for (const FCppToolsElfSymbol& Symbol : Symbols[Index])
+                {
+                    const int32* DefiningModule = Symbol.bDefined ? nullptr : DefiningModules.Find(Symbol.Name);
+                    if (DefiningModule != nullptr && Members.Contains(ModuleNames[*DefiningModule]))
+                    {
+                        Cluster.NumInternalImports++;
+                    }
+                }
+            }
+
+            Cluster.EstimatedSavingsMilliseconds = (Component.Num() - 1) * Settings.MillisecondsPerModule
+                + Cluster.NumInternalImports * (Settings.MicrosecondsPerImport + Settings.MicrosecondsPerRelocation) / 1000.0;
+        }
+    }
+    Report.Clusters.Sort([](const FCppToolsModuleCluster& A, const FCppToolsModuleCluster& B) { return A.EstimatedSavingsMilliseconds > B.EstimatedSavingsMilliseconds; });
+
+    double SavingsMilliseconds = 0.0;
+    for (const FCppToolsModuleCluster& Cluster : Report.Clusters)
+    {
+        SavingsMilliseconds += Cluster.EstimatedSavingsMilliseconds;
+    }
+    UE_LOG(LogCppToolsConsolidation, Log, TEXT("Loading %d modules costs an estimated %.1f ms, and merging %d clusters would save an estimated %.1f ms"),
+        Report.LoadCosts.Num(), Report.TotalMilliseconds, Report.Clusters.Num(), SavingsMilliseconds);
+    return Report;
+}
+
+const FCppToolsModuleCluster* CppToolsConsolidation::FindCluster(const FCppToolsConsolidationReport& Report, const FString& ModuleName)
+{
+    return Report.Clusters.FindByPredicate([&ModuleName](const FCppToolsModuleCluster& Cluster) { return Cluster.Modules.Contains(ModuleName); });
+}
+
+bool CppToolsConsolidation::MergeCluster(const FCppToolsConsolidationReport& Report, const FCppToolsModuleCluster& Cluster, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(MergeModuleCluster);
+    using namespace CppToolsConsolidationImpl;
+
+    const FCppToolsModuleNode& Target = Report.Modules[Cluster.TargetModule];
+    const FString TargetAPIMacro = CppToolsUtil::GetModuleAPIMacro(Target.Name, false).TrimEnd();
+    TArray<FString> MergedModules = Cluster.Modules;
+    MergedModules.Remove(Target.Name);
+
+    FString TargetBuildFile;
+    if (!CppToolsUtil::GetModuleBuildFilePath(Target.Name, Target.Plugin, TargetBuildFile))
+    {
+        OutFailReason = FText::Format(LOCTEXT("NoTargetBuildFile", "Failed to find the .Build.cs file of {0}"), FText::FromString(Target.Name));
+        return false;
+    }
+
+    FCppToolsFileTransaction Transaction;
+    TArray<FString> PublicDependencies;
+    TArray<FString> PrivateDependencies;
+    TArray<FString> Redirects;
+    for (const FString& ModuleName : MergedModules)
+    {
+        const FCppToolsModuleNode& Module = Report.Modules[ModuleName];
+        FString BuildFile;
+        FString BuildFileContents;
+        if (!CppToolsUtil::GetModuleBuildFilePath(ModuleName, Module.Plugin, BuildFile) || !CppToolsUtil::LoadFileToString(BuildFileContents, BuildFile))
+        {
+            OutFailReason = FText::Format(LOCTEXT("NoMergedBuildFile", "Failed to read the .Build.cs file of {0}"), FText::FromString(ModuleName));
+            return false;
+        }
+
+        const TArray<FString> ModulePublicDependencies = CppToolsUtil::ParseModuleDependencies(BuildFileContents, false);
+        for (const FString& Dependency : CppToolsUtil::ParseModuleDependencies(BuildFileContents, true))
+        {
+            if (Cluster.Modules.Contains(Dependency)) continue;
+            (ModulePublicDependencies.Contains(Dependency) ? PublicDependencies : PrivateDependencies).AddUnique(Dependency);
+        }
+        if (!Transaction.StageDelete(BuildFile, OutFailReason)) return false;
+
+        bool bStartupCode;
+        bool bReflectedTypes;
+        ScanModuleSources(Module.Path, bStartupCode, bReflectedTypes);
+        if (bStartupCode)
+        {
+            OutFailReason = FText::Format(LOCTEXT("MergedStartupCode", "{0} has startup code, which has to be moved into {1} by hand"),
+                FText::FromString(ModuleName), FText::FromString(Target.Name));
+            return false;
+        }
+        if (bReflectedTypes)
+        {
+            Redirects.Add(FString::Printf(TEXT("+PackageRedirects=(OldName=\"/Script/%s\",NewName=\"/Script/%s\")"), *ModuleName, *Target.Name));
+        }
+
+        // The sources keep their paths relative to the module directory, so includes through the public directories still resolve
+        const FRegexPattern APIMacroPattern(FString::Printf(TEXT("\\b%s\\b"), *CppToolsUtil::GetModuleAPIMacro(ModuleName, false).TrimEnd()));
+        const FRegexPattern ImplementModulePattern(FString::Printf(TEXT("IMPLEMENT_(?:GAME_)?MODULE\\s*\\(\\s*[\\w:]+\\s*,\\s*%s\\s*\\)\\s*;?"), *ModuleName));
+        TArray<FString> Files;
+        IFileManager::Get().FindFilesRecursive(Files, *Module.Path, TEXT("*"), true, false, false);
+        for (const FString& File : Files)
+        {
+            if (FPaths::IsSamePath(File, BuildFile)) continue;
+
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("FullFileName"), FText::FromString(File));
+            const FString Extension = FPaths::GetExtension(File);
+            bool bSource = false;
+            for (const TCHAR* SourceExtension : SourceExtensions)
+            {
+                bSource |= Extension == SourceExtension;
+            }
+            if (!bSource)
+            {
+                OutFailReason = FText::Format(LOCTEXT("NotASourceFile", "Failed to move \"{FullFileName}\", only source files can be merged"), Args);
+                return false;
+            }
+
+            FString Contents;
+            if (!CppToolsUtil::LoadFileToString(Contents, File))
+            {
+                OutFailReason = FText::Format(LOCTEXT("FailedToReadMergedFile", "Failed to read \"{FullFileName}\""), Args);
+                return false;
+            }
+            ReplaceMatches(Contents, APIMacroPattern, TargetAPIMacro);
+            ReplaceMatches(Contents, ImplementModulePattern, FString());
+
+            FString RelativePath = File;
+            FPaths::MakePathRelativeTo(RelativePath, *(Module.Path / TEXT("")));
+            if (!Transaction.StageCreate(Target.Path / RelativePath, Contents, OutFailReason) || !Transaction.StageDelete(File, OutFailReason)) return false;
+        }
+    }
+
+    if (!Transaction.StageModify(TargetBuildFile, [&](FString& Contents)
+        {
+            bool bChanged = false;
+            for (const FString& ModuleName : MergedModules)
+            {
+                bChanged |= CppToolsUtil::RemoveDependencyFromBuildFile(Contents, ModuleName);
+            }
+            const TArray<FString> Existing = CppToolsUtil::ParseModuleDependencies(Contents, true);
+            for (const FString& Dependency : PublicDependencies)
+            {
+                bChanged |= !Existing.Contains(Dependency) && CppToolsUtil::InsertDependencyIntoBuildFile(Contents, Dependency, false);
+            }
+            for (const FString& Dependency : PrivateDependencies)
+            {
+                bChanged |= !Existing.Contains(Dependency) && !PublicDependencies.Contains(Dependency)
+                    && CppToolsUtil::InsertDependencyIntoBuildFile(Contents, Dependency, true);
+            }
+            return bChanged;
+        }, OutFailReason))
+    {
+        return false;
+    }
+
+    // Modules depending on a merged module depend on the target module instead, in the same list
+    for (const TPair<FString, FCppToolsModuleNode>& Module : Report.Modules)
+    {
+        if (Cluster.Modules.Contains(Module.Key)) continue;
+        if (!MergedModules.ContainsByPredicate([&Module](const FString& ModuleName) { return Module.Value.Dependencies.Contains(ModuleName); })) continue;
+
+        FString BuildFile;
+        if (!CppToolsUtil::GetModuleBuildFilePath(Module.Key, Module.Value.Plugin, BuildFile)) continue;
+        if (!Transaction.StageModify(BuildFile, [&](FString& Contents)
+            {
+                bool bChanged = false;
+                for (const FString& ModuleName : MergedModules)
+                {
+                    const bool bPublic = CppToolsUtil::ParseModuleDependencies(Contents, false).Contains(ModuleName);
+                    if (!CppToolsUtil::RemoveDependencyFromBuildFile(Contents, ModuleName)) continue;
+
+                    bChanged = true;
+                    if (!CppToolsUtil::ParseModuleDependencies(Contents, true).Contains(Target.Name))
+                    {
+                        CppToolsUtil::InsertDependencyIntoBuildFile(Contents, Target.Name, !bPublic);
+                    }
+                }
+                return bChanged;
+            }, OutFailReason))
+        {
+            return false;
+        }
+    }
+
+    for (const FString& TargetFile : CppToolsUtil::GetProjectTargetFiles())
+    {
+        if (!Transaction.StageModify(TargetFile, [&](FString& Contents)
+            {
+                bool bRemoved = false;
+                for (const FString& ModuleName : MergedModules)
+                {
+                    bRemoved |= CppToolsUtil::RemoveModuleFromTargetFile(Contents, ModuleName);
+                }
+                if (bRemoved && !CppToolsUtil::ParseTargetExtraModules(Contents).Contains(Target.Name))
+                {
+                    CppToolsUtil::InsertModuleIntoTargetFile(Contents, Target.Name);
+                }
+                return bRemoved;
+            }, OutFailReason))
+        {
+            return false;
+        }
+    }
+
+    // Assets referencing the reflected types of the merged modules find them in the target module's script package
+    if (Redirects.Num() > 0)
+    {
+        const FString EngineConfig = FPaths::ConvertRelativePathToFull(FPaths::ProjectConfigDir() / TEXT("DefaultEngine.ini"));
+        FString NewConfig;
+        AddPackageRedirects(NewConfig, Redirects);
+        if (FPaths::FileExists(EngineConfig)
+            ? !Transaction.StageModify(EngineConfig, [&Redirects](FString& Contents) { AddPackageRedirects(Contents, Redirects); return true; }, OutFailReason)
+            : !Transaction.StageCreate(EngineConfig, NewConfig.TrimStart(), OutFailReason))
+        {
+            return false;
+        }
+    }
+
+    if (!Transaction.Commit(OutFailReason)) return false;
+
+    // The descriptors are saved by the engine, so they are backed up in the transaction's journal to be rolled back with the files
+    FCppToolsDescriptorSession Session;
+    if (!Session.RemoveModules(MergedModules, OutFailReason) || !Session.Commit(OutFailReason, &Transaction))
+    {
+        FText RollbackFailReason;
+        if (!Transaction.Rollback(RollbackFailReason))
+        {
+            UE_LOG(LogCppToolsConsolidation, Error, TEXT("%s"), *RollbackFailReason.ToString());
+        }
+        return false;
+    }
+    Transaction.Finish();
+
+    for (const FString& ModuleName : MergedModules)
+    {
+        // Only the directories the merge emptied are deleted
+        const FString& ModulePath = Report.Modules[ModuleName].Path;
+        TArray<FString> RemainingFiles;
+        IFileManager::Get().FindFilesRecursive(RemainingFiles, *ModulePath, TEXT("*"), true, false, false);
+        if (RemainingFiles.Num() == 0)
+        {
+            IFileManager::Get().DeleteDirectory(*ModulePath, false, true);
+        }
+    }
+
+    UE_LOG(LogCppToolsConsolidation, Log, TEXT("Merged %s into %s"), *FString::Join(MergedModules, TEXT(", ")), *Target.Name);
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
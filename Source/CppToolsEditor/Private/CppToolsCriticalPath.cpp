@@ -0,0 +1,326 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsCriticalPath.h"
+
+#include "CppToolsBuild.h"
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsCriticalPath"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsCriticalPath, Log, All);
+
+namespace CppToolsCriticalPathImpl
+{
+    /** Gets the dependencies of each task that come before it in the order, which are the ones the build waits for. */
+    static TMap<FString, TArray<FString>> GetOrderedDependencies(const TMap<FString, FCppToolsModuleBuildTask>& Tasks, const TArray<FString>& Order)
+    {
+        TMap<FString, int32> Positions;
+        for (int32 I = 0; I < Order.Num(); I++)
+        {
+            Positions.Add(Order[I], I);
+        }
+
+        TMap<FString, TArray<FString>> Result;
+        for (int32 I = 0; I < Order.Num(); I++)
+        {
+            TArray<FString>& Dependencies = Result.Add(Order[I]);
+            for (const FString& Dependency : Tasks[Order[I]].Dependencies)
+            {
+                const int32* Position = Positions.Find(Dependency);
+                if (Position != nullptr && *Position < I)
+                {
+                    Dependencies.Add(Dependency);
+                }
+            }
+        }
+        return Result;
+    }
+
+    /** Replaces a task with the specified number of equal parts, which every task depending on it then depends on. */
+    static TMap<FString, FCppToolsModuleBuildTask> SplitTask(const TMap<FString, FCppToolsModuleBuildTask>& Tasks, const FString& Name, int32 Parts)
+    {
+        TMap<FString, FCppToolsModuleBuildTask> Result = Tasks;
+        const FCppToolsModuleBuildTask Original = Result.FindAndRemoveChecked(Name);
+
+        TArray<FString> PartNames;
+        for (int32 I = 0; I < Parts; I++)
+        {
+            FCppToolsModuleBuildTask Part = Original;
+            Part.Name = FString::Printf(TEXT("%s_Part%d"), *Name, I + 1);
+            Part.Seconds = Original.Seconds / Parts;
+            PartNames.Add(Part.Name);
+            Result.Add(Part.Name, MoveTemp(Part));
+        }
+
+        for (TPair<FString, FCppToolsModuleBuildTask>& Task : Result)
+        {
+            if (Task.Value.Dependencies.Remove(Name) > 0)
+            {
+                Task.Value.Dependencies.Append(PartNames);
+            }
+        }
+        return Result;
+    }
+}
+
+TMap<FString, FCppToolsModuleBuildTask> CppToolsCriticalPath::ReadBuildTasks(double SecondsPerKilobyte)
+{
+    CPPTOOLS_TRACE_SCOPE(ReadBuildTasks);
+
+    const TArray<TPair<FModuleContextInfo, TSharedPtr<IPlugin>>> Modules = CppToolsUtil::GetProjectAndPluginModules();
+
+    TSet<FString> ModuleNames;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : Modules)
+    {
+        ModuleNames.Add(Module.Key.ModuleName);
+    }
+
+    TMap<FString, FCppToolsModuleBuildTask> Tasks;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : Modules)
+    {
+        FCppToolsModuleBuildTask& Task = Tasks.Add(Module.Key.ModuleName);
+        Task.Name = Module.Key.ModuleName;
+        Task.Path = Module.Key.ModuleSourcePath;
+
+        // Engine modules are already built, so only the project's own modules hold up the build
+        for (const FString& Dependency : CppToolsUtil::GetModuleDependencies(Task.Name, Module.Value, true))
+        {
+            if (ModuleNames.Contains(Dependency) && Dependency != Task.Name)
+            {
+                Task.Dependencies.AddUnique(Dependency);
+            }
+        }
+
+        TArray<FString> SourceFiles;
+        IFileManager::Get().FindFilesRecursive(SourceFiles, *Task.Path, TEXT("*.cpp"), true, false, false);
+        IFileManager::Get().FindFilesRecursive(SourceFiles, *Task.Path, TEXT("*.h"), true, false, false);
+        int64 SourceBytes = 0;
+        for (const FString& SourceFile : SourceFiles)
+        {
+            SourceBytes += FMath::Max<int64>(0, IFileManager::Get().FileSize(*SourceFile));
+        }
+        Task.Seconds = SourceBytes / 1024.0 * SecondsPerKilobyte;
+    }
+    return Tasks;
+}
+
+bool CppToolsCriticalPath::MeasureBuildTasks(TMap<FString, FCppToolsModuleBuildTask>& Tasks, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(MeasureBuildTasks);
+
+    for (TPair<FString, FCppToolsModuleBuildTask>& Task : Tasks)
+    {
+        TArray<FString> SourceFiles;
+        IFileManager::Get().FindFilesRecursive(SourceFiles, *Task.Value.Path, TEXT("*.cpp"), true, false, false);
+
+        if (!CppToolsBuild::MeasureModuleBuild(Task.Key, SourceFiles, Task.Value.Seconds, OutFailReason)) return false;
+        Task.Value.bMeasured = true;
+
+        UE_LOG(LogCppToolsCriticalPath, Log, TEXT("Module %s builds in %.1fs"), *Task.Key, Task.Value.Seconds);
+    }
+    return true;
+}
+
+double CppToolsCriticalPath::Schedule(const TMap<FString, FCppToolsModuleBuildTask>& Tasks, int32 Cores)
+{
+    CPPTOOLS_TRACE_SCOPE(ScheduleBuildTasks);
+
+    const TArray<FString> Order = SortTopologically(Tasks);
+    const TMap<FString, TArray<FString>> Dependencies = CppToolsCriticalPathImpl::GetOrderedDependencies(Tasks, Order);
+
+    TMap<FString, TArray<FString>> Dependents;
+    TMap<FString, int32> NumPendingDependencies;
+    for (const FString& Name : Order)
+    {
+        NumPendingDependencies.Add(Name, Dependencies[Name].Num());
+        for (const FString& Dependency : Dependencies[Name])
+        {
+            Dependents.FindOrAdd(Dependency).Add(Name);
+        }
+    }
+
+    // The priority of a task is the longest chain of work that cannot start before it is done, including itself
+    TMap<FString, double> Priorities;
+    for (int32 I = Order.Num() - 1; I >= 0; I--)
+    {
+        double LongestAfter = 0.0;
+        if (const TArray<FString>* TaskDependents = Dependents.Find(Order[I]))
+        {
+            for (const FString& Dependent : *TaskDependents)
+            {
+                LongestAfter = FMath::Max(LongestAfter, Priorities[Dependent]);
+            }
+        }
+        Priorities.Add(Order[I], Tasks[Order[I]].Seconds + LongestAfter);
+    }
+
+    TArray<FString> Ready;
+    for (const FString& Name : Order)
+    {
+        if (NumPendingDependencies[Name] == 0) Ready.Add(Name);
+    }
+
+    TArray<TPair<double, FString>> Running;
+    double Time = 0.0;
+    while (Ready.Num() > 0 || Running.Num() > 0)
+    {
+        Ready.Sort([&Priorities](const FString& A, const FString& B)
+        {
+            return Priorities[A] != Priorities[B] ? Priorities[A] > Priorities[B] : A < B;
+        });
+        while (Running.Num() < FMath::Max(1, Cores) && Ready.Num() > 0)
+        {
+            Running.Emplace(Time + Tasks[Ready[0]].Seconds, Ready[0]);
+            Ready.RemoveAt(0);
+        }
+
+        double NextFinish = TNumericLimits<double>::Max();
+        for (const TPair<double, FString>& Task : Running)
+        {
+            NextFinish = FMath::Min(NextFinish, Task.Key);
+        }
+        Time = NextFinish;
+
+        for (int32 I = Running.Num() - 1; I >= 0; I--)
+        {
+            if (Running[I].Key > Time) continue;
+
+            if (const TArray<FString>* TaskDependents = Dependents.Find(Running[I].Value))
+            {
+                for (const FString& Dependent : *TaskDependents)
+                {
+                    if (--NumPendingDependencies[Dependent] == 0) Ready.Add(Dependent);
+                }
+            }
+            Running.RemoveAt(I);
+        }
+    }
+    return Time;
+}
+
+FCppToolsCriticalPathReport CppToolsCriticalPath::Analyze(const TMap<FString, FCppToolsModuleBuildTask>& Tasks, const FCppToolsCriticalPathSettings& Settings)
+{
+    CPPTOOLS_TRACE_SCOPE(AnalyzeCriticalPath);
+
+    FCppToolsCriticalPathReport Report;
+    Report.Tasks = Tasks;
+
+    const TArray<FString> Order = SortTopologically(Tasks);
+    const TMap<FString, TArray<FString>> Dependencies = CppToolsCriticalPathImpl::GetOrderedDependencies(Tasks, Order);
+
+    // With unlimited cores every module finishes right after the last of its dependencies
+    TMap<FString, FString> CriticalDependencies;
+    FString LastFinished;
+    for (const FString& Name : Order)
+    {
+        FCppToolsModuleBuildTask& Task = Report.Tasks[Name];
+        double Start = 0.0;
+        for (const FString& Dependency : Dependencies[Name])
+        {
+            if (Report.Tasks[Dependency].EarliestFinish > Start || !CriticalDependencies.Contains(Name))
+            {
+                Start = FMath::Max(Start, Report.Tasks[Dependency].EarliestFinish);
+                CriticalDependencies.Add(Name, Dependency);
+            }
+        }
+        Task.EarliestFinish = Start + Task.Seconds;
+        Report.TotalSeconds += Task.Seconds;
+
+        if (LastFinished.IsEmpty() || Task.EarliestFinish > Report.Tasks[LastFinished].EarliestFinish)
+        {
+            LastFinished = Name;
+        }
+    }
+
+    for (FString Name = LastFinished; !Name.IsEmpty(); Name = CriticalDependencies.FindRef(Name))
+    {
+        Report.CriticalPath.Insert(Name, 0);
+    }
+    Report.CriticalPathSeconds = LastFinished.IsEmpty() ? 0.0 : Report.Tasks[LastFinished].EarliestFinish;
+
+    for (const int32 Cores : Settings.Cores)
+    {
+        FCppToolsParallelism& Parallelism = Report.Parallelism.AddDefaulted_GetRef();
+        Parallelism.Cores = Cores;
+        Parallelism.Seconds = Schedule(Tasks, Cores);
+        if (Parallelism.Seconds > 0.0)
+        {
+            Parallelism.Speedup = Report.TotalSeconds / Parallelism.Seconds;
+            Parallelism.Efficiency = Parallelism.Speedup / FMath::Max(1, Cores);
+        }
+    }
+
+    // Splitting only helps modules that make up a large part of the critical path
+    const double SecondsBefore = Schedule(Tasks, Settings.TargetCores);
+    for (const FString& Name : Report.CriticalPath)
+    {
+        const double ModuleSeconds = Tasks[Name].Seconds;
+        if (ModuleSeconds <= 0.0 || ModuleSeconds < Settings.MinSplitFraction * Report.CriticalPathSeconds) continue;
+
+        FCppToolsSplitSuggestion Suggestion;
+        Suggestion.ModuleName = Name;
+        Suggestion.ModuleSeconds = ModuleSeconds;
+        Suggestion.Parts = FMath::Max(2, Settings.SplitParts);
+        Suggestion.SecondsBefore = SecondsBefore;
+        Suggestion.SecondsAfter = Schedule(CppToolsCriticalPathImpl::SplitTask(Tasks, Name, Suggestion.Parts), Settings.TargetCores);
+        if (Suggestion.SecondsAfter < SecondsBefore)
+        {
+            Report.Suggestions.Add(Suggestion);
+        }
+    }
+    Report.Suggestions.Sort([](const FCppToolsSplitSuggestion& A, const FCppToolsSplitSuggestion& B)
+    {
+        return A.GetProjectedSpeedup() > B.GetProjectedSpeedup();
+    });
+    if (Report.Suggestions.Num() > Settings.MaxSuggestions)
+    {
+        Report.Suggestions.SetNum(Settings.MaxSuggestions);
+    }
+
+    UE_LOG(LogCppToolsCriticalPath, Log, TEXT("The critical path of %d modules takes %.1fs of %.1fs of total build time"),
+        Report.CriticalPath.Num(), Report.CriticalPathSeconds, Report.TotalSeconds);
+    return Report;
+}
+
+TArray<FString> CppToolsCriticalPath::SortTopologically(const TMap<FString, FCppToolsModuleBuildTask>& Tasks)
+{
+    TArray<FString> Names;
+    Tasks.GetKeys(Names);
+    Names.Sort();
+
+    TArray<FString> Order;
+    TSet<FString> Visiting;
+    TSet<FString> Visited;
+
+    TFunction<void(const FString&)> Visit = [&](const FString& Name)
+    {
+        if (Visited.Contains(Name)) return;
+        if (Visiting.Contains(Name))
+        {
+            UE_LOG(LogCppToolsCriticalPath, Warning, TEXT("Module %s is part of a dependency cycle, which is ignored"), *Name);
+            return;
+        }
+
+        Visiting.Add(Name);
+        for (const FString& Dependency : Tasks[Name].Dependencies)
+        {
+            if (Tasks.Contains(Dependency)) Visit(Dependency);
+        }
+        Visiting.Remove(Name);
+
+        Visited.Add(Name);
+        Order.Add(Name);
+    };
+
+    for (const FString& Name : Names)
+    {
+        Visit(Name);
+    }
+    return Order;
+}
+
+#undef LOCTEXT_NAMESPACE
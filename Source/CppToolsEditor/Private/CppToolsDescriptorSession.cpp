@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsDescriptorSession.h"
+
+#include "CppToolsFileTransaction.h"
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "DesktopPlatformModule.h"
+#include "GameProjectUtils.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsDescriptorSession"
+
+bool FCppToolsDescriptorSession::ModifyProject(TFunctionRef<bool(FProjectDescriptor&)> Modifier, FText& OutFailReason)
+{
+    FOpenDescriptor* Descriptor = Open(nullptr, OutFailReason);
+    if (!Descriptor) return false;
+
+    if (Modifier(Descriptor->ProjectDescriptor))
+    {
+        Descriptor->bModified = true;
+        IndexModules(*Descriptor);
+    }
+    return true;
+}
+
+bool FCppToolsDescriptorSession::ModifyPlugin(const TSharedPtr<IPlugin>& Plugin, TFunctionRef<bool(FPluginDescriptor&)> Modifier, FText& OutFailReason)
+{
+    if (!Plugin.IsValid())
+    {
+        OutFailReason = LOCTEXT("InvalidPlugin", "No plugin was specified to update.");
+        return false;
+    }
+
+    FOpenDescriptor* Descriptor = Open(Plugin, OutFailReason);
+    if (!Descriptor) return false;
+
+    if (Modifier(Descriptor->PluginDescriptor))
+    {
+        Descriptor->bModified = true;
+        IndexModules(*Descriptor);
+    }
+    return true;
+}
+
+bool FCppToolsDescriptorSession::AppendModules(const TSharedPtr<IPlugin>& Plugin, const TArray<FModuleDescriptor>& Modules, FText& OutFailReason)
+{
+    // See GameProjectUtils.cpp L1070
+    FOpenDescriptor* Descriptor = Open(Plugin, OutFailReason);
+    if (!Descriptor) return false;
+
+    const FString PrimaryModuleName = Plugin.IsValid() ? Plugin->GetName() : FString(FApp::GetProjectName());
+    const FName PrimaryGameModule(*PrimaryModuleName);
+    const FName PrimaryEditorModule(*(PrimaryModuleName + TEXT("Editor")));
+
+    TArray<FModuleDescriptor>& DescriptorModules = Descriptor->GetModules();
+    for (const FModuleDescriptor& Module : Modules)
+    {
+        // The primary module is looked up before the new module is added, so a module is never its own dependency
+        if (const int32* PrimaryIndex = Descriptor->ModuleIndices.Find(Module.Type == EHostType::Editor ? PrimaryEditorModule : PrimaryGameModule))
+        {
+            TArray<FString>& AdditionalDependencies = DescriptorModules[*PrimaryIndex].AdditionalDependencies;
+            const FString ModuleName = Module.Name.ToString();
+            if (!AdditionalDependencies.Contains(ModuleName))
+            {
+                AdditionalDependencies.Add(ModuleName);
+                Descriptor->bModified = true;
+            }
+        }
+
+        if (!Descriptor->ModuleIndices.Contains(Module.Name))
+        {
+            Descriptor->ModuleIndices.Add(Module.Name, DescriptorModules.Add(Module));
+            Descriptor->bModified = true;
+        }
+    }
+    return true;
+}
+
+bool FCppToolsDescriptorSession::RemoveModules(const TArray<FString>& ModuleNames, FText& OutFailReason)
+{
+    TSet<FName> RemovedModules;
+    for (const FString& ModuleName : ModuleNames)
+    {
+        RemovedModules.Add(FName(*ModuleName));
+    }
+    const TSet<FString> RemovedDependencies(ModuleNames);
+
+    TArray<TSharedPtr<IPlugin>> Targets;
+    Targets.Add(nullptr);
+    Targets.Append(CppToolsUtil::GetProjectPlugins());
+
+    for (const TSharedPtr<IPlugin>& Target : Targets)
+    {
+        FOpenDescriptor* Descriptor = Open(Target, OutFailReason);
+        if (!Descriptor) return false;
+
+        TArray<FModuleDescriptor>& Modules = Descriptor->GetModules();
+        bool bChanged = Modules.RemoveAll([&RemovedModules](const FModuleDescriptor& Module)
+        {
+            return RemovedModules.Contains(Module.Name);
+        }) > 0;
+
+        for (FModuleDescriptor& Module : Modules)
+        {
+            bChanged |= Module.AdditionalDependencies.RemoveAll([&RemovedDependencies](const FString& Dependency)
+            {
+                return RemovedDependencies.Contains(Dependency);
+            }) > 0;
+        }
+
+        if (bChanged)
+        {
+            Descriptor->bModified = true;
+            IndexModules(*Descriptor);
+        }
+    }
+    return true;
+}
+
+const TArray<FModuleDescriptor>* FCppToolsDescriptorSession::GetModules(const TSharedPtr<IPlugin>& Plugin, FText& OutFailReason)
+{
+    FOpenDescriptor* Descriptor = Open(Plugin, OutFailReason);
+    return Descriptor ? &Descriptor->GetModules() : nullptr;
+}
+
+TArray<FString> FCppToolsDescriptorSession::GetModifiedFiles() const
+{
+    TArray<FString> Result;
+    for (const TPair<FString, FOpenDescriptor>& Descriptor : Descriptors)
+    {
+        if (Descriptor.Value.bModified)
+        {
+            Result.Add(Descriptor.Key);
+        }
+    }
+    return Result;
+}
+
+bool FCppToolsDescriptorSession::Commit(FText& OutFailReason, FCppToolsFileTransaction* Transaction)
+{
+    CPPTOOLS_TRACE_SCOPE(CommitDescriptorSession);
+
+    int32 NumSaved = 0;
+    for (TPair<FString, FOpenDescriptor>& Pair : Descriptors)
+    {
+        FOpenDescriptor& Descriptor = Pair.Value;
+        if (!Descriptor.bModified) continue;
+
+        if (Transaction && !Transaction->BackupExternalWrite(Descriptor.Filename, OutFailReason)) return false;
+
+        // See GameProjectUtils.cpp L3661
+        CppToolsUtil::TryMakeFileWriteable(Descriptor.Filename);
+        const bool bSaved = Descriptor.Plugin.IsValid() ? Descriptor.PluginDescriptor.Save(Descriptor.Filename, OutFailReason)
+            : Descriptor.ProjectDescriptor.Save(Descriptor.Filename, OutFailReason)
+                && FDesktopPlatformModule::Get()->SetEngineIdentifierForProject(Descriptor.Filename, FDesktopPlatformModule::Get()->GetCurrentEngineIdentifier());
+        if (!bSaved) return false;
+
+        Descriptor.bModified = false;
+        NumSaved++;
+    }
+
+    if (NumSaved > 0)
+    {
+        GameProjectUtils::ResetCurrentProjectModulesCache();
+    }
+    return true;
+}
+
+FCppToolsDescriptorSession::FOpenDescriptor* FCppToolsDescriptorSession::Open(const TSharedPtr<IPlugin>& Plugin, FText& OutFailReason)
+{
+    const FString Filename = Plugin.IsValid() ? Plugin->GetDescriptorFileName() : FPaths::GetProjectFilePath();
+    if (FOpenDescriptor* Existing = Descriptors.Find(Filename))
+    {
+        return Existing;
+    }
+
+    CPPTOOLS_TRACE_FILE_SCOPE(LoadDescriptor, Filename);
+
+    FOpenDescriptor Descriptor;
+    Descriptor.Filename = Filename;
+    Descriptor.Plugin = Plugin;
+    const bool bLoaded = Plugin.IsValid() ? Descriptor.PluginDescriptor.Load(Filename, OutFailReason)
+        : Descriptor.ProjectDescriptor.Load(Filename, OutFailReason);
+    if (!bLoaded) return nullptr;
+
+    IndexModules(Descriptor);
+    return &Descriptors.Add(Filename, MoveTemp(Descriptor));
+}
+
+void FCppToolsDescriptorSession::IndexModules(FOpenDescriptor& Descriptor)
+{
+    const TArray<FModuleDescriptor>& Modules = Descriptor.GetModules();
+    Descriptor.ModuleIndices.Reset();
+    Descriptor.ModuleIndices.Reserve(Modules.Num());
+    for (int32 I = 0; I < Modules.Num(); I++)
+    {
+        Descriptor.ModuleIndices.Add(Modules[I].Name, I);
+    }
+}
+
+#undef LOCTEXT_NAMESPACE
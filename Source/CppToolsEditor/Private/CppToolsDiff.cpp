@@ -0,0 +1,240 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsDiff.h"
+
+#include "CppToolsTrace.h"
+
+#include "Misc/Crc.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsDiff"
+
+namespace CppToolsDiffImpl
+{
+    /**
+     * The largest number of line pairs compared to find the longest common subsequence of the changed lines. Beyond it the
+     * changed lines are shown as removed and added as a whole, which keeps the memory of the comparison bounded.
+     */
+    static const int64 MaxComparedLinePairs = 1024 * 1024;
+
+    enum class EEditType : uint8
+    {
+        Equal,
+        Delete,
+        Insert
+    };
+
+    /** A line of the diff, with the number of old and new lines before it. */
+    struct FEdit
+    {
+        EEditType Type;
+        int32 OldLine;
+        int32 NewLine;
+    };
+
+    /** A line with its hash, so most unequal lines are told apart without comparing them. */
+    struct FLine
+    {
+        FStringView Text;
+        uint32 Hash;
+    };
+
+    static void HashLines(const FString& Text, TArray<FLine>& OutLines)
+    {
+        TArray<FStringView> Lines;
+        CppToolsDiff::SplitLines(Text, Lines);
+
+        OutLines.Reset(Lines.Num());
+        for (const FStringView& Line : Lines)
+        {
+            OutLines.Add({ Line, FCrc::MemCrc32(Line.GetData(), Line.Len() * sizeof(TCHAR)) });
+        }
+    }
+
+    static bool LinesEqual(const FLine& A, const FLine& B)
+    {
+        return A.Hash == B.Hash && A.Text.Len() == B.Text.Len()
+            && (A.Text.Len() == 0 || FCString::Strncmp(A.Text.GetData(), B.Text.GetData(), A.Text.Len()) == 0);
+    }
+
+    /**
+     * Computes the edits turning the old lines into the new lines. The unchanged lines at the start and end are skipped
+     * first, so the comparison only covers the changed region, which is small for the edits made by the tools.
+     */
+    static void MakeEdits(const TArray<FLine>& Old, const TArray<FLine>& New, TArray<FEdit>& OutEdits)
+    {
+        int32 Prefix = 0;
+        while (Prefix < Old.Num() && Prefix < New.Num() && LinesEqual(Old[Prefix], New[Prefix]))
+        {
+            Prefix++;
+        }
+        int32 Suffix = 0;
+        while (Suffix < Old.Num() - Prefix && Suffix < New.Num() - Prefix && LinesEqual(Old[Old.Num() - 1 - Suffix], New[New.Num() - 1 - Suffix]))
+        {
+            Suffix++;
+        }
+
+        OutEdits.Reset(Old.Num() + New.Num() - Prefix - Suffix);
+        for (int32 I = 0; I < Prefix; I++)
+        {
+            OutEdits.Add({ EEditType::Equal, I, I });
+        }
+
+        const int32 OldCount = Old.Num() - Prefix - Suffix;
+        const int32 NewCount = New.Num() - Prefix - Suffix;
+        int32 I = 0;
+        int32 J = 0;
+        if (OldCount > 0 && NewCount > 0 && static_cast<int64>(OldCount) * NewCount <= MaxComparedLinePairs)
+        {
+            // Length of the longest common subsequence of the remaining old and new lines from each pair of lines onwards
+            const int32 Stride = NewCount + 1;
+            TArray<int32> Lengths;
+            Lengths.SetNumZeroed((OldCount + 1) * Stride);
+            for (int32 Row = OldCount - 1; Row >= 0; Row--)
+            {
+                for (int32 Column = NewCount - 1; Column >= 0; Column--)
+                {
+                    Lengths[Row * Stride + Column] = LinesEqual(Old[Prefix + Row], New[Prefix + Column])
+                        ? Lengths[(Row + 1) * Stride + Column + 1] + 1
+                        : FMath::Max(Lengths[(Row + 1) * Stride + Column], Lengths[Row * Stride + Column + 1]);
+                }
+            }
+
+            while (I < OldCount && J < NewCount)
+            {
+                if (LinesEqual(Old[Prefix + I], New[Prefix + J]))
+                {
+                    OutEdits.Add({ EEditType::Equal, Prefix + I++, Prefix + J++ });
+                }
+                else if (Lengths[(I + 1) * Stride + J] >= Lengths[I * Stride + J + 1])
+                {
+                    OutEdits.Add({ EEditType::Delete, Prefix + I++, Prefix + J });
+                }
+                else
+                {
+                    OutEdits.Add({ EEditType::Insert, Prefix + I, Prefix + J++ });
+                }
+            }
+        }
+        while (I < OldCount)
+        {
+            OutEdits.Add({ EEditType::Delete, Prefix + I++, Prefix + J });
+        }
+        while (J < NewCount)
+        {
+            OutEdits.Add({ EEditType::Insert, Prefix + I, Prefix + J++ });
+        }
+
+        for (int32 K = 0; K < Suffix; K++)
+        {
+            OutEdits.Add({ EEditType::Equal, Prefix + OldCount + K, Prefix + NewCount + K });
+        }
+    }
+
+    static void AppendLine(FString& Result, TCHAR Marker, const FStringView& Line)
+    {
+        Result.AppendChar(Marker);
+        Result.AppendChars(Line.GetData(), Line.Len());
+        Result.AppendChar(TEXT('\n'));
+    }
+
+    /** Formats the start and length of a hunk, where an empty range starts at the line before it. */
+    static FString FormatRange(int32 Start, int32 Length)
+    {
+        return FString::Printf(TEXT("%d,%d"), Length > 0 ? Start + 1 : Start, Length);
+    }
+}
+
+void CppToolsDiff::SplitLines(const FString& Text, TArray<FStringView>& OutLines)
+{
+    OutLines.Reset();
+
+    const TCHAR* Data = *Text;
+    const int32 Length = Text.Len();
+    int32 LineStart = 0;
+    for (int32 I = 0; I < Length; I++)
+    {
+        if (Data[I] != TEXT('\n')) continue;
+
+        const int32 LineEnd = I > LineStart && Data[I - 1] == TEXT('\r') ? I - 1 : I;
+        OutLines.Add(FStringView(Data + LineStart, LineEnd - LineStart));
+        LineStart = I + 1;
+    }
+    if (LineStart < Length)
+    {
+        OutLines.Add(FStringView(Data + LineStart, Length - LineStart));
+    }
+}
+
+FString CppToolsDiff::MakeUnifiedDiff(const FString& Filename, const FString& OldContents, const FString& NewContents, int32 ContextLines)
+{
+    using namespace CppToolsDiffImpl;
+
+    CPPTOOLS_TRACE_SCOPE(MakeUnifiedDiff);
+
+    if (OldContents.Equals(NewContents, ESearchCase::CaseSensitive)) return FString();
+
+    TArray<FLine> Old;
+    TArray<FLine> New;
+    HashLines(OldContents, Old);
+    HashLines(NewContents, New);
+
+    TArray<FEdit> Edits;
+    MakeEdits(Old, New, Edits);
+
+    FString Result = FString::Printf(TEXT("--- %s\n+++ %s\n"), *Filename, *Filename);
+
+    int32 Index = 0;
+    while (Index < Edits.Num())
+    {
+        while (Index < Edits.Num() && Edits[Index].Type == EEditType::Equal)
+        {
+            Index++;
+        }
+        if (Index == Edits.Num()) break;
+
+        // A hunk runs until there are more unchanged lines than the context of two neighbouring changes
+        int32 LastChange = Index;
+        for (int32 Scan = Index; Scan < Edits.Num() && Scan - LastChange <= 2 * ContextLines + 1; Scan++)
+        {
+            if (Edits[Scan].Type != EEditType::Equal)
+            {
+                LastChange = Scan;
+            }
+        }
+        const int32 HunkStart = FMath::Max(0, Index - ContextLines);
+        const int32 HunkEnd = FMath::Min(Edits.Num(), LastChange + 1 + ContextLines);
+
+        int32 OldLength = 0;
+        int32 NewLength = 0;
+        for (int32 I = HunkStart; I < HunkEnd; I++)
+        {
+            OldLength += Edits[I].Type != EEditType::Insert ? 1 : 0;
+            NewLength += Edits[I].Type != EEditType::Delete ? 1 : 0;
+        }
+
+        Result += FString::Printf(TEXT("@@ -%s +%s @@\n"), *FormatRange(Edits[HunkStart].OldLine, OldLength),
+            *FormatRange(Edits[HunkStart].NewLine, NewLength));
+        for (int32 I = HunkStart; I < HunkEnd; I++)
+        {
+            const FEdit& Edit = Edits[I];
+            switch (Edit.Type)
+            {
+            case EEditType::Equal:
+                AppendLine(Result, TEXT(' '), Old[Edit.OldLine].Text);
+                break;
+            case EEditType::Delete:
+                AppendLine(Result, TEXT('-'), Old[Edit.OldLine].Text);
+                break;
+            case EEditType::Insert:
+                AppendLine(Result, TEXT('+'), New[Edit.NewLine].Text);
+                break;
+            }
+        }
+
+        Index = HunkEnd;
+    }
+    return Result;
+}
+
+#undef LOCTEXT_NAMESPACE
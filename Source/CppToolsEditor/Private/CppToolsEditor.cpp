@@ -1,6 +1,15 @@
 #include "CppToolsEditor.h"
 #include "CppToolsEditorPrivatePCH.h"
 
+#include "CppToolsBinaryCache.h"
+#include "CppToolsBuildWatcherPanel.h"
+#include "CppToolsCompileHotSpots.h"
+#include "CppToolsFileTransaction.h"
+#include "CppToolsIWYUWizard.h"
+#include "CppToolsMemoryReport.h"
+#include "CppToolsRefactorDependencies.h"
+#include "CppToolsTraceHistory.h"
+
 //#include "Developer/AssetTools/Public/IAssetTools.h"
 //#include "Developer/AssetTools/Public/AssetToolsModule.h"
 
@@ -11,6 +20,18 @@ DEFINE_LOG_CATEGORY(CppToolsLog)
 
 void FCppToolsEditorModule::StartupModule()
 {
+    // Undo the changes of any operation that was interrupted before it finished writing the project's files
+    FCppToolsFileTransaction::RecoverUnfinishedTransactions();
+
+    // Commandlets have no menus to extend, see UCppToolsCommandlet for running the tools headless
+    if (IsRunningCommandlet()) return;
+
+    BuildWatcher = MakeUnique<FCppToolsBuildWatcher>();
+    if (FCppToolsBuildWatcher::IsEnabledInSettings())
+    {
+        BuildWatcher->Start();
+    }
+
     FLevelEditorModule& LevelEditorModule = FModuleManager::LoadModuleChecked<FLevelEditorModule>("LevelEditor");
 
     TSharedPtr<FExtender> MenuExtender = MakeShareable(new FExtender());
@@ -25,6 +46,7 @@ void FCppToolsEditorModule::StartupModule()
 
 void FCppToolsEditorModule::ShutdownModule()
 {
+    BuildWatcher.Reset();
 }
 
 void FCppToolsEditorModule::AddMenuEntry(FMenuBuilder& MenuBuilder) {
@@ -36,12 +58,54 @@ void FCppToolsEditorModule::AddMenuEntry(FMenuBuilder& MenuBuilder) {
             FSlateIcon(),
             FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::OnNewCppModule))
         );
+        MenuBuilder.AddMenuEntry(
+            FText::FromString("Update Forward Declaration Headers"),
+            FText::FromString("Regenerates the forward declaration header of every module that has one from its Public headers"),
+            FSlateIcon(),
+            FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::OnUpdateFwdHeaders))
+        );
+        MenuBuilder.AddMenuEntry(
+            FText::FromString("Refactor Dependencies..."),
+            FText::FromString("Adds, removes, moves or replaces a dependency in the .Build.cs files of many modules at once"),
+            FSlateIcon(),
+            FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::OnShowRefactorDependencies))
+        );
+        MenuBuilder.AddMenuEntry(
+            FText::FromString("Convert Module to IWYU..."),
+            FText::FromString("Replaces a module's monolithic includes with the headers it uses and checks that its headers compile on their own"),
+            FSlateIcon(),
+            FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::OnShowIWYUWizard))
+        );
         MenuBuilder.AddMenuEntry(
             FText::FromString("Restart Editor"),
             FText::FromString("Restarts the UE4 Editor"),
             FSlateIcon(),
             FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::RestartEditor))
         );
+        MenuBuilder.AddMenuEntry(
+            FText::FromString("Operation Timings..."),
+            FText::FromString("Shows how long each stage of recent C++ Tools operations took"),
+            FSlateIcon(),
+            FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::OnShowTraceHistory))
+        );
+        MenuBuilder.AddMenuEntry(
+            FText::FromString("Compile Hot Spots..."),
+            FText::FromString("Shows the most expensive headers and template instantiations of each module from clang time traces"),
+            FSlateIcon(),
+            FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::OnShowCompileHotSpots))
+        );
+        MenuBuilder.AddMenuEntry(
+            FText::FromString("Background Build..."),
+            FText::FromString("Builds the modules whose sources are saved in the background and shows the build state of each module"),
+            FSlateIcon(),
+            FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::OnShowBuildWatcher))
+        );
+        MenuBuilder.AddMenuEntry(
+            FText::FromString("Module Memory..."),
+            FText::FromString("Shows the live and peak memory of every module with an LLM tag and saves snapshots of it"),
+            FSlateIcon(),
+            FUIAction(FExecuteAction::CreateRaw(this, &FCppToolsEditorModule::OnShowMemoryReport))
+        );
     }
     MenuBuilder.EndSection();
 }
@@ -50,7 +114,7 @@ void FCppToolsEditorModule::OnNewCppModule() {
     UE_LOG(CppToolsLog, Log, TEXT("Test add new cpp module!"));
     CreateModuleWindow = SNew(SWindow)
         .Title(NSLOCTEXT("CreateNewModule", "WindowTitle", "Create New C++ Module"))
-        .ClientSize(FVector2D(750, 350))
+        .ClientSize(FVector2D(900, 720))
         .SizingRule(ESizingRule::FixedSize)
         .SupportsMinimize(false).SupportsMaximize(false);
 
@@ -79,11 +143,99 @@ void FCppToolsEditorModule::OnNewCppModule() {
 
 }
 
+void FCppToolsEditorModule::OnUpdateFwdHeaders() {
+    FText FailReason;
+    const int32 NumUpdated = CppToolsUtil::UpdateProjectFwdHeaders(FailReason);
+    if (NumUpdated == INDEX_NONE)
+    {
+        CppToolsUtil::PushNotification(FText::Format(LOCTEXT("UpdateFwdHeadersFailed", "Failed to update forward declaration headers. {0}"), FailReason),
+            SNotificationItem::CS_Fail);
+    }
+    else
+    {
+        CppToolsUtil::PushNotification(FText::Format(LOCTEXT("UpdatedFwdHeaders", "Updated {0} forward declaration headers"), NumUpdated),
+            SNotificationItem::CS_Success);
+    }
+}
+
+void FCppToolsEditorModule::OnShowRefactorDependencies() {
+    TSharedRef<SWindow> RefactorDependenciesWindow = SNew(SWindow)
+        .Title(NSLOCTEXT("CppToolsRefactorDependencies", "WindowTitle", "C++ Tools Refactor Dependencies"))
+        .ClientSize(FVector2D(1000, 700))
+        .SupportsMinimize(false);
+
+    RefactorDependenciesWindow->SetContent(SNew(SCppToolsRefactorDependencies));
+    FSlateApplication::Get().AddWindow(RefactorDependenciesWindow);
+}
+
+void FCppToolsEditorModule::OnShowIWYUWizard() {
+    TSharedRef<SWindow> IWYUWizardWindow = SNew(SWindow)
+        .Title(NSLOCTEXT("CppToolsIWYUWizard", "WindowTitle", "C++ Tools Convert Module to IWYU"))
+        .ClientSize(FVector2D(1000, 700))
+        .SupportsMinimize(false);
+
+    IWYUWizardWindow->SetContent(SNew(SCppToolsIWYUWizard));
+    FSlateApplication::Get().AddWindow(IWYUWizardWindow);
+}
+
 void FCppToolsEditorModule::RestartEditor() {
+    // Finish the background build first, so the restarted editor loads the latest binaries instead of asking to rebuild them
+    if (BuildWatcher.IsValid() && !BuildWatcher->WaitForBuild())
+    {
+        UE_LOG(CppToolsLog, Warning, TEXT("The background build failed, see the Background Build window for the errors of each module"));
+    }
+
+    // Restore any stale modules that have been built before, and cache the ones that are up to date for the next sync
+    const int32 NumRestoredModules = CppToolsBinaryCache::SyncProjectModules();
+    if (NumRestoredModules > 0)
+    {
+        UE_LOG(CppToolsLog, Log, TEXT("Restored %d modules from the binary cache"), NumRestoredModules);
+    }
+
     UE_LOG(CppToolsLog, Log, TEXT("Restarting editor..."));
     FUnrealEdMisc::Get().RestartEditor(false);
 }
 
+void FCppToolsEditorModule::OnShowTraceHistory() {
+    TSharedRef<SWindow> TraceHistoryWindow = SNew(SWindow)
+        .Title(NSLOCTEXT("CppToolsTraceHistory", "WindowTitle", "C++ Tools Operation Timings"))
+        .ClientSize(FVector2D(900, 400))
+        .SupportsMinimize(false);
+
+    TraceHistoryWindow->SetContent(SNew(SCppToolsTraceHistory));
+    FSlateApplication::Get().AddWindow(TraceHistoryWindow);
+}
+
+void FCppToolsEditorModule::OnShowCompileHotSpots() {
+    TSharedRef<SWindow> CompileHotSpotsWindow = SNew(SWindow)
+        .Title(NSLOCTEXT("CppToolsCompileHotSpots", "WindowTitle", "C++ Tools Compile Hot Spots"))
+        .ClientSize(FVector2D(1100, 700))
+        .SupportsMinimize(false);
+
+    CompileHotSpotsWindow->SetContent(SNew(SCppToolsCompileHotSpots));
+    FSlateApplication::Get().AddWindow(CompileHotSpotsWindow);
+}
+
+void FCppToolsEditorModule::OnShowBuildWatcher() {
+    TSharedRef<SWindow> BuildWatcherWindow = SNew(SWindow)
+        .Title(NSLOCTEXT("CppToolsBuildWatcherPanel", "WindowTitle", "C++ Tools Background Build"))
+        .ClientSize(FVector2D(1000, 500))
+        .SupportsMinimize(false);
+
+    BuildWatcherWindow->SetContent(SNew(SCppToolsBuildWatcherPanel).Watcher(BuildWatcher.Get()));
+    FSlateApplication::Get().AddWindow(BuildWatcherWindow);
+}
+
+void FCppToolsEditorModule::OnShowMemoryReport() {
+    TSharedRef<SWindow> MemoryReportWindow = SNew(SWindow)
+        .Title(NSLOCTEXT("CppToolsMemoryReport", "WindowTitle", "C++ Tools Module Memory"))
+        .ClientSize(FVector2D(800, 500))
+        .SupportsMinimize(false);
+
+    MemoryReportWindow->SetContent(SNew(SCppToolsMemoryReport));
+    FSlateApplication::Get().AddWindow(MemoryReportWindow);
+}
+
 void FCppToolsEditorModule::CreateNewModule(FString Name, FCreateModuleTarget Target, EHostType::Type Type) {
     UE_LOG(CppToolsLog, Log, TEXT("Creating module..."));
 }
@@ -0,0 +1,530 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsExportAudit.h"
+
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Internationalization/Regex.h"
+#include "Templates/UniquePtr.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsExportAudit"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsExportAudit, Log, All);
+
+namespace CppToolsExportAuditImpl
+{
+    // See the System V ABI for the layout of ELF files
+    static const int32 ElfHeaderSize = 64;
+    static const int32 SectionHeaderSize = 64;
+    static const int32 SymbolSize = 24;
+    static const uint8 ElfClass64 = 2;
+    static const uint8 ElfDataLittleEndian = 1;
+    static const uint32 SectionTypeProgramBits = 1;
+    static const uint32 SectionTypeRelocationsWithAddends = 4;
+    static const uint32 SectionTypeRelocations = 9;
+    static const uint32 SectionTypeDynamicSymbols = 11;
+    static const uint64 SectionFlagAlloc = 0x2;
+    static const uint64 SectionFlagExecInstr = 0x4;
+    static const uint8 SymbolBindGlobal = 1;
+    static const uint8 SymbolBindWeak = 2;
+    static const uint8 SymbolVisibilityInternal = 1;
+    static const uint8 SymbolVisibilityHidden = 2;
+    static const uint16 SectionIndexUndefined = 0;
+
+    /** The members that UCLASS(MinimalAPI) still exports, so other modules can cast to the class. */
+    static const TCHAR* MinimalAPIMembers[] = { TEXT("GetPrivateStaticClass"), TEXT("StaticClass") };
+
+    template <typename T>
+    static T ReadValue(const TArray<uint8>& Data, int64 Offset)
+    {
+        T Value;
+        FMemory::Memcpy(&Value, Data.GetData() + Offset, sizeof(T));
+        return Value;
+    }
+
+    static bool ReadRange(IFileHandle& Handle, int64 Offset, int64 Size, TArray<uint8>& OutData)
+    {
+        if (Offset < 0 || Size < 0 || Offset + Size > Handle.Size()) return false;
+
+        OutData.SetNumUninitialized(Size);
+        return Handle.Seek(Offset) && Handle.Read(OutData.GetData(), Size);
+    }
+
+    /**
+     * Opens an ELF file and reads its section headers. Only the headers, and the sections read afterwards, are read from the
+     * file, as the debug information can be large.
+     */
+    static bool OpenElfFile(const FString& Filename, TUniquePtr<IFileHandle>& OutHandle, TArray<uint8>& OutSectionHeaders, int64& OutSectionHeaderStride,
+        int32& OutNumSections, FText& OutFailReason)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+
+        OutHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename));
+        if (!OutHandle.IsValid())
+        {
+            OutFailReason = FText::Format(LOCTEXT("FailedToReadBinary", "Failed to read \"{FullFileName}\""), Args);
+            return false;
+        }
+
+        TArray<uint8> Header;
+        if (!ReadRange(*OutHandle, 0, ElfHeaderSize, Header) || Header[0] != 0x7f || Header[1] != 'E' || Header[2] != 'L' || Header[3] != 'F')
+        {
+            OutFailReason = FText::Format(LOCTEXT("NotAnElfFile", "\"{FullFileName}\" is not an ELF file"), Args);
+            return false;
+        }
+        if (Header[4] != ElfClass64 || Header[5] != ElfDataLittleEndian)
+        {
+            OutFailReason = FText::Format(LOCTEXT("UnsupportedElfFile", "\"{FullFileName}\" is not a 64 bit little endian ELF file"), Args);
+            return false;
+        }
+
+        const int64 SectionHeadersOffset = ReadValue<uint64>(Header, 40);
+        OutSectionHeaderStride = ReadValue<uint16>(Header, 58);
+        OutNumSections = ReadValue<uint16>(Header, 60);
+        if (OutSectionHeaderStride < SectionHeaderSize
+            || !ReadRange(*OutHandle, SectionHeadersOffset, OutSectionHeaderStride * OutNumSections, OutSectionHeaders))
+        {
+            OutFailReason = FText::Format(LOCTEXT("CorruptElfFile", "\"{FullFileName}\" is corrupt"), Args);
+            return false;
+        }
+        return true;
+    }
+
+    static bool ReadSourceName(const FString& Symbol, int32& Pos, FString& OutName)
+    {
+        int32 Length = 0;
+        while (Pos < Symbol.Len() && FChar::IsDigit(Symbol[Pos]))
+        {
+            Length = Length * 10 + (Symbol[Pos++] - TEXT('0'));
+            if (Length > Symbol.Len()) return false;
+        }
+        if (Length == 0 || Pos + Length > Symbol.Len()) return false;
+
+        OutName = Symbol.Mid(Pos, Length);
+        Pos += Length;
+        return true;
+    }
+
+    /** Skips the template arguments starting at Pos, which may nest names, further arguments and literals. */
+    static bool SkipTemplateArguments(const FString& Symbol, int32& Pos)
+    {
+        int32 Depth = 0;
+        FString Name;
+        while (Pos < Symbol.Len())
+        {
+            const TCHAR Char = Symbol[Pos];
+            if (FChar::IsDigit(Char))
+            {
+                if (!ReadSourceName(Symbol, Pos, Name)) return false;
+            }
+            else if (Char == TEXT('L'))
+            {
+                // Literals end with the first E, and their values are numbers rather than lengths
+                while (Pos < Symbol.Len() && Symbol[Pos] != TEXT('E')) Pos++;
+                Pos++;
+            }
+            else if (Char == TEXT('I') || Char == TEXT('N'))
+            {
+                Depth++;
+                Pos++;
+            }
+            else if (Char == TEXT('E'))
+            {
+                Pos++;
+                if (--Depth == 0) return true;
+            }
+            else
+            {
+                Pos++;
+            }
+        }
+        return false;
+    }
+
+    static void ProposeNarrowing(FCppToolsExportedClass& Class, const FCppToolsExportAuditSettings& Settings)
+    {
+        if (Class.NumReferencedExports == 0)
+        {
+            Class.Proposal = TEXT("Unexport");
+            return;
+        }
+
+        const float ReferencedFraction = static_cast<float>(Class.NumReferencedExports) / Class.NumExports;
+        if (Class.bReflected)
+        {
+            // MinimalAPI covers casting, so only the other referenced members need their own exports
+            bool bMinimal = true;
+            for (const FString& Member : Class.ReferencedMembers)
+            {
+                bool bCovered = false;
+                for (const TCHAR* MinimalMember : MinimalAPIMembers)
+                {
+                    bCovered |= Member == MinimalMember;
+                }
+                bMinimal &= bCovered;
+            }
+            Class.Proposal = bMinimal || ReferencedFraction <= Settings.MaxReferencedFraction ? TEXT("MinimalAPI") : TEXT("Keep");
+        }
+        else
+        {
+            Class.Proposal = ReferencedFraction <= Settings.MaxReferencedFraction ? TEXT("PerFunction") : TEXT("Keep");
+        }
+    }
+}
+
+bool CppToolsExportAudit::ReadDynamicSymbols(const FString& Filename, TArray<FCppToolsElfSymbol>& OutSymbols, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(ReadDynamicSymbols);
+    using namespace CppToolsExportAuditImpl;
+
+    TUniquePtr<IFileHandle> Handle;
+    TArray<uint8> SectionHeaders;
+    int64 SectionHeaderStride;
+    int32 NumSections;
+    if (!OpenElfFile(Filename, Handle, SectionHeaders, SectionHeaderStride, NumSections, OutFailReason)) return false;
+
+    FFormatNamedArguments Args;
+    Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+    const FText CorruptReason = FText::Format(LOCTEXT("CorruptElfFile", "\"{FullFileName}\" is corrupt"), Args);
+
+    for (int32 Section = 0; Section < NumSections; Section++)
+    {
+        const int64 SectionBase = Section * SectionHeaderStride;
+        if (ReadValue<uint32>(SectionHeaders, SectionBase + 4) != SectionTypeDynamicSymbols) continue;
+
+        // The symbol table links to the string table holding the symbol names
+        const uint32 StringsSection = ReadValue<uint32>(SectionHeaders, SectionBase + 40);
+        const int64 SymbolStride = ReadValue<uint64>(SectionHeaders, SectionBase + 56);
+        const int64 StringsBase = StringsSection * SectionHeaderStride;
+        TArray<uint8> Symbols;
+        TArray<uint8> Strings;
+        if (StringsSection >= static_cast<uint32>(NumSections) || SymbolStride < SymbolSize
+            || !ReadRange(*Handle, ReadValue<uint64>(SectionHeaders, SectionBase + 24), ReadValue<uint64>(SectionHeaders, SectionBase + 32), Symbols)
+            || !ReadRange(*Handle, ReadValue<uint64>(SectionHeaders, StringsBase + 24), ReadValue<uint64>(SectionHeaders, StringsBase + 32), Strings))
+        {
+            OutFailReason = CorruptReason;
+            return false;
+        }
+
+        // The first symbol is always the undefined null symbol
+        for (int64 SymbolBase = SymbolStride; SymbolBase + SymbolSize <= Symbols.Num(); SymbolBase += SymbolStride)
+        {
+            const uint32 NameOffset = ReadValue<uint32>(Symbols, SymbolBase);
+            const uint8 Bind = Symbols[SymbolBase + 4] >> 4;
+            const uint8 Visibility = Symbols[SymbolBase + 5] & 0x3;
+            if (Bind != SymbolBindGlobal && Bind != SymbolBindWeak) continue;
+            if (Visibility == SymbolVisibilityInternal || Visibility == SymbolVisibilityHidden) continue;
+            if (NameOffset >= static_cast<uint32>(Strings.Num())) continue;
+
+            int32 NameLength = 0;
+            while (NameOffset + NameLength < static_cast<uint32>(Strings.Num()) && Strings[NameOffset + NameLength] != 0)
+            {
+                NameLength++;
+            }
+            if (NameLength == 0) continue;
+
+            FCppToolsElfSymbol& Symbol = OutSymbols.AddDefaulted_GetRef();
+            Symbol.Name = FString(NameLength, reinterpret_cast<const ANSICHAR*>(Strings.GetData() + NameOffset));
+            Symbol.bDefined = ReadValue<uint16>(Symbols, SymbolBase + 6) != SectionIndexUndefined;
+        }
+        return true;
+    }
+
+    OutFailReason = FText::Format(LOCTEXT("NoDynamicSymbols", "\"{FullFileName}\" has no dynamic symbol table"), Args);
+    return false;
+}
+
+bool CppToolsExportAudit::ReadLoadInfo(const FString& Filename, FCppToolsElfLoadInfo& OutInfo, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(ReadLoadInfo);
+    using namespace CppToolsExportAuditImpl;
+
+    TUniquePtr<IFileHandle> Handle;
+    TArray<uint8> SectionHeaders;
+    int64 SectionHeaderStride;
+    int32 NumSections;
+    if (!OpenElfFile(Filename, Handle, SectionHeaders, SectionHeaderStride, NumSections, OutFailReason)) return false;
+
+    OutInfo = FCppToolsElfLoadInfo();
+    OutInfo.FileBytes = Handle->Size();
+    for (int32 Section = 0; Section < NumSections; Section++)
+    {
+        const int64 SectionBase = Section * SectionHeaderStride;
+        const uint32 Type = ReadValue<uint32>(SectionHeaders, SectionBase + 4);
+        const uint64 Flags = ReadValue<uint64>(SectionHeaders, SectionBase + 8);
+        const int64 Size = ReadValue<uint64>(SectionHeaders, SectionBase + 32);
+        const int64 EntrySize = ReadValue<uint64>(SectionHeaders, SectionBase + 56);
+        if (Type == SectionTypeProgramBits && (Flags & SectionFlagExecInstr) != 0)
+        {
+            OutInfo.CodeBytes += Size;
+        }
+        // Only the relocation sections that are loaded are applied by the dynamic loader
+        else if ((Type == SectionTypeRelocationsWithAddends || Type == SectionTypeRelocations) && (Flags & SectionFlagAlloc) != 0 && EntrySize > 0)
+        {
+            OutInfo.NumRelocations += Size / EntrySize;
+        }
+    }
+    return true;
+}
+
+bool CppToolsExportAudit::ParseMangledName(const FString& Symbol, TArray<FString>& OutScope, FString& OutMember)
+{
+    using namespace CppToolsExportAuditImpl;
+
+    OutScope.Reset();
+    OutMember.Reset();
+    if (!Symbol.StartsWith(TEXT("_Z"), ESearchCase::CaseSensitive)) return false;
+
+    int32 Pos = 2;
+    FString Special;
+    if (Symbol.Mid(Pos, 2) == TEXT("TV"))
+    {
+        Special = TEXT("vtable");
+        Pos += 2;
+    }
+    else if (Symbol.Mid(Pos, 2) == TEXT("TI") || Symbol.Mid(Pos, 2) == TEXT("TS"))
+    {
+        Special = TEXT("typeinfo");
+        Pos += 2;
+    }
+    if (Pos >= Symbol.Len()) return false;
+
+    TArray<FString> Names;
+    FString Name;
+    if (Symbol[Pos] == TEXT('N'))
+    {
+        Pos++;
+        // Qualifiers of member functions
+        while (Pos < Symbol.Len() && FCString::Strchr(TEXT("rVKRO"), Symbol[Pos]) != nullptr) Pos++;
+
+        while (Pos < Symbol.Len() && Symbol[Pos] != TEXT('E'))
+        {
+            const TCHAR Char = Symbol[Pos];
+            const TCHAR Next = Pos + 1 < Symbol.Len() ? Symbol[Pos + 1] : TCHAR(0);
+            if (FChar::IsDigit(Char))
+            {
+                if (!ReadSourceName(Symbol, Pos, Name)) return false;
+                Names.Add(Name);
+            }
+            else if (Char == TEXT('S') && Next == TEXT('t'))
+            {
+                Names.Add(TEXT("std"));
+                Pos += 2;
+            }
+            else if ((Char == TEXT('C') || Char == TEXT('D')) && FChar::IsDigit(Next))
+            {
+                // Constructors and destructors are named after the enclosing class
+                if (Names.Num() == 0) return false;
+                const FString ClassName = Names.Last();
+                Names.Add(Char == TEXT('C') ? ClassName : TEXT("~") + ClassName);
+                Pos += 2;
+            }
+            else if (Char == TEXT('I'))
+            {
+                if (!SkipTemplateArguments(Symbol, Pos)) return false;
+            }
+            else if (Char == TEXT('B'))
+            {
+                // ABI tags follow the name they tag
+                Pos++;
+                if (!ReadSourceName(Symbol, Pos, Name)) return false;
+            }
+            else if (FChar::IsLower(Char) && FChar::IsLower(Next))
+            {
+                Names.Add(TEXT("operator ") + Symbol.Mid(Pos, 2));
+                Pos += 2;
+            }
+            else
+            {
+                // Substitutions refer back to earlier parts of the name, which are not tracked
+                return false;
+            }
+        }
+        if (Pos >= Symbol.Len()) return false;
+    }
+    else if (FChar::IsDigit(Symbol[Pos]))
+    {
+        if (!ReadSourceName(Symbol, Pos, Name)) return false;
+        Names.Add(Name);
+    }
+    else
+    {
+        return false;
+    }
+
+    if (Names.Num() == 0) return false;
+    if (Special.IsEmpty())
+    {
+        OutMember = Names.Pop(false);
+    }
+    else
+    {
+        OutMember = Special;
+    }
+    OutScope = MoveTemp(Names);
+    return true;
+}
+
+TArray<TPair<FString, bool>> CppToolsExportAudit::ParseExportedClasses(const FString& HeaderContents, const FString& APIMacro)
+{
+    TArray<TPair<FString, bool>> Classes;
+    if (!HeaderContents.Contains(APIMacro, ESearchCase::CaseSensitive)) return Classes;
+
+    const FString Contents = CppToolsUtil::StripCStyleComments(HeaderContents);
+    const FRegexPattern ClassPattern(FString::Printf(TEXT("\\b(?:class|struct)\\s+%s\\s+(\\w+)\\s*(?:final\\s*)?[:{]"), *APIMacro));
+    FRegexMatcher ClassMatcher(ClassPattern, Contents);
+    while (ClassMatcher.FindNext())
+    {
+        // A UCLASS macro only belongs to the class if no declaration ends between the two
+        const FString Before = Contents.Left(ClassMatcher.GetMatchBeginning());
+        const int32 ReflectedIndex = Before.Find(TEXT("UCLASS"), ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+        bool bReflected = ReflectedIndex != INDEX_NONE;
+        for (int32 Index = ReflectedIndex + 1; bReflected && Index < Before.Len(); Index++)
+        {
+            bReflected = Before[Index] != TEXT(';') && Before[Index] != TEXT('{') && Before[Index] != TEXT('}');
+        }
+        Classes.Emplace(ClassMatcher.GetCaptureGroup(1), bReflected);
+    }
+    return Classes;
+}
+
+FString CppToolsExportAudit::FindModuleBinary(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, const FString& Platform)
+{
+    const FString RootDir = FPaths::ConvertRelativePathToFull(Target.IsValid() ? Target->GetBaseDir() : FPaths::ProjectDir());
+    const FString BinariesDir = RootDir / TEXT("Binaries") / Platform;
+    TArray<FString> BinaryFiles;
+    IFileManager::Get().FindFiles(BinaryFiles, *(BinariesDir / TEXT("*.so")), true, false);
+
+    // Shared objects are named lib<Target>-<Module>[-<Platform>-<Configuration>].so
+    const FString NameWithExtension = TEXT("-") + ModuleName + TEXT(".");
+    const FString NameWithSuffix = TEXT("-") + ModuleName + TEXT("-");
+    FString NewestBinary;
+    FDateTime NewestTimeStamp = FDateTime::MinValue();
+    for (const FString& BinaryFile : BinaryFiles)
+    {
+        if (!BinaryFile.Contains(NameWithExtension, ESearchCase::CaseSensitive) && !BinaryFile.Contains(NameWithSuffix, ESearchCase::CaseSensitive)) continue;
+
+        const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*(BinariesDir / BinaryFile));
+        if (TimeStamp > NewestTimeStamp)
+        {
+            NewestBinary = BinariesDir / BinaryFile;
+            NewestTimeStamp = TimeStamp;
+        }
+    }
+    return NewestBinary;
+}
+
+TArray<FCppToolsModuleExports> CppToolsExportAudit::AuditModules(const TArray<FString>& ModuleFilter, const FCppToolsExportAuditSettings& Settings)
+{
+    CPPTOOLS_TRACE_SCOPE(AuditExports);
+    using namespace CppToolsExportAuditImpl;
+
+    const TArray<TPair<FModuleContextInfo, TSharedPtr<IPlugin>>> Modules = CppToolsUtil::GetProjectAndPluginModules();
+    TArray<FString> Binaries;
+    TArray<TArray<FCppToolsElfSymbol>> Symbols;
+    Binaries.SetNum(Modules.Num());
+    Symbols.SetNum(Modules.Num());
+    ParallelFor(Modules.Num(), [&Modules, &Binaries, &Symbols, &Settings](int32 Index)
+    {
+        Binaries[Index] = FindModuleBinary(Modules[Index].Key.ModuleName, Modules[Index].Value, Settings.Platform);
+        FText FailReason;
+        if (!Binaries[Index].IsEmpty() && !ReadDynamicSymbols(Binaries[Index], Symbols[Index], FailReason))
+        {
+            UE_LOG(LogCppToolsExportAudit, Warning, TEXT("%s"), *FailReason.ToString());
+            Binaries[Index].Reset();
+        }
+    });
+
+    // A shared object never imports the symbols it defines, so every import comes from another module
+    TSet<FString> Imported;
+    for (const TArray<FCppToolsElfSymbol>& ModuleSymbols : Symbols)
+    {
+        for (const FCppToolsElfSymbol& Symbol : ModuleSymbols)
+        {
+            if (!Symbol.bDefined)
+            {
+                Imported.Add(Symbol.Name);
+            }
+        }
+    }
+
+    TArray<FCppToolsModuleExports> Results;
+    for (int32 Index = 0; Index < Modules.Num(); Index++)
+    {
+        const FModuleContextInfo& Module = Modules[Index].Key;
+        if (Binaries[Index].IsEmpty()) continue;
+        if (ModuleFilter.Num() > 0 && !ModuleFilter.Contains(Module.ModuleName)) continue;
+
+        FCppToolsModuleExports& Result = Results.AddDefaulted_GetRef();
+        Result.ModuleName = Module.ModuleName;
+        Result.Binary = Binaries[Index];
+
+        const FString APIMacro = CppToolsUtil::GetModuleAPIMacro(Module.ModuleName, false).TrimEnd();
+        TMap<FString, FCppToolsExportedClass> Classes;
+        TArray<FString> Headers;
+        IFileManager::Get().FindFilesRecursive(Headers, *Module.ModuleSourcePath, TEXT("*.h"), true, false, false);
+        for (FString& Header : Headers)
+        {
+            FString Contents;
+            if (!CppToolsUtil::LoadFileToString(Contents, Header)) continue;
+
+            FPaths::MakePathRelativeTo(Header, *Module.ModuleSourcePath);
+            for (const TPair<FString, bool>& ExportedClass : ParseExportedClasses(Contents, APIMacro))
+            {
+                FCppToolsExportedClass& Class = Classes.Add(ExportedClass.Key);
+                Class.Name = ExportedClass.Key;
+                Class.Header = Header;
+                Class.bReflected = ExportedClass.Value;
+            }
+        }
+
+        TArray<FString> Scope;
+        FString Member;
+        for (const FCppToolsElfSymbol& Symbol : Symbols[Index])
+        {
+            if (!Symbol.bDefined) continue;
+
+            Result.NumExports++;
+            const bool bReferenced = Imported.Contains(Symbol.Name);
+            const bool bMangled = ParseMangledName(Symbol.Name, Scope, Member);
+            if (Symbol.Name.StartsWith(TEXT("_Z"), ESearchCase::CaseSensitive) && !bReferenced)
+            {
+                Result.NumUnreferencedExports++;
+            }
+            if (!bMangled || Scope.Num() == 0) continue;
+
+            FCppToolsExportedClass* Class = Classes.Find(Scope.Last());
+            if (Class == nullptr) continue;
+
+            Class->NumExports++;
+            if (bReferenced)
+            {
+                Class->NumReferencedExports++;
+                Class->ReferencedMembers.AddUnique(Member);
+            }
+        }
+
+        for (TPair<FString, FCppToolsExportedClass>& Class : Classes)
+        {
+            // Classes without exports are header only, or were not built into this binary
+            if (Class.Value.NumExports == 0) continue;
+
+            Class.Value.ReferencedMembers.Sort();
+            ProposeNarrowing(Class.Value, Settings);
+            Result.Classes.Add(MoveTemp(Class.Value));
+        }
+        Result.Classes.Sort([](const FCppToolsExportedClass& A, const FCppToolsExportedClass& B) { return A.NumExports > B.NumExports; });
+
+        UE_LOG(LogCppToolsExportAudit, Log, TEXT("%s exports %d symbols, %d of which no other module imports"), *Result.ModuleName,
+            Result.NumExports, Result.NumUnreferencedExports);
+    }
+    return Results;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,456 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsFileTransaction.h"
+
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Guid.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsFileTransaction"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsFileTransaction, Log, All);
+
+namespace CppToolsFileTransactionImpl
+{
+    static const TCHAR* JournalFilename = TEXT("Journal.json");
+
+    static FText MakeFileFailReason(const FText& Format, const FString& Filename)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+        return FText::Format(Format, Args);
+    }
+}
+
+bool FCppToolsFileTransaction::StageCreate(const FString& Filename, const FString& Contents, FText& OutFailReason)
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    if (bCommitted || StagedFiles.ContainsByPredicate([&Filename](const FCppToolsStagedFile& File) { return File.Filename == Filename; })
+        || FPaths::FileExists(Filename))
+    {
+        OutFailReason = MakeFileFailReason(LOCTEXT("FileAlreadyExists", "\"{FullFileName}\" already exists"), Filename);
+        return false;
+    }
+
+    FCppToolsStagedFile& File = StagedFiles.AddDefaulted_GetRef();
+    File.Filename = Filename;
+    File.Contents = Contents;
+    File.bCreate = true;
+    return true;
+}
+
+bool FCppToolsFileTransaction::StageModify(const FString& Filename, TFunctionRef<bool(FString&)> Modifier, FText& OutFailReason)
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    if (bCommitted)
+    {
+        OutFailReason = MakeFileFailReason(LOCTEXT("TransactionCommitted", "Failed to update \"{FullFileName}\", the changes were already written"), Filename);
+        return false;
+    }
+
+    // Files staged before are modified in memory, so several edits of the same file are written together
+    if (FCppToolsStagedFile* Staged = StagedFiles.FindByPredicate([&Filename](const FCppToolsStagedFile& File) { return File.Filename == Filename; }))
+    {
+        if (Staged->bDelete)
+        {
+            OutFailReason = MakeFileFailReason(LOCTEXT("ModifiedFileDeleted", "Failed to update \"{FullFileName}\", it is deleted by the same change"), Filename);
+            return false;
+        }
+        Modifier(Staged->Contents);
+        return true;
+    }
+
+    FCppToolsStagedFile File;
+    File.Filename = Filename;
+    File.TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
+    if (!CppToolsUtil::LoadFileToString(File.Contents, Filename))
+    {
+        OutFailReason = MakeFileFailReason(LOCTEXT("FailedToReadStagedFile", "Failed to read \"{FullFileName}\""), Filename);
+        return false;
+    }
+
+    if (Modifier(File.Contents))
+    {
+        StagedFiles.Add(MoveTemp(File));
+    }
+    return true;
+}
+
+bool FCppToolsFileTransaction::StageReplace(const FString& Filename, const FString& Contents, const FDateTime& TimeStamp, FText& OutFailReason)
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    if (bCommitted || StagedFiles.ContainsByPredicate([&Filename](const FCppToolsStagedFile& File) { return File.Filename == Filename; }))
+    {
+        OutFailReason = MakeFileFailReason(LOCTEXT("FileAlreadyStaged", "Failed to update \"{FullFileName}\", it was already staged"), Filename);
+        return false;
+    }
+
+    FCppToolsStagedFile& File = StagedFiles.AddDefaulted_GetRef();
+    File.Filename = Filename;
+    File.Contents = Contents;
+    File.TimeStamp = TimeStamp;
+    return true;
+}
+
+bool FCppToolsFileTransaction::StageDelete(const FString& Filename, FText& OutFailReason)
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    if (bCommitted || StagedFiles.ContainsByPredicate([&Filename](const FCppToolsStagedFile& File) { return File.Filename == Filename; }))
+    {
+        OutFailReason = MakeFileFailReason(LOCTEXT("FileAlreadyStaged", "Failed to update \"{FullFileName}\", it was already staged"), Filename);
+        return false;
+    }
+    if (!FPaths::FileExists(Filename))
+    {
+        OutFailReason = MakeFileFailReason(LOCTEXT("DeletedFileMissing", "Failed to delete \"{FullFileName}\", it does not exist"), Filename);
+        return false;
+    }
+
+    FCppToolsStagedFile& File = StagedFiles.AddDefaulted_GetRef();
+    File.Filename = Filename;
+    File.bDelete = true;
+    File.TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
+    return true;
+}
+
+bool FCppToolsFileTransaction::BackupExternalWrite(const FString& Filename, FText& OutFailReason)
+{
+    if (JournalEntries.ContainsByPredicate([&Filename](const FJournalEntry& Entry) { return Entry.Filename == Filename; }))
+    {
+        return true;
+    }
+    return OpenJournal(OutFailReason) && AddJournalEntry(Filename, OutFailReason) && WriteJournal(OutFailReason);
+}
+
+bool FCppToolsFileTransaction::Validate(FText& OutFailReason) const
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    for (const FCppToolsStagedFile& File : StagedFiles)
+    {
+        if (File.bCreate && FPaths::FileExists(File.Filename))
+        {
+            OutFailReason = MakeFileFailReason(LOCTEXT("FileAlreadyExists", "\"{FullFileName}\" already exists"), File.Filename);
+            return false;
+        }
+        if (!File.bCreate && IFileManager::Get().GetTimeStamp(*File.Filename) != File.TimeStamp)
+        {
+            OutFailReason = MakeFileFailReason(LOCTEXT("FileChanged", "\"{FullFileName}\" was changed while the update was prepared"), File.Filename);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FCppToolsFileTransaction::Commit(FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(CommitFileTransaction);
+    using namespace CppToolsFileTransactionImpl;
+
+    if (bCommitted) return true;
+    if (!Validate(OutFailReason) || !OpenJournal(OutFailReason)) return false;
+
+    // Everything the commit replaces is backed up, and the journal written, before the first file is touched
+    for (const FCppToolsStagedFile& File : StagedFiles)
+    {
+        if (!AddJournalEntry(File.Filename, OutFailReason)) return false;
+
+        TArray<FString> MissingDirectories;
+        for (FString Directory = FPaths::GetPath(File.Filename); !Directory.IsEmpty() && !FPaths::DirectoryExists(Directory);
+            Directory = FPaths::GetPath(Directory))
+        {
+            MissingDirectories.Add(Directory);
+        }
+        for (int32 I = MissingDirectories.Num() - 1; I >= 0; I--)
+        {
+            CreatedDirectories.AddUnique(MissingDirectories[I]);
+        }
+    }
+    if (!WriteJournal(OutFailReason)) return false;
+
+    // Files are written in full next to their destination first, so a failure cannot leave a file partially written
+    bool bSucceeded = true;
+    for (const FCppToolsStagedFile& File : StagedFiles)
+    {
+        if (File.bDelete) continue;
+        if (!File.bCreate)
+        {
+            CppToolsUtil::TryMakeFileWriteable(File.Filename);
+        }
+        IFileManager::Get().MakeDirectory(*FPaths::GetPath(File.Filename), true);
+        if (!CppToolsUtil::SaveStringToFile(File.Contents, GetTemporaryFilename(File.Filename)))
+        {
+            OutFailReason = MakeFileFailReason(LOCTEXT("FailedToWriteStagedFile", "Failed to write \"{FullFileName}\""), File.Filename);
+            bSucceeded = false;
+            break;
+        }
+    }
+
+    if (bSucceeded)
+    {
+        for (const FCppToolsStagedFile& File : StagedFiles)
+        {
+            if (File.bDelete)
+            {
+                CppToolsUtil::TryMakeFileWriteable(File.Filename);
+                if (!IFileManager::Get().Delete(*File.Filename, false, true, true))
+                {
+                    OutFailReason = MakeFileFailReason(LOCTEXT("FailedToDeleteStagedFile", "Failed to delete \"{FullFileName}\""), File.Filename);
+                    bSucceeded = false;
+                    break;
+                }
+                continue;
+            }
+            if (!IFileManager::Get().Move(*File.Filename, *GetTemporaryFilename(File.Filename), true, true))
+            {
+                OutFailReason = MakeFileFailReason(LOCTEXT("FailedToReplaceStagedFile", "Failed to replace \"{FullFileName}\""), File.Filename);
+                bSucceeded = false;
+                break;
+            }
+        }
+    }
+
+    if (!bSucceeded)
+    {
+        FText RollbackFailReason;
+        if (!Rollback(RollbackFailReason))
+        {
+            UE_LOG(LogCppToolsFileTransaction, Error, TEXT("%s"), *RollbackFailReason.ToString());
+        }
+        return false;
+    }
+
+    UE_LOG(LogCppToolsFileTransaction, Log, TEXT("Wrote %d files"), StagedFiles.Num());
+    bCommitted = true;
+    return true;
+}
+
+bool FCppToolsFileTransaction::Rollback(FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(RollbackFileTransaction);
+
+    for (const FCppToolsStagedFile& File : StagedFiles)
+    {
+        IFileManager::Get().Delete(*GetTemporaryFilename(File.Filename), false, true, true);
+    }
+
+    const bool bSucceeded = JournalDirectory.IsEmpty() || RollbackJournal(JournalDirectory, OutFailReason);
+
+    JournalDirectory.Empty();
+    JournalEntries.Reset();
+    CreatedDirectories.Reset();
+    bCommitted = false;
+    return bSucceeded;
+}
+
+void FCppToolsFileTransaction::Finish()
+{
+    if (!JournalDirectory.IsEmpty())
+    {
+        IFileManager::Get().DeleteDirectory(*JournalDirectory, false, true);
+    }
+
+    StagedFiles.Reset();
+    JournalDirectory.Empty();
+    JournalEntries.Reset();
+    CreatedDirectories.Reset();
+    bCommitted = false;
+}
+
+TArray<FString> FCppToolsFileTransaction::GetCreatedFiles() const
+{
+    TArray<FString> Result;
+    for (const FCppToolsStagedFile& File : StagedFiles)
+    {
+        if (File.bCreate)
+        {
+            Result.Add(File.Filename);
+        }
+    }
+    return Result;
+}
+
+FString FCppToolsFileTransaction::GetJournalRootDirectory()
+{
+    return FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir() / TEXT("CppTools") / TEXT("Transactions"));
+}
+
+int32 FCppToolsFileTransaction::RecoverUnfinishedTransactions()
+{
+    CPPTOOLS_TRACE_SCOPE(RecoverUnfinishedTransactions);
+    using namespace CppToolsFileTransactionImpl;
+
+    const FString RootDirectory = GetJournalRootDirectory();
+    TArray<FString> Directories;
+    IFileManager::Get().FindFiles(Directories, *(RootDirectory / TEXT("*")), false, true);
+
+    int32 NumRecovered = 0;
+    for (const FString& Directory : Directories)
+    {
+        const FString JournalDirectory = RootDirectory / Directory;
+
+        // Transactions of another editor that is still running are not unfinished
+        FString Text;
+        TSharedPtr<FJsonObject> Journal;
+        int32 ProcessId;
+        if (CppToolsUtil::LoadFileToString(Text, JournalDirectory / JournalFilename) && FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Journal)
+            && Journal.IsValid() && Journal->TryGetNumberField(TEXT("ProcessId"), ProcessId)
+            && static_cast<uint32>(ProcessId) != FPlatformProcess::GetCurrentProcessId() && FPlatformProcess::IsApplicationRunning(static_cast<uint32>(ProcessId)))
+        {
+            continue;
+        }
+
+        FText FailReason;
+        if (RollbackJournal(JournalDirectory, FailReason))
+        {
+            UE_LOG(LogCppToolsFileTransaction, Warning, TEXT("Rolled back the unfinished changes recorded in %s"), *JournalDirectory);
+            NumRecovered++;
+        }
+        else
+        {
+            UE_LOG(LogCppToolsFileTransaction, Error, TEXT("%s"), *FailReason.ToString());
+        }
+    }
+    return NumRecovered;
+}
+
+bool FCppToolsFileTransaction::OpenJournal(FText& OutFailReason)
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    if (!JournalDirectory.IsEmpty()) return true;
+
+    const FString Directory = GetJournalRootDirectory() / FGuid::NewGuid().ToString();
+    if (!IFileManager::Get().MakeDirectory(*Directory, true))
+    {
+        OutFailReason = MakeFileFailReason(LOCTEXT("FailedToCreateJournal", "Failed to create the journal directory \"{FullFileName}\""), Directory);
+        return false;
+    }
+    JournalDirectory = Directory;
+    return true;
+}
+
+bool FCppToolsFileTransaction::AddJournalEntry(const FString& Filename, FText& OutFailReason)
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    FJournalEntry Entry;
+    Entry.Filename = Filename;
+    if (FPaths::FileExists(Filename))
+    {
+        Entry.Backup = FString::Printf(TEXT("%d.bak"), JournalEntries.Num());
+        if (IFileManager::Get().Copy(*(JournalDirectory / Entry.Backup), *Filename, true, true) != COPY_OK)
+        {
+            OutFailReason = MakeFileFailReason(LOCTEXT("FailedToBackUpFile", "Failed to back up \"{FullFileName}\""), Filename);
+            return false;
+        }
+    }
+    JournalEntries.Add(MoveTemp(Entry));
+    return true;
+}
+
+bool FCppToolsFileTransaction::WriteJournal(FText& OutFailReason) const
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    TArray<TSharedPtr<FJsonValue>> FileValues;
+    for (const FJournalEntry& Entry : JournalEntries)
+    {
+        TSharedRef<FJsonObject> FileObject = MakeShareable(new FJsonObject);
+        FileObject->SetStringField(TEXT("File"), Entry.Filename);
+        FileObject->SetStringField(TEXT("Backup"), Entry.Backup);
+        FileValues.Add(MakeShareable(new FJsonValueObject(FileObject)));
+    }
+
+    TArray<TSharedPtr<FJsonValue>> DirectoryValues;
+    for (const FString& Directory : CreatedDirectories)
+    {
+        DirectoryValues.Add(MakeShareable(new FJsonValueString(Directory)));
+    }
+
+    TSharedRef<FJsonObject> Journal = MakeShareable(new FJsonObject);
+    Journal->SetNumberField(TEXT("ProcessId"), FPlatformProcess::GetCurrentProcessId());
+    Journal->SetArrayField(TEXT("Files"), FileValues);
+    Journal->SetArrayField(TEXT("Directories"), DirectoryValues);
+
+    FString Text;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+    FJsonSerializer::Serialize(Journal, Writer);
+
+    if (!CppToolsUtil::SaveStringToFile(Text, JournalDirectory / JournalFilename))
+    {
+        OutFailReason = MakeFileFailReason(LOCTEXT("FailedToWriteJournal", "Failed to write the journal \"{FullFileName}\""), JournalDirectory / JournalFilename);
+        return false;
+    }
+    return true;
+}
+
+bool FCppToolsFileTransaction::RollbackJournal(const FString& JournalDirectory, FText& OutFailReason)
+{
+    using namespace CppToolsFileTransactionImpl;
+
+    FString Text;
+    TSharedPtr<FJsonObject> Journal;
+    if (!CppToolsUtil::LoadFileToString(Text, JournalDirectory / JournalFilename) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Journal)
+        || !Journal.IsValid())
+    {
+        // Nothing is written before the journal, so a transaction without one changed nothing
+        IFileManager::Get().DeleteDirectory(*JournalDirectory, false, true);
+        return true;
+    }
+
+    bool bSucceeded = true;
+    const TArray<TSharedPtr<FJsonValue>> FileValues = Journal->GetArrayField(TEXT("Files"));
+    for (int32 I = FileValues.Num() - 1; I >= 0; I--)
+    {
+        const TSharedPtr<FJsonObject> FileObject = FileValues[I]->AsObject();
+        const FString Filename = FileObject->GetStringField(TEXT("File"));
+        const FString Backup = FileObject->GetStringField(TEXT("Backup"));
+
+        IFileManager::Get().Delete(*GetTemporaryFilename(Filename), false, true, true);
+        if (Backup.IsEmpty())
+        {
+            IFileManager::Get().Delete(*Filename, false, true, true);
+            continue;
+        }
+
+        CppToolsUtil::TryMakeFileWriteable(Filename);
+        if (IFileManager::Get().Copy(*Filename, *(JournalDirectory / Backup), true, true) != COPY_OK)
+        {
+            OutFailReason = MakeFileFailReason(LOCTEXT("FailedToRestoreFile", "Failed to restore \"{FullFileName}\""), Filename);
+            bSucceeded = false;
+        }
+    }
+
+    // Directories are deleted innermost first, and only if nothing else was put in them since
+    const TArray<TSharedPtr<FJsonValue>> DirectoryValues = Journal->GetArrayField(TEXT("Directories"));
+    for (int32 I = DirectoryValues.Num() - 1; I >= 0; I--)
+    {
+        IFileManager::Get().DeleteDirectory(*DirectoryValues[I]->AsString(), false, false);
+    }
+
+    // A journal that could not be fully restored is kept so the rollback can be retried
+    if (bSucceeded)
+    {
+        IFileManager::Get().DeleteDirectory(*JournalDirectory, false, true);
+    }
+    return bSucceeded;
+}
+
+FString FCppToolsFileTransaction::GetTemporaryFilename(const FString& Filename)
+{
+    return Filename + TEXT(".cpptools.tmp");
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsFuzzyIndex.h"
+
+namespace CppToolsFuzzyIndexImpl
+{
+    static const int32 MatchScore = 1;
+    static const int32 ConsecutiveBonus = 5;
+    static const int32 WordStartBonus = 8;
+    static const int32 PrefixBonus = 10;
+    /** Matching the category instead of the name puts an entry after entries matching the name about as well. */
+    static const int32 CategoryPenalty = 20;
+
+    static uint64 GetCharacterBit(TCHAR Character)
+    {
+        if (Character >= TEXT('a') && Character <= TEXT('z')) return 1ull << (Character - TEXT('a'));
+        if (Character >= TEXT('0') && Character <= TEXT('9')) return 1ull << (26 + Character - TEXT('0'));
+        return 1ull << (36 + Character % 28);
+    }
+
+    static uint64 GetCharacterMask(const FString& LowerText)
+    {
+        uint64 Mask = 0;
+        for (TCHAR Character : LowerText)
+        {
+            Mask |= GetCharacterBit(Character);
+        }
+        return Mask;
+    }
+
+    /** Finds the characters starting a word: the first one, those after a separator, and those starting a run of upper case letters or digits. */
+    static TArray<bool> GetWordStarts(const FString& Text)
+    {
+        TArray<bool> WordStarts;
+        WordStarts.SetNumZeroed(Text.Len());
+        for (int32 I = 0; I < Text.Len(); I++)
+        {
+            const TCHAR Character = Text[I];
+            if (!FChar::IsAlnum(Character)) continue;
+            if (I == 0)
+            {
+                WordStarts[I] = true;
+                continue;
+            }
+            const TCHAR Previous = Text[I - 1];
+            WordStarts[I] = !FChar::IsAlnum(Previous)
+                || (FChar::IsUpper(Character) && !FChar::IsUpper(Previous))
+                || (FChar::IsDigit(Character) && !FChar::IsDigit(Previous));
+        }
+        return WordStarts;
+    }
+}
+
+int32 FCppToolsFuzzyIndex::Add(const FString& Name, const FString& Category)
+{
+    using namespace CppToolsFuzzyIndexImpl;
+
+    FEntry& Entry = Entries.AddDefaulted_GetRef();
+    Entry.Name = Name.ToLower();
+    Entry.Category = Category.ToLower();
+    Entry.NameWordStarts = GetWordStarts(Name);
+    Entry.CategoryWordStarts = GetWordStarts(Category);
+    Entry.CharacterMask = GetCharacterMask(Entry.Name) | GetCharacterMask(Entry.Category);
+    return Entries.Num() - 1;
+}
+
+void FCppToolsFuzzyIndex::Reset()
+{
+    Entries.Reset();
+}
+
+int32 FCppToolsFuzzyIndex::Score(const FString& LowerQuery, const FString& LowerText, const TArray<bool>& WordStarts)
+{
+    using namespace CppToolsFuzzyIndexImpl;
+
+    const TCHAR* Text = *LowerText;
+    const int32 TextLen = LowerText.Len();
+    int32 Score = 0;
+    int32 Position = 0;
+    int32 LastMatch = INDEX_NONE;
+    for (TCHAR Character : LowerQuery)
+    {
+        while (Position < TextLen && Text[Position] != Character)
+        {
+            Position++;
+        }
+        if (Position == TextLen) return INDEX_NONE;
+
+        Score += MatchScore;
+        if (Position == 0) Score += PrefixBonus;
+        if (WordStarts[Position]) Score += WordStartBonus;
+        if (LastMatch != INDEX_NONE && Position == LastMatch + 1) Score += ConsecutiveBonus;
+        LastMatch = Position++;
+    }
+    // Prefer the shorter of two otherwise equal matches
+    return Score * 256 + FMath::Max(0, 255 - TextLen);
+}
+
+void FCppToolsFuzzyIndex::Filter(const FString& Query, TArray<int32>& OutMatches, const TArray<int32>* Candidates) const
+{
+    using namespace CppToolsFuzzyIndexImpl;
+
+    OutMatches.Reset();
+
+    FString LowerQuery = Query.ToLower();
+    LowerQuery.ReplaceInline(TEXT(" "), TEXT(""));
+    if (LowerQuery.IsEmpty())
+    {
+        if (Candidates)
+        {
+            OutMatches = *Candidates;
+            OutMatches.Sort();
+            return;
+        }
+        OutMatches.Reserve(Entries.Num());
+        for (int32 I = 0; I < Entries.Num(); I++)
+        {
+            OutMatches.Add(I);
+        }
+        return;
+    }
+
+    const uint64 QueryMask = GetCharacterMask(LowerQuery);
+    const int32 NumCandidates = Candidates ? Candidates->Num() : Entries.Num();
+    TArray<TPair<int32, int32>> Scores;
+    Scores.Reserve(NumCandidates);
+    for (int32 I = 0; I < NumCandidates; I++)
+    {
+        const int32 EntryIndex = Candidates ? (*Candidates)[I] : I;
+        const FEntry& Entry = Entries[EntryIndex];
+        if ((Entry.CharacterMask & QueryMask) != QueryMask) continue;
+
+        const int32 NameScore = Score(LowerQuery, Entry.Name, Entry.NameWordStarts);
+        const int32 CategoryScore = Score(LowerQuery, Entry.Category, Entry.CategoryWordStarts);
+        if (NameScore < 0 && CategoryScore < 0) continue;
+
+        Scores.Emplace(EntryIndex, CategoryScore < 0 ? NameScore
+            : FMath::Max(NameScore, CategoryScore - CategoryPenalty * 256));
+    }
+
+    Scores.Sort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+    {
+        return A.Value != B.Value ? A.Value > B.Value : A.Key < B.Key;
+    });
+    OutMatches.Reserve(Scores.Num());
+    for (const TPair<int32, int32>& EntryScore : Scores)
+    {
+        OutMatches.Add(EntryScore.Key);
+    }
+}
@@ -0,0 +1,913 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsIWYU.h"
+
+#include "CppToolsBuild.h"
+#include "CppToolsDiff.h"
+#include "CppToolsPCH.h"
+#include "CppToolsTrace.h"
+#include "CppToolsUtil.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Internationalization/Regex.h"
+#include "Misc/ScopeExit.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsIWYU"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsIWYU, Log, All);
+
+namespace CppToolsIWYUImpl
+{
+    static const TCHAR* CoreMinimalInclude = TEXT("CoreMinimal.h");
+    /**
+     * The directory the header check stubs are generated in, within the module's Intermediate directory so they stay out of its
+     * source directories while Unreal Build Tool still compiles them with the module.
+     */
+    static const TCHAR* StubDirectoryName = TEXT("CppToolsIWYUCheck");
+
+    enum class ETokenKind : uint8
+    {
+        Identifier,
+        /** A number, string or character literal. */
+        Literal,
+        Punctuation,
+        /** A preprocessor directive, including any continued lines. */
+        Directive
+    };
+
+    struct FToken
+    {
+        FStringView Text;
+        ETokenKind Kind;
+    };
+
+    /** A header parsed while walking the includes of the monolithic headers. */
+    struct FParsedHeader
+    {
+        FString Filename;
+        TArray<FString> Symbols;
+        TArray<FString> Includes;
+    };
+
+    static FString NormalizePath(const FString& Path)
+    {
+        FString Result = FPaths::ConvertRelativePathToFull(Path);
+        FPaths::NormalizeFilename(Result);
+        return Result;
+    }
+
+    static bool ViewEquals(FStringView A, FStringView B)
+    {
+        return A.Len() == B.Len() && FCString::Strncmp(A.GetData(), B.GetData(), A.Len()) == 0;
+    }
+
+    static bool ViewStartsWith(FStringView View, FStringView Prefix)
+    {
+        return View.Len() >= Prefix.Len() && FCString::Strncmp(View.GetData(), Prefix.GetData(), Prefix.Len()) == 0;
+    }
+
+    static bool IsIdentifierChar(TCHAR Char)
+    {
+        return FChar::IsAlnum(Char) || Char == TEXT('_');
+    }
+
+    /** Splits the contents of a source file into tokens, skipping whitespace and comments. Punctuation is split into single characters. */
+    static void Tokenize(const FString& Contents, TArray<FToken>& OutTokens)
+    {
+        const TCHAR* Char = *Contents;
+        bool bLineStart = true;
+        while (*Char)
+        {
+            const TCHAR* TokenStart = Char;
+            if (*Char == TEXT('\n'))
+            {
+                bLineStart = true;
+                Char++;
+            }
+            else if (FChar::IsWhitespace(*Char))
+            {
+                Char++;
+            }
+            else if (Char[0] == TEXT('/') && Char[1] == TEXT('/'))
+            {
+                while (*Char && *Char != TEXT('\n')) Char++;
+            }
+            else if (Char[0] == TEXT('/') && Char[1] == TEXT('*'))
+            {
+                Char += 2;
+                while (*Char && !(Char[0] == TEXT('*') && Char[1] == TEXT('/'))) Char++;
+                if (*Char) Char += 2;
+            }
+            else if (bLineStart && *Char == TEXT('#'))
+            {
+                while (*Char && !(*Char == TEXT('\n') && Char[-1] != TEXT('\\'))) Char++;
+                OutTokens.Add({ FStringView(TokenStart, static_cast<int32>(Char - TokenStart)), ETokenKind::Directive });
+            }
+            else if (*Char == TEXT('"') || *Char == TEXT('\''))
+            {
+                const TCHAR Quote = *Char++;
+                while (*Char && *Char != Quote)
+                {
+                    if (*Char == TEXT('\\') && Char[1]) Char++;
+                    Char++;
+                }
+                if (*Char) Char++;
+                OutTokens.Add({ FStringView(TokenStart, static_cast<int32>(Char - TokenStart)), ETokenKind::Literal });
+                bLineStart = false;
+            }
+            else if (IsIdentifierChar(*Char))
+            {
+                while (IsIdentifierChar(*Char)) Char++;
+                const ETokenKind Kind = FChar::IsDigit(*TokenStart) ? ETokenKind::Literal : ETokenKind::Identifier;
+                OutTokens.Add({ FStringView(TokenStart, static_cast<int32>(Char - TokenStart)), Kind });
+                bLineStart = false;
+            }
+            else
+            {
+                Char++;
+                OutTokens.Add({ FStringView(TokenStart, 1), ETokenKind::Punctuation });
+                bLineStart = false;
+            }
+        }
+    }
+
+    static bool IsPunctuation(const FToken& Token, TCHAR Char)
+    {
+        return Token.Kind == ETokenKind::Punctuation && Token.Text[0] == Char;
+    }
+
+    static bool IsTypeKeyword(FStringView Token)
+    {
+        return ViewEquals(Token, TEXT("class")) || ViewEquals(Token, TEXT("struct")) || ViewEquals(Token, TEXT("enum")) || ViewEquals(Token, TEXT("union"));
+    }
+
+    /** Checks if a token is a macro annotating a declaration, such as ENGINE_API or MS_ALIGN. */
+    static bool IsDeclarationMacro(const FToken& Token)
+    {
+        if (Token.Kind != ETokenKind::Identifier || Token.Text.Len() < 2) return false;
+        for (int32 Index = 0; Index < Token.Text.Len(); Index++)
+        {
+            const TCHAR Char = Token.Text[Index];
+            if (!FChar::IsUpper(Char) && !FChar::IsDigit(Char) && Char != TEXT('_')) return false;
+        }
+        return true;
+    }
+
+    /** Gets the name of the type a statement ending in an opening brace defines, or an empty view. */
+    static FStringView GetDefinedType(const TArray<FToken>& Statement)
+    {
+        int32 Index = 0;
+
+        // Skip the parameters of templates, so their typename and class keywords are not mistaken for the definition
+        if (Statement.Num() > 0 && ViewEquals(Statement[0].Text, TEXT("template")))
+        {
+            int32 Depth = 0;
+            for (Index = 1; Index < Statement.Num(); Index++)
+            {
+                if (IsPunctuation(Statement[Index], TEXT('<'))) Depth++;
+                else if (IsPunctuation(Statement[Index], TEXT('>')) && --Depth == 0) break;
+            }
+            Index++;
+        }
+
+        while (Index < Statement.Num() && !(Statement[Index].Kind == ETokenKind::Identifier && IsTypeKeyword(Statement[Index].Text)))
+        {
+            // Anything but annotations before the keyword makes this a function or variable using the type
+            if (Statement[Index].Kind != ETokenKind::Identifier) return FStringView();
+            Index++;
+        }
+        if (Index >= Statement.Num()) return FStringView();
+
+        const bool bIsEnum = ViewEquals(Statement[Index].Text, TEXT("enum"));
+        Index++;
+        if (bIsEnum && Index < Statement.Num() && (ViewEquals(Statement[Index].Text, TEXT("class")) || ViewEquals(Statement[Index].Text, TEXT("struct")))) Index++;
+        while (Index < Statement.Num() && IsDeclarationMacro(Statement[Index])) Index++;
+        if (Index >= Statement.Num() || Statement[Index].Kind != ETokenKind::Identifier) return FStringView();
+
+        // Only definitions of a plain name count, not specializations, qualified names or functions returning the type
+        const FStringView Name = Statement[Index].Text;
+        const int32 AfterName = Index + 1;
+        if (AfterName == Statement.Num()) return Name;
+        if (ViewEquals(Statement[AfterName].Text, TEXT("final"))) return Name;
+        if (IsPunctuation(Statement[AfterName], TEXT(':')) && !(AfterName + 1 < Statement.Num() && IsPunctuation(Statement[AfterName + 1], TEXT(':'))))
+        {
+            return Name;
+        }
+        return FStringView();
+    }
+
+    /** Gets the name a statement ending in a semicolon declares through typedef, using or extern, or an empty view. */
+    static FStringView GetDeclaredName(const TArray<FToken>& Statement)
+    {
+        if (Statement.Num() < 2) return FStringView();
+
+        const FStringView First = Statement[0].Text;
+        if (ViewEquals(First, TEXT("using")))
+        {
+            const bool bIsAlias = Statement.Num() >= 3 && Statement[1].Kind == ETokenKind::Identifier && IsPunctuation(Statement[2], TEXT('='));
+            return bIsAlias ? Statement[1].Text : FStringView();
+        }
+        if (ViewEquals(First, TEXT("typedef")) || ViewEquals(First, TEXT("extern")))
+        {
+            for (int32 Index = Statement.Num() - 1; Index > 0; Index--)
+            {
+                if (Statement[Index].Kind == ETokenKind::Identifier) return Statement[Index].Text;
+            }
+        }
+        return FStringView();
+    }
+
+    /** Gets the macro defined by a preprocessor directive, or an empty view. */
+    static FStringView GetDefinedMacro(FStringView Directive)
+    {
+        const FStringView Define(TEXT("define"));
+        int32 Index = 1;
+        while (Index < Directive.Len() && FChar::IsWhitespace(Directive[Index])) Index++;
+        if (!ViewStartsWith(FStringView(Directive.GetData() + Index, Directive.Len() - Index), Define)) return FStringView();
+
+        Index += Define.Len();
+        while (Index < Directive.Len() && FChar::IsWhitespace(Directive[Index])) Index++;
+        const int32 NameStart = Index;
+        while (Index < Directive.Len() && IsIdentifierChar(Directive[Index])) Index++;
+        return FStringView(Directive.GetData() + NameStart, Index - NameStart);
+    }
+
+    /** Namespaces usually span many headers, except the ones wrapping the enums of UENUMs, such as EEndPlayReason. */
+    static bool IsEnumNamespace(FStringView Name)
+    {
+        return Name.Len() > 1 && Name[0] == TEXT('E') && FChar::IsUpper(Name[1]);
+    }
+
+    /** Resolves an include of a header the same way the compiler does, next to the including file first. */
+    static bool ResolveInclude(const FString& Include, const FString& IncludingFile, const FString& PreferredDirectory, const FCppToolsHeaderIndex& HeaderIndex,
+        FString& OutFilename)
+    {
+        OutFilename = NormalizePath(FPaths::GetPath(IncludingFile) / Include);
+        return FPaths::FileExists(OutFilename) || HeaderIndex.Resolve(Include, PreferredDirectory, OutFilename);
+    }
+
+    /**
+     * Parses every header included, directly or not, by the root headers that was not visited yet. Each level of includes is
+     * parsed in parallel, and the headers are returned in the order they were reached.
+     */
+    static void ParseHeaderClosure(const TArray<FString>& Roots, const FCppToolsHeaderIndex& HeaderIndex, TSet<FString>& Visited,
+        TArray<FParsedHeader>& OutHeaders)
+    {
+        TArray<FString> Frontier;
+        for (const FString& Root : Roots)
+        {
+            bool bAlreadyVisited;
+            Visited.Add(Root, &bAlreadyVisited);
+            if (!bAlreadyVisited) Frontier.Add(Root);
+        }
+
+        while (Frontier.Num() > 0)
+        {
+            TArray<FParsedHeader> Level;
+            Level.SetNum(Frontier.Num());
+            ParallelFor(Frontier.Num(), [&Frontier, &Level, &HeaderIndex](int32 Index)
+            {
+                FParsedHeader& Header = Level[Index];
+                Header.Filename = Frontier[Index];
+
+                FString Contents;
+                if (!CppToolsUtil::LoadFileToString(Contents, Header.Filename)) return;
+
+                Header.Symbols = CppToolsIWYU::ParseDeclaredSymbols(Contents);
+                for (const FString& Include : CppToolsUtil::ParseIncludes(Contents))
+                {
+                    FString IncludedFile;
+                    if (!Include.EndsWith(TEXT(".generated.h")) && ResolveInclude(Include, Header.Filename, FPaths::GetPath(Header.Filename), HeaderIndex, IncludedFile))
+                    {
+                        Header.Includes.Add(MoveTemp(IncludedFile));
+                    }
+                }
+            });
+
+            Frontier.Reset();
+            for (FParsedHeader& Header : Level)
+            {
+                for (const FString& Include : Header.Includes)
+                {
+                    bool bAlreadyVisited;
+                    Visited.Add(Include, &bAlreadyVisited);
+                    if (!bAlreadyVisited) Frontier.Add(Include);
+                }
+                OutHeaders.Add(MoveTemp(Header));
+            }
+        }
+    }
+
+    static bool ContainsInclude(const TArray<FString>& Includes, const FString& Include)
+    {
+        return Includes.ContainsByPredicate([&Include](const FString& Other) { return Other.Equals(Include, ESearchCase::IgnoreCase); });
+    }
+
+    static bool GetModuleDir(const FString& ModuleName, TSharedPtr<IPlugin> Target, FString& OutModuleDir, FString& OutBuildFilePath, FText& OutFailReason)
+    {
+        if (!CppToolsUtil::GetModuleBuildFilePath(ModuleName, Target, OutBuildFilePath))
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+            OutFailReason = FText::Format(LOCTEXT("ModuleNotFound", "Could not find the .Build.cs file of module \"{ModuleName}\""), Args);
+            return false;
+        }
+        OutModuleDir = NormalizePath(FPaths::GetPath(OutBuildFilePath));
+        return true;
+    }
+
+    static TArray<FString> FindModuleFiles(const FString& ModuleDir, const TCHAR* Extension)
+    {
+        TArray<FString> Files;
+        IFileManager::Get().FindFilesRecursive(Files, *ModuleDir, Extension, true, false, false);
+        for (FString& File : Files)
+        {
+            File = NormalizePath(File);
+        }
+        Files.Sort();
+        return Files;
+    }
+
+    /**
+     * Finds the stubs with compiler errors in the log of the build that compiled them. Unreal Build Tool logs the output of every
+     * compile action together, led by the name of the stub, and errors in a header also name the stub it was included from.
+     */
+    static TArray<bool> FindFailedStubs(const FString& BuildLog, const TArray<FString>& Stubs)
+    {
+        TMap<FString, int32> StubIndices;
+        for (int32 I = 0; I < Stubs.Num(); I++)
+        {
+            StubIndices.Add(FPaths::GetCleanFilename(Stubs[I]), I);
+        }
+
+        TArray<bool> Failed;
+        Failed.SetNumZeroed(Stubs.Num());
+        TArray<FString> Lines;
+        BuildLog.ParseIntoArrayLines(Lines);
+        int32 CurrentStub = INDEX_NONE;
+        for (const FString& Line : Lines)
+        {
+            // Stub names are identifiers followed by the extension, whatever path or punctuation surrounds them
+            int32 Extension = Line.Find(TEXT(".cpp"), ESearchCase::IgnoreCase);
+            while (Extension != INDEX_NONE)
+            {
+                int32 NameStart = Extension;
+                while (NameStart > 0 && IsIdentifierChar(Line[NameStart - 1])) NameStart--;
+                if (const int32* StubIndex = StubIndices.Find(Line.Mid(NameStart, Extension - NameStart + 4)))
+                {
+                    CurrentStub = *StubIndex;
+                }
+                Extension = Line.Find(TEXT(".cpp"), ESearchCase::IgnoreCase, ESearchDir::FromStart, Extension + 4);
+            }
+
+            if (CurrentStub != INDEX_NONE && (Line.Contains(TEXT(": error")) || Line.Contains(TEXT(": fatal error"))))
+            {
+                Failed[CurrentStub] = true;
+            }
+        }
+        return Failed;
+    }
+}
+
+void FCppToolsSymbolIndex::Build(const TArray<FString>& MonolithicHeaders, const FCppToolsHeaderIndex& HeaderIndex)
+{
+    CPPTOOLS_TRACE_SCOPE(BuildSymbolIndex);
+    using namespace CppToolsIWYUImpl;
+
+    Includes.Reset();
+
+    const FString EngineSourceDir = NormalizePath(FPaths::EngineSourceDir());
+    TSet<FString> Visited;
+
+    // Everything CoreMinimal.h declares is available through it, so its headers are walked first and map to it
+    FString CoreMinimalFile;
+    if (HeaderIndex.Resolve(CoreMinimalInclude, EngineSourceDir, CoreMinimalFile))
+    {
+        TArray<FParsedHeader> CoreHeaders;
+        ParseHeaderClosure({ CoreMinimalFile }, HeaderIndex, Visited, CoreHeaders);
+        for (const FParsedHeader& Header : CoreHeaders)
+        {
+            for (const FString& Symbol : Header.Symbols)
+            {
+                Includes.FindOrAdd(Symbol, CoreMinimalInclude);
+            }
+        }
+    }
+
+    TArray<FString> Roots;
+    for (const FString& MonolithicHeader : MonolithicHeaders)
+    {
+        FString Filename;
+        if (HeaderIndex.Resolve(MonolithicHeader, EngineSourceDir, Filename))
+        {
+            Roots.Add(Filename);
+        }
+        else
+        {
+            UE_LOG(LogCppToolsIWYU, Warning, TEXT("Could not find the monolithic header %s"), *MonolithicHeader);
+        }
+    }
+
+    // Headers reached first are the closest to the monolithic headers, so they win when a symbol is declared more than once
+    TArray<FParsedHeader> Headers;
+    ParseHeaderClosure(Roots, HeaderIndex, Visited, Headers);
+    for (const FParsedHeader& Header : Headers)
+    {
+        FString Include;
+        if (!CppToolsIWYU::GetIncludePath(Header.Filename, Include) || ContainsInclude(MonolithicHeaders, Include)) continue;
+
+        for (const FString& Symbol : Header.Symbols)
+        {
+            Includes.FindOrAdd(Symbol, Include);
+        }
+    }
+
+    UE_LOG(LogCppToolsIWYU, Log, TEXT("Indexed %d symbols declared by %d headers"), Includes.Num(), Visited.Num());
+}
+
+const FString* FCppToolsSymbolIndex::FindInclude(const FString& Symbol) const
+{
+    return Includes.Find(Symbol);
+}
+
+TArray<FString> CppToolsIWYU::ParseDeclaredSymbols(const FString& HeaderContents)
+{
+    using namespace CppToolsIWYUImpl;
+
+    TArray<FString> Result;
+    auto AddSymbol = [&Result](FStringView Symbol)
+    {
+        if (!Symbol.IsEmpty()) Result.AddUnique(FString(Symbol.Len(), Symbol.GetData()));
+    };
+
+    TArray<FToken> Tokens;
+    Tokenize(HeaderContents, Tokens);
+
+    // Whether each enclosing brace is a namespace, through which declarations are still at namespace scope
+    TArray<bool> Scopes;
+    int32 NumTypeScopes = 0;
+    // The tokens of the current statement, excluding anything within parentheses
+    TArray<FToken> Statement;
+    int32 ParenthesesDepth = 0;
+
+    for (int32 Index = 0; Index < Tokens.Num(); Index++)
+    {
+        const FToken& Token = Tokens[Index];
+        if (Token.Kind == ETokenKind::Directive)
+        {
+            AddSymbol(GetDefinedMacro(Token.Text));
+            continue;
+        }
+
+        if (IsPunctuation(Token, TEXT('(')))
+        {
+            // Macros such as DECLARE_DELEGATE_OneParam and DECLARE_LOG_CATEGORY_EXTERN declare their first argument
+            if (ParenthesesDepth == 0 && NumTypeScopes == 0 && Statement.Num() > 0 && ViewStartsWith(Statement.Last().Text, TEXT("DECLARE_"))
+                && Tokens.IsValidIndex(Index + 1) && Tokens[Index + 1].Kind == ETokenKind::Identifier)
+            {
+                AddSymbol(Tokens[Index + 1].Text);
+            }
+            ParenthesesDepth++;
+            continue;
+        }
+        if (IsPunctuation(Token, TEXT(')')))
+        {
+            ParenthesesDepth = FMath::Max(0, ParenthesesDepth - 1);
+            continue;
+        }
+        if (ParenthesesDepth > 0) continue;
+
+        if (IsPunctuation(Token, TEXT('{')))
+        {
+            bool bIsNamespace = false;
+            if (NumTypeScopes == 0)
+            {
+                if (Statement.Num() > 0 && ViewEquals(Statement[0].Text, TEXT("namespace")))
+                {
+                    bIsNamespace = true;
+                    if (Statement.Num() == 2 && IsEnumNamespace(Statement[1].Text)) AddSymbol(Statement[1].Text);
+                }
+                else if (Statement.Num() == 2 && ViewEquals(Statement[0].Text, TEXT("extern")) && Statement[1].Kind == ETokenKind::Literal)
+                {
+                    // extern "C" blocks are transparent
+                    bIsNamespace = true;
+                }
+                else
+                {
+                    AddSymbol(GetDefinedType(Statement));
+                }
+            }
+            Scopes.Add(bIsNamespace);
+            NumTypeScopes += bIsNamespace ? 0 : 1;
+            Statement.Reset();
+        }
+        else if (IsPunctuation(Token, TEXT('}')))
+        {
+            if (Scopes.Num() > 0 && !Scopes.Pop()) NumTypeScopes--;
+            Statement.Reset();
+        }
+        else if (IsPunctuation(Token, TEXT(';')))
+        {
+            if (NumTypeScopes == 0) AddSymbol(GetDeclaredName(Statement));
+            Statement.Reset();
+        }
+        else
+        {
+            Statement.Add(Token);
+        }
+    }
+
+    return Result;
+}
+
+TSet<FString> CppToolsIWYU::ParseUsedSymbols(const FString& SourceContents)
+{
+    using namespace CppToolsIWYUImpl;
+
+    TArray<FToken> Tokens;
+    Tokenize(SourceContents, Tokens);
+
+    TSet<FString> Result;
+    const FToken* Previous = nullptr;
+    const FToken* BeforePrevious = nullptr;
+    for (const FToken& Token : Tokens)
+    {
+        if (Token.Kind == ETokenKind::Directive) continue;
+
+        if (Token.Kind == ETokenKind::Identifier)
+        {
+            const bool bIsMember = Previous && (IsPunctuation(*Previous, TEXT('.'))
+                || (BeforePrevious && IsPunctuation(*Previous, TEXT('>')) && IsPunctuation(*BeforePrevious, TEXT('-')))
+                || (BeforePrevious && IsPunctuation(*Previous, TEXT(':')) && IsPunctuation(*BeforePrevious, TEXT(':'))));
+            const bool bIsForwardDeclared = Previous && Previous->Kind == ETokenKind::Identifier && IsTypeKeyword(Previous->Text);
+            if (!bIsMember && !bIsForwardDeclared)
+            {
+                Result.Emplace(FString(Token.Text.Len(), Token.Text.GetData()));
+            }
+        }
+
+        BeforePrevious = Previous;
+        Previous = &Token;
+    }
+    return Result;
+}
+
+bool CppToolsIWYU::GetIncludePath(const FString& HeaderFilename, FString& OutInclude)
+{
+    FString Path = HeaderFilename;
+    FPaths::NormalizeFilename(Path);
+
+    int32 IncludeStart = INDEX_NONE;
+    for (const TCHAR* Directory : { TEXT("/Public/"), TEXT("/Classes/") })
+    {
+        const int32 Index = Path.Find(Directory, ESearchCase::IgnoreCase, ESearchDir::FromEnd);
+        if (Index != INDEX_NONE)
+        {
+            IncludeStart = FMath::Max(IncludeStart, Index + FCString::Strlen(Directory));
+        }
+    }
+    if (IncludeStart == INDEX_NONE) return false;
+
+    OutInclude = Path.Mid(IncludeStart);
+    return true;
+}
+
+bool CppToolsIWYU::ReplaceMonolithicIncludes(FString& Contents, const TArray<FString>& MonolithicIncludes, const TArray<FString>& LegacyIncludes,
+    const FString& OwnInclude, const FCppToolsSymbolIndex& SymbolIndex)
+{
+    CPPTOOLS_TRACE_SCOPE(ReplaceMonolithicIncludes);
+    using namespace CppToolsIWYUImpl;
+
+    const TArray<FString> Present = CppToolsUtil::ParseIncludes(Contents);
+    const bool bHasMonolithic = Present.ContainsByPredicate([&MonolithicIncludes](const FString& Include) { return ContainsInclude(MonolithicIncludes, Include); });
+    const bool bHasLegacy = Present.ContainsByPredicate([&LegacyIncludes](const FString& Include) { return ContainsInclude(LegacyIncludes, Include); });
+    if (!bHasMonolithic && !bHasLegacy) return false;
+
+    // Files that only get the monolithic headers through a legacy header get CoreMinimal.h from it once it is converted too
+    TArray<FString> Needed;
+    for (const FString& Symbol : ParseUsedSymbols(Contents))
+    {
+        const FString* Include = SymbolIndex.FindInclude(Symbol);
+        if (!Include || ContainsInclude(Present, *Include) || *Include == OwnInclude) continue;
+        if (!bHasMonolithic && *Include == CoreMinimalInclude) continue;
+        Needed.AddUnique(*Include);
+    }
+    if (bHasMonolithic && !ContainsInclude(Present, CoreMinimalInclude))
+    {
+        Needed.AddUnique(CoreMinimalInclude);
+    }
+    Needed.Sort([](const FString& A, const FString& B)
+    {
+        const bool bAIsCore = A == CoreMinimalInclude;
+        const bool bBIsCore = B == CoreMinimalInclude;
+        return bAIsCore != bBIsCore ? bAIsCore : A < B;
+    });
+
+    const TCHAR* LineTerminator = Contents.Contains(TEXT("\r\n")) ? TEXT("\r\n") : TEXT("\n");
+    FString NeededLines;
+    for (const FString& Include : Needed)
+    {
+        NeededLines += TEXT("#include \"") + Include + TEXT("\"") + LineTerminator;
+    }
+
+    // The needed includes take the place of the first monolithic include, or follow the first legacy include
+    const FRegexPattern IncludePattern(TEXT("^[ \\t]*#[ \\t]*include[ \\t]*[\"<]([^\">]+)[\">]"));
+    FString Result;
+    Result.Reserve(Contents.Len() + NeededLines.Len());
+    bool bInserted = false;
+    int32 LineStart = 0;
+    while (LineStart < Contents.Len())
+    {
+        int32 LineEnd = Contents.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, LineStart);
+        LineEnd = LineEnd == INDEX_NONE ? Contents.Len() : LineEnd + 1;
+        const FString Line = Contents.Mid(LineStart, LineEnd - LineStart);
+        LineStart = LineEnd;
+
+        FRegexMatcher IncludeMatcher(IncludePattern, Line);
+        if (IncludeMatcher.FindNext())
+        {
+            const FString Include = IncludeMatcher.GetCaptureGroup(1).TrimStartAndEnd();
+            if (ContainsInclude(MonolithicIncludes, Include))
+            {
+                if (!bInserted) Result += NeededLines;
+                bInserted = true;
+                continue;
+            }
+            if (!bHasMonolithic && !bInserted && ContainsInclude(LegacyIncludes, Include))
+            {
+                Result += Line;
+                if (!Line.EndsWith(TEXT("\n"))) Result += LineTerminator;
+                Result += NeededLines;
+                bInserted = true;
+                continue;
+            }
+        }
+        Result += Line;
+    }
+
+    if (Result.Equals(Contents, ESearchCase::CaseSensitive)) return false;
+
+    Contents = MoveTemp(Result);
+    return true;
+}
+
+bool CppToolsIWYU::PlanConversion(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FCppToolsHeaderIndex& HeaderIndex,
+    const FCppToolsSymbolIndex& SymbolIndex, const FCppToolsIWYUSettings& Settings, TArray<FCppToolsFileEdit>& OutEdits, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(PlanIWYUConversion);
+    using namespace CppToolsIWYUImpl;
+
+    OutEdits.Reset();
+
+    FString ModuleDir;
+    FString BuildFilePath;
+    if (!GetModuleDir(ModuleName, Target, ModuleDir, BuildFilePath, OutFailReason)) return false;
+
+    TArray<FString> Files = FindModuleFiles(ModuleDir, TEXT("*.h"));
+    Files.Append(FindModuleFiles(ModuleDir, TEXT("*.cpp")));
+
+    TArray<FString> Contents;
+    Contents.SetNum(Files.Num());
+    TArray<bool> ReadFailed;
+    ReadFailed.SetNumZeroed(Files.Num());
+    ParallelFor(Files.Num(), [&Files, &Contents, &ReadFailed](int32 Index)
+    {
+        ReadFailed[Index] = !CppToolsUtil::LoadFileToString(Contents[Index], Files[Index]);
+    });
+    for (int32 Index = 0; Index < Files.Num(); Index++)
+    {
+        if (ReadFailed[Index])
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("FullFileName"), FText::FromString(Files[Index]));
+            OutFailReason = FText::Format(LOCTEXT("FailedToReadFile", "Failed to read \"{FullFileName}\""), Args);
+            return false;
+        }
+    }
+
+    // Find the module's own headers that include a monolithic header, directly or through another of its headers
+    TSet<FString> LegacyHeaders;
+    TArray<TArray<TPair<FString, FString>>> OwnIncludes;
+    OwnIncludes.SetNum(Files.Num());
+    for (int32 Index = 0; Index < Files.Num(); Index++)
+    {
+        for (const FString& Include : CppToolsUtil::ParseIncludes(Contents[Index]))
+        {
+            FString IncludedFile;
+            if (ContainsInclude(Settings.MonolithicHeaders, Include))
+            {
+                LegacyHeaders.Add(Files[Index]);
+            }
+            else if (ResolveInclude(Include, Files[Index], ModuleDir, HeaderIndex, IncludedFile) && IncludedFile.StartsWith(ModuleDir / TEXT("")))
+            {
+                OwnIncludes[Index].Emplace(Include, IncludedFile);
+            }
+        }
+    }
+    for (bool bChanged = true; bChanged; )
+    {
+        bChanged = false;
+        for (int32 Index = 0; Index < Files.Num(); Index++)
+        {
+            if (LegacyHeaders.Contains(Files[Index])) continue;
+            for (const TPair<FString, FString>& Include : OwnIncludes[Index])
+            {
+                if (LegacyHeaders.Contains(Include.Value))
+                {
+                    LegacyHeaders.Add(Files[Index]);
+                    bChanged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    TArray<FCppToolsFileEdit> Edits;
+    Edits.SetNum(Files.Num());
+    ParallelFor(Files.Num(), [&](int32 Index)
+    {
+        TArray<FString> LegacyIncludes;
+        for (const TPair<FString, FString>& Include : OwnIncludes[Index])
+        {
+            if (LegacyHeaders.Contains(Include.Value)) LegacyIncludes.Add(Include.Key);
+        }
+
+        FString OwnInclude;
+        if (!CppToolsIWYU::GetIncludePath(Files[Index], OwnInclude))
+        {
+            OwnInclude = FPaths::GetCleanFilename(Files[Index]);
+        }
+
+        FString NewContents = Contents[Index];
+        if (!ReplaceMonolithicIncludes(NewContents, Settings.MonolithicHeaders, LegacyIncludes, OwnInclude, SymbolIndex)) return;
+
+        FCppToolsFileEdit& Edit = Edits[Index];
+        Edit.ModuleName = ModuleName;
+        Edit.Filename = Files[Index];
+        Edit.TimeStamp = IFileManager::Get().GetTimeStamp(*Edit.Filename);
+        Edit.Diff = CppToolsDiff::MakeUnifiedDiff(Edit.Filename, Contents[Index], NewContents);
+        Edit.NewContents = MoveTemp(NewContents);
+    });
+
+    // The .Build.cs file comes first, followed by the files in the order they were found
+    FString BuildFileContents;
+    if (!CppToolsUtil::LoadFileToString(BuildFileContents, BuildFilePath))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(BuildFilePath));
+        OutFailReason = FText::Format(LOCTEXT("FailedToReadFile", "Failed to read \"{FullFileName}\""), Args);
+        return false;
+    }
+    FString NewBuildFileContents = BuildFileContents;
+    bool bBuildFileChanged = CppToolsUtil::SetModuleRulesField(NewBuildFileContents, TEXT("PCHUsage"), TEXT("PCHUsageMode.UseExplicitOrSharedPCHs"));
+    bBuildFileChanged |= CppToolsUtil::SetModuleRulesField(NewBuildFileContents, TEXT("bEnforceIWYU"), TEXT("true"));
+    if (bBuildFileChanged)
+    {
+        FCppToolsFileEdit& Edit = OutEdits.AddDefaulted_GetRef();
+        Edit.ModuleName = ModuleName;
+        Edit.Filename = BuildFilePath;
+        Edit.TimeStamp = IFileManager::Get().GetTimeStamp(*BuildFilePath);
+        Edit.Diff = CppToolsDiff::MakeUnifiedDiff(BuildFilePath, BuildFileContents, NewBuildFileContents);
+        Edit.NewContents = MoveTemp(NewBuildFileContents);
+    }
+    for (FCppToolsFileEdit& Edit : Edits)
+    {
+        if (!Edit.Filename.IsEmpty()) OutEdits.Add(MoveTemp(Edit));
+    }
+
+    UE_LOG(LogCppToolsIWYU, Log, TEXT("Module %s: %d of %d files depend on monolithic headers, %d files change"), *ModuleName,
+        LegacyHeaders.Num(), Files.Num(), OutEdits.Num());
+    return true;
+}
+
+bool CppToolsIWYU::CheckSelfContainedHeaders(const FString& ModuleName, TSharedPtr<IPlugin> Target, FCppToolsIWYUResult& OutResult, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(CheckSelfContainedHeaders);
+    using namespace CppToolsIWYUImpl;
+
+    OutResult.bCheckedHeaders = false;
+    OutResult.NumCheckedHeaders = 0;
+    OutResult.NonSelfContainedHeaders.Reset();
+    OutResult.bSourcesFailed = false;
+
+    FString ModuleDir;
+    FString BuildFilePath;
+    if (!GetModuleDir(ModuleName, Target, ModuleDir, BuildFilePath, OutFailReason)) return false;
+
+    // Stubs left behind by an interrupted check would otherwise be compiled again
+    const FString StubDir = ModuleDir / TEXT("Intermediate") / StubDirectoryName;
+    const FString BuildLogFile = FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir() / StubDirectoryName / ModuleName + TEXT(".log"));
+    IFileManager::Get().DeleteDirectory(*StubDir, false, true);
+    ON_SCOPE_EXIT
+    {
+        IFileManager::Get().DeleteDirectory(*StubDir, false, true);
+        IFileManager::Get().DeleteDirectory(*FPaths::GetPath(StubDir), false, false);
+        IFileManager::Get().Delete(*BuildLogFile, false, true, true);
+    };
+
+    const TArray<FString> Headers = FindModuleFiles(ModuleDir, TEXT("*.h"));
+    TArray<FString> Stubs;
+    for (const FString& Header : Headers)
+    {
+        FString RelativeHeader = Header;
+        FPaths::MakePathRelativeTo(RelativeHeader, *(ModuleDir / TEXT("")));
+        FString IncludePath = Header;
+        FPaths::MakePathRelativeTo(IncludePath, *(StubDir / TEXT("")));
+
+        // Stub names are kept to identifier characters so they can be found in the build log
+        FString StubName = RelativeHeader;
+        for (TCHAR& Char : StubName)
+        {
+            if (!IsIdentifierChar(Char)) Char = TEXT('_');
+        }
+
+        const FString Stub = StubDir / StubName + TEXT(".cpp");
+        const FString StubContents = FString(TEXT("// Generated by C++ Tools to check that the header compiles on its own. Deleted once the check finishes.")) + LINE_TERMINATOR
+            + TEXT("#include \"") + IncludePath + TEXT("\"") + LINE_TERMINATOR;
+        if (!CppToolsUtil::WriteOutputFile(Stub, StubContents, OutFailReason)) return false;
+        Stubs.Add(Stub);
+    }
+
+    // Without unity builds every stub is its own translation unit, and without precompiled headers nothing else is included first.
+    // All of the stubs are compiled in parallel by the one build, and the failing ones are found in its log. Nothing is linked, so the
+    // module binaries the running editor has loaded are left alone.
+    IFileManager::Get().Delete(*BuildLogFile, false, true, true);
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(BuildLogFile), true);
+    const FString Arguments = FString::Printf(TEXT("-Module=%s -DisableUnity -NoPCH -NoLink -Log=\"%s\""), *ModuleName,
+        *IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*BuildLogFile));
+    double Seconds;
+    FText BuildFailReason;
+    OutResult.bCheckedHeaders = true;
+    OutResult.NumCheckedHeaders = Headers.Num();
+    if (CppToolsBuild::RunUnrealBuildTool(Arguments, Seconds, BuildFailReason))
+    {
+        UE_LOG(LogCppToolsIWYU, Log, TEXT("Module %s: all %d headers compile on their own"), *ModuleName, Headers.Num());
+        return true;
+    }
+
+    FString BuildLog;
+    if (!CppToolsUtil::LoadFileToString(BuildLog, BuildLogFile))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(BuildLogFile));
+        OutFailReason = FText::Format(LOCTEXT("FailedToReadBuildLog", "The header check failed to build, and its log \"{FullFileName}\" could not be read"), Args);
+        return false;
+    }
+
+    const TArray<bool> FailedStubs = FindFailedStubs(BuildLog, Stubs);
+    for (int32 Index = 0; Index < Stubs.Num(); Index++)
+    {
+        if (FailedStubs[Index])
+        {
+            FString RelativeHeader = Headers[Index];
+            FPaths::MakePathRelativeTo(RelativeHeader, *(ModuleDir / TEXT("")));
+            OutResult.NonSelfContainedHeaders.Add(RelativeHeader);
+        }
+    }
+
+    // Every header compiling alone means the module's own source files are what fail without precompiled headers
+    OutResult.bSourcesFailed = OutResult.NonSelfContainedHeaders.Num() == 0;
+    UE_LOG(LogCppToolsIWYU, Log, TEXT("Module %s: %d of %d headers do not compile on their own"), *ModuleName,
+        OutResult.NonSelfContainedHeaders.Num(), Headers.Num());
+    return true;
+}
+
+bool CppToolsIWYU::ConvertModule(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FCppToolsHeaderIndex& HeaderIndex,
+    const FCppToolsSymbolIndex& SymbolIndex, const FCppToolsIWYUSettings& Settings, bool bApply, bool bCheckHeaders, bool bMeasure,
+    FCppToolsIWYUResult& OutResult, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(ConvertModuleToIWYU);
+    using namespace CppToolsIWYUImpl;
+
+    OutResult = FCppToolsIWYUResult();
+    OutResult.ModuleName = ModuleName;
+
+    // Measuring touches the source files, so it is done before the edits are planned and their time stamps taken
+    TArray<FString> SourceFiles;
+    if (bApply && bMeasure)
+    {
+        FString ModuleDir;
+        FString BuildFilePath;
+        if (!GetModuleDir(ModuleName, Target, ModuleDir, BuildFilePath, OutFailReason)) return false;
+        SourceFiles = FindModuleFiles(ModuleDir, TEXT("*.cpp"));
+
+        if (!CppToolsBuild::MeasureModuleBuild(ModuleName, SourceFiles, OutResult.SecondsBefore, OutFailReason)) return false;
+    }
+
+    if (!PlanConversion(ModuleName, Target, HeaderIndex, SymbolIndex, Settings, OutResult.Edits, OutFailReason)) return false;
+    if (bApply && !CppToolsRefactor::ApplyEdits(OutResult.Edits, OutFailReason)) return false;
+    if (bCheckHeaders && !CheckSelfContainedHeaders(ModuleName, Target, OutResult, OutFailReason)) return false;
+
+    if (bApply && bMeasure)
+    {
+        if (!CppToolsBuild::MeasureModuleBuild(ModuleName, SourceFiles, OutResult.SecondsAfter, OutFailReason)) return false;
+
+        UE_LOG(LogCppToolsIWYU, Log, TEXT("Module %s builds in %.1fs before and %.1fs after the conversion"), *ModuleName,
+            OutResult.SecondsBefore, OutResult.SecondsAfter);
+    }
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,246 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsIWYUWizard.h"
+
+#include "CppToolsUtil.h"
+
+#include "EditorStyleSet.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/SBoxPanel.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsIWYUWizard"
+
+void SCppToolsIWYUWizard::Construct(const FArguments& InArgs)
+{
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        AvailableModules.Add(MakeShareable(new FString(Module.Key.ModuleName)));
+        ModuleTargets.Add(Module.Key.ModuleName, Module.Value);
+    }
+    AvailableModules.Sort([](const TSharedPtr<FString>& A, const TSharedPtr<FString>& B) { return *A < *B; });
+    if (AvailableModules.Num() > 0)
+    {
+        SelectedModule = AvailableModules[0];
+    }
+
+    ChildSlot
+    [
+        SNew(SBorder)
+        .Padding(8)
+        .BorderImage(FEditorStyle::GetBrush("Docking.Tab.ContentAreaBrush"))
+        [
+            SNew(SVerticalBox)
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 8)
+            [
+                SNew(STextBlock)
+                .Text(LOCTEXT("WizardDescription", "Replaces the monolithic includes of a module, such as Engine.h, with the headers declaring what each file uses, and switches the module to explicit or shared precompiled headers with bEnforceIWYU. Preview the conversion to see a diff of every file it edits, then convert the module to write them."))
+                .AutoWrapText(true)
+            ]
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 8)
+            [
+                SNew(SHorizontalBox)
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.0f)
+                [
+                    SNew(SComboBox<TSharedPtr<FString>>)
+                    .ToolTipText(LOCTEXT("ModuleToolTip", "Choose the module to convert"))
+                    .OptionsSource(&AvailableModules)
+                    .InitiallySelectedItem(SelectedModule)
+                    .OnSelectionChanged(this, &SCppToolsIWYUWizard::OnModuleChanged)
+                    .OnGenerateWidget(this, &SCppToolsIWYUWizard::MakeWidgetForModuleCombo)
+                    [
+                        SNew(STextBlock)
+                        .Text(this, &SCppToolsIWYUWizard::OnGetModuleComboText)
+                    ]
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .VAlign(VAlign_Center)
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SCheckBox)
+                    .ToolTipText(LOCTEXT("CheckHeadersToolTip", "Compiles every header of the module on its own once it is converted, without precompiled headers and unity builds"))
+                    .IsChecked(bCheckHeaders ? ECheckBoxState::Checked : ECheckBoxState::Unchecked)
+                    .OnCheckStateChanged_Lambda([this](ECheckBoxState NewState) { bCheckHeaders = NewState == ECheckBoxState::Checked; })
+                    [
+                        SNew(STextBlock)
+                        .Text(LOCTEXT("CheckHeaders", "Check Headers"))
+                    ]
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .VAlign(VAlign_Center)
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SCheckBox)
+                    .ToolTipText(LOCTEXT("MeasureToolTip", "Rebuilds the module before and after the conversion to measure its build time"))
+                    .IsChecked(bMeasure ? ECheckBoxState::Checked : ECheckBoxState::Unchecked)
+                    .OnCheckStateChanged_Lambda([this](ECheckBoxState NewState) { bMeasure = NewState == ECheckBoxState::Checked; })
+                    [
+                        SNew(STextBlock)
+                        .Text(LOCTEXT("Measure", "Measure Build Time"))
+                    ]
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("Preview", "Preview"))
+                    .IsEnabled_Lambda([this]() { return SelectedModule.IsValid(); })
+                    .OnClicked(this, &SCppToolsIWYUWizard::PreviewClicked)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("Convert", "Convert"))
+                    .ToolTipText(LOCTEXT("ConvertToolTip", "Writes the previewed conversion"))
+                    .IsEnabled(this, &SCppToolsIWYUWizard::CanConvert)
+                    .OnClicked(this, &SCppToolsIWYUWizard::ConvertClicked)
+                ]
+            ]
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 4)
+            [
+                SAssignNew(StatusTextBlock, STextBlock)
+                .AutoWrapText(true)
+            ]
+
+            + SVerticalBox::Slot()
+            .FillHeight(1.0f)
+            [
+                SAssignNew(DiffTextBox, SMultiLineEditableTextBox)
+                .IsReadOnly(true)
+                .Font(FCoreStyle::GetDefaultFontStyle("Mono", 9))
+            ]
+        ]
+    ];
+}
+
+FReply SCppToolsIWYUWizard::PreviewClicked()
+{
+    BuildIndices();
+
+    FText FailReason;
+    if (!CppToolsIWYU::PlanConversion(*SelectedModule, ModuleTargets.FindRef(*SelectedModule), HeaderIndex, SymbolIndex, Settings, Edits, FailReason))
+    {
+        ClearPreview();
+        StatusTextBlock->SetText(FailReason);
+        return FReply::Handled();
+    }
+
+    StatusTextBlock->SetText(Edits.Num() > 0
+        ? FText::Format(LOCTEXT("PreviewStatus", "{0} files change"), Edits.Num())
+        : LOCTEXT("AlreadyConverted", "The module does not include any monolithic headers and already enforces IWYU"));
+    DiffTextBox->SetText(FText::FromString(CppToolsRefactor::JoinDiffs(Edits)));
+    return FReply::Handled();
+}
+
+FReply SCppToolsIWYUWizard::ConvertClicked()
+{
+    FCppToolsIWYUResult Result;
+    FText FailReason;
+    if (!CppToolsIWYU::ConvertModule(*SelectedModule, ModuleTargets.FindRef(*SelectedModule), HeaderIndex, SymbolIndex, Settings, true, bCheckHeaders,
+        bMeasure, Result, FailReason))
+    {
+        CppToolsUtil::PushNotification(FText::Format(LOCTEXT("ConvertFailed", "Failed to convert {0}. {1}"), FText::FromString(*SelectedModule), FailReason),
+            SNotificationItem::CS_Fail);
+        return FReply::Handled();
+    }
+
+    TArray<FText> Lines;
+    Lines.Add(FText::Format(LOCTEXT("Converted", "Converted {0}, writing {1} files."), FText::FromString(Result.ModuleName), Result.Edits.Num()));
+    if (Result.bCheckedHeaders)
+    {
+        if (Result.NonSelfContainedHeaders.Num() > 0)
+        {
+            Lines.Add(FText::Format(LOCTEXT("NonSelfContainedHeaders", "{0} of {1} headers do not compile on their own: {2}"),
+                Result.NonSelfContainedHeaders.Num(), Result.NumCheckedHeaders, FText::FromString(FString::Join(Result.NonSelfContainedHeaders, TEXT(", ")))));
+        }
+        else if (Result.bSourcesFailed)
+        {
+            Lines.Add(LOCTEXT("SourcesFailed", "Every header compiles on its own, but the module's source files do not build without precompiled headers and unity builds."));
+        }
+        else
+        {
+            Lines.Add(FText::Format(LOCTEXT("SelfContainedHeaders", "All {0} headers compile on their own."), Result.NumCheckedHeaders));
+        }
+    }
+    if (bMeasure)
+    {
+        Lines.Add(FText::Format(LOCTEXT("BuildTimes", "The module built in {0} seconds before and {1} seconds after the conversion."),
+            FText::AsNumber(Result.SecondsBefore), FText::AsNumber(Result.SecondsAfter)));
+    }
+
+    const bool bSucceeded = Result.NonSelfContainedHeaders.Num() == 0 && !Result.bSourcesFailed;
+    CppToolsUtil::PushNotification(Lines[0], bSucceeded ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+
+    Edits.Reset();
+    DiffTextBox->SetText(FText::GetEmpty());
+    StatusTextBlock->SetText(FText::Join(FText::FromString(TEXT(" ")), Lines));
+    return FReply::Handled();
+}
+
+bool SCppToolsIWYUWizard::CanConvert() const
+{
+    return SelectedModule.IsValid() && Edits.Num() > 0;
+}
+
+void SCppToolsIWYUWizard::ClearPreview()
+{
+    Edits.Reset();
+    StatusTextBlock->SetText(FText::GetEmpty());
+    DiffTextBox->SetText(FText::GetEmpty());
+}
+
+void SCppToolsIWYUWizard::BuildIndices()
+{
+    if (bIndicesBuilt) return;
+
+    FScopedSlowTask SlowTask(2, LOCTEXT("BuildingIndices", "Indexing the headers of the monolithic includes..."));
+    SlowTask.MakeDialog();
+
+    SlowTask.EnterProgressFrame();
+    HeaderIndex.Build(CppToolsPCH::GetIncludeSearchDirectories());
+    SlowTask.EnterProgressFrame();
+    SymbolIndex.Build(Settings.MonolithicHeaders, HeaderIndex);
+    bIndicesBuilt = true;
+}
+
+FText SCppToolsIWYUWizard::OnGetModuleComboText() const
+{
+    return SelectedModule.IsValid() ? FText::FromString(*SelectedModule) : LOCTEXT("NoModules", "No Modules");
+}
+
+void SCppToolsIWYUWizard::OnModuleChanged(TSharedPtr<FString> Value, ESelectInfo::Type SelectInfo)
+{
+    SelectedModule = Value;
+    ClearPreview();
+}
+
+TSharedRef<SWidget> SCppToolsIWYUWizard::MakeWidgetForModuleCombo(TSharedPtr<FString> Value)
+{
+    return SNew(STextBlock)
+        .Text(FText::FromString(*Value));
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,661 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsManifest.h"
+
+#include "CppToolsBinaryCache.h"
+#include "CppToolsBuild.h"
+#include "CppToolsDescriptorSession.h"
+#include "CppToolsDiff.h"
+#include "CppToolsFileTransaction.h"
+#include "CppToolsModuleGraph.h"
+#include "CppToolsTemplate.h"
+#include "CppToolsTrace.h"
+#include "CppToolsUtil.h"
+
+#include "HAL/FileManager.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsManifest"
+
+namespace CppToolsManifestImpl
+{
+    /** An existing file edited by a plan, with the contents it was read with. */
+    struct FEditedFile
+    {
+        FString ModuleName;
+        FString OldContents;
+        FString Contents;
+        FDateTime TimeStamp;
+    };
+
+    static FText MakeManifestError(const FString& Filename, const FText& Error)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+        Args.Add(TEXT("Error"), Error);
+        return FText::Format(LOCTEXT("InvalidManifest", "Invalid manifest \"{FullFileName}\": {Error}"), Args);
+    }
+
+    static bool ReadStringArray(const FJsonObject& Object, const FString& FieldName, TArray<FString>& OutStrings)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Values;
+        if (!Object.TryGetArrayField(FieldName, Values)) return false;
+
+        for (const TSharedPtr<FJsonValue>& Value : *Values)
+        {
+            OutStrings.AddUnique(Value->AsString());
+        }
+        return true;
+    }
+
+    static TArray<TSharedPtr<FJsonValue>> MakeStringValues(const TArray<FString>& Strings)
+    {
+        TArray<TSharedPtr<FJsonValue>> Values;
+        for (const FString& String : Strings)
+        {
+            Values.Add(MakeShareable(new FJsonValueString(String)));
+        }
+        return Values;
+    }
+
+    /** Writes the modules of a descriptor the way the descriptor file lists them. */
+    static FString WriteModules(const TArray<FModuleDescriptor>& Modules)
+    {
+        FString Text;
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+        Writer->WriteObjectStart();
+        FModuleDescriptor::WriteArray(Writer.Get(), TEXT("Modules"), Modules);
+        Writer->WriteObjectEnd();
+        Writer->Close();
+        return Text;
+    }
+
+    /**
+     * Makes the dependency lists of a .Build.cs file match a module of the manifest. Only the dependencies that are missing,
+     * superfluous or in the wrong list are touched. Returns false if a dependency has no list to go into.
+     */
+    static bool ReconcileDependencies(FString& Contents, const FCppToolsManifestModule& Module, bool& bOutChanged)
+    {
+        const TArray<FString> CurrentPublic = CppToolsUtil::ParseModuleDependencies(Contents, false);
+        const TArray<FString> CurrentAll = CppToolsUtil::ParseModuleDependencies(Contents, true);
+
+        TArray<FString> Dependencies = CurrentAll;
+        for (const FString& Dependency : Module.PublicDependencies) Dependencies.AddUnique(Dependency);
+        for (const FString& Dependency : Module.PrivateDependencies) Dependencies.AddUnique(Dependency);
+
+        for (const FString& Dependency : Dependencies)
+        {
+            const bool bPublic = CurrentPublic.Contains(Dependency);
+            // A dependency listed in both lists counts as private as well, so it is cleaned up
+            const bool bPrivate = CurrentAll.FilterByPredicate([&Dependency](const FString& Other) { return Other == Dependency; }).Num()
+                > (bPublic ? 1 : 0);
+            const bool bWantPublic = Module.PublicDependencies.Contains(Dependency);
+            const bool bWantPrivate = !bWantPublic && Module.PrivateDependencies.Contains(Dependency);
+            if (bPublic == bWantPublic && bPrivate == bWantPrivate) continue;
+
+            if (bPublic || bPrivate)
+            {
+                CppToolsUtil::RemoveDependencyFromBuildFile(Contents, Dependency);
+            }
+            if ((bWantPublic || bWantPrivate) && !CppToolsUtil::InsertDependencyIntoBuildFile(Contents, Dependency, bWantPrivate))
+            {
+                return false;
+            }
+            bOutChanged = true;
+        }
+        return true;
+    }
+}
+
+FString FCppToolsManifestPlan::GetDiff() const
+{
+    return CppToolsRefactor::JoinDiffs(CreatedFiles) + CppToolsRefactor::JoinDiffs(Edits) + DescriptorDiff;
+}
+
+FString CppToolsManifest::GetDefaultManifestPath()
+{
+    return FPaths::ProjectDir() / TEXT("CppToolsManifest.json");
+}
+
+bool CppToolsManifest::ReadManifest(const FString& Filename, FCppToolsManifest& OutManifest, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(ReadManifest);
+    using namespace CppToolsManifestImpl;
+
+    OutManifest.Modules.Reset();
+
+    FString Text;
+    if (!CppToolsUtil::LoadFileToString(Text, Filename))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+        OutFailReason = FText::Format(LOCTEXT("FailedToReadManifest", "Failed to read \"{FullFileName}\""), Args);
+        return false;
+    }
+
+    TSharedPtr<FJsonObject> Root;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+    const TArray<TSharedPtr<FJsonValue>>* ModuleValues;
+    if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || !Root->TryGetArrayField(TEXT("Modules"), ModuleValues))
+    {
+        OutFailReason = MakeManifestError(Filename, LOCTEXT("NoModulesArray", "expected an object with a Modules array"));
+        return false;
+    }
+
+    TSet<FString> ModuleNames;
+    for (const TSharedPtr<FJsonValue>& ModuleValue : *ModuleValues)
+    {
+        const TSharedPtr<FJsonObject>* ModuleObject;
+        if (!ModuleValue->TryGetObject(ModuleObject))
+        {
+            OutFailReason = MakeManifestError(Filename, LOCTEXT("ModuleNotObject", "every module must be an object"));
+            return false;
+        }
+
+        FCppToolsManifestModule& Module = OutManifest.Modules.AddDefaulted_GetRef();
+        Module.Name = (*ModuleObject)->GetStringField(TEXT("Name"));
+        Module.Plugin = (*ModuleObject)->HasField(TEXT("Plugin")) ? (*ModuleObject)->GetStringField(TEXT("Plugin")) : FString();
+
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Module"), FText::FromString(Module.Name));
+        Args.Add(TEXT("Plugin"), FText::FromString(Module.Plugin));
+
+        if (Module.Name.IsEmpty())
+        {
+            OutFailReason = MakeManifestError(Filename, LOCTEXT("ModuleWithoutName", "a module has no Name"));
+            return false;
+        }
+        bool bDuplicate;
+        ModuleNames.Add(Module.Name, &bDuplicate);
+        if (bDuplicate)
+        {
+            OutFailReason = MakeManifestError(Filename, FText::Format(LOCTEXT("DuplicateModule", "{Module} is declared more than once"), Args));
+            return false;
+        }
+        if (!Module.Plugin.IsEmpty() && !CppToolsUtil::FindProjectPlugin(Module.Plugin).IsValid())
+        {
+            OutFailReason = MakeManifestError(Filename, FText::Format(LOCTEXT("UnknownPlugin", "{Module} belongs to {Plugin}, which is not a plugin of the project"), Args));
+            return false;
+        }
+
+        Module.Type = (*ModuleObject)->HasField(TEXT("Type"))
+            ? EHostType::FromString(*(*ModuleObject)->GetStringField(TEXT("Type")))
+            : EHostType::Runtime;
+        if (Module.Type == EHostType::Max)
+        {
+            OutFailReason = MakeManifestError(Filename, FText::Format(LOCTEXT("InvalidModuleType", "{Module} has an invalid Type"), Args));
+            return false;
+        }
+
+        Module.LoadingPhase = (*ModuleObject)->HasField(TEXT("LoadingPhase"))
+            ? ELoadingPhase::FromString(*(*ModuleObject)->GetStringField(TEXT("LoadingPhase")))
+            : ELoadingPhase::Default;
+        if (Module.LoadingPhase == ELoadingPhase::Max)
+        {
+            OutFailReason = MakeManifestError(Filename, FText::Format(LOCTEXT("InvalidLoadingPhase", "{Module} has an invalid LoadingPhase"), Args));
+            return false;
+        }
+
+        // Either dependency list declares both, so a module with only public dependencies can leave out the private list
+        const bool bHasPublic = ReadStringArray(**ModuleObject, TEXT("PublicDependencies"), Module.PublicDependencies);
+        const bool bHasPrivate = ReadStringArray(**ModuleObject, TEXT("PrivateDependencies"), Module.PrivateDependencies);
+        Module.bHasDependencies = bHasPublic || bHasPrivate;
+
+        Module.bHasTargets = ReadStringArray(**ModuleObject, TEXT("Targets"), Module.Targets);
+        if (Module.bHasTargets && !Module.Plugin.IsEmpty())
+        {
+            OutFailReason = MakeManifestError(Filename, FText::Format(LOCTEXT("PluginModuleTargets",
+                "{Module} belongs to {Plugin}, whose modules are built through its descriptor rather than listed in targets"), Args));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CppToolsManifest::WriteManifest(const FString& Filename, const FCppToolsManifest& Manifest, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(WriteManifest);
+    using namespace CppToolsManifestImpl;
+
+    TArray<FCppToolsManifestModule> Modules = Manifest.Modules;
+    Modules.Sort([](const FCppToolsManifestModule& A, const FCppToolsManifestModule& B)
+    {
+        return A.Plugin != B.Plugin ? A.Plugin < B.Plugin : A.Name < B.Name;
+    });
+
+    TArray<TSharedPtr<FJsonValue>> ModuleValues;
+    for (const FCppToolsManifestModule& Module : Modules)
+    {
+        TSharedRef<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+        ModuleObject->SetStringField(TEXT("Name"), Module.Name);
+        if (!Module.Plugin.IsEmpty())
+        {
+            ModuleObject->SetStringField(TEXT("Plugin"), Module.Plugin);
+        }
+        ModuleObject->SetStringField(TEXT("Type"), EHostType::ToString(Module.Type));
+        ModuleObject->SetStringField(TEXT("LoadingPhase"), ELoadingPhase::ToString(Module.LoadingPhase));
+        if (Module.bHasDependencies)
+        {
+            TArray<FString> PublicDependencies = Module.PublicDependencies;
+            TArray<FString> PrivateDependencies = Module.PrivateDependencies;
+            PublicDependencies.Sort();
+            PrivateDependencies.Sort();
+            ModuleObject->SetArrayField(TEXT("PublicDependencies"), MakeStringValues(PublicDependencies));
+            ModuleObject->SetArrayField(TEXT("PrivateDependencies"), MakeStringValues(PrivateDependencies));
+        }
+        if (Module.bHasTargets)
+        {
+            TArray<FString> Targets = Module.Targets;
+            Targets.Sort();
+            ModuleObject->SetArrayField(TEXT("Targets"), MakeStringValues(Targets));
+        }
+        ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+    }
+
+    TSharedRef<FJsonObject> Root = MakeShareable(new FJsonObject);
+    Root->SetArrayField(TEXT("Modules"), ModuleValues);
+
+    FString Text;
+    TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Text);
+    FJsonSerializer::Serialize(Root, Writer);
+
+    // Capturing a project that did not change leaves the file as it is
+    FString OldText;
+    if (CppToolsUtil::LoadFileToString(OldText, Filename) && OldText == Text) return true;
+    return CppToolsUtil::WriteOutputFile(Filename, Text, OutFailReason);
+}
+
+bool CppToolsManifest::CaptureManifest(FCppToolsManifest& OutManifest, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(CaptureManifest);
+
+    OutManifest.Modules.Reset();
+
+    const TArray<FCppToolsTargetInfo> Targets = CppToolsModuleGraph::ReadProjectTargets();
+    FCppToolsDescriptorSession Session;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& ContextModule : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        FCppToolsManifestModule& Module = OutManifest.Modules.AddDefaulted_GetRef();
+        Module.Name = ContextModule.Key.ModuleName;
+        Module.Plugin = ContextModule.Value.IsValid() ? ContextModule.Value->GetName() : FString();
+        Module.Type = ContextModule.Key.ModuleType;
+
+        const TArray<FModuleDescriptor>* Descriptors = Session.GetModules(ContextModule.Value, OutFailReason);
+        if (!Descriptors) return false;
+        if (const FModuleDescriptor* Descriptor = Descriptors->FindByPredicate([&Module](const FModuleDescriptor& Other) { return Other.Name == FName(*Module.Name); }))
+        {
+            Module.LoadingPhase = Descriptor->LoadingPhase;
+        }
+
+        FString BuildFile;
+        FString Contents;
+        if (CppToolsUtil::GetModuleBuildFilePath(Module.Name, ContextModule.Value, BuildFile) && CppToolsUtil::LoadFileToString(Contents, BuildFile))
+        {
+            Module.bHasDependencies = true;
+            Module.PublicDependencies = CppToolsUtil::ParseModuleDependencies(Contents, false);
+            for (const FString& Dependency : CppToolsUtil::ParseModuleDependencies(Contents, true))
+            {
+                if (!Module.PublicDependencies.Contains(Dependency))
+                {
+                    Module.PrivateDependencies.AddUnique(Dependency);
+                }
+            }
+        }
+
+        if (!ContextModule.Value.IsValid())
+        {
+            Module.bHasTargets = true;
+            for (const FCppToolsTargetInfo& Target : Targets)
+            {
+                if (Target.ExtraModuleNames.Contains(Module.Name))
+                {
+                    Module.Targets.Add(Target.Name);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool CppToolsManifest::PlanReconcile(const FCppToolsManifest& Manifest, FCppToolsManifestPlan& OutPlan, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(PlanManifestReconcile);
+    using namespace CppToolsManifestImpl;
+
+    OutPlan = FCppToolsManifestPlan();
+
+    TMap<FString, TPair<FModuleContextInfo, TSharedPtr<IPlugin>>> ExistingModules;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        ExistingModules.Add(Module.Key.ModuleName, Module);
+    }
+
+    TMap<FString, FCppToolsTargetInfo> Targets;
+    for (FCppToolsTargetInfo& Target : CppToolsModuleGraph::ReadProjectTargets())
+    {
+        Targets.Add(Target.Name, MoveTemp(Target));
+    }
+
+    TSharedPtr<const FCppToolsTemplate> BuildFileTemplate;
+    TSharedPtr<const FCppToolsTemplate> HeaderTemplate;
+    TSharedPtr<const FCppToolsTemplate> SourceTemplate;
+
+    // Several modules can edit the same .Target.cs file, so every file is read once and edited in place
+    TMap<FString, FEditedFile> EditedFiles;
+    auto GetEditedFile = [&EditedFiles, &OutFailReason](const FString& Filename, const FString& ModuleName) -> FEditedFile*
+    {
+        if (FEditedFile* File = EditedFiles.Find(Filename)) return File;
+
+        FEditedFile File;
+        File.ModuleName = ModuleName;
+        File.TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
+        if (!CppToolsUtil::LoadFileToString(File.OldContents, Filename))
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+            OutFailReason = FText::Format(LOCTEXT("FailedToReadFile", "Failed to read \"{FullFileName}\""), Args);
+            return nullptr;
+        }
+        File.Contents = File.OldContents;
+        return &EditedFiles.Add(Filename, MoveTemp(File));
+    };
+
+    FCppToolsDescriptorSession Descriptors;
+    TSet<FString> ListedModules;
+    for (const FCppToolsManifestModule& Module : Manifest.Modules)
+    {
+        ListedModules.Add(Module.Name);
+        const TSharedPtr<IPlugin> Plugin = Module.Plugin.IsEmpty() ? nullptr : CppToolsUtil::FindProjectPlugin(Module.Plugin);
+
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Module"), FText::FromString(Module.Name));
+        Args.Add(TEXT("Plugin"), FText::FromString(Module.Plugin));
+
+        bool bChanged = false;
+        const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>* Existing = ExistingModules.Find(Module.Name);
+        if (Existing)
+        {
+            const FString ExistingPlugin = Existing->Value.IsValid() ? Existing->Value->GetName() : FString();
+            if (ExistingPlugin != Module.Plugin)
+            {
+                Args.Add(TEXT("ExistingPlugin"), Existing->Value.IsValid() ? FText::FromString(ExistingPlugin) : FText::FromString(FApp::GetProjectName()));
+                OutFailReason = FText::Format(LOCTEXT("ModuleOwnerChanged", "{Module} belongs to {ExistingPlugin}, and modules cannot be moved to another owner"), Args);
+                return false;
+            }
+
+            const TArray<FModuleDescriptor>* DescriptorModules = Descriptors.GetModules(Plugin, OutFailReason);
+            if (!DescriptorModules) return false;
+            const FModuleDescriptor* Descriptor = DescriptorModules->FindByPredicate([&Module](const FModuleDescriptor& Other) { return Other.Name == FName(*Module.Name); });
+            if (!Descriptor || Descriptor->Type != Module.Type || Descriptor->LoadingPhase != Module.LoadingPhase)
+            {
+                OutPlan.DescriptorModules.Add(Module);
+                bChanged = true;
+            }
+
+            if (Module.bHasDependencies)
+            {
+                FString BuildFile;
+                if (!CppToolsUtil::GetModuleBuildFilePath(Module.Name, Plugin, BuildFile))
+                {
+                    OutFailReason = FText::Format(LOCTEXT("NoBuildFile", "Failed to find the .Build.cs file of {Module}"), Args);
+                    return false;
+                }
+                FEditedFile* File = GetEditedFile(BuildFile, Module.Name);
+                if (!File) return false;
+                if (!ReconcileDependencies(File->Contents, Module, bChanged))
+                {
+                    Args.Add(TEXT("FullFileName"), FText::FromString(BuildFile));
+                    OutFailReason = FText::Format(LOCTEXT("FailedToInsertDependency", "Failed to update \"{FullFileName}\", it has no dependency list"), Args);
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            // A new module, whose sources are created unless they were already written without adding the module to its descriptor
+            const FString ModulePath = CppToolsUtil::GetNewModulePath(Module.Name, Plugin);
+            const FString BuildFile = ModulePath / Module.Name + TEXT(".Build.cs");
+            if (!FPaths::FileExists(BuildFile))
+            {
+                if (!BuildFileTemplate.IsValid())
+                {
+                    BuildFileTemplate = FCppToolsTemplate::Load(TEXT("Module.Build.cs.template"), OutFailReason);
+                    HeaderTemplate = FCppToolsTemplate::Load(TEXT("Module.h.template"), OutFailReason);
+                    SourceTemplate = FCppToolsTemplate::Load(TEXT("Module.cpp.template"), OutFailReason);
+                    if (!BuildFileTemplate.IsValid() || !HeaderTemplate.IsValid() || !SourceTemplate.IsValid()) return false;
+                }
+
+                TArray<FString> PublicDependencies = Module.PublicDependencies;
+                TArray<FString> PrivateDependencies = Module.PrivateDependencies;
+                if (!Module.bHasDependencies)
+                {
+                    CppToolsUtil::GetNewModuleDependencies(PublicDependencies, PrivateDependencies);
+                }
+
+                auto AddCreatedFile = [&OutPlan, &Module](const FString& Filename, FString&& Contents)
+                {
+                    FCppToolsFileEdit& Edit = OutPlan.CreatedFiles.AddDefaulted_GetRef();
+                    Edit.ModuleName = Module.Name;
+                    Edit.Filename = Filename;
+                    Edit.Diff = CppToolsDiff::MakeUnifiedDiff(Filename, FString(), Contents);
+                    Edit.NewContents = MoveTemp(Contents);
+                };
+                AddCreatedFile(BuildFile, CppToolsUtil::RenderModuleBuildFile(*BuildFileTemplate, Module.Name, PublicDependencies, PrivateDependencies, false));
+                AddCreatedFile(ModulePath / TEXT("Public") / Module.Name + TEXT(".h"), CppToolsUtil::RenderModuleHeaderFile(*HeaderTemplate, Module.Name, TArray<FString>()));
+                AddCreatedFile(ModulePath / TEXT("Private") / Module.Name + TEXT(".cpp"), CppToolsUtil::RenderModuleCPPFile(*SourceTemplate, Module.Name, FString(), FString()));
+            }
+            else if (Module.bHasDependencies)
+            {
+                FEditedFile* File = GetEditedFile(BuildFile, Module.Name);
+                if (!File) return false;
+                if (!ReconcileDependencies(File->Contents, Module, bChanged))
+                {
+                    Args.Add(TEXT("FullFileName"), FText::FromString(BuildFile));
+                    OutFailReason = FText::Format(LOCTEXT("FailedToInsertDependency", "Failed to update \"{FullFileName}\", it has no dependency list"), Args);
+                    return false;
+                }
+            }
+
+            OutPlan.DescriptorModules.Add(Module);
+            bChanged = true;
+
+            // New game modules without targets go into the primary target, as they do when generated
+            if (!Plugin.IsValid() && !Module.bHasTargets)
+            {
+                const FString TargetFile = CppToolsUtil::GetPrimaryTargetFilePath(!CppToolsModuleGraph::IsModuleTypeInTarget(Module.Type, false));
+                FEditedFile* File = GetEditedFile(TargetFile, Module.Name);
+                if (!File) return false;
+                if (!CppToolsUtil::ParseTargetExtraModules(File->Contents).Contains(Module.Name) && !CppToolsUtil::InsertModuleIntoTargetFile(File->Contents, Module.Name))
+                {
+                    Args.Add(TEXT("FullFileName"), FText::FromString(TargetFile));
+                    OutFailReason = FText::Format(LOCTEXT("FailedToUpdateTarget", "Failed to update \"{FullFileName}\", it has no ExtraModuleNames list"), Args);
+                    return false;
+                }
+            }
+        }
+
+        if (Module.bHasTargets)
+        {
+            for (const FString& TargetName : Module.Targets)
+            {
+                if (!Targets.Contains(TargetName))
+                {
+                    Args.Add(TEXT("Target"), FText::FromString(TargetName));
+                    OutFailReason = FText::Format(LOCTEXT("UnknownTarget", "{Module} is listed in {Target}, which is not a target of the project"), Args);
+                    return false;
+                }
+            }
+
+            for (const TPair<FString, FCppToolsTargetInfo>& Target : Targets)
+            {
+                const bool bListed = Target.Value.ExtraModuleNames.Contains(Module.Name);
+                const bool bWanted = Module.Targets.Contains(Target.Key);
+                if (bListed == bWanted) continue;
+
+                FEditedFile* File = GetEditedFile(Target.Value.Filename, Target.Key);
+                if (!File) return false;
+                if (bWanted ? !CppToolsUtil::InsertModuleIntoTargetFile(File->Contents, Module.Name) : !CppToolsUtil::RemoveModuleFromTargetFile(File->Contents, Module.Name))
+                {
+                    Args.Add(TEXT("FullFileName"), FText::FromString(Target.Value.Filename));
+                    OutFailReason = FText::Format(LOCTEXT("FailedToUpdateTarget", "Failed to update \"{FullFileName}\", it has no ExtraModuleNames list"), Args);
+                    return false;
+                }
+                bChanged = true;
+            }
+        }
+
+        if (bChanged)
+        {
+            OutPlan.ChangedModules.Add(Module.Name, Module.Plugin);
+        }
+    }
+
+    for (const TPair<FString, TPair<FModuleContextInfo, TSharedPtr<IPlugin>>>& Module : ExistingModules)
+    {
+        if (!ListedModules.Contains(Module.Key))
+        {
+            OutPlan.UnlistedModules.Add(Module.Key);
+        }
+    }
+    OutPlan.UnlistedModules.Sort();
+
+    // Only files whose contents end up different are edited, which leaves out edits that cancel out
+    for (TPair<FString, FEditedFile>& File : EditedFiles)
+    {
+        if (File.Value.Contents == File.Value.OldContents) continue;
+
+        FCppToolsFileEdit& Edit = OutPlan.Edits.AddDefaulted_GetRef();
+        Edit.ModuleName = File.Value.ModuleName;
+        Edit.Filename = File.Key;
+        Edit.Diff = CppToolsDiff::MakeUnifiedDiff(File.Key, File.Value.OldContents, File.Value.Contents);
+        Edit.NewContents = MoveTemp(File.Value.Contents);
+        Edit.TimeStamp = File.Value.TimeStamp;
+    }
+    OutPlan.Edits.Sort([](const FCppToolsFileEdit& A, const FCppToolsFileEdit& B) { return A.Filename < B.Filename; });
+
+    // The descriptor edits are previewed on a copy of the loaded descriptors, which are saved by the engine when the plan is applied
+    if (OutPlan.DescriptorModules.Num() > 0)
+    {
+        FCppToolsDescriptorSession Edited = Descriptors;
+        if (!StageDescriptorModules(Edited, OutPlan.DescriptorModules, OutFailReason)) return false;
+
+        TSet<FString> Owners;
+        for (const FCppToolsManifestModule& Module : OutPlan.DescriptorModules)
+        {
+            bool bAlreadyDiffed;
+            Owners.Add(Module.Plugin, &bAlreadyDiffed);
+            if (bAlreadyDiffed) continue;
+
+            const TSharedPtr<IPlugin> Plugin = Module.Plugin.IsEmpty() ? nullptr : CppToolsUtil::FindProjectPlugin(Module.Plugin);
+            const TArray<FModuleDescriptor>* OldModules = Descriptors.GetModules(Plugin, OutFailReason);
+            const TArray<FModuleDescriptor>* NewModules = Edited.GetModules(Plugin, OutFailReason);
+            if (!OldModules || !NewModules) return false;
+
+            const FString Filename = Plugin.IsValid() ? Plugin->GetDescriptorFileName() : FPaths::GetProjectFilePath();
+            OutPlan.DescriptorDiff += CppToolsDiff::MakeUnifiedDiff(Filename, WriteModules(*OldModules), WriteModules(*NewModules));
+        }
+    }
+    return true;
+}
+
+bool CppToolsManifest::ApplyPlan(const FCppToolsManifestPlan& Plan, bool bBuild, TArray<FString>& OutBuiltModules, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(ApplyManifestPlan);
+
+    OutBuiltModules.Reset();
+    if (Plan.IsEmpty()) return true;
+
+    FCppToolsFileTransaction Transaction;
+    for (const FCppToolsFileEdit& Created : Plan.CreatedFiles)
+    {
+        if (!Transaction.StageCreate(Created.Filename, Created.NewContents, OutFailReason)) return false;
+    }
+    for (const FCppToolsFileEdit& Edit : Plan.Edits)
+    {
+        if (!Transaction.StageReplace(Edit.Filename, Edit.NewContents, Edit.TimeStamp, OutFailReason)) return false;
+    }
+    if (!Transaction.Commit(OutFailReason)) return false;
+
+    // The descriptors are saved by the engine, so they are backed up in the transaction's journal to be rolled back with the files
+    if (Plan.DescriptorModules.Num() > 0)
+    {
+        FCppToolsDescriptorSession Session;
+        if (!StageDescriptorModules(Session, Plan.DescriptorModules, OutFailReason) || !Session.Commit(OutFailReason, &Transaction))
+        {
+            FText RollbackFailReason;
+            if (!Transaction.Rollback(RollbackFailReason))
+            {
+                CppToolsUtil::PushNotification(RollbackFailReason, SNotificationItem::CS_Fail);
+            }
+            return false;
+        }
+    }
+    Transaction.Finish();
+
+    if (!bBuild) return true;
+
+    // Only the changed modules are built, and the ones whose binaries the cache has are restored instead
+    for (const TPair<FString, FString>& Module : Plan.ChangedModules)
+    {
+        const TSharedPtr<IPlugin> Plugin = Module.Value.IsEmpty() ? nullptr : CppToolsUtil::FindProjectPlugin(Module.Value);
+        if (!CppToolsBinaryCache::TryRestoreModule(Module.Key, Plugin))
+        {
+            OutBuiltModules.Add(Module.Key);
+        }
+    }
+
+    double BuildSeconds;
+    if (!CppToolsBuild::BuildModules(OutBuiltModules, BuildSeconds, OutFailReason)) return false;
+
+    FModuleManager::Get().ResetModulePathsCache();
+    return true;
+}
+
+bool CppToolsManifest::StageDescriptorModules(FCppToolsDescriptorSession& Session, const TArray<FCppToolsManifestModule>& Modules, FText& OutFailReason)
+{
+    TMap<FString, TArray<FModuleDescriptor>> AddedModules;
+    for (const FCppToolsManifestModule& Module : Modules)
+    {
+        const TSharedPtr<IPlugin> Plugin = Module.Plugin.IsEmpty() ? nullptr : CppToolsUtil::FindProjectPlugin(Module.Plugin);
+        const TArray<FModuleDescriptor>* Existing = Session.GetModules(Plugin, OutFailReason);
+        if (!Existing) return false;
+
+        const FName ModuleName(*Module.Name);
+        if (!Existing->ContainsByPredicate([ModuleName](const FModuleDescriptor& Other) { return Other.Name == ModuleName; }))
+        {
+            AddedModules.FindOrAdd(Module.Plugin).Add(FModuleDescriptor(ModuleName, Module.Type, Module.LoadingPhase));
+            continue;
+        }
+
+        auto SetModule = [&Module, ModuleName](TArray<FModuleDescriptor>& DescriptorModules)
+        {
+            for (FModuleDescriptor& Descriptor : DescriptorModules)
+            {
+                if (Descriptor.Name != ModuleName) continue;
+
+                const bool bChanged = Descriptor.Type != Module.Type || Descriptor.LoadingPhase != Module.LoadingPhase;
+                Descriptor.Type = Module.Type;
+                Descriptor.LoadingPhase = Module.LoadingPhase;
+                return bChanged;
+            }
+            return false;
+        };
+        const bool bModified = Plugin.IsValid()
+            ? Session.ModifyPlugin(Plugin, [&SetModule](FPluginDescriptor& Descriptor) { return SetModule(Descriptor.Modules); }, OutFailReason)
+            : Session.ModifyProject([&SetModule](FProjectDescriptor& Descriptor) { return SetModule(Descriptor.Modules); }, OutFailReason);
+        if (!bModified) return false;
+    }
+
+    for (const TPair<FString, TArray<FModuleDescriptor>>& Added : AddedModules)
+    {
+        const TSharedPtr<IPlugin> Plugin = Added.Key.IsEmpty() ? nullptr : CppToolsUtil::FindProjectPlugin(Added.Key);
+        if (!Session.AppendModules(Plugin, Added.Value, OutFailReason)) return false;
+    }
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,247 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsMemoryReport.h"
+
+#include "CppToolsUtil.h"
+
+#include "EditorStyleSet.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/SBoxPanel.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsMemoryReport"
+
+namespace CppToolsMemoryReportImpl
+{
+    static const FName ModuleColumn(TEXT("Module"));
+    static const FName TagColumn(TEXT("Tag"));
+    static const FName LiveColumn(TEXT("Live"));
+    static const FName PeakColumn(TEXT("Peak"));
+}
+
+/** A row of the module list, with one cell per column. Cells read the module as they paint, so they follow each sample. */
+class SCppToolsMemoryReportRow : public SMultiColumnTableRow<TSharedPtr<FCppToolsModuleMemory>>
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsMemoryReportRow) {}
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FCppToolsModuleMemory> InModule)
+    {
+        Module = InModule;
+        SMultiColumnTableRow<TSharedPtr<FCppToolsModuleMemory>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+    }
+
+    virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+    {
+        using namespace CppToolsMemoryReportImpl;
+
+        TSharedPtr<FCppToolsModuleMemory> RowModule = Module;
+        if (ColumnName == ModuleColumn)
+        {
+            return SNew(STextBlock)
+                .Text(FText::FromString(Module->ModuleName))
+                .ToolTipText(FText::FromString(CppToolsMemoryTags::GetTagMacroName(Module->ModuleName)));
+        }
+        if (ColumnName == TagColumn)
+        {
+            return SNew(STextBlock)
+                .Text(FText::AsNumber(Module->TagIndex));
+        }
+        if (ColumnName == LiveColumn)
+        {
+            return SNew(STextBlock)
+                .Text_Lambda([RowModule]() { return FText::AsMemory(RowModule->LiveBytes); });
+        }
+        return SNew(STextBlock)
+            .Text_Lambda([RowModule]() { return FText::AsMemory(RowModule->PeakBytes); });
+    }
+
+private:
+
+    TSharedPtr<FCppToolsModuleMemory> Module;
+
+};
+
+void SCppToolsMemoryReport::Construct(const FArguments& InArgs)
+{
+    using namespace CppToolsMemoryReportImpl;
+
+    ChildSlot
+    [
+        SNew(SBorder)
+        .Padding(8)
+        .BorderImage(FEditorStyle::GetBrush("Docking.Tab.ContentAreaBrush"))
+        [
+            SNew(SVerticalBox)
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 8)
+            [
+                SNew(SHorizontalBox)
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.0f)
+                .VAlign(VAlign_Center)
+                [
+                    SNew(STextBlock)
+                    .Text(this, &SCppToolsMemoryReport::GetStatusText)
+                    .AutoWrapText(true)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("ResetPeaks", "Reset Peaks"))
+                    .OnClicked(this, &SCppToolsMemoryReport::ResetPeaksClicked)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("SaveSnapshot", "Save Snapshot"))
+                    .ToolTipText(LOCTEXT("SaveSnapshotToolTip", "Saves the live and peak memory of every module to a CSV file, to compare with other builds"))
+                    .OnClicked(this, &SCppToolsMemoryReport::SaveSnapshotClicked)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("OpenFolder", "Open Snapshot Folder"))
+                    .OnClicked(this, &SCppToolsMemoryReport::OpenFolderClicked)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("Refresh", "Refresh"))
+                    .OnClicked(this, &SCppToolsMemoryReport::RefreshClicked)
+                ]
+            ]
+
+            + SVerticalBox::Slot()
+            .FillHeight(1.0f)
+            [
+                SAssignNew(ModuleList, SListView<TSharedPtr<FCppToolsModuleMemory>>)
+                .ListItemsSource(&Modules)
+                .OnGenerateRow(this, &SCppToolsMemoryReport::MakeModuleRow)
+                .HeaderRow
+                (
+                    SNew(SHeaderRow)
+                    + SHeaderRow::Column(ModuleColumn).DefaultLabel(LOCTEXT("ModuleColumn", "Module")).FillWidth(2.0f)
+                    + SHeaderRow::Column(TagColumn).DefaultLabel(LOCTEXT("TagColumn", "Tag")).FillWidth(0.5f)
+                    + SHeaderRow::Column(LiveColumn).DefaultLabel(LOCTEXT("LiveColumn", "Live")).FillWidth(1.0f)
+                    + SHeaderRow::Column(PeakColumn).DefaultLabel(LOCTEXT("PeakColumn", "Peak")).FillWidth(1.0f)
+                )
+            ]
+        ]
+    ];
+
+    Refresh();
+    RegisterActiveTimer(InArgs._SampleInterval, FWidgetActiveTimerDelegate::CreateSP(this, &SCppToolsMemoryReport::Sample));
+}
+
+void SCppToolsMemoryReport::Refresh()
+{
+    Modules.Reset();
+    for (const TPair<FString, int32>& Tag : CppToolsMemoryTags::GetProjectTags())
+    {
+        TSharedPtr<FCppToolsModuleMemory> Module = MakeShareable(new FCppToolsModuleMemory);
+        Module->ModuleName = Tag.Key;
+        Module->TagIndex = Tag.Value;
+        Modules.Add(Module);
+    }
+    Sample(0.0, 0.0f);
+}
+
+EActiveTimerReturnType SCppToolsMemoryReport::Sample(double InCurrentTime, float InDeltaTime)
+{
+    for (const TSharedPtr<FCppToolsModuleMemory>& Module : Modules)
+    {
+        CppToolsMemoryTags::Sample(*Module);
+    }
+    Modules.Sort([](const TSharedPtr<FCppToolsModuleMemory>& A, const TSharedPtr<FCppToolsModuleMemory>& B)
+    {
+        return A->LiveBytes != B->LiveBytes ? A->LiveBytes > B->LiveBytes : A->ModuleName < B->ModuleName;
+    });
+    ModuleList->RequestListRefresh();
+    return EActiveTimerReturnType::Continue;
+}
+
+FText SCppToolsMemoryReport::GetStatusText() const
+{
+    if (!CppToolsMemoryTags::IsTrackingEnabled())
+    {
+        return LOCTEXT("TrackingDisabled", "The Low-Level Memory Tracker is off. Start the editor with -LLM to track memory by module.");
+    }
+    if (Modules.Num() == 0)
+    {
+        return LOCTEXT("NoTaggedModules", "No module has an LLM tag. New modules get one with the \"Add LLM memory tag\" option.");
+    }
+    if (!LastSnapshotFile.IsEmpty())
+    {
+        return FText::Format(LOCTEXT("SavedSnapshot", "Memory of {0} modules. Saved {1}"), Modules.Num(), FText::FromString(FPaths::GetCleanFilename(LastSnapshotFile)));
+    }
+    return FText::Format(LOCTEXT("ModuleMemory", "Memory of {0} modules, peaks since the window opened."), Modules.Num());
+}
+
+FReply SCppToolsMemoryReport::RefreshClicked()
+{
+    Refresh();
+    return FReply::Handled();
+}
+
+FReply SCppToolsMemoryReport::ResetPeaksClicked()
+{
+    for (const TSharedPtr<FCppToolsModuleMemory>& Module : Modules)
+    {
+        Module->PeakBytes = Module->LiveBytes;
+    }
+    return FReply::Handled();
+}
+
+FReply SCppToolsMemoryReport::SaveSnapshotClicked()
+{
+    TArray<FCppToolsModuleMemory> Snapshot;
+    for (const TSharedPtr<FCppToolsModuleMemory>& Module : Modules)
+    {
+        Snapshot.Add(*Module);
+    }
+
+    FText FailReason;
+    if (!CppToolsMemoryTags::WriteSnapshot(Snapshot, LastSnapshotFile, FailReason))
+    {
+        LastSnapshotFile.Reset();
+        CppToolsUtil::PushNotification(FailReason, SNotificationItem::CS_Fail);
+    }
+    return FReply::Handled();
+}
+
+FReply SCppToolsMemoryReport::OpenFolderClicked()
+{
+    const FString SnapshotDirectory = FPaths::ConvertRelativePathToFull(CppToolsMemoryTags::GetSnapshotDirectory());
+    IFileManager::Get().MakeDirectory(*SnapshotDirectory, true);
+    FPlatformProcess::ExploreFolder(*SnapshotDirectory);
+    return FReply::Handled();
+}
+
+TSharedRef<ITableRow> SCppToolsMemoryReport::MakeModuleRow(TSharedPtr<FCppToolsModuleMemory> Module, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(SCppToolsMemoryReportRow, OwnerTable, Module);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsMemoryTags.h"
+
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/LowLevelMemTracker.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsMemoryTags"
+
+namespace CppToolsMemoryTagsImpl
+{
+    /** The start of the tag macro's definition, which is followed by the tag index. Generated and parsed headers must agree on it. */
+    static FString GetTagDefinitionPrefix(const FString& ModuleName)
+    {
+        return FString::Printf(TEXT("#define %s ((ELLMTag)((int32)ELLMTag::ProjectTagStart + "), *CppToolsMemoryTags::GetTagMacroName(ModuleName));
+    }
+
+    static FString GetStatName(const FString& ModuleName)
+    {
+        return FString::Printf(TEXT("STAT_%sLLM"), *ModuleName);
+    }
+}
+
+FString CppToolsMemoryTags::GetTagMacroName(const FString& ModuleName)
+{
+    return ModuleName.ToUpper() + TEXT("_LLM_TAG");
+}
+
+int32 CppToolsMemoryTags::ParseTagIndex(const FString& HeaderContents, const FString& ModuleName)
+{
+    using namespace CppToolsMemoryTagsImpl;
+
+    const FString Prefix = GetTagDefinitionPrefix(ModuleName);
+    const int32 PrefixStart = HeaderContents.Find(Prefix, ESearchCase::CaseSensitive);
+    if (PrefixStart == INDEX_NONE) return INDEX_NONE;
+
+    int32 Index = 0;
+    int32 NumDigits = 0;
+    for (int32 I = PrefixStart + Prefix.Len(); I < HeaderContents.Len() && FChar::IsDigit(HeaderContents[I]); I++, NumDigits++)
+    {
+        Index = Index * 10 + (HeaderContents[I] - TEXT('0'));
+    }
+    return NumDigits > 0 && Index < MaxProjectTags ? Index : INDEX_NONE;
+}
+
+TMap<FString, int32> CppToolsMemoryTags::GetProjectTags()
+{
+    CPPTOOLS_TRACE_SCOPE(GetProjectTags);
+
+    TMap<FString, int32> Tags;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        const FString& ModuleName = Module.Key.ModuleName;
+        FString HeaderContents;
+        if (!FFileHelper::LoadFileToString(HeaderContents, *(Module.Key.ModuleSourcePath / TEXT("Public") / ModuleName + TEXT(".h")))) continue;
+
+        const int32 TagIndex = ParseTagIndex(HeaderContents, ModuleName);
+        if (TagIndex != INDEX_NONE)
+        {
+            Tags.Add(ModuleName, TagIndex);
+        }
+    }
+    return Tags;
+}
+
+int32 CppToolsMemoryTags::FindFreeTagIndex(const TMap<FString, int32>& UsedTags)
+{
+    TBitArray<> Used(false, MaxProjectTags);
+    for (const TPair<FString, int32>& Tag : UsedTags)
+    {
+        Used[Tag.Value] = true;
+    }
+    return Used.Find(false);
+}
+
+FString CppToolsMemoryTags::RenderTagDeclaration(const FString& ModuleName, int32 TagIndex)
+{
+    using namespace CppToolsMemoryTagsImpl;
+
+    return FString::Printf(TEXT("\n\n/** The Low-Level Memory Tracker tag of the %s module. Use LLM_SCOPE(%s) to attribute allocations to the module. */\n%s%d))"),
+        *ModuleName, *GetTagMacroName(ModuleName), *GetTagDefinitionPrefix(ModuleName), TagIndex);
+}
+
+FString CppToolsMemoryTags::RenderTagDefinition(const FString& ModuleName)
+{
+    using namespace CppToolsMemoryTagsImpl;
+
+    return FString::Printf(TEXT("\n#if ENABLE_LOW_LEVEL_MEM_TRACKER\n#include \"HAL/LowLevelMemStats.h\"\n\nDECLARE_LLM_MEMORY_STAT(TEXT(\"%s\"), %s, STATGROUP_LLMFULL);\n#endif\n"),
+        *ModuleName, *GetStatName(ModuleName));
+}
+
+FString CppToolsMemoryTags::RenderTagScope(const FString& ModuleName)
+{
+    using namespace CppToolsMemoryTagsImpl;
+
+    const FString MacroName = GetTagMacroName(ModuleName);
+    return FString::Printf(TEXT("#if ENABLE_LOW_LEVEL_MEM_TRACKER\n\tFLowLevelMemTracker::Get().RegisterProjectTag((int32)%s, TEXT(\"%s\"), GET_STATFNAME(%s), NAME_None);\n#endif\n\tLLM_SCOPE(%s);\n"),
+        *MacroName, *ModuleName, *GetStatName(ModuleName), *MacroName);
+}
+
+bool CppToolsMemoryTags::IsTrackingEnabled()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    return FLowLevelMemTracker::IsEnabled();
+#else
+    return false;
+#endif
+}
+
+void CppToolsMemoryTags::Sample(FCppToolsModuleMemory& Module)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    if (!FLowLevelMemTracker::IsEnabled()) return;
+
+    const ELLMTag Tag = (ELLMTag)((int32)ELLMTag::ProjectTagStart + Module.TagIndex);
+    Module.LiveBytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, Tag);
+    Module.PeakBytes = FMath::Max(Module.PeakBytes, Module.LiveBytes);
+#endif
+}
+
+FString CppToolsMemoryTags::GetSnapshotDirectory()
+{
+    return FPaths::ProjectSavedDir() / TEXT("CppTools") / TEXT("Memory");
+}
+
+bool CppToolsMemoryTags::WriteSnapshot(const TArray<FCppToolsModuleMemory>& Modules, FString& OutFilename, FText& OutFailReason)
+{
+    OutFilename = GetSnapshotDirectory() / FString::Printf(TEXT("ModuleMemory-%s-%s.csv"),
+        LexToString(FApp::GetBuildConfiguration()), *FDateTime::Now().ToString());
+
+    FString Csv = TEXT("Module,Tag,LiveBytes,PeakBytes\n");
+    for (const FCppToolsModuleMemory& Module : Modules)
+    {
+        Csv += FString::Printf(TEXT("%s,%d,%lld,%lld\n"), *Module.ModuleName, Module.TagIndex, Module.LiveBytes, Module.PeakBytes);
+    }
+
+    if (!FFileHelper::SaveStringToFile(Csv, *OutFilename))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(OutFilename));
+        OutFailReason = FText::Format(LOCTEXT("FailedToWriteSnapshot", "Failed to write \"{FullFileName}\""), Args);
+        return false;
+    }
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,572 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsModuleGraph.h"
+
+#include "CppToolsUtil.h"
+#include "CppToolsDescriptorSession.h"
+#include "CppToolsDiff.h"
+#include "CppToolsFileTransaction.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+#include "Interfaces/IProjectManager.h"
+#include "Internationalization/Regex.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsModuleGraph"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsModuleGraph, Log, All);
+
+namespace CppToolsModuleGraphImpl
+{
+    static TArray<FString> FindModuleFiles(const FString& ModulePath, const FString& Extensions)
+    {
+        TArray<FString> Files;
+        TArray<FString> ExtensionList;
+        Extensions.ParseIntoArray(ExtensionList, TEXT(";"));
+        for (const FString& Extension : ExtensionList)
+        {
+            IFileManager::Get().FindFilesRecursive(Files, *ModulePath, *Extension, true, false, false);
+        }
+        return Files;
+    }
+
+    /** Walks the dependencies of the specified modules, returning every module reached. */
+    static TSet<FString> Walk(const TMap<FString, FCppToolsModuleNode>& Modules, const TArray<FString>& Roots, bool bUsedDependenciesOnly)
+    {
+        TSet<FString> Reached;
+        TArray<FString> Pending = Roots;
+        while (Pending.Num() > 0)
+        {
+            const FString ModuleName = Pending.Pop(false);
+            bool bAlreadyReached;
+            Reached.Add(ModuleName, &bAlreadyReached);
+            if (bAlreadyReached) continue;
+
+            const FCppToolsModuleNode* Module = Modules.Find(ModuleName);
+            if (Module == nullptr) continue;
+
+            for (const FString& Dependency : Module->Dependencies)
+            {
+                if (!bUsedDependenciesOnly || !Module->UnusedDependencies.Contains(Dependency))
+                {
+                    Pending.Add(Dependency);
+                }
+            }
+        }
+        return Reached;
+    }
+
+    /** Gets why a target of the specified type does not build a module for the platform, or an empty string if it does. */
+    static FString GetExclusionReason(const FCppToolsModuleNode& Module, const FModuleDescriptor* Descriptor, const FString& TargetType, const FString& Platform)
+    {
+        if (Module.Plugin.IsValid())
+        {
+            if (!Module.Plugin->IsEnabled())
+            {
+                return FString::Printf(TEXT("Its plugin %s is disabled"), *Module.Plugin->GetName());
+            }
+            const TArray<FString>& SupportedPlatforms = Module.Plugin->GetDescriptor().SupportedTargetPlatforms;
+            if (SupportedPlatforms.Num() > 0 && !SupportedPlatforms.Contains(Platform))
+            {
+                return FString::Printf(TEXT("Its plugin %s does not support %s"), *Module.Plugin->GetName(), *Platform);
+            }
+        }
+        if (!CppToolsModuleGraph::IsModuleTypeInTargetType(Module.Type, TargetType))
+        {
+            return FString::Printf(TEXT("%s modules are not built by %s targets"), EHostType::ToString(Module.Type), *TargetType);
+        }
+        if (Descriptor != nullptr)
+        {
+            if (Descriptor->WhitelistPlatforms.Num() > 0 && !Descriptor->WhitelistPlatforms.Contains(Platform))
+            {
+                return FString::Printf(TEXT("Its WhitelistPlatforms do not include %s"), *Platform);
+            }
+            if (Descriptor->BlacklistPlatforms.Contains(Platform))
+            {
+                return FString::Printf(TEXT("Its BlacklistPlatforms include %s"), *Platform);
+            }
+        }
+        return FString();
+    }
+}
+
+TArray<FCppToolsTargetInfo> CppToolsModuleGraph::ReadProjectTargets()
+{
+    CPPTOOLS_TRACE_SCOPE(ReadProjectTargets);
+
+    TArray<FCppToolsTargetInfo> Targets;
+    const FRegexPattern TypePattern(TEXT("Type\\s*=\\s*TargetType\\.(\\w+)"));
+    for (const FString& TargetFile : CppToolsUtil::GetProjectTargetFiles())
+    {
+        FString Contents;
+        if (!CppToolsUtil::LoadFileToString(Contents, TargetFile)) continue;
+
+        FCppToolsTargetInfo& Target = Targets.AddDefaulted_GetRef();
+        Target.Filename = TargetFile;
+        Target.Name = FPaths::GetCleanFilename(TargetFile).LeftChop(FString(TEXT(".Target.cs")).Len());
+        Target.ExtraModuleNames = CppToolsUtil::ParseTargetExtraModules(Contents);
+
+        FRegexMatcher TypeMatcher(TypePattern, CppToolsUtil::StripCStyleComments(Contents));
+        Target.Type = TypeMatcher.FindNext() ? TypeMatcher.GetCaptureGroup(1) : FString(TEXT("Game"));
+        Target.bEditor = Target.Type == TEXT("Editor");
+    }
+    return Targets;
+}
+
+TMap<FString, FCppToolsModuleNode> CppToolsModuleGraph::BuildGraph()
+{
+    CPPTOOLS_TRACE_SCOPE(BuildModuleGraph);
+    using namespace CppToolsModuleGraphImpl;
+
+    TMap<FString, FCppToolsModuleNode> Modules;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        FCppToolsModuleNode& Node = Modules.Add(Module.Key.ModuleName);
+        Node.Name = Module.Key.ModuleName;
+        Node.Plugin = Module.Value;
+        Node.Type = Module.Key.ModuleType;
+        Node.Path = Module.Key.ModuleSourcePath;
+    }
+
+    // The public headers of every module, by their path relative to the public directory and by their file name
+    TMap<FString, TArray<FString>> HeaderModules;
+    for (const TPair<FString, FCppToolsModuleNode>& Module : Modules)
+    {
+        for (const TCHAR* PublicDir : { TEXT("Public"), TEXT("Classes") })
+        {
+            const FString PublicPath = Module.Value.Path / PublicDir / TEXT("");
+            for (FString HeaderFile : FindModuleFiles(PublicPath, TEXT("*.h;*.inl")))
+            {
+                FPaths::MakePathRelativeTo(HeaderFile, *PublicPath);
+                HeaderModules.FindOrAdd(HeaderFile.ToLower()).AddUnique(Module.Key);
+                HeaderModules.FindOrAdd(FPaths::GetCleanFilename(HeaderFile).ToLower()).AddUnique(Module.Key);
+            }
+        }
+    }
+
+    for (TPair<FString, FCppToolsModuleNode>& Module : Modules)
+    {
+        FCppToolsModuleNode& Node = Module.Value;
+        for (const FString& Dependency : CppToolsUtil::GetModuleDependencies(Node.Name, Node.Plugin, true))
+        {
+            if (Modules.Contains(Dependency) && Dependency != Node.Name)
+            {
+                Node.Dependencies.AddUnique(Dependency);
+            }
+        }
+        if (Node.Dependencies.Num() == 0) continue;
+
+        TSet<FString> IncludedModules;
+        for (const FString& File : FindModuleFiles(Node.Path, TEXT("*.h;*.inl;*.cpp")))
+        {
+            FString Contents;
+            if (!CppToolsUtil::LoadFileToString(Contents, File)) continue;
+
+            for (FString Include : CppToolsUtil::ParseIncludes(Contents))
+            {
+                FPaths::NormalizeFilename(Include);
+                const TArray<FString>* Owners = HeaderModules.Find(Include.ToLower());
+                if (Owners == nullptr)
+                {
+                    Owners = HeaderModules.Find(FPaths::GetCleanFilename(Include).ToLower());
+                }
+                if (Owners != nullptr)
+                {
+                    IncludedModules.Append(*Owners);
+                }
+            }
+        }
+
+        for (const FString& Dependency : Node.Dependencies)
+        {
+            if (!IncludedModules.Contains(Dependency))
+            {
+                Node.UnusedDependencies.Add(Dependency);
+            }
+        }
+    }
+
+    for (TPair<FString, FCppToolsModuleNode>& Module : Modules)
+    {
+        Module.Value.RootReason = GetModuleRootReason(Module.Value);
+    }
+    return Modules;
+}
+
+TMap<FString, FModuleDescriptor> CppToolsModuleGraph::GetModuleDescriptors(const TMap<FString, FCppToolsModuleNode>& Modules)
+{
+    TMap<FString, FModuleDescriptor> Descriptors;
+    if (const FProjectDescriptor* Project = IProjectManager::Get().GetCurrentProject())
+    {
+        for (const FModuleDescriptor& Descriptor : Project->Modules)
+        {
+            Descriptors.Add(Descriptor.Name.ToString(), Descriptor);
+        }
+    }
+
+    TSet<TSharedPtr<IPlugin>> Plugins;
+    for (const TPair<FString, FCppToolsModuleNode>& Module : Modules)
+    {
+        if (Module.Value.Plugin.IsValid())
+        {
+            Plugins.Add(Module.Value.Plugin);
+        }
+    }
+    for (const TSharedPtr<IPlugin>& Plugin : Plugins)
+    {
+        for (const FModuleDescriptor& Descriptor : Plugin->GetDescriptor().Modules)
+        {
+            Descriptors.Add(Descriptor.Name.ToString(), Descriptor);
+        }
+    }
+    return Descriptors;
+}
+
+bool CppToolsModuleGraph::IsModuleTypeInTarget(EHostType::Type Type, bool bEditorTarget)
+{
+    return IsModuleTypeInTargetType(Type, bEditorTarget ? TEXT("Editor") : TEXT("Game"));
+}
+
+bool CppToolsModuleGraph::IsModuleTypeInTargetType(EHostType::Type Type, const FString& TargetType)
+{
+    const bool bEditorTarget = TargetType == TEXT("Editor");
+    const bool bProgramTarget = TargetType == TEXT("Program");
+    switch (Type)
+    {
+    case EHostType::Runtime:
+    case EHostType::RuntimeNoCommandlet:
+        return !bProgramTarget;
+    case EHostType::RuntimeAndProgram:
+        return true;
+    case EHostType::CookedOnly:
+        return !bEditorTarget && !bProgramTarget;
+    case EHostType::ServerOnly:
+        return TargetType != TEXT("Client") && !bProgramTarget;
+    case EHostType::ClientOnly:
+    case EHostType::ClientOnlyNoCommandlet:
+        return TargetType != TEXT("Server") && !bProgramTarget;
+    case EHostType::Developer:
+        return bEditorTarget || bProgramTarget;
+    case EHostType::Program:
+        return bProgramTarget;
+    default:
+        // Editor and uncooked modules
+        return bEditorTarget;
+    }
+}
+
+FCppToolsDeadModuleReport CppToolsModuleGraph::FindDeadModules(const TArray<FString>& ExtraRoots)
+{
+    CPPTOOLS_TRACE_SCOPE(FindDeadModules);
+    using namespace CppToolsModuleGraphImpl;
+
+    FCppToolsDeadModuleReport Report;
+    Report.Targets = ReadProjectTargets();
+    Report.Modules = BuildGraph();
+
+    TSet<FString> BuiltModules;
+    TSet<FString> LiveModules;
+    for (const FCppToolsTargetInfo& Target : Report.Targets)
+    {
+        // Every module of the descriptors and of ExtraModuleNames is built, along with everything it depends on
+        TArray<FString> Entries = Target.ExtraModuleNames;
+        TArray<FString> Roots = ExtraRoots;
+        for (const TPair<FString, FCppToolsModuleNode>& Module : Report.Modules)
+        {
+            if (!IsModuleTypeInTargetType(Module.Value.Type, Target.Type)) continue;
+            if (Module.Value.Plugin.IsValid() && !Module.Value.Plugin->IsEnabled()) continue;
+
+            Entries.Add(Module.Key);
+            if (!Module.Value.RootReason.IsEmpty())
+            {
+                Roots.Add(Module.Key);
+            }
+        }
+
+        TArray<FString>& TargetModules = Report.TargetModules.Add(Target.Name);
+        for (const FString& ModuleName : Walk(Report.Modules, Entries, false))
+        {
+            if (Report.Modules.Contains(ModuleName))
+            {
+                TargetModules.Add(ModuleName);
+            }
+        }
+        TargetModules.Sort();
+
+        TArray<FString>& TargetLiveModules = Report.LiveModules.Add(Target.Name);
+        for (const FString& ModuleName : Walk(Report.Modules, Roots, true))
+        {
+            if (TargetModules.Contains(ModuleName))
+            {
+                TargetLiveModules.Add(ModuleName);
+            }
+        }
+        TargetLiveModules.Sort();
+
+        BuiltModules.Append(TargetModules);
+        LiveModules.Append(TargetLiveModules);
+    }
+
+    for (const FString& ModuleName : BuiltModules)
+    {
+        if (!LiveModules.Contains(ModuleName))
+        {
+            Report.DeadModules.Add(ModuleName);
+        }
+    }
+    Report.DeadModules.Sort();
+
+    UE_LOG(LogCppToolsModuleGraph, Log, TEXT("Found %d dead modules among the %d modules built by %d targets"), Report.DeadModules.Num(),
+        BuiltModules.Num(), Report.Targets.Num());
+    return Report;
+}
+
+bool CppToolsModuleGraph::RemoveDeadModules(const FCppToolsDeadModuleReport& Report, bool bRemoveUnusedDependencies, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(RemoveDeadModules);
+
+    // Every edit is staged before anything is written, so a failure leaves no file half updated
+    FCppToolsFileTransaction Transaction;
+    for (const FCppToolsTargetInfo& Target : Report.Targets)
+    {
+        if (!Transaction.StageModify(Target.Filename, [&Report](FString& Contents)
+        {
+            bool bChanged = false;
+            for (const FString& ModuleName : Report.DeadModules)
+            {
+                bChanged |= CppToolsUtil::RemoveModuleFromTargetFile(Contents, ModuleName);
+            }
+            return bChanged;
+        }, OutFailReason))
+        {
+            return false;
+        }
+    }
+
+    for (const TPair<FString, FCppToolsModuleNode>& Module : Report.Modules)
+    {
+        if (Report.DeadModules.Contains(Module.Key)) continue;
+
+        TArray<FString> RemovedDependencies;
+        for (const FString& Dependency : Module.Value.Dependencies)
+        {
+            if (Report.DeadModules.Contains(Dependency) || (bRemoveUnusedDependencies && Module.Value.UnusedDependencies.Contains(Dependency)))
+            {
+                RemovedDependencies.Add(Dependency);
+            }
+        }
+        if (RemovedDependencies.Num() == 0) continue;
+
+        FString BuildFilePath;
+        if (!CppToolsUtil::GetModuleBuildFilePath(Module.Key, Module.Value.Plugin, BuildFilePath))
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("ModuleName"), FText::FromString(Module.Key));
+            OutFailReason = FText::Format(LOCTEXT("ModuleBuildFileNotFound", "Could not find the .Build.cs file of module \"{ModuleName}\""), Args);
+            return false;
+        }
+
+        if (!Transaction.StageModify(BuildFilePath, [&RemovedDependencies](FString& BuildFileContents)
+        {
+            bool bChanged = false;
+            for (const FString& Dependency : RemovedDependencies)
+            {
+                bChanged |= CppToolsUtil::RemoveDependencyFromBuildFile(BuildFileContents, Dependency);
+            }
+            return bChanged;
+        }, OutFailReason))
+        {
+            return false;
+        }
+    }
+
+    if (!Transaction.Commit(OutFailReason)) return false;
+
+    // The descriptors are saved by the engine, so they are backed up in the transaction's journal to be rolled back with the files
+    if (Report.DeadModules.Num() > 0)
+    {
+        FCppToolsDescriptorSession Session;
+        if (!Session.RemoveModules(Report.DeadModules, OutFailReason) || !Session.Commit(OutFailReason, &Transaction))
+        {
+            FText RollbackFailReason;
+            if (!Transaction.Rollback(RollbackFailReason))
+            {
+                CppToolsUtil::PushNotification(RollbackFailReason, SNotificationItem::CS_Fail);
+            }
+            return false;
+        }
+    }
+    Transaction.Finish();
+    return true;
+}
+
+FCppToolsTargetMembershipReport CppToolsModuleGraph::AnalyzeTargetMembership(const FString& Platform)
+{
+    CPPTOOLS_TRACE_SCOPE(AnalyzeTargetMembership);
+    using namespace CppToolsModuleGraphImpl;
+
+    FCppToolsTargetMembershipReport Report;
+    Report.Platform = Platform;
+    Report.Targets = ReadProjectTargets();
+    Report.Modules = BuildGraph();
+    const TMap<FString, FModuleDescriptor> Descriptors = GetModuleDescriptors(Report.Modules);
+
+    for (const FCppToolsTargetInfo& Target : Report.Targets)
+    {
+        // Why the target should not build each module, for the modules it should not build
+        TMap<FString, FString> Exclusions;
+        TArray<FString> Entries;
+        for (const TPair<FString, FCppToolsModuleNode>& Module : Report.Modules)
+        {
+            const FString Reason = GetExclusionReason(Module.Value, Descriptors.Find(Module.Key), Target.Type, Platform);
+            if (Reason.IsEmpty())
+            {
+                Entries.Add(Module.Key);
+            }
+            else
+            {
+                Exclusions.Add(Module.Key, Reason);
+            }
+        }
+
+        // The target needs its entries and everything they depend on, even modules it should not build, which are reported below
+        const TSet<FString> Needed = Walk(Report.Modules, Entries, false);
+        for (const FString& ModuleName : Needed)
+        {
+            if (Report.Modules.Contains(ModuleName))
+            {
+                Report.ModuleTargets.FindOrAdd(ModuleName).Add(Target.Name);
+            }
+        }
+
+        TArray<FString> Roots = Entries;
+        Roots.Append(Target.ExtraModuleNames);
+        TArray<FString>& Unneeded = Report.UnneededModules.Add(Target.Name);
+        for (const FString& ModuleName : Walk(Report.Modules, Roots, false))
+        {
+            if (Report.Modules.Contains(ModuleName) && !Needed.Contains(ModuleName))
+            {
+                Unneeded.Add(ModuleName);
+            }
+        }
+        Unneeded.Sort();
+
+        for (const FString& ModuleName : Target.ExtraModuleNames)
+        {
+            if (!Report.Modules.Contains(ModuleName) || Needed.Contains(ModuleName)) continue;
+
+            FCppToolsTargetMembershipIssue& Issue = Report.Issues.AddDefaulted_GetRef();
+            Issue.Target = Target.Name;
+            Issue.Module = ModuleName;
+            Issue.Kind = TEXT("Misplaced");
+            Issue.Reason = Exclusions.FindRef(ModuleName);
+            Issue.bFixable = true;
+        }
+
+        // Removing these from the target does not help, as Unreal Build Tool builds every dependency regardless of its type
+        for (const FString& ModuleName : Entries)
+        {
+            for (const FString& Dependency : Report.Modules[ModuleName].Dependencies)
+            {
+                const FString* Exclusion = Exclusions.Find(Dependency);
+                if (Exclusion == nullptr) continue;
+
+                FCppToolsTargetMembershipIssue& Issue = Report.Issues.AddDefaulted_GetRef();
+                Issue.Target = Target.Name;
+                Issue.Module = ModuleName;
+                Issue.Kind = TEXT("IncompatibleDependency");
+                Issue.Reason = FString::Printf(TEXT("Depends on %s, which the target should not build: %s. Add the dependency only for the targets that need it."),
+                    *Dependency, **Exclusion);
+            }
+        }
+    }
+
+    for (TPair<FString, TArray<FString>>& ModuleTargets : Report.ModuleTargets)
+    {
+        ModuleTargets.Value.Sort();
+    }
+    Report.ModuleTargets.KeySort(TLess<FString>());
+
+    UE_LOG(LogCppToolsModuleGraph, Log, TEXT("Found %d target membership issues among the %d modules of %d targets on %s"), Report.Issues.Num(),
+        Report.Modules.Num(), Report.Targets.Num(), *Platform);
+    return Report;
+}
+
+bool CppToolsModuleGraph::PlanTargetMembershipFixes(const FCppToolsTargetMembershipReport& Report, TArray<FCppToolsFileEdit>& OutEdits, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(PlanTargetMembershipFixes);
+
+    OutEdits.Reset();
+    for (const FCppToolsTargetInfo& Target : Report.Targets)
+    {
+        FString Contents;
+        if (!CppToolsUtil::LoadFileToString(Contents, Target.Filename))
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("FullFileName"), FText::FromString(Target.Filename));
+            OutFailReason = FText::Format(LOCTEXT("FailedToReadTargetFile", "Failed to read \"{FullFileName}\""), Args);
+            return false;
+        }
+
+        FCppToolsFileEdit Edit;
+        Edit.ModuleName = Target.Name;
+        Edit.Filename = Target.Filename;
+        Edit.TimeStamp = IFileManager::Get().GetTimeStamp(*Target.Filename);
+        Edit.NewContents = Contents;
+
+        bool bChanged = false;
+        for (const FCppToolsTargetMembershipIssue& Issue : Report.Issues)
+        {
+            if (Issue.bFixable && Issue.Target == Target.Name)
+            {
+                bChanged |= CppToolsUtil::RemoveModuleFromTargetFile(Edit.NewContents, Issue.Module);
+            }
+        }
+        if (!bChanged) continue;
+
+        Edit.Diff = CppToolsDiff::MakeUnifiedDiff(Target.Filename, Contents, Edit.NewContents);
+        OutEdits.Add(MoveTemp(Edit));
+    }
+    return true;
+}
+
+FString CppToolsModuleGraph::GetModuleRootReason(const FCppToolsModuleNode& Module)
+{
+    const FString PrimaryModuleName = Module.Plugin.IsValid() ? Module.Plugin->GetName() : FString(FApp::GetProjectName());
+    if (Module.Name == PrimaryModuleName || Module.Name == PrimaryModuleName + TEXT("Editor"))
+    {
+        return TEXT("Primary module");
+    }
+
+    const FRegexPattern StartupPattern(TEXT("::StartupModule\\s*\\(\\s*\\)\\s*\\{([^\\}]*)\\}"));
+    const FRegexPattern ReflectedTypePattern(TEXT("\\b(?:UCLASS|USTRUCT|UENUM|UINTERFACE)\\s*\\("));
+    for (const FString& File : CppToolsModuleGraphImpl::FindModuleFiles(Module.Path, TEXT("*.h;*.cpp")))
+    {
+        FString Contents;
+        if (!CppToolsUtil::LoadFileToString(Contents, File)) continue;
+        Contents = CppToolsUtil::StripCStyleComments(Contents);
+
+        if (Contents.Contains(TEXT("IMPLEMENT_PRIMARY_GAME_MODULE")))
+        {
+            return TEXT("Primary game module");
+        }
+
+        // Startup code may register the module's functionality without anything including it
+        FRegexMatcher StartupMatcher(StartupPattern, Contents);
+        if (StartupMatcher.FindNext() && !StartupMatcher.GetCaptureGroup(1).TrimStartAndEnd().IsEmpty())
+        {
+            return TEXT("Has startup code");
+        }
+
+        // Reflected types may be referenced by assets and config rather than by code
+        FRegexMatcher ReflectedTypeMatcher(ReflectedTypePattern, Contents);
+        if (ReflectedTypeMatcher.FindNext())
+        {
+            return TEXT("Declares reflected types");
+        }
+    }
+    return FString();
+}
+
+#undef LOCTEXT_NAMESPACE
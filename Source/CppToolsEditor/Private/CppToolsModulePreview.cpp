@@ -0,0 +1,290 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsModulePreview.h"
+
+#include "CppToolsDiff.h"
+#include "CppToolsModuleGraph.h"
+#include "CppToolsTemplate.h"
+#include "CppToolsTrace.h"
+#include "CppToolsUtil.h"
+
+#include "Serialization/JsonWriter.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsModulePreview"
+
+namespace CppToolsModulePreviewImpl
+{
+    static FString GetTargetName(const TSharedPtr<IPlugin>& Target)
+    {
+        return Target.IsValid() ? Target->GetName() : FString();
+    }
+
+    static FString JoinKey(std::initializer_list<FString> Parts)
+    {
+        FString Key;
+        for (const FString& Part : Parts)
+        {
+            Key += Part;
+            Key += TEXT('|');
+        }
+        return Key;
+    }
+
+    static TSharedPtr<FCppToolsPreviewFile> MakeFile(const FString& Filename, FString&& Text, bool bCreate)
+    {
+        TSharedPtr<FCppToolsPreviewFile> File = MakeShareable(new FCppToolsPreviewFile);
+        File->Filename = Filename;
+        File->Text = MoveTemp(Text);
+        File->bCreate = bCreate;
+        return File;
+    }
+
+    /** Writes the modules of a descriptor the way the descriptor file lists them. */
+    static FString WriteModules(const TArray<FModuleDescriptor>& Modules)
+    {
+        FString Text;
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+        Writer->WriteObjectStart();
+        FModuleDescriptor::WriteArray(Writer.Get(), TEXT("Modules"), Modules);
+        Writer->WriteObjectEnd();
+        Writer->Close();
+        return Text;
+    }
+}
+
+bool FCppToolsModulePreview::Initialize(FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(InitializeModulePreview);
+
+    BuildFileTemplate = FCppToolsTemplate::Load(TEXT("Module.Build.cs.template"), OutFailReason);
+    if (!BuildFileTemplate.IsValid()) return false;
+    HeaderTemplate = FCppToolsTemplate::Load(TEXT("Module.h.template"), OutFailReason);
+    if (!HeaderTemplate.IsValid()) return false;
+    SourceTemplate = FCppToolsTemplate::Load(TEXT("Module.cpp.template"), OutFailReason);
+    if (!SourceTemplate.IsValid()) return false;
+    FwdHeaderTemplate = FCppToolsTemplate::Load(TEXT("ModuleFwd.h.template"), OutFailReason);
+    return FwdHeaderTemplate.IsValid();
+}
+
+bool FCppToolsModulePreview::Update(const FCppToolsNewModuleSettings& Settings)
+{
+    using namespace CppToolsModulePreviewImpl;
+
+    CPPTOOLS_TRACE_SCOPE(UpdateModulePreview);
+
+    if (!BuildFileTemplate.IsValid()) return false;
+
+    const FString& ModuleName = Settings.ModuleName;
+    const FString ModulePath = CppToolsUtil::GetNewModulePath(ModuleName, Settings.Target);
+    const FString TargetName = GetTargetName(Settings.Target);
+    const FString Type = EHostType::ToString(Settings.Type);
+    const bool bHasName = !ModuleName.IsEmpty();
+
+    // The new files only depend on the name, where the module goes and its options, the edits also depend on its type
+    const FString SourceKey = JoinKey({ ModulePath, LexToString(Settings.LLMTagIndex), CppToolsModuleTemplates::ToString(Settings.ModuleTemplate) });
+    TArray<FString> PublicHeaderIncludes;
+    FString StartupSource;
+    FString ShutdownSource;
+    CppToolsModuleTemplates::GetModuleCode(Settings.ModuleTemplate, ModuleName, PublicHeaderIncludes, StartupSource, ShutdownSource);
+    bool bChanged = false;
+    bChanged |= UpdateSection(EPreviewFile::BuildFile, ModulePath, [&](FText& OutFailReason) -> TSharedPtr<FCppToolsPreviewFile>
+    {
+        if (!bHasName) return nullptr;
+
+        TArray<FString> PublicDependencyModuleNames;
+        TArray<FString> PrivateDependencyModuleNames;
+        CppToolsUtil::GetNewModuleDependencies(PublicDependencyModuleNames, PrivateDependencyModuleNames);
+        return MakeFile(ModulePath / ModuleName + TEXT(".Build.cs"),
+            CppToolsUtil::RenderModuleBuildFile(*BuildFileTemplate, ModuleName, PublicDependencyModuleNames, PrivateDependencyModuleNames, false), true);
+    });
+    bChanged |= UpdateSection(EPreviewFile::HeaderFile, SourceKey, [&](FText& OutFailReason) -> TSharedPtr<FCppToolsPreviewFile>
+    {
+        if (!bHasName) return nullptr;
+
+        return MakeFile(ModulePath / TEXT("Public") / ModuleName + TEXT(".h"),
+            CppToolsUtil::RenderModuleHeaderFile(*HeaderTemplate, ModuleName, PublicHeaderIncludes, Settings.LLMTagIndex), true);
+    });
+    bChanged |= UpdateSection(EPreviewFile::SourceFile, SourceKey, [&](FText& OutFailReason) -> TSharedPtr<FCppToolsPreviewFile>
+    {
+        if (!bHasName) return nullptr;
+
+        return MakeFile(ModulePath / TEXT("Private") / ModuleName + TEXT(".cpp"),
+            CppToolsUtil::RenderModuleCPPFile(*SourceTemplate, ModuleName, StartupSource, ShutdownSource, Settings.LLMTagIndex), true);
+    });
+    bChanged |= UpdateSection(EPreviewFile::FwdHeaderFile, JoinKey({ ModulePath, Settings.bGenerateFwdHeader ? TEXT("Fwd") : TEXT("") }),
+        [&](FText& OutFailReason) -> TSharedPtr<FCppToolsPreviewFile>
+    {
+        if (!bHasName || !Settings.bGenerateFwdHeader) return nullptr;
+
+        return MakeFile(CppToolsUtil::GetModuleFwdHeaderPath(ModulePath, ModuleName),
+            CppToolsUtil::RenderModuleFwdHeaderFile(*FwdHeaderTemplate, ModuleName, FString()), true);
+    });
+    bChanged |= UpdateTemplateFiles(Settings, ModulePath);
+    bChanged |= UpdateSection(EPreviewFile::OwnerBuildFile, JoinKey({ ModuleName, TargetName, Type }), [&](FText& OutFailReason)
+    {
+        return bHasName ? RenderOwnerBuildFile(Settings, OutFailReason) : nullptr;
+    });
+    bChanged |= UpdateSection(EPreviewFile::TargetFile, JoinKey({ ModuleName, TargetName, Type }), [&](FText& OutFailReason)
+    {
+        return bHasName && !Settings.Target.IsValid() ? RenderTargetFile(Settings, OutFailReason) : nullptr;
+    });
+    bChanged |= UpdateSection(EPreviewFile::Descriptor, JoinKey({ ModuleName, TargetName, Type, ELoadingPhase::ToString(Settings.LoadingPhase) }),
+        [&](FText& OutFailReason)
+    {
+        return bHasName ? RenderDescriptor(Settings, OutFailReason) : nullptr;
+    });
+
+    if (bChanged)
+    {
+        Files.Reset();
+        for (int32 I = 0; I < static_cast<int32>(EPreviewFile::Num); I++)
+        {
+            if (Sections[I].File.IsValid())
+            {
+                Files.Add(Sections[I].File);
+            }
+            if (I == static_cast<int32>(EPreviewFile::FwdHeaderFile))
+            {
+                Files.Append(TemplateFiles);
+            }
+        }
+    }
+    return bChanged;
+}
+
+FText FCppToolsModulePreview::GetFailReason() const
+{
+    for (const FSection& Section : Sections)
+    {
+        if (!Section.FailReason.IsEmpty()) return Section.FailReason;
+    }
+    return TemplateFilesFailReason;
+}
+
+bool FCppToolsModulePreview::UpdateSection(EPreviewFile SectionIndex, const FString& Key, TFunctionRef<TSharedPtr<FCppToolsPreviewFile>(FText&)> Render)
+{
+    FSection& Section = Sections[static_cast<int32>(SectionIndex)];
+    if (Section.Key == Key) return false;
+
+    Section.Key = Key;
+    Section.FailReason = FText::GetEmpty();
+    Section.File = Render(Section.FailReason);
+    return true;
+}
+
+bool FCppToolsModulePreview::UpdateTemplateFiles(const FCppToolsNewModuleSettings& Settings, const FString& ModulePath)
+{
+    using namespace CppToolsModulePreviewImpl;
+
+    const FString Key = JoinKey({ ModulePath, CppToolsModuleTemplates::ToString(Settings.ModuleTemplate) });
+    if (TemplateFilesKey == Key) return false;
+
+    TemplateFilesKey = Key;
+    TemplateFilesFailReason = FText::GetEmpty();
+    TemplateFiles.Reset();
+    if (Settings.ModuleName.IsEmpty()) return true;
+
+    TArray<FCppToolsModuleTemplateFile> RenderedFiles;
+    if (CppToolsModuleTemplates::RenderFiles(Settings.ModuleTemplate, ModulePath, Settings.ModuleName, RenderedFiles, TemplateFilesFailReason))
+    {
+        for (FCppToolsModuleTemplateFile& File : RenderedFiles)
+        {
+            TemplateFiles.Add(MakeFile(File.Filename, MoveTemp(File.Contents), true));
+        }
+    }
+    return true;
+}
+
+TSharedPtr<FCppToolsPreviewFile> FCppToolsModulePreview::RenderOwnerBuildFile(const FCppToolsNewModuleSettings& Settings, FText& OutFailReason)
+{
+    using namespace CppToolsModulePreviewImpl;
+
+    // Finding the .Build.cs file searches the source directories, so it is only done once for each target and type
+    const FString OwnerKey = JoinKey({ GetTargetName(Settings.Target), EHostType::ToString(Settings.Type) });
+    const FString* OwnerBuildFile = OwnerBuildFiles.Find(OwnerKey);
+    if (!OwnerBuildFile)
+    {
+        const FString OwningModule = CppToolsUtil::GetNewModuleOwner(Settings.Target, Settings.Type);
+        FString BuildFilePath;
+        if (OwningModule.IsEmpty() || !CppToolsUtil::GetModuleBuildFilePath(OwningModule, Settings.Target, BuildFilePath))
+        {
+            BuildFilePath.Reset();
+        }
+        OwnerBuildFile = &OwnerBuildFiles.Add(OwnerKey, BuildFilePath);
+    }
+    if (OwnerBuildFile->IsEmpty()) return nullptr;
+
+    const FString Filename = *OwnerBuildFile;
+    const FString* Contents = GetFileContents(Filename);
+    if (!Contents)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+        OutFailReason = FText::Format(LOCTEXT("FailedToReadFile", "Failed to read \"{FullFileName}\""), Args);
+        return nullptr;
+    }
+
+    FString NewContents = *Contents;
+    if (!CppToolsUtil::InsertDependencyIntoBuildFile(NewContents, Settings.ModuleName, false))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+        OutFailReason = FText::Format(LOCTEXT("NoDependencyList", "\"{FullFileName}\" has no dependency list to add the module to"), Args);
+        return nullptr;
+    }
+    return MakeFile(Filename, CppToolsDiff::MakeUnifiedDiff(Filename, *Contents, NewContents), false);
+}
+
+TSharedPtr<FCppToolsPreviewFile> FCppToolsModulePreview::RenderTargetFile(const FCppToolsNewModuleSettings& Settings, FText& OutFailReason)
+{
+    using namespace CppToolsModulePreviewImpl;
+
+    const FString Filename = CppToolsUtil::GetPrimaryTargetFilePath(!CppToolsModuleGraph::IsModuleTypeInTarget(Settings.Type, false));
+    const FString* Contents = GetFileContents(Filename);
+    FString NewContents = Contents ? *Contents : FString();
+    if (!Contents || !CppToolsUtil::InsertModuleIntoTargetFile(NewContents, Settings.ModuleName))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(Filename));
+        OutFailReason = FText::Format(LOCTEXT("FailedToPreviewTargetFile", "Failed to preview the update of \"{FullFileName}\""), Args);
+        return nullptr;
+    }
+    return MakeFile(Filename, CppToolsDiff::MakeUnifiedDiff(Filename, *Contents, NewContents), false);
+}
+
+TSharedPtr<FCppToolsPreviewFile> FCppToolsModulePreview::RenderDescriptor(const FCppToolsNewModuleSettings& Settings, FText& OutFailReason)
+{
+    using namespace CppToolsModulePreviewImpl;
+
+    const TArray<FModuleDescriptor>* Modules = Descriptors.GetModules(Settings.Target, OutFailReason);
+    if (!Modules) return nullptr;
+
+    // The new module is added to a copy of the loaded descriptor, which stays as it is on disk
+    FCppToolsDescriptorSession Edited = Descriptors;
+    TArray<FModuleDescriptor> NewModules;
+    NewModules.Add(FModuleDescriptor(*Settings.ModuleName, Settings.Type, Settings.LoadingPhase));
+    if (!Edited.AppendModules(Settings.Target, NewModules, OutFailReason)) return nullptr;
+
+    const TArray<FModuleDescriptor>* EditedModules = Edited.GetModules(Settings.Target, OutFailReason);
+    if (!EditedModules) return nullptr;
+
+    const FString Filename = Settings.Target.IsValid() ? Settings.Target->GetDescriptorFileName() : FPaths::GetProjectFilePath();
+    return MakeFile(Filename, CppToolsDiff::MakeUnifiedDiff(Filename, WriteModules(*Modules), WriteModules(*EditedModules)), false);
+}
+
+const FString* FCppToolsModulePreview::GetFileContents(const FString& Filename)
+{
+    if (const FString* Contents = FileContents.Find(Filename)) return Contents;
+    if (UnreadableFiles.Contains(Filename)) return nullptr;
+
+    FString Contents;
+    if (!CppToolsUtil::LoadFileToString(Contents, Filename))
+    {
+        UnreadableFiles.Add(Filename);
+        return nullptr;
+    }
+    return &FileContents.Add(Filename, MoveTemp(Contents));
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsModuleTemplates.h"
+
+#include "CppToolsTemplate.h"
+#include "CppToolsUtil.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsModuleTemplates"
+
+namespace CppToolsModuleTemplatesImpl
+{
+    static const TCHAR* TemplateNames[] = { TEXT("Basic"), TEXT("HighPerformanceRuntime") };
+    static_assert(UE_ARRAY_COUNT(TemplateNames) == static_cast<int32>(ECppToolsModuleTemplate::Num), "Every module template needs a name");
+
+    /** A template file and where the file rendered from it goes: a directory of the module and the module name with a suffix. */
+    struct FTemplateFile
+    {
+        const TCHAR* TemplateName;
+        const TCHAR* Directory;
+        const TCHAR* Suffix;
+    };
+
+    static const FTemplateFile HighPerformanceRuntimeFiles[] =
+    {
+        { TEXT("ModuleAllocators.h.template"), TEXT("Public"), TEXT("Allocators.h") },
+        { TEXT("ModuleAllocators.cpp.template"), TEXT("Private"), TEXT("Allocators.cpp") },
+        { TEXT("ModuleAllocatorTests.cpp.template"), TEXT("Private/Tests"), TEXT("AllocatorTests.cpp") },
+    };
+
+    static TArrayView<const FTemplateFile> GetTemplateFiles(ECppToolsModuleTemplate Template)
+    {
+        switch (Template)
+        {
+        case ECppToolsModuleTemplate::HighPerformanceRuntime: return MakeArrayView(HighPerformanceRuntimeFiles);
+        default: return TArrayView<const FTemplateFile>();
+        }
+    }
+}
+
+FString CppToolsModuleTemplates::ToString(ECppToolsModuleTemplate Template)
+{
+    using namespace CppToolsModuleTemplatesImpl;
+
+    return TemplateNames[static_cast<int32>(Template)];
+}
+
+bool CppToolsModuleTemplates::FromString(const FString& Name, ECppToolsModuleTemplate& OutTemplate)
+{
+    using namespace CppToolsModuleTemplatesImpl;
+
+    for (int32 I = 0; I < UE_ARRAY_COUNT(TemplateNames); I++)
+    {
+        if (Name == TemplateNames[I])
+        {
+            OutTemplate = static_cast<ECppToolsModuleTemplate>(I);
+            return true;
+        }
+    }
+    return false;
+}
+
+FText CppToolsModuleTemplates::GetDisplayName(ECppToolsModuleTemplate Template)
+{
+    switch (Template)
+    {
+    case ECppToolsModuleTemplate::HighPerformanceRuntime: return LOCTEXT("HighPerformanceRuntime", "High-performance runtime");
+    default: return LOCTEXT("Basic", "Basic");
+    }
+}
+
+FText CppToolsModuleTemplates::GetDescription(ECppToolsModuleTemplate Template)
+{
+    switch (Template)
+    {
+    case ECppToolsModuleTemplate::HighPerformanceRuntime:
+        return LOCTEXT("HighPerformanceRuntimeDescription", "Adds a per-frame arena reset at the end of every frame, a fixed-size object pool, "
+            "inline allocator containers and stats counters for them, with automation tests and a benchmark against FMemory");
+    default:
+        return LOCTEXT("BasicDescription", "Only the module class, with empty StartupModule and ShutdownModule");
+    }
+}
+
+void CppToolsModuleTemplates::GetModuleCode(ECppToolsModuleTemplate Template, const FString& ModuleName, TArray<FString>& OutPublicHeaderIncludes,
+    FString& OutStartupCode, FString& OutShutdownCode)
+{
+    if (Template == ECppToolsModuleTemplate::HighPerformanceRuntime)
+    {
+        OutPublicHeaderIncludes.Add(ModuleName + TEXT("Allocators.h"));
+        OutStartupCode = FString::Printf(TEXT("F%sFrameArena::StartFrameResets();"), *ModuleName);
+        OutShutdownCode = FString::Printf(TEXT("F%sFrameArena::StopFrameResets();"), *ModuleName);
+    }
+}
+
+bool CppToolsModuleTemplates::RenderFiles(ECppToolsModuleTemplate Template, const FString& ModulePath, const FString& ModuleName,
+    TArray<FCppToolsModuleTemplateFile>& OutFiles, FText& OutFailReason)
+{
+    using namespace CppToolsModuleTemplatesImpl;
+
+    TMap<FString, FString> Values;
+    Values.Add(TEXT("COPYRIGHT_LINE"), CppToolsUtil::GetCopyrightLine());
+    Values.Add(TEXT("MODULE_NAME"), ModuleName);
+    Values.Add(TEXT("CLASS_MODULE_API_MACRO"), CppToolsUtil::GetModuleAPIMacro(ModuleName, false));
+
+    for (const FTemplateFile& File : GetTemplateFiles(Template))
+    {
+        const TSharedPtr<const FCppToolsTemplate> FileTemplate = FCppToolsTemplate::Load(ToString(Template) / File.TemplateName, OutFailReason);
+        if (!FileTemplate.IsValid()) return false;
+
+        FCppToolsModuleTemplateFile& OutFile = OutFiles.AddDefaulted_GetRef();
+        OutFile.Filename = ModulePath / File.Directory / ModuleName + File.Suffix;
+        OutFile.Contents = FileTemplate->Render(Values);
+    }
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
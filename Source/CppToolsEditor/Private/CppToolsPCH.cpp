@@ -0,0 +1,519 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsPCH.h"
+
+#include "CppToolsBuild.h"
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+#include "Internationalization/Regex.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsPCH"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsPCH, Log, All);
+
+namespace CppToolsPCHImpl
+{
+    /** The line of the template that marks a precompiled header as generated, so hand-written ones are never touched. */
+    static const TCHAR* GeneratedMarker = TEXT("Generated by C++ Tools from the module's include profile");
+
+    static FString NormalizePath(const FString& Path)
+    {
+        FString Result = FPaths::ConvertRelativePathToFull(Path);
+        FPaths::NormalizeFilename(Result);
+        return Result;
+    }
+
+    static TArray<FString> GetIncludes(const TArray<FCppToolsIncludeProfileEntry>& Profile)
+    {
+        TArray<FString> Result;
+        for (const FCppToolsIncludeProfileEntry& Entry : Profile)
+        {
+            Result.Add(Entry.Include);
+        }
+        return Result;
+    }
+
+    /**
+     * Gets the include of a header found next to the source file including it, as written in the precompiled header. Headers of
+     * the module are included through the module's directory, since the parent of every module directory is an include path.
+     */
+    static FString MakePCHInclude(const FString& Include, const FString& SourceDir, const FString& HeaderFile, const FString& ModuleDir,
+        const FString& PCHDir)
+    {
+        // Includes of source files next to the precompiled header resolve the same from it
+        if (SourceDir == PCHDir) return Include;
+
+        FString RelativePath = HeaderFile;
+        if (FPaths::IsUnderDirectory(HeaderFile, ModuleDir))
+        {
+            FPaths::MakePathRelativeTo(RelativePath, *(ModuleDir / TEXT("")));
+            return FPaths::GetCleanFilename(ModuleDir) / RelativePath;
+        }
+        FPaths::MakePathRelativeTo(RelativePath, *(PCHDir / TEXT("")));
+        return RelativePath;
+    }
+
+    /**
+     * The comment a generated precompiled header records the module's PCHUsage with from before it was generated, so removing the
+     * header puts it back. Modules that did not set PCHUsage record UnsetPCHUsage.
+     */
+    static const TCHAR* OriginalPCHUsagePrefix = TEXT("// PCHUsage before the precompiled header was generated: ");
+    static const TCHAR* UnsetPCHUsage = TEXT("unset");
+
+    /** Gets the PrivatePCHHeaderFile value of the generated precompiled header, as written in the .Build.cs file. */
+    static FString GetPrivatePCHHeaderFileValue(const FString& ModuleName)
+    {
+        return FString::Printf(TEXT("\"Private/%sPrivatePCH.h\""), *ModuleName);
+    }
+
+    /** Checks if the .Build.cs file sets PrivatePCHHeaderFile to a header other than the generated one. */
+    static bool UsesOtherPCH(const FString& BuildFileContents, const FString& ModuleName)
+    {
+        FString PrivatePCHHeaderFile;
+        return CppToolsUtil::GetModuleRulesField(BuildFileContents, TEXT("PrivatePCHHeaderFile"), PrivatePCHHeaderFile)
+            && PrivatePCHHeaderFile != GetPrivatePCHHeaderFileValue(ModuleName);
+    }
+
+    /** Reads the PCHUsage a generated precompiled header recorded. Returns false if it recorded none. */
+    static bool ReadOriginalPCHUsage(const FString& PCHFilename, FString& OutPCHUsage)
+    {
+        FString Contents;
+        if (!CppToolsUtil::LoadFileToString(Contents, PCHFilename)) return false;
+
+        const int32 Start = Contents.Find(OriginalPCHUsagePrefix, ESearchCase::CaseSensitive);
+        if (Start == INDEX_NONE) return false;
+
+        const int32 ValueStart = Start + FCString::Strlen(OriginalPCHUsagePrefix);
+        int32 ValueEnd = Contents.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, ValueStart);
+        if (ValueEnd == INDEX_NONE) ValueEnd = Contents.Len();
+        OutPCHUsage = Contents.Mid(ValueStart, ValueEnd - ValueStart).TrimStartAndEnd();
+        return !OutPCHUsage.IsEmpty();
+    }
+
+    static bool LoadBuildFile(const FString& ModuleName, TSharedPtr<IPlugin> Target, FString& OutContents, FText& OutFailReason)
+    {
+        FString BuildFilePath;
+        if (!CppToolsUtil::GetModuleBuildFilePath(ModuleName, Target, BuildFilePath) || !CppToolsUtil::LoadFileToString(OutContents, BuildFilePath))
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+            OutFailReason = FText::Format(LOCTEXT("FailedToReadBuildFile", "Could not read the .Build.cs file of module \"{ModuleName}\""), Args);
+            return false;
+        }
+        return true;
+    }
+
+    static bool GetModuleDir(const FString& ModuleName, TSharedPtr<IPlugin> Target, FString& OutModuleDir, FText& OutFailReason)
+    {
+        FString BuildFilePath;
+        if (!CppToolsUtil::GetModuleBuildFilePath(ModuleName, Target, BuildFilePath))
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+            OutFailReason = FText::Format(LOCTEXT("ModuleNotFound", "Could not find the .Build.cs file of module \"{ModuleName}\""), Args);
+            return false;
+        }
+        OutModuleDir = NormalizePath(FPaths::GetPath(BuildFilePath));
+        return true;
+    }
+}
+
+void FCppToolsHeaderIndex::Build(const TArray<FString>& Directories)
+{
+    CPPTOOLS_TRACE_SCOPE(BuildHeaderIndex);
+
+    Headers.Reset();
+    for (const FString& Directory : Directories)
+    {
+        TArray<FString> HeaderFiles;
+        IFileManager::Get().FindFilesRecursive(HeaderFiles, *Directory, TEXT("*.h"), true, false, false);
+        for (const FString& HeaderFile : HeaderFiles)
+        {
+            Headers.Add(FPaths::GetCleanFilename(HeaderFile).ToLower(), CppToolsPCHImpl::NormalizePath(HeaderFile));
+        }
+    }
+
+    UE_LOG(LogCppToolsPCH, Log, TEXT("Indexed %d headers in %d directories"), Headers.Num(), Directories.Num());
+}
+
+bool FCppToolsHeaderIndex::Resolve(const FString& Include, const FString& PreferredDirectory, FString& OutFilename) const
+{
+    FString Suffix = Include;
+    FPaths::NormalizeFilename(Suffix);
+    Suffix = TEXT("/") + Suffix;
+
+    TArray<FString> Candidates;
+    Headers.MultiFind(FPaths::GetCleanFilename(Include).ToLower(), Candidates);
+
+    const FString* Resolved = nullptr;
+    for (const FString& Candidate : Candidates)
+    {
+        if (!Candidate.EndsWith(Suffix, ESearchCase::IgnoreCase)) continue;
+
+        // Headers of the including module shadow the same include path in other modules
+        if (Candidate.StartsWith(PreferredDirectory / TEXT(""), ESearchCase::IgnoreCase))
+        {
+            OutFilename = Candidate;
+            return true;
+        }
+        if (Resolved == nullptr || Candidate < *Resolved)
+        {
+            Resolved = &Candidate;
+        }
+    }
+
+    if (Resolved == nullptr) return false;
+    OutFilename = *Resolved;
+    return true;
+}
+
+TArray<FString> CppToolsPCH::GetIncludeSearchDirectories()
+{
+    TArray<FString> Directories;
+    Directories.Add(FPaths::EngineSourceDir());
+    Directories.Add(FPaths::EnginePluginsDir());
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        Directories.Add(Module.Key.ModuleSourcePath);
+    }
+    return Directories;
+}
+
+TArray<FCppToolsIncludeProfileEntry> CppToolsPCH::ProfileModuleIncludes(const FString& ModuleName, TSharedPtr<IPlugin> Target,
+    const FCppToolsHeaderIndex& HeaderIndex, const TMap<FString, int32>& Edits, const FCppToolsPCHSettings& Settings, int32& OutNumSourceFiles)
+{
+    CPPTOOLS_TRACE_SCOPE(ProfileModuleIncludes);
+    using namespace CppToolsPCHImpl;
+
+    OutNumSourceFiles = 0;
+    TArray<FCppToolsIncludeProfileEntry> Profile;
+
+    FString ModuleDir;
+    FText FailReason;
+    if (!GetModuleDir(ModuleName, Target, ModuleDir, FailReason)) return Profile;
+
+    const FString PCHPath = GetModulePCHPath(ModuleDir, ModuleName);
+    const FString PCHDir = FPaths::GetPath(PCHPath);
+
+    TArray<FString> SourceFiles;
+    IFileManager::Get().FindFilesRecursive(SourceFiles, *ModuleDir, TEXT("*.cpp"), true, false, false);
+    OutNumSourceFiles = SourceFiles.Num();
+
+    TMap<FString, FCppToolsIncludeProfileEntry> Entries;
+    for (const FString& SourceFile : SourceFiles)
+    {
+        FString SourceContents;
+        if (!CppToolsUtil::LoadFileToString(SourceContents, SourceFile)) continue;
+
+        // Each header counts once per translation unit, however many times it is included
+        const FString SourceDir = NormalizePath(FPaths::GetPath(SourceFile));
+        TSet<FString> IncludedHeaders;
+        for (const FString& Include : CppToolsUtil::ParseIncludes(SourceContents))
+        {
+            if (Include.EndsWith(TEXT(".generated.h"))) continue;
+
+            // Quoted includes are looked up next to the including file first, the same as the compiler does. The precompiled
+            // header is in another directory, so those includes are rewritten to resolve from it.
+            FString HeaderFile = NormalizePath(SourceDir / Include);
+            FString PCHInclude = Include;
+            if (FPaths::FileExists(HeaderFile))
+            {
+                PCHInclude = MakePCHInclude(Include, SourceDir, HeaderFile, ModuleDir, PCHDir);
+            }
+            else if (!HeaderIndex.Resolve(Include, ModuleDir, HeaderFile))
+            {
+                continue;
+            }
+            if (HeaderFile == PCHPath) continue;
+
+            bool bAlreadyIncluded;
+            IncludedHeaders.Add(HeaderFile, &bAlreadyIncluded);
+            if (bAlreadyIncluded) continue;
+
+            FCppToolsIncludeProfileEntry& Entry = Entries.FindOrAdd(HeaderFile);
+            if (Entry.Filename.IsEmpty())
+            {
+                Entry.Include = PCHInclude;
+                Entry.Filename = HeaderFile;
+                Entry.Size = IFileManager::Get().FileSize(*HeaderFile);
+            }
+            Entry.NumIncludingFiles++;
+        }
+    }
+
+    const int32 MinIncludingFiles = FMath::Max(2, FMath::CeilToInt(Settings.MinIncludeFraction * OutNumSourceFiles));
+    for (TPair<FString, FCppToolsIncludeProfileEntry>& Entry : Entries)
+    {
+        if (Entry.Value.NumIncludingFiles < MinIncludingFiles) continue;
+
+        // Headers that are still being edited would rebuild the whole module through the precompiled header
+        const int32* NumEdits = Edits.Find(Entry.Key);
+        if (NumEdits != nullptr && *NumEdits >= Settings.MinEditsForUnstableHeader) continue;
+
+        Profile.Add(MoveTemp(Entry.Value));
+    }
+
+    Profile.Sort([](const FCppToolsIncludeProfileEntry& A, const FCppToolsIncludeProfileEntry& B)
+    {
+        return A.GetScore() != B.GetScore() ? A.GetScore() > B.GetScore() : A.Include < B.Include;
+    });
+    if (Profile.Num() > Settings.MaxHeaders)
+    {
+        Profile.SetNum(Settings.MaxHeaders);
+    }
+
+    // CoreMinimal.h goes first, as the engine headers expect it to have been included before them
+    Profile.StableSort([](const FCppToolsIncludeProfileEntry& A, const FCppToolsIncludeProfileEntry& B)
+    {
+        return A.Include == TEXT("CoreMinimal.h") && B.Include != TEXT("CoreMinimal.h");
+    });
+
+    UE_LOG(LogCppToolsPCH, Log, TEXT("Module %s: %d of %d included headers in %d source files qualify for its precompiled header"),
+        *ModuleName, Profile.Num(), Entries.Num(), OutNumSourceFiles);
+    return Profile;
+}
+
+FString CppToolsPCH::GetModulePCHPath(const FString& ModulePath, const FString& ModuleName)
+{
+    return CppToolsPCHImpl::NormalizePath(ModulePath / TEXT("Private") / ModuleName + TEXT("PrivatePCH.h"));
+}
+
+bool CppToolsPCH::ReadGeneratedPCHIncludes(const FString& PCHFilename, TArray<FString>& OutIncludes)
+{
+    FString Contents;
+    if (!CppToolsUtil::LoadFileToString(Contents, PCHFilename) || !Contents.Contains(CppToolsPCHImpl::GeneratedMarker))
+    {
+        return false;
+    }
+
+    const FRegexPattern IncludePattern(TEXT("#include \"([^\"]+)\""));
+    FRegexMatcher IncludeMatcher(IncludePattern, Contents);
+    while (IncludeMatcher.FindNext())
+    {
+        OutIncludes.Add(IncludeMatcher.GetCaptureGroup(1));
+    }
+    return true;
+}
+
+float CppToolsPCH::GetProfileDrift(const TArray<FString>& A, const TArray<FString>& B)
+{
+    const TSet<FString> SetA(A);
+    const TSet<FString> SetB(B);
+    const int32 NumUnion = SetA.Union(SetB).Num();
+    if (NumUnion == 0) return 0.0f;
+
+    return 1.0f - static_cast<float>(SetA.Intersect(SetB).Num()) / NumUnion;
+}
+
+bool CppToolsPCH::GeneratePCH(const FString& ModuleName, TSharedPtr<IPlugin> Target, const TArray<FCppToolsIncludeProfileEntry>& Profile,
+    FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(GeneratePCH);
+    using namespace CppToolsPCHImpl;
+
+    FString ModuleDir;
+    if (!GetModuleDir(ModuleName, Target, ModuleDir, OutFailReason)) return false;
+    const FString PCHPath = GetModulePCHPath(ModuleDir, ModuleName);
+
+    TArray<FString> CurrentIncludes;
+    if (FPaths::FileExists(PCHPath) && !ReadGeneratedPCHIncludes(PCHPath, CurrentIncludes))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(PCHPath));
+        OutFailReason = FText::Format(LOCTEXT("PCHNotGenerated", "\"{FullFileName}\" was not generated by C++ Tools and will not be overwritten"), Args);
+        return false;
+    }
+
+    FString BuildFileContents;
+    if (!LoadBuildFile(ModuleName, Target, BuildFileContents, OutFailReason)) return false;
+    if (UsesOtherPCH(BuildFileContents, ModuleName))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+        OutFailReason = FText::Format(LOCTEXT("OtherPCHInUse", "Module \"{ModuleName}\" already uses another precompiled header, which will not be replaced"), Args);
+        return false;
+    }
+
+    // A regenerated header keeps the PCHUsage recorded when the first one was generated, as the .Build.cs file now has the changed one
+    FString OriginalPCHUsage;
+    if (!ReadOriginalPCHUsage(PCHPath, OriginalPCHUsage) && !CppToolsUtil::GetModuleRulesField(BuildFileContents, TEXT("PCHUsage"), OriginalPCHUsage))
+    {
+        OriginalPCHUsage = UnsetPCHUsage;
+    }
+
+    FString Template;
+    if (!CppToolsUtil::ReadCustomTemplateFile(TEXT("ModulePrivatePCH.h.template"), Template, OutFailReason))
+    {
+        return false;
+    }
+
+    FString Includes;
+    for (const FCppToolsIncludeProfileEntry& Entry : Profile)
+    {
+        Includes += TEXT("#include \"") + Entry.Include + TEXT("\"") LINE_TERMINATOR;
+    }
+    Includes.TrimEndInline();
+
+    FString FinalOutput = Template.Replace(TEXT("%COPYRIGHT_LINE%"), *CppToolsUtil::GetCopyrightLine(), ESearchCase::CaseSensitive);
+    FinalOutput = FinalOutput.Replace(TEXT("%MODULE_NAME%"), *ModuleName, ESearchCase::CaseSensitive);
+    FinalOutput = FinalOutput.Replace(TEXT("%PCH_INCLUDES%"), *Includes, ESearchCase::CaseSensitive);
+    FinalOutput.TrimEndInline();
+    FinalOutput += LINE_TERMINATOR LINE_TERMINATOR + FString(OriginalPCHUsagePrefix) + OriginalPCHUsage + LINE_TERMINATOR;
+
+    // Leave the file untouched if nothing changed, so it does not trigger a rebuild of the whole module
+    FString CurrentContents;
+    if (!CppToolsUtil::LoadFileToString(CurrentContents, PCHPath) || CurrentContents != FinalOutput)
+    {
+        if (FPaths::FileExists(PCHPath))
+        {
+            CppToolsUtil::TryMakeFileWriteable(PCHPath);
+        }
+        if (!CppToolsUtil::WriteOutputFile(PCHPath, FinalOutput, OutFailReason))
+        {
+            return false;
+        }
+    }
+
+    const FString PrivatePCHHeaderFile = GetPrivatePCHHeaderFileValue(ModuleName);
+    return CppToolsUtil::UpdateModuleBuildFile(ModuleName, Target, [&PrivatePCHHeaderFile](FString& BuildFileContents)
+    {
+        bool bChanged = CppToolsUtil::SetModuleRulesField(BuildFileContents, TEXT("PCHUsage"), TEXT("PCHUsageMode.UseExplicitOrSharedPCHs"));
+        bChanged |= CppToolsUtil::SetModuleRulesField(BuildFileContents, TEXT("PrivatePCHHeaderFile"), PrivatePCHHeaderFile);
+        return bChanged;
+    }, OutFailReason);
+}
+
+bool CppToolsPCH::RemovePCH(const FString& ModuleName, TSharedPtr<IPlugin> Target, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(RemovePCH);
+    using namespace CppToolsPCHImpl;
+
+    FString ModuleDir;
+    if (!GetModuleDir(ModuleName, Target, ModuleDir, OutFailReason)) return false;
+    const FString PCHPath = GetModulePCHPath(ModuleDir, ModuleName);
+
+    TArray<FString> CurrentIncludes;
+    if (!ReadGeneratedPCHIncludes(PCHPath, CurrentIncludes))
+    {
+        // Nothing was generated for this module, so any precompiled header it has is hand-written
+        return true;
+    }
+
+    // PCHUsage goes back to what it was before the header was generated. Headers that recorded nothing leave it as it is, since the
+    // module may rely on shared precompiled headers.
+    FString OriginalPCHUsage;
+    const bool bRestorePCHUsage = ReadOriginalPCHUsage(PCHPath, OriginalPCHUsage);
+    if (!CppToolsUtil::UpdateModuleBuildFile(ModuleName, Target, [bRestorePCHUsage, &OriginalPCHUsage](FString& BuildFileContents)
+    {
+        bool bChanged = CppToolsUtil::RemoveModuleRulesField(BuildFileContents, TEXT("PrivatePCHHeaderFile"));
+        if (bRestorePCHUsage)
+        {
+            bChanged |= OriginalPCHUsage == UnsetPCHUsage ? CppToolsUtil::RemoveModuleRulesField(BuildFileContents, TEXT("PCHUsage"))
+                : CppToolsUtil::SetModuleRulesField(BuildFileContents, TEXT("PCHUsage"), OriginalPCHUsage);
+        }
+        return bChanged;
+    }, OutFailReason))
+    {
+        return false;
+    }
+
+    CppToolsUtil::TryMakeFileWriteable(PCHPath);
+    if (!IFileManager::Get().Delete(*PCHPath))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(PCHPath));
+        OutFailReason = FText::Format(LOCTEXT("FailedToDeletePCH", "Failed to delete \"{FullFileName}\""), Args);
+        return false;
+    }
+    return true;
+}
+
+bool CppToolsPCH::UpdateModulePCH(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FCppToolsHeaderIndex& HeaderIndex,
+    const TMap<FString, int32>& Edits, const FCppToolsPCHSettings& Settings, FCppToolsPCHResult& OutResult, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(UpdateModulePCH);
+    using namespace CppToolsPCHImpl;
+
+    OutResult = FCppToolsPCHResult();
+    OutResult.ModuleName = ModuleName;
+
+    FString ModuleDir;
+    FString BuildFileContents;
+    if (!GetModuleDir(ModuleName, Target, ModuleDir, OutFailReason) || !LoadBuildFile(ModuleName, Target, BuildFileContents, OutFailReason))
+    {
+        return false;
+    }
+    const FString PCHPath = GetModulePCHPath(ModuleDir, ModuleName);
+
+    TArray<FString> CurrentIncludes;
+    const bool bGenerated = ReadGeneratedPCHIncludes(PCHPath, CurrentIncludes);
+    if ((!bGenerated && FPaths::FileExists(PCHPath)) || UsesOtherPCH(BuildFileContents, ModuleName))
+    {
+        OutResult.Status = TEXT("Skipped");
+        OutResult.Reason = TEXT("The module has a hand-written precompiled header");
+        return true;
+    }
+
+    int32 NumSourceFiles;
+    OutResult.Profile = ProfileModuleIncludes(ModuleName, Target, HeaderIndex, Edits, Settings, NumSourceFiles);
+    const TArray<FString> Includes = GetIncludes(OutResult.Profile);
+
+    if (NumSourceFiles < Settings.MinSourceFiles || Includes.Num() == 0)
+    {
+        OutResult.Reason = FString::Printf(TEXT("%d source files share %d stable headers"), NumSourceFiles, Includes.Num());
+        if (!bGenerated)
+        {
+            OutResult.Status = TEXT("Skipped");
+            return true;
+        }
+        OutResult.Status = TEXT("Removed");
+        return RemovePCH(ModuleName, Target, OutFailReason);
+    }
+
+    if (bGenerated)
+    {
+        OutResult.Drift = GetProfileDrift(CurrentIncludes, Includes);
+        if (OutResult.Drift <= Settings.MaxDrift)
+        {
+            OutResult.Status = TEXT("UpToDate");
+            return true;
+        }
+    }
+    OutResult.Status = bGenerated ? TEXT("Regenerated") : TEXT("Generated");
+
+    // A precompiled header is only kept if it is measured to pay off. Every source file of the module is rebuilt with and without
+    // it, and with it the header itself is touched as well, so its own compile time counts against it.
+    TArray<FString> SourceFiles;
+    IFileManager::Get().FindFilesRecursive(SourceFiles, *ModuleDir, TEXT("*.cpp"), true, false, false);
+
+    if ((bGenerated && !RemovePCH(ModuleName, Target, OutFailReason)) ||
+        !CppToolsBuild::MeasureModuleBuild(ModuleName, SourceFiles, OutResult.SecondsWithoutPCH, OutFailReason) ||
+        !GeneratePCH(ModuleName, Target, OutResult.Profile, OutFailReason))
+    {
+        return false;
+    }
+
+    TArray<FString> ChangedFiles = SourceFiles;
+    ChangedFiles.Add(PCHPath);
+    if (!CppToolsBuild::MeasureModuleBuild(ModuleName, ChangedFiles, OutResult.SecondsWithPCH, OutFailReason))
+    {
+        return false;
+    }
+    OutResult.bMeasured = true;
+
+    UE_LOG(LogCppToolsPCH, Log, TEXT("Module %s builds in %.1fs without and %.1fs with a precompiled header"), *ModuleName,
+        OutResult.SecondsWithoutPCH, OutResult.SecondsWithPCH);
+
+    if (OutResult.SecondsWithPCH > OutResult.SecondsWithoutPCH * (1.0f - Settings.MinBuildGain))
+    {
+        OutResult.Status = TEXT("Removed");
+        OutResult.Reason = TEXT("The precompiled header does not save enough build time");
+        return RemovePCH(ModuleName, Target, OutFailReason);
+    }
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,235 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsRefactor.h"
+
+#include "CppToolsDiff.h"
+#include "CppToolsFileTransaction.h"
+#include "CppToolsTrace.h"
+#include "CppToolsUtil.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsRefactor"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsRefactor, Log, All);
+
+namespace CppToolsRefactorImpl
+{
+    static const TCHAR* ChangeTypeNames[] = { TEXT("Add"), TEXT("Remove"), TEXT("Move"), TEXT("Replace") };
+
+    static bool ContainsDependency(const TArray<FStringView>& Dependencies, const FString& Name)
+    {
+        return Dependencies.ContainsByPredicate([&Name](FStringView Dependency)
+        {
+            return Dependency.Len() == Name.Len() && FCString::Strncmp(Dependency.GetData(), *Name, Name.Len()) == 0;
+        });
+    }
+
+    static bool MatchesModule(const FModuleContextInfo& Module, const FCppToolsDependencyChange& Change)
+    {
+        return (Change.ModuleTypes.Num() == 0 || Change.ModuleTypes.Contains(Module.ModuleType))
+            && (Change.ModuleNames.Num() == 0 || Change.ModuleNames.Contains(Module.ModuleName));
+    }
+}
+
+FString CppToolsRefactor::ChangeTypeToString(ECppToolsDependencyChangeType Type)
+{
+    return CppToolsRefactorImpl::ChangeTypeNames[static_cast<int32>(Type)];
+}
+
+bool CppToolsRefactor::ChangeTypeFromString(const FString& Name, ECppToolsDependencyChangeType& OutType)
+{
+    using namespace CppToolsRefactorImpl;
+
+    for (int32 I = 0; I < UE_ARRAY_COUNT(ChangeTypeNames); I++)
+    {
+        if (Name == ChangeTypeNames[I])
+        {
+            OutType = static_cast<ECppToolsDependencyChangeType>(I);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CppToolsRefactor::IsValidChange(const FCppToolsDependencyChange& Change, FText& OutFailReason)
+{
+    if (Change.Dependency.IsEmpty())
+    {
+        OutFailReason = LOCTEXT("NoDependency", "No dependency was specified");
+        return false;
+    }
+    if (Change.Type == ECppToolsDependencyChangeType::Replace && (Change.Replacement.IsEmpty() || Change.Replacement == Change.Dependency))
+    {
+        OutFailReason = LOCTEXT("NoReplacement", "A replacement different from the dependency must be specified");
+        return false;
+    }
+    return true;
+}
+
+bool CppToolsRefactor::ApplyToBuildFile(FString& BuildFileContents, const FString& ModuleName, const FCppToolsDependencyChange& Change)
+{
+    CPPTOOLS_TRACE_SCOPE(ApplyDependencyChange);
+    using namespace CppToolsRefactorImpl;
+
+    // The views point into the contents, so everything needed from them is looked up before editing
+    const FStringView Contents(*BuildFileContents, BuildFileContents.Len());
+    TArray<FStringView> PublicDependencies;
+    TArray<FStringView> Dependencies;
+    CppToolsUtil::ParseModuleDependencyViews(Contents, false, PublicDependencies);
+    CppToolsUtil::ParseModuleDependencyViews(Contents, true, Dependencies);
+
+    const bool bDepends = ContainsDependency(Dependencies, Change.Dependency);
+    const bool bPublic = ContainsDependency(PublicDependencies, Change.Dependency);
+    const bool bDependsOnReplacement = ContainsDependency(Dependencies, Change.Replacement);
+
+    // Edits are made to a copy, so a change that cannot be completed, such as a move into a list the file does not have,
+    // leaves the file as it is
+    FString Edited = BuildFileContents;
+    switch (Change.Type)
+    {
+    case ECppToolsDependencyChangeType::Add:
+        if (bDepends || ModuleName == Change.Dependency) return false;
+        if (!CppToolsUtil::InsertDependencyIntoBuildFile(Edited, Change.Dependency, Change.bPrivate)) return false;
+        break;
+
+    case ECppToolsDependencyChangeType::Remove:
+        if (!bDepends || !CppToolsUtil::RemoveDependencyFromBuildFile(Edited, Change.Dependency)) return false;
+        break;
+
+    case ECppToolsDependencyChangeType::Move:
+        // Only dependencies in the other list are moved
+        if (!bDepends || bPublic != Change.bPrivate) return false;
+        CppToolsUtil::RemoveDependencyFromBuildFile(Edited, Change.Dependency);
+        if (!CppToolsUtil::InsertDependencyIntoBuildFile(Edited, Change.Dependency, Change.bPrivate)) return false;
+        break;
+
+    case ECppToolsDependencyChangeType::Replace:
+        if (!bDepends) return false;
+        CppToolsUtil::RemoveDependencyFromBuildFile(Edited, Change.Dependency);
+        if (!bDependsOnReplacement && ModuleName != Change.Replacement
+            && !CppToolsUtil::InsertDependencyIntoBuildFile(Edited, Change.Replacement, !bPublic))
+        {
+            return false;
+        }
+        break;
+    }
+
+    if (Edited.Equals(BuildFileContents, ESearchCase::CaseSensitive)) return false;
+
+    BuildFileContents = MoveTemp(Edited);
+    return true;
+}
+
+bool CppToolsRefactor::PreviewChange(const FCppToolsDependencyChange& Change, TArray<FCppToolsFileEdit>& OutEdits, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(PreviewDependencyChange);
+    using namespace CppToolsRefactorImpl;
+
+    OutEdits.Reset();
+    if (!IsValidChange(Change, OutFailReason)) return false;
+
+    TArray<TPair<FModuleContextInfo, TSharedPtr<IPlugin>>> Modules;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        if (MatchesModule(Module.Key, Change))
+        {
+            Modules.Add(Module);
+        }
+    }
+
+    // The build files are found up front, as they may be outside the module source path
+    TArray<FCppToolsFileEdit> Edits;
+    Edits.SetNum(Modules.Num());
+    for (int32 I = 0; I < Modules.Num(); I++)
+    {
+        Edits[I].ModuleName = Modules[I].Key.ModuleName;
+        if (!CppToolsUtil::GetModuleBuildFilePath(Edits[I].ModuleName, Modules[I].Value, Edits[I].Filename))
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("ModuleName"), FText::FromString(Edits[I].ModuleName));
+            OutFailReason = FText::Format(LOCTEXT("ModuleBuildFileNotFound", "Could not find the .Build.cs file of module \"{ModuleName}\""), Args);
+            return false;
+        }
+    }
+
+    // Every file is read, edited and diffed independently, so the modules are spread over the worker threads
+    TArray<bool> ReadFailed;
+    ReadFailed.SetNumZeroed(Modules.Num());
+    ParallelFor(Modules.Num(), [&Change, &Edits, &ReadFailed](int32 Index)
+    {
+        FCppToolsFileEdit& Edit = Edits[Index];
+        Edit.TimeStamp = IFileManager::Get().GetTimeStamp(*Edit.Filename);
+
+        FString Contents;
+        if (!CppToolsUtil::LoadFileToString(Contents, Edit.Filename))
+        {
+            ReadFailed[Index] = true;
+            return;
+        }
+
+        Edit.NewContents = Contents;
+        if (ApplyToBuildFile(Edit.NewContents, Edit.ModuleName, Change))
+        {
+            Edit.Diff = CppToolsDiff::MakeUnifiedDiff(Edit.Filename, Contents, Edit.NewContents);
+        }
+    });
+
+    for (int32 I = 0; I < Edits.Num(); I++)
+    {
+        if (ReadFailed[I])
+        {
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("FullFileName"), FText::FromString(Edits[I].Filename));
+            OutFailReason = FText::Format(LOCTEXT("FailedToReadBuildFile", "Failed to read \"{FullFileName}\""), Args);
+            OutEdits.Reset();
+            return false;
+        }
+        if (!Edits[I].Diff.IsEmpty())
+        {
+            OutEdits.Add(MoveTemp(Edits[I]));
+        }
+    }
+
+    UE_LOG(LogCppToolsRefactor, Log, TEXT("%s %s changes %d of %d modules"), *ChangeTypeToString(Change.Type), *Change.Dependency,
+        OutEdits.Num(), Modules.Num());
+    return true;
+}
+
+bool CppToolsRefactor::ApplyEdits(const TArray<FCppToolsFileEdit>& Edits, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(ApplyBuildFileEdits);
+
+    if (Edits.Num() == 0) return true;
+
+    FCppToolsFileTransaction Transaction;
+    for (const FCppToolsFileEdit& Edit : Edits)
+    {
+        if (!Transaction.StageReplace(Edit.Filename, Edit.NewContents, Edit.TimeStamp, OutFailReason)) return false;
+    }
+    if (!Transaction.Commit(OutFailReason)) return false;
+
+    Transaction.Finish();
+    return true;
+}
+
+FString CppToolsRefactor::JoinDiffs(const TArray<FCppToolsFileEdit>& Edits)
+{
+    int32 Length = 0;
+    for (const FCppToolsFileEdit& Edit : Edits)
+    {
+        Length += Edit.Diff.Len();
+    }
+
+    FString Result;
+    Result.Reserve(Length);
+    for (const FCppToolsFileEdit& Edit : Edits)
+    {
+        Result += Edit.Diff;
+    }
+    return Result;
+}
+
+#undef LOCTEXT_NAMESPACE
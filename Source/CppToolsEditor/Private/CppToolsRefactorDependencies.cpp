@@ -0,0 +1,265 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsRefactorDependencies.h"
+
+#include "CppToolsUtil.h"
+
+#include "EditorStyleSet.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SEditableTextBox.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/SBoxPanel.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsRefactorDependencies"
+
+void SCppToolsRefactorDependencies::Construct(const FArguments& InArgs)
+{
+    for (int32 I = 0; I <= static_cast<int32>(ECppToolsDependencyChangeType::Replace); I++)
+    {
+        AvailableChangeTypes.Add(MakeShareable(new ECppToolsDependencyChangeType(static_cast<ECppToolsDependencyChangeType>(I))));
+    }
+    ChangeType = AvailableChangeTypes[0];
+
+    // Every module comes first, followed by each module type
+    AvailableModuleTypes.Add(MakeShareable(new int32(EHostType::Max)));
+    for (int32 I = 0; I < EHostType::Max; I++)
+    {
+        AvailableModuleTypes.Add(MakeShareable(new int32(I)));
+    }
+    ModuleType = AvailableModuleTypes[0];
+
+    ChildSlot
+    [
+        SNew(SBorder)
+        .Padding(8)
+        .BorderImage(FEditorStyle::GetBrush("Docking.Tab.ContentAreaBrush"))
+        [
+            SNew(SVerticalBox)
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 8)
+            [
+                SNew(STextBlock)
+                .Text(LOCTEXT("RefactorDescription", "Changes the dependency lists of every matching module's .Build.cs file. Preview the change to see a diff of every file it edits, then apply it to write only the files that changed."))
+                .AutoWrapText(true)
+            ]
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 8)
+            [
+                SNew(SHorizontalBox)
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                [
+                    SNew(SComboBox<TSharedPtr<ECppToolsDependencyChangeType>>)
+                    .ToolTipText(LOCTEXT("ChangeTypeToolTip", "Choose how the dependency is changed"))
+                    .OptionsSource(&AvailableChangeTypes)
+                    .InitiallySelectedItem(ChangeType)
+                    .OnSelectionChanged(this, &SCppToolsRefactorDependencies::OnChangeTypeChanged)
+                    .OnGenerateWidget(this, &SCppToolsRefactorDependencies::MakeWidgetForChangeTypeCombo)
+                    [
+                        SNew(STextBlock)
+                        .Text(this, &SCppToolsRefactorDependencies::OnGetChangeTypeComboText)
+                    ]
+                ]
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.0f)
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SEditableTextBox)
+                    .HintText(LOCTEXT("DependencyHint", "Dependency"))
+                    .OnTextChanged_Lambda([this](const FText& NewText)
+                    {
+                        Change.Dependency = NewText.ToString().TrimStartAndEnd();
+                        ClearPreview();
+                    })
+                ]
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.0f)
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SEditableTextBox)
+                    .HintText(LOCTEXT("ReplacementHint", "Replacement"))
+                    .IsEnabled_Lambda([this]() { return *ChangeType == ECppToolsDependencyChangeType::Replace; })
+                    .OnTextChanged_Lambda([this](const FText& NewText)
+                    {
+                        Change.Replacement = NewText.ToString().TrimStartAndEnd();
+                        ClearPreview();
+                    })
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SComboBox<TSharedPtr<int32>>)
+                    .ToolTipText(LOCTEXT("ModuleTypeToolTip", "Choose the type of the modules to change"))
+                    .OptionsSource(&AvailableModuleTypes)
+                    .InitiallySelectedItem(ModuleType)
+                    .OnSelectionChanged(this, &SCppToolsRefactorDependencies::OnModuleTypeChanged)
+                    .OnGenerateWidget(this, &SCppToolsRefactorDependencies::MakeWidgetForModuleTypeCombo)
+                    [
+                        SNew(STextBlock)
+                        .Text(this, &SCppToolsRefactorDependencies::OnGetModuleTypeComboText)
+                    ]
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .VAlign(VAlign_Center)
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SCheckBox)
+                    .ToolTipText(LOCTEXT("PrivateToolTip", "Adds the dependency to, or moves it into, the private dependency list instead of the public one"))
+                    .OnCheckStateChanged_Lambda([this](ECheckBoxState NewState)
+                    {
+                        Change.bPrivate = NewState == ECheckBoxState::Checked;
+                        ClearPreview();
+                    })
+                    [
+                        SNew(STextBlock)
+                        .Text(LOCTEXT("Private", "Private"))
+                    ]
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("Preview", "Preview"))
+                    .OnClicked(this, &SCppToolsRefactorDependencies::PreviewClicked)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("Apply", "Apply"))
+                    .ToolTipText(LOCTEXT("ApplyToolTip", "Writes the previewed edits"))
+                    .IsEnabled(this, &SCppToolsRefactorDependencies::CanApply)
+                    .OnClicked(this, &SCppToolsRefactorDependencies::ApplyClicked)
+                ]
+            ]
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 4)
+            [
+                SAssignNew(StatusTextBlock, STextBlock)
+            ]
+
+            + SVerticalBox::Slot()
+            .FillHeight(1.0f)
+            [
+                SAssignNew(DiffTextBox, SMultiLineEditableTextBox)
+                .IsReadOnly(true)
+                .Font(FCoreStyle::GetDefaultFontStyle("Mono", 9))
+            ]
+        ]
+    ];
+}
+
+FReply SCppToolsRefactorDependencies::PreviewClicked()
+{
+    Change.Type = *ChangeType;
+    Change.ModuleTypes.Reset();
+    if (*ModuleType != EHostType::Max)
+    {
+        Change.ModuleTypes.Add(static_cast<EHostType::Type>(*ModuleType));
+    }
+
+    FText FailReason;
+    if (!CppToolsRefactor::PreviewChange(Change, Edits, FailReason))
+    {
+        ClearPreview();
+        StatusTextBlock->SetText(FailReason);
+        return FReply::Handled();
+    }
+
+    StatusTextBlock->SetText(FText::Format(LOCTEXT("PreviewStatus", "{0} .Build.cs files change"), Edits.Num()));
+    DiffTextBox->SetText(FText::FromString(CppToolsRefactor::JoinDiffs(Edits)));
+    return FReply::Handled();
+}
+
+FReply SCppToolsRefactorDependencies::ApplyClicked()
+{
+    FText FailReason;
+    if (!CppToolsRefactor::ApplyEdits(Edits, FailReason))
+    {
+        CppToolsUtil::PushNotification(FText::Format(LOCTEXT("ApplyFailed", "Failed to change dependencies. {0}"), FailReason),
+            SNotificationItem::CS_Fail);
+        return FReply::Handled();
+    }
+
+    CppToolsUtil::PushNotification(FText::Format(LOCTEXT("Applied", "Updated {0} .Build.cs files"), Edits.Num()), SNotificationItem::CS_Success);
+    ClearPreview();
+    return FReply::Handled();
+}
+
+bool SCppToolsRefactorDependencies::CanApply() const
+{
+    return Edits.Num() > 0;
+}
+
+void SCppToolsRefactorDependencies::ClearPreview()
+{
+    if (Edits.Num() == 0 && DiffTextBox->GetText().IsEmpty()) return;
+
+    Edits.Reset();
+    StatusTextBlock->SetText(FText::GetEmpty());
+    DiffTextBox->SetText(FText::GetEmpty());
+}
+
+FText SCppToolsRefactorDependencies::OnGetChangeTypeComboText() const
+{
+    return FText::FromString(CppToolsRefactor::ChangeTypeToString(*ChangeType));
+}
+
+void SCppToolsRefactorDependencies::OnChangeTypeChanged(TSharedPtr<ECppToolsDependencyChangeType> Value, ESelectInfo::Type SelectInfo)
+{
+    ChangeType = Value;
+    ClearPreview();
+}
+
+TSharedRef<SWidget> SCppToolsRefactorDependencies::MakeWidgetForChangeTypeCombo(TSharedPtr<ECppToolsDependencyChangeType> Value)
+{
+    return SNew(STextBlock)
+        .Text(FText::FromString(CppToolsRefactor::ChangeTypeToString(*Value)));
+}
+
+FText SCppToolsRefactorDependencies::OnGetModuleTypeComboText() const
+{
+    return GetModuleTypeText(*ModuleType);
+}
+
+void SCppToolsRefactorDependencies::OnModuleTypeChanged(TSharedPtr<int32> Value, ESelectInfo::Type SelectInfo)
+{
+    ModuleType = Value;
+    ClearPreview();
+}
+
+TSharedRef<SWidget> SCppToolsRefactorDependencies::MakeWidgetForModuleTypeCombo(TSharedPtr<int32> Value)
+{
+    return SNew(STextBlock)
+        .Text(GetModuleTypeText(*Value));
+}
+
+FText SCppToolsRefactorDependencies::GetModuleTypeText(int32 InModuleType)
+{
+    if (InModuleType == EHostType::Max)
+    {
+        return LOCTEXT("AllModules", "All Modules");
+    }
+    return FText::FromString(EHostType::ToString(static_cast<EHostType::Type>(InModuleType)));
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,512 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsScaleTest.h"
+
+#include "CppToolsFuzzyIndex.h"
+#include "CppToolsUtil.h"
+#include "CreateModuleDialog.h"
+
+#include "PluginDescriptor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Math/RandomStream.h"
+#include "Framework/Application/SlateApplication.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsScaleTest"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsScaleTest, Log, All);
+
+namespace CppToolsScaleTestImpl
+{
+    /** The number of times stages that do not depend on the number of modules are repeated. */
+    static const int32 NumRepeats = 10;
+
+    /** The file marking a directory as the root of a synthetic project, so nothing else is ever deleted in its place. */
+    static const TCHAR* MarkerFilename = TEXT(".cpptools-synthetic-project");
+    static const TCHAR* PluginNamePattern = TEXT("ScalePlugin*");
+
+    static FString MakePluginName(int32 PluginIndex)
+    {
+        return FString::Printf(TEXT("ScalePlugin%d"), PluginIndex);
+    }
+
+    static FString MakeModuleName(int32 PluginIndex, int32 ModuleIndex)
+    {
+        return FString::Printf(TEXT("ScalePlugin%dModule%d"), PluginIndex, ModuleIndex);
+    }
+
+    static FCppToolsScaleMeasurement& AddMeasurement(TArray<FCppToolsScaleMeasurement>& OutMeasurements, const FString& Stage,
+        const FCppToolsSyntheticProjectSettings& Settings, int32 NumModules)
+    {
+        FCppToolsScaleMeasurement& Measurement = OutMeasurements.AddDefaulted_GetRef();
+        Measurement.Stage = Stage;
+        Measurement.NumPlugins = Settings.NumPlugins;
+        Measurement.NumModules = NumModules;
+        return Measurement;
+    }
+
+    static void AddSample(FCppToolsScaleMeasurement& Measurement, double StartTime)
+    {
+        const double Seconds = FPlatformTime::Seconds() - StartTime;
+        Measurement.Samples++;
+        Measurement.TotalSeconds += Seconds;
+        Measurement.MaxSeconds = FMath::Max(Measurement.MaxSeconds, Seconds);
+    }
+}
+
+FString CppToolsScaleTest::GetDefaultRootDir()
+{
+    return FPaths::ConvertRelativePathToFull(FPaths::ProjectPluginsDir() / TEXT("CppToolsScaleTest"));
+}
+
+FString CppToolsScaleTest::GetResultsDirectory()
+{
+    return FPaths::ProjectSavedDir() / TEXT("CppTools") / TEXT("ScaleTests");
+}
+
+bool CppToolsScaleTest::ParseDependencyShape(const FString& ShapeName, ECppToolsDependencyShape& OutShape)
+{
+    if (ShapeName == TEXT("Chain")) OutShape = ECppToolsDependencyShape::Chain;
+    else if (ShapeName == TEXT("Tree")) OutShape = ECppToolsDependencyShape::Tree;
+    else if (ShapeName == TEXT("RandomDAG")) OutShape = ECppToolsDependencyShape::RandomDAG;
+    else return false;
+    return true;
+}
+
+FString CppToolsScaleTest::GetDependencyShapeName(ECppToolsDependencyShape Shape)
+{
+    switch (Shape)
+    {
+    case ECppToolsDependencyShape::Chain: return TEXT("Chain");
+    case ECppToolsDependencyShape::Tree: return TEXT("Tree");
+    case ECppToolsDependencyShape::RandomDAG: return TEXT("RandomDAG");
+    }
+    return FString();
+}
+
+bool CppToolsScaleTest::GenerateSyntheticProject(const FCppToolsSyntheticProjectSettings& Settings, TArray<FCppToolsSyntheticModule>& OutModules,
+    FText& OutFailReason)
+{
+    using namespace CppToolsScaleTestImpl;
+
+    if (Settings.NumPlugins < 1 || Settings.ModulesPerPlugin < 1)
+    {
+        OutFailReason = LOCTEXT("EmptySyntheticProject", "A synthetic project must have at least one plugin with at least one module");
+        return false;
+    }
+
+    if (!IsValidRootDir(Settings.RootDir, OutFailReason)) return false;
+
+    // Only a synthetic project generated before is replaced, never a directory holding anything else
+    const FString MarkerFile = Settings.RootDir / MarkerFilename;
+    TArray<FString> ExistingFiles;
+    IFileManager::Get().FindFiles(ExistingFiles, *(Settings.RootDir / TEXT("*")), true, true);
+    if (ExistingFiles.Num() > 0 && !IFileManager::Get().FileExists(*MarkerFile))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Directory"), FText::FromString(Settings.RootDir));
+        OutFailReason = FText::Format(LOCTEXT("RootDirNotSynthetic",
+            "\"{Directory}\" is not empty and was not generated by the scale test, choose an empty or new directory"), Args);
+        return false;
+    }
+    if (!DeleteSyntheticProject(Settings.RootDir, OutFailReason)) return false;
+
+    if (!FFileHelper::SaveStringToFile(TEXT("Generated by the C++ Tools scale test, which deletes the ScalePlugin* directories next to this file.\n"),
+        *MarkerFile))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(MarkerFile));
+        OutFailReason = FText::Format(LOCTEXT("FailedToWriteMarker", "Failed to write \"{FullFileName}\""), Args);
+        return false;
+    }
+
+    FRandomStream Random(Settings.Seed);
+    const int32 NumModules = Settings.NumPlugins * Settings.ModulesPerPlugin;
+
+    OutModules.Reset(NumModules);
+    TArray<TArray<int32>> DependencyIndices;
+    for (int32 ModuleIndex = 0; ModuleIndex < NumModules; ModuleIndex++)
+    {
+        FCppToolsSyntheticModule& Module = OutModules.AddDefaulted_GetRef();
+        Module.PluginName = MakePluginName(ModuleIndex / Settings.ModulesPerPlugin);
+        Module.ModuleName = MakeModuleName(ModuleIndex / Settings.ModulesPerPlugin, ModuleIndex % Settings.ModulesPerPlugin);
+
+        DependencyIndices.Add(MakeDependencyIndices(ModuleIndex, Settings, Random));
+        for (int32 DependencyIndex : DependencyIndices.Last())
+        {
+            Module.Dependencies.Add(OutModules[DependencyIndex].ModuleName);
+        }
+    }
+
+    FScopedSlowTask SlowTask(Settings.NumPlugins, LOCTEXT("GeneratingSyntheticProject", "Generating synthetic project..."));
+    if (CppToolsUtil::IsInteractive())
+    {
+        SlowTask.MakeDialog();
+    }
+
+    for (int32 PluginIndex = 0; PluginIndex < Settings.NumPlugins; PluginIndex++)
+    {
+        SlowTask.EnterProgressFrame();
+
+        const FString PluginName = MakePluginName(PluginIndex);
+        const FString PluginDir = Settings.RootDir / PluginName;
+
+        FPluginDescriptor Descriptor;
+        Descriptor.FriendlyName = PluginName;
+        Descriptor.Description = TEXT("Synthetic plugin generated by the C++ Tools scale test.");
+        Descriptor.Category = TEXT("CppToolsScaleTest");
+        Descriptor.EnabledByDefault = EPluginEnabledByDefault::Disabled;
+
+        TSet<int32> PluginDependencies;
+        for (int32 ModuleIndex = PluginIndex * Settings.ModulesPerPlugin; ModuleIndex < (PluginIndex + 1) * Settings.ModulesPerPlugin; ModuleIndex++)
+        {
+            const FCppToolsSyntheticModule& Module = OutModules[ModuleIndex];
+            const FString ModuleDir = PluginDir / TEXT("Source") / Module.ModuleName;
+
+            TArray<FString> PublicDependencyModuleNames;
+            PublicDependencyModuleNames.Add(TEXT("Core"));
+            PublicDependencyModuleNames.Add(TEXT("CoreUObject"));
+            PublicDependencyModuleNames.Add(TEXT("Engine"));
+            PublicDependencyModuleNames.Append(Module.Dependencies);
+            TArray<FString> PrivateDependencyModuleNames;
+
+            TArray<FString> PublicHeaderIncludes;
+            for (const FString& Dependency : Module.Dependencies)
+            {
+                PublicHeaderIncludes.Add(Dependency + TEXT(".h"));
+            }
+
+            if (!CppToolsUtil::GenerateModuleBuildFile(ModuleDir / Module.ModuleName + TEXT(".Build.cs"), Module.ModuleName, PublicDependencyModuleNames,
+                    PrivateDependencyModuleNames, OutFailReason, false)
+                || !CppToolsUtil::GenerateModuleHeaderFile(ModuleDir / TEXT("Public") / Module.ModuleName + TEXT(".h"), Module.ModuleName,
+                    PublicHeaderIncludes, OutFailReason)
+                || !CppToolsUtil::GenerateModuleCPPFile(ModuleDir / TEXT("Private") / Module.ModuleName + TEXT(".cpp"), Module.ModuleName,
+                    FString(), FString(), OutFailReason)
+                || !GenerateSyntheticSourceFiles(ModuleDir, Module, Settings.FilesPerModule, Settings.LinesPerFile, OutFailReason))
+            {
+                return false;
+            }
+
+            Descriptor.Modules.Add(FModuleDescriptor(*Module.ModuleName, EHostType::Runtime, ELoadingPhase::Default));
+
+            // Modules depending on modules of another plugin require that plugin to be enabled
+            for (int32 DependencyIndex : DependencyIndices[ModuleIndex])
+            {
+                if (DependencyIndex / Settings.ModulesPerPlugin != PluginIndex)
+                {
+                    PluginDependencies.Add(DependencyIndex / Settings.ModulesPerPlugin);
+                }
+            }
+        }
+
+        for (int32 PluginDependency : PluginDependencies)
+        {
+            Descriptor.Plugins.Add(FPluginReferenceDescriptor(MakePluginName(PluginDependency), true));
+        }
+
+        if (!Descriptor.Save(PluginDir / PluginName + TEXT(".uplugin"), OutFailReason))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CppToolsScaleTest::IsValidRootDir(const FString& RootDir, FText& OutFailReason)
+{
+    const FString FullRootDir = FPaths::ConvertRelativePathToFull(RootDir);
+    const FString AllowedDirs[] = { FPaths::ProjectPluginsDir(), FPaths::ProjectIntermediateDir() };
+    for (const FString& AllowedDir : AllowedDirs)
+    {
+        const FString FullAllowedDir = FPaths::ConvertRelativePathToFull(AllowedDir);
+        if (FPaths::IsUnderDirectory(FullRootDir, FullAllowedDir) && !FPaths::IsSamePath(FullRootDir, FullAllowedDir))
+        {
+            return true;
+        }
+    }
+
+    FFormatNamedArguments Args;
+    Args.Add(TEXT("Directory"), FText::FromString(FullRootDir));
+    OutFailReason = FText::Format(LOCTEXT("InvalidRootDir",
+        "Synthetic projects can only be generated below the project's Plugins or Intermediate folder, not in \"{Directory}\""), Args);
+    return false;
+}
+
+bool CppToolsScaleTest::DeleteSyntheticProject(const FString& RootDir, FText& OutFailReason)
+{
+    using namespace CppToolsScaleTestImpl;
+
+    if (!IsValidRootDir(RootDir, OutFailReason)) return false;
+    if (!IFileManager::Get().DirectoryExists(*RootDir)) return true;
+
+    const FString MarkerFile = RootDir / MarkerFilename;
+    if (!IFileManager::Get().FileExists(*MarkerFile))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Directory"), FText::FromString(RootDir));
+        OutFailReason = FText::Format(LOCTEXT("DeleteRootDirNotSynthetic", "\"{Directory}\" was not generated by the scale test, it was not deleted"), Args);
+        return false;
+    }
+
+    TArray<FString> PluginDirs;
+    IFileManager::Get().FindFiles(PluginDirs, *(RootDir / PluginNamePattern), false, true);
+    bool bDeleted = true;
+    for (const FString& PluginDir : PluginDirs)
+    {
+        bDeleted &= IFileManager::Get().DeleteDirectory(*(RootDir / PluginDir), false, true);
+    }
+
+    if (bDeleted)
+    {
+        // The root directory is only removed if nothing but the generated plugins was in it
+        IFileManager::Get().Delete(*MarkerFile);
+        IFileManager::Get().DeleteDirectory(*RootDir, false, false);
+    }
+    IPluginManager::Get().RefreshPluginsList();
+
+    if (!bDeleted)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Directory"), FText::FromString(RootDir));
+        OutFailReason = FText::Format(LOCTEXT("FailedToDeleteSyntheticProject", "Failed to delete the synthetic project in \"{Directory}\""), Args);
+    }
+    return bDeleted;
+}
+
+bool CppToolsScaleTest::RunScaleTest(const FCppToolsSyntheticProjectSettings& Settings, const TArray<int32>& PluginCounts,
+    TArray<FCppToolsScaleMeasurement>& OutMeasurements, FText& OutFailReason)
+{
+    for (int32 NumPlugins : PluginCounts)
+    {
+        FCppToolsSyntheticProjectSettings SizeSettings = Settings;
+        SizeSettings.NumPlugins = NumPlugins;
+
+        UE_LOG(LogCppToolsScaleTest, Display, TEXT("Generating %d plugins with %d modules each (%s)..."), NumPlugins, SizeSettings.ModulesPerPlugin,
+            *GetDependencyShapeName(SizeSettings.Shape));
+
+        TArray<FCppToolsSyntheticModule> Modules;
+        const double GenerateStartTime = FPlatformTime::Seconds();
+        if (!GenerateSyntheticProject(SizeSettings, Modules, OutFailReason))
+        {
+            FText DeleteFailReason;
+            DeleteSyntheticProject(SizeSettings.RootDir, DeleteFailReason);
+            return false;
+        }
+        CppToolsScaleTestImpl::AddSample(CppToolsScaleTestImpl::AddMeasurement(OutMeasurements, TEXT("GenerateSyntheticProject"), SizeSettings,
+            Modules.Num()), GenerateStartTime);
+
+        MeasureStages(SizeSettings, Modules, OutMeasurements);
+
+        if (!DeleteSyntheticProject(SizeSettings.RootDir, OutFailReason)) return false;
+    }
+    return true;
+}
+
+bool CppToolsScaleTest::SaveMeasurements(const TArray<FCppToolsScaleMeasurement>& Measurements, const FString& Filename)
+{
+    FString Csv = TEXT("Stage,Plugins,Modules,Samples,TotalSeconds,MeanSeconds,MaxSeconds\n");
+    for (const FCppToolsScaleMeasurement& Measurement : Measurements)
+    {
+        Csv += FString::Printf(TEXT("%s,%d,%d,%d,%f,%f,%f\n"), *Measurement.Stage, Measurement.NumPlugins, Measurement.NumModules,
+            Measurement.Samples, Measurement.TotalSeconds, Measurement.GetMeanSeconds(), Measurement.MaxSeconds);
+    }
+    return FFileHelper::SaveStringToFile(Csv, *Filename);
+}
+
+TArray<int32> CppToolsScaleTest::MakeDependencyIndices(int32 ModuleIndex, const FCppToolsSyntheticProjectSettings& Settings, FRandomStream& Random)
+{
+    TArray<int32> Result;
+    if (ModuleIndex == 0) return Result;
+
+    switch (Settings.Shape)
+    {
+    case ECppToolsDependencyShape::Chain:
+        Result.Add(ModuleIndex - 1);
+        break;
+    case ECppToolsDependencyShape::Tree:
+        Result.Add((ModuleIndex - 1) / FMath::Max(2, Settings.MaxDependencies));
+        break;
+    case ECppToolsDependencyShape::RandomDAG:
+        for (int32 I = FMath::Min(Settings.MaxDependencies, ModuleIndex); I > 0; I--)
+        {
+            Result.AddUnique(Random.RandHelper(ModuleIndex));
+        }
+        Result.Sort();
+        break;
+    }
+    return Result;
+}
+
+bool CppToolsScaleTest::GenerateSyntheticSourceFiles(const FString& ModuleDir, const FCppToolsSyntheticModule& Module, int32 NumFiles, int32 NumLines,
+    FText& OutFailReason)
+{
+    const FString CopyrightLine = CppToolsUtil::GetCopyrightLine();
+    const FString APIMacro = CppToolsUtil::GetModuleAPIMacro(Module.ModuleName, false);
+
+    for (int32 FileIndex = 0; FileIndex < NumFiles; FileIndex++)
+    {
+        const FString FileName = FString::Printf(TEXT("%sFile%d"), *Module.ModuleName, FileIndex);
+
+        FString Header = CopyrightLine + TEXT("\n\n#pragma once\n\n#include \"CoreMinimal.h\"\n");
+        FString Source = CopyrightLine + TEXT("\n\n#include \"") + FileName + TEXT(".h\"\n");
+        if (FileIndex == 0)
+        {
+            // Include the dependencies from one file so the include graph follows the dependency graph
+            for (const FString& Dependency : Module.Dependencies)
+            {
+                Header += TEXT("#include \"") + Dependency + TEXT(".h\"\n");
+            }
+        }
+        Header += TEXT("\n");
+        Source += TEXT("\n");
+
+        for (int32 Line = 0; Line < NumLines; Line++)
+        {
+            Header += FString::Printf(TEXT("%sint32 %s_Function%d(int32 Value);\n"), *APIMacro, *FileName, Line);
+            Source += FString::Printf(TEXT("int32 %s_Function%d(int32 Value) { return Value + %d; }\n"), *FileName, Line, Line);
+        }
+
+        if (!CppToolsUtil::WriteOutputFile(ModuleDir / TEXT("Public") / FileName + TEXT(".h"), Header, OutFailReason)
+            || !CppToolsUtil::WriteOutputFile(ModuleDir / TEXT("Private") / FileName + TEXT(".cpp"), Source, OutFailReason))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CppToolsScaleTest::MeasureStages(const FCppToolsSyntheticProjectSettings& Settings, const TArray<FCppToolsSyntheticModule>& Modules,
+    TArray<FCppToolsScaleMeasurement>& OutMeasurements)
+{
+    using namespace CppToolsScaleTestImpl;
+
+    const int32 NumModules = Modules.Num();
+
+    // Discover the generated plugins
+    {
+        FCppToolsScaleMeasurement& Measurement = AddMeasurement(OutMeasurements, TEXT("DiscoverPlugins"), Settings, NumModules);
+        const double StartTime = FPlatformTime::Seconds();
+        IPluginManager::Get().RefreshPluginsList();
+        AddSample(Measurement, StartTime);
+    }
+
+    // Construct the create module dialog, which lists every project plugin as a target
+    if (FSlateApplication::IsInitialized())
+    {
+        FCppToolsScaleMeasurement& Measurement = AddMeasurement(OutMeasurements, TEXT("OpenDialog"), Settings, NumModules);
+        for (int32 Repeat = 0; Repeat < NumRepeats; Repeat++)
+        {
+            const double StartTime = FPlatformTime::Seconds();
+            TSharedRef<SCreateModuleDialog> Dialog = SNew(SCreateModuleDialog);
+            AddSample(Measurement, StartTime);
+        }
+    }
+    else
+    {
+        UE_LOG(LogCppToolsScaleTest, Display, TEXT("Slate is not initialized, skipping the OpenDialog stage"));
+    }
+
+    // Index the targets of the dialog's target picker, as it does when it first opens, then type the name of the last plugin
+    // into its search box, with one sample per keystroke
+    {
+        FCppToolsFuzzyIndex TargetIndex;
+        {
+            FCppToolsScaleMeasurement& Measurement = AddMeasurement(OutMeasurements, TEXT("IndexTargets"), Settings, NumModules);
+            const double StartTime = FPlatformTime::Seconds();
+            for (const TSharedPtr<IPlugin>& Plugin : CppToolsUtil::GetProjectPlugins())
+            {
+                TargetIndex.Add(Plugin->GetDescriptor().FriendlyName + TEXT(" ") + Plugin->GetName(), Plugin->GetDescriptor().Category);
+            }
+            AddSample(Measurement, StartTime);
+        }
+
+        FCppToolsScaleMeasurement& Measurement = AddMeasurement(OutMeasurements, TEXT("FilterTargets"), Settings, NumModules);
+        const FString Query = MakePluginName(Settings.NumPlugins - 1).ToLower();
+        TArray<int32> Matches;
+        for (int32 QueryLen = 1; QueryLen <= Query.Len(); QueryLen++)
+        {
+            const TArray<int32> Candidates = MoveTemp(Matches);
+            const double StartTime = FPlatformTime::Seconds();
+            TargetIndex.Filter(Query.Left(QueryLen), Matches, QueryLen > 1 ? &Candidates : nullptr);
+            AddSample(Measurement, StartTime);
+        }
+    }
+
+    // Validate a new module name, as the dialog does on every keystroke
+    {
+        FCppToolsScaleMeasurement& Measurement = AddMeasurement(OutMeasurements, TEXT("ValidateModuleName"), Settings, NumModules);
+        const TSharedPtr<IPlugin> Target = CppToolsUtil::FindProjectPlugin(Modules.Last().PluginName);
+        for (int32 Repeat = 0; Repeat < NumRepeats; Repeat++)
+        {
+            FText FailReason;
+            const double StartTime = FPlatformTime::Seconds();
+            CppToolsUtil::IsValidNewModuleName(FString::Printf(TEXT("ScaleTestNewModule%d"), Repeat), FailReason);
+            CppToolsUtil::GetNewModulePath(FString::Printf(TEXT("ScaleTestNewModule%d"), Repeat), Target);
+            AddSample(Measurement, StartTime);
+        }
+    }
+
+    // List every plugin and its modules
+    {
+        FCppToolsScaleMeasurement& Measurement = AddMeasurement(OutMeasurements, TEXT("ListModules"), Settings, NumModules);
+        for (int32 Repeat = 0; Repeat < NumRepeats; Repeat++)
+        {
+            const double StartTime = FPlatformTime::Seconds();
+            for (const TSharedPtr<IPlugin>& Plugin : CppToolsUtil::GetProjectPlugins())
+            {
+                CppToolsUtil::GetPluginModules(Plugin);
+            }
+            AddSample(Measurement, StartTime);
+        }
+    }
+
+    // Query the dependencies of every module, with one sample per module
+    {
+        FCppToolsScaleMeasurement& Measurement = AddMeasurement(OutMeasurements, TEXT("QueryDependencies"), Settings, NumModules);
+        for (const FCppToolsSyntheticModule& Module : Modules)
+        {
+            const double StartTime = FPlatformTime::Seconds();
+            CppToolsUtil::GetModuleDependencies(Module.ModuleName, CppToolsUtil::FindProjectPlugin(Module.PluginName), true);
+            AddSample(Measurement, StartTime);
+        }
+    }
+
+    // Generate the files of a new module and add it to an existing module, as the first stages of GenerateModule do.
+    // Compiling is left out, as it does not depend on the size of the project.
+    {
+        FCppToolsScaleMeasurement& Measurement = AddMeasurement(OutMeasurements, TEXT("GenerateModuleFiles"), Settings, NumModules);
+        const FCppToolsSyntheticModule& Owner = Modules.Last();
+        const TSharedPtr<IPlugin> Target = CppToolsUtil::FindProjectPlugin(Owner.PluginName);
+        for (int32 Repeat = 0; Repeat < NumRepeats; Repeat++)
+        {
+            const FString ModuleName = FString::Printf(TEXT("ScaleTestNewModule%d"), Repeat);
+            const FString ModulePath = Target.IsValid() ? CppToolsUtil::GetNewModulePath(ModuleName, Target)
+                : Settings.RootDir / Owner.PluginName / TEXT("Source") / ModuleName;
+
+            TArray<FString> PublicDependencyModuleNames;
+            PublicDependencyModuleNames.Add(TEXT("Core"));
+            TArray<FString> PrivateDependencyModuleNames;
+            TArray<FString> PublicHeaderIncludes;
+            FText FailReason;
+
+            const double StartTime = FPlatformTime::Seconds();
+            CppToolsUtil::GenerateModuleBuildFile(ModulePath / ModuleName + TEXT(".Build.cs"), ModuleName, PublicDependencyModuleNames,
+                PrivateDependencyModuleNames, FailReason, false);
+            CppToolsUtil::GenerateModuleHeaderFile(ModulePath / TEXT("Public") / ModuleName + TEXT(".h"), ModuleName, PublicHeaderIncludes, FailReason);
+            CppToolsUtil::GenerateModuleCPPFile(ModulePath / TEXT("Private") / ModuleName + TEXT(".cpp"), ModuleName, FString(), FString(), FailReason);
+            CppToolsUtil::InsertDependencyIntoModule(Owner.ModuleName, Target, ModuleName, FailReason, false);
+            AddSample(Measurement, StartTime);
+        }
+    }
+
+    for (const FCppToolsScaleMeasurement& Measurement : OutMeasurements)
+    {
+        if (Measurement.NumPlugins != Settings.NumPlugins) continue;
+        UE_LOG(LogCppToolsScaleTest, Display, TEXT("%d plugins, %s: %.3f ms mean, %.3f ms max over %d samples"), Settings.NumPlugins,
+            *Measurement.Stage, Measurement.GetMeanSeconds() * 1000.0, Measurement.MaxSeconds * 1000.0, Measurement.Samples);
+    }
+}
+
+#undef LOCTEXT_NAMESPACE
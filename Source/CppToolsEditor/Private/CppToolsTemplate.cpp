@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsTemplate.h"
+
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsTemplate"
+
+namespace CppToolsTemplateImpl
+{
+    /** A parsed template file with the time stamp of the file it was parsed from. */
+    struct FCachedTemplate
+    {
+        TSharedPtr<const FCppToolsTemplate> Template;
+        FDateTime TimeStamp;
+    };
+
+    static bool IsTokenChar(TCHAR Char)
+    {
+        return FChar::IsUpper(Char) || FChar::IsDigit(Char) || Char == TEXT('_');
+    }
+}
+
+FCppToolsTemplate FCppToolsTemplate::Parse(const FString& TemplateContents)
+{
+    using namespace CppToolsTemplateImpl;
+
+    FCppToolsTemplate Result;
+    const TCHAR* Data = *TemplateContents;
+    const int32 Length = TemplateContents.Len();
+
+    int32 LiteralStart = 0;
+    int32 I = 0;
+    while (I < Length)
+    {
+        if (Data[I] != TEXT('%'))
+        {
+            I++;
+            continue;
+        }
+
+        // A placeholder is a percent sign, a non-empty upper case token and another percent sign
+        int32 TokenEnd = I + 1;
+        while (TokenEnd < Length && IsTokenChar(Data[TokenEnd]))
+        {
+            TokenEnd++;
+        }
+        if (TokenEnd == I + 1 || TokenEnd >= Length || Data[TokenEnd] != TEXT('%'))
+        {
+            I++;
+            continue;
+        }
+
+        if (I > LiteralStart)
+        {
+            FSegment& Literal = Result.Segments.AddDefaulted_GetRef();
+            Literal.Text = FString(I - LiteralStart, Data + LiteralStart);
+            Result.LiteralLength += Literal.Text.Len();
+        }
+        FSegment& Placeholder = Result.Segments.AddDefaulted_GetRef();
+        Placeholder.Text = FString(TokenEnd + 1 - I, Data + I);
+        Placeholder.Token = FString(TokenEnd - I - 1, Data + I + 1);
+
+        I = LiteralStart = TokenEnd + 1;
+    }
+
+    if (Length > LiteralStart)
+    {
+        FSegment& Literal = Result.Segments.AddDefaulted_GetRef();
+        Literal.Text = FString(Length - LiteralStart, Data + LiteralStart);
+        Result.LiteralLength += Literal.Text.Len();
+    }
+    return Result;
+}
+
+TSharedPtr<const FCppToolsTemplate> FCppToolsTemplate::Load(const FString& TemplateFileName, FText& OutFailReason)
+{
+    using namespace CppToolsTemplateImpl;
+
+    static TMap<FString, FCachedTemplate> Cache;
+
+    const FString FullFileName = CppToolsUtil::CppToolsContentDir() / TEXT("Editor") / TEXT("Templates") / TemplateFileName;
+    const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*FullFileName);
+
+    FCachedTemplate* Cached = Cache.Find(TemplateFileName);
+    if (Cached && Cached->TimeStamp == TimeStamp)
+    {
+        return Cached->Template;
+    }
+
+    CPPTOOLS_TRACE_FILE_SCOPE(LoadTemplate, FullFileName);
+
+    FString Contents;
+    if (!CppToolsUtil::ReadCustomTemplateFile(TemplateFileName, Contents, OutFailReason))
+    {
+        return nullptr;
+    }
+
+    FCachedTemplate& Entry = Cache.FindOrAdd(TemplateFileName);
+    Entry.Template = MakeShareable(new FCppToolsTemplate(Parse(Contents)));
+    Entry.TimeStamp = TimeStamp;
+    return Entry.Template;
+}
+
+FString FCppToolsTemplate::Render(const TMap<FString, FString>& Values) const
+{
+    int32 Length = LiteralLength;
+    for (const TPair<FString, FString>& Value : Values)
+    {
+        Length += Value.Value.Len();
+    }
+
+    FString Result;
+    Result.Reserve(Length);
+    for (const FSegment& Segment : Segments)
+    {
+        const FString* Value = Segment.Token.IsEmpty() ? nullptr : Values.Find(Segment.Token);
+        Result += Value ? *Value : Segment.Text;
+    }
+    return Result;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsTimeTrace.h"
+
+#include "CppToolsBuild.h"
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsTimeTrace"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsTimeTrace, Log, All);
+
+namespace CppToolsTimeTraceImpl
+{
+    static void AddEntry(TMap<FString, FCppToolsTimeTraceEntry>& Entries, const FString& Name, double Milliseconds, int32 Count)
+    {
+        FCppToolsTimeTraceEntry& Entry = Entries.FindOrAdd(Name);
+        Entry.Name = Name;
+        Entry.Milliseconds += Milliseconds;
+        Entry.Count += Count;
+    }
+
+    static TArray<FCppToolsTimeTraceEntry> GetSlowestEntries(const TMap<FString, FCppToolsTimeTraceEntry>& Entries, int32 MaxEntries)
+    {
+        TArray<FCppToolsTimeTraceEntry> Result;
+        Entries.GenerateValueArray(Result);
+        Result.Sort([](const FCppToolsTimeTraceEntry& A, const FCppToolsTimeTraceEntry& B) { return A.Milliseconds > B.Milliseconds; });
+        if (Result.Num() > MaxEntries)
+        {
+            Result.SetNum(MaxEntries);
+        }
+        return Result;
+    }
+}
+
+bool CppToolsTimeTrace::BuildWithTimeTrace(double& OutSeconds, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(BuildWithTimeTrace);
+
+    // Changing the compiler arguments invalidates every compile action, so the whole target is rebuilt with traces. That is the game
+    // target, as relinking the current target would replace the libraries the running editor has loaded.
+    return CppToolsBuild::RunGameTargetBuild(TEXT("-CompilerArguments=\"-ftime-trace\""), OutSeconds, OutFailReason);
+}
+
+TArray<FString> CppToolsTimeTrace::GetTraceDirectories()
+{
+    TArray<FString> Directories;
+    Directories.Add(FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir() / TEXT("Build")));
+    for (const TSharedPtr<IPlugin>& Plugin : CppToolsUtil::GetProjectPlugins())
+    {
+        Directories.Add(FPaths::ConvertRelativePathToFull(Plugin->GetBaseDir() / TEXT("Intermediate") / TEXT("Build")));
+    }
+    return Directories;
+}
+
+bool CppToolsTimeTrace::ReadTraceFile(const FString& TraceFile, FCppToolsTranslationUnitTrace& OutTrace)
+{
+    CPPTOOLS_TRACE_SCOPE(ReadTimeTraceFile);
+    using namespace CppToolsTimeTraceImpl;
+
+    FString Contents;
+    if (!CppToolsUtil::LoadFileToString(Contents, TraceFile)) return false;
+
+    TSharedPtr<FJsonObject> Trace;
+    const TArray<TSharedPtr<FJsonValue>>* Events;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Contents);
+    if (!FJsonSerializer::Deserialize(Reader, Trace) || !Trace.IsValid() || !Trace->TryGetArrayField(TEXT("traceEvents"), Events))
+    {
+        return false;
+    }
+
+    // Traces are written next to the object files, in a directory named after the module
+    OutTrace.TraceFile = TraceFile;
+    OutTrace.ModuleName = FPaths::GetCleanFilename(FPaths::GetPath(TraceFile));
+
+    double ExecuteCompilerMilliseconds = 0.0;
+    for (const TSharedPtr<FJsonValue>& EventValue : *Events)
+    {
+        const TSharedPtr<FJsonObject>* Event;
+        if (!EventValue->TryGetObject(Event)) continue;
+
+        FString Name;
+        FString Phase;
+        double Microseconds;
+        if (!(*Event)->TryGetStringField(TEXT("name"), Name) || !(*Event)->TryGetStringField(TEXT("ph"), Phase) || Phase != TEXT("X")
+            || !(*Event)->TryGetNumberField(TEXT("dur"), Microseconds))
+        {
+            continue;
+        }
+        const double Milliseconds = Microseconds / 1000.0;
+
+        FString Detail;
+        const TSharedPtr<FJsonObject>* Args;
+        if ((*Event)->TryGetObjectField(TEXT("args"), Args))
+        {
+            (*Args)->TryGetStringField(TEXT("detail"), Detail);
+        }
+
+        if (Name == TEXT("ExecuteCompiler"))
+        {
+            ExecuteCompilerMilliseconds += Milliseconds;
+        }
+        else if (Name == TEXT("Frontend"))
+        {
+            OutTrace.FrontendMilliseconds += Milliseconds;
+        }
+        else if (Name == TEXT("Backend"))
+        {
+            OutTrace.BackendMilliseconds += Milliseconds;
+        }
+        else if (Name == TEXT("Source") && !Detail.IsEmpty())
+        {
+            FPaths::NormalizeFilename(Detail);
+            AddEntry(OutTrace.Headers, Detail, Milliseconds, 1);
+        }
+        else if ((Name == TEXT("InstantiateClass") || Name == TEXT("InstantiateFunction")) && !Detail.IsEmpty())
+        {
+            AddEntry(OutTrace.Templates, Detail, Milliseconds, 1);
+        }
+    }
+
+    OutTrace.TotalMilliseconds = ExecuteCompilerMilliseconds > 0.0 ? ExecuteCompilerMilliseconds
+        : OutTrace.FrontendMilliseconds + OutTrace.BackendMilliseconds;
+    return true;
+}
+
+TArray<FCppToolsModuleCompileProfile> CppToolsTimeTrace::IngestTraces(int32 MaxEntries)
+{
+    CPPTOOLS_TRACE_SCOPE(IngestTimeTraces);
+    using namespace CppToolsTimeTraceImpl;
+
+    TMap<FString, FCppToolsModuleCompileProfile> Profiles;
+    TMap<FString, TMap<FString, FCppToolsTimeTraceEntry>> ModuleHeaders;
+    TMap<FString, TMap<FString, FCppToolsTimeTraceEntry>> ModuleTemplates;
+
+    int32 NumTraces = 0;
+    for (const FString& Directory : GetTraceDirectories())
+    {
+        // Clang names the trace after the object file, so every traced translation unit has a .cpp.json file
+        TArray<FString> TraceFiles;
+        IFileManager::Get().FindFilesRecursive(TraceFiles, *Directory, TEXT("*.cpp.json"), true, false, false);
+
+        for (const FString& TraceFile : TraceFiles)
+        {
+            FCppToolsTranslationUnitTrace Trace;
+            if (!ReadTraceFile(TraceFile, Trace)) continue;
+            NumTraces++;
+
+            FCppToolsModuleCompileProfile& Profile = Profiles.FindOrAdd(Trace.ModuleName);
+            Profile.ModuleName = Trace.ModuleName;
+            Profile.NumTranslationUnits++;
+            Profile.TotalMilliseconds += Trace.TotalMilliseconds;
+            Profile.FrontendMilliseconds += Trace.FrontendMilliseconds;
+            Profile.BackendMilliseconds += Trace.BackendMilliseconds;
+            if (Trace.TotalMilliseconds > Profile.SlowestTranslationUnitMilliseconds)
+            {
+                Profile.SlowestTranslationUnit = FPaths::GetBaseFilename(TraceFile);
+                Profile.SlowestTranslationUnitMilliseconds = Trace.TotalMilliseconds;
+            }
+
+            TMap<FString, FCppToolsTimeTraceEntry>& Headers = ModuleHeaders.FindOrAdd(Trace.ModuleName);
+            for (const TPair<FString, FCppToolsTimeTraceEntry>& Header : Trace.Headers)
+            {
+                AddEntry(Headers, Header.Key, Header.Value.Milliseconds, Header.Value.Count);
+            }
+            TMap<FString, FCppToolsTimeTraceEntry>& Templates = ModuleTemplates.FindOrAdd(Trace.ModuleName);
+            for (const TPair<FString, FCppToolsTimeTraceEntry>& Template : Trace.Templates)
+            {
+                AddEntry(Templates, Template.Key, Template.Value.Milliseconds, Template.Value.Count);
+            }
+        }
+    }
+
+    TArray<FCppToolsModuleCompileProfile> Result;
+    for (TPair<FString, FCppToolsModuleCompileProfile>& Profile : Profiles)
+    {
+        Profile.Value.Headers = GetSlowestEntries(ModuleHeaders.FindChecked(Profile.Key), MaxEntries);
+        Profile.Value.Templates = GetSlowestEntries(ModuleTemplates.FindChecked(Profile.Key), MaxEntries);
+        Result.Add(MoveTemp(Profile.Value));
+    }
+    Result.Sort([](const FCppToolsModuleCompileProfile& A, const FCppToolsModuleCompileProfile& B)
+    {
+        return A.TotalMilliseconds > B.TotalMilliseconds;
+    });
+
+    UE_LOG(LogCppToolsTimeTrace, Log, TEXT("Read %d time traces of %d modules"), NumTraces, Result.Num());
+    return Result;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/Atomic.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsTrace, Log, All);
+
+namespace CppToolsTraceImpl
+{
+    /**
+     * State of the current trace session. Events may be recorded from any thread. The depth is only changed under the lock,
+     * but may be read without it so scopes can skip recording when no session is active.
+     */
+    static FCriticalSection SessionLock;
+    static TAtomic<int32> SessionDepth(0);
+    static FString SessionName;
+    static FDateTime SessionDate;
+    static double SessionStartTime = 0.0;
+    static TArray<FCppToolsTraceEvent> SessionEvents;
+}
+
+void CppToolsTrace::BeginSession(const FString& SessionName)
+{
+    using namespace CppToolsTraceImpl;
+
+    FScopeLock Lock(&SessionLock);
+    if (SessionDepth++ > 0) return;
+
+    CppToolsTraceImpl::SessionName = SessionName;
+    SessionDate = FDateTime::Now();
+    SessionStartTime = FPlatformTime::Seconds();
+    SessionEvents.Reset();
+}
+
+void CppToolsTrace::EndSession()
+{
+    using namespace CppToolsTraceImpl;
+
+    FString Name;
+    FDateTime Date;
+    TArray<FCppToolsTraceEvent> Events;
+    {
+        FScopeLock Lock(&SessionLock);
+        if (!ensure(SessionDepth > 0) || --SessionDepth > 0) return;
+
+        Name = CppToolsTraceImpl::SessionName;
+        Date = SessionDate;
+        Events = MoveTemp(SessionEvents);
+
+        // Record the session itself so its total duration is part of the trace
+        FCppToolsTraceEvent& SessionEvent = Events.AddDefaulted_GetRef();
+        SessionEvent.Name = Name;
+        SessionEvent.Category = TEXT("Session");
+        SessionEvent.StartTime = 0.0;
+        SessionEvent.Duration = FPlatformTime::Seconds() - SessionStartTime;
+        SessionEvent.ThreadId = FPlatformTLS::GetCurrentThreadId();
+    }
+
+    WriteTraceFile(Name, Date, Events);
+}
+
+bool CppToolsTrace::IsSessionActive()
+{
+    return CppToolsTraceImpl::SessionDepth.Load(EMemoryOrder::Relaxed) > 0;
+}
+
+void CppToolsTrace::AddEvent(const TCHAR* Name, const TCHAR* Category, const TCHAR* Detail, double StartTime, double EndTime)
+{
+    using namespace CppToolsTraceImpl;
+
+    if (!IsSessionActive()) return;
+
+    // The session may have ended since the check above
+    FScopeLock Lock(&SessionLock);
+    if (SessionDepth == 0) return;
+
+    FCppToolsTraceEvent& Event = SessionEvents.AddDefaulted_GetRef();
+    Event.Name = Name;
+    Event.Category = Category;
+    Event.Detail = Detail;
+    Event.StartTime = StartTime - SessionStartTime;
+    Event.Duration = EndTime - StartTime;
+    Event.ThreadId = FPlatformTLS::GetCurrentThreadId();
+}
+
+FString CppToolsTrace::GetTraceDirectory()
+{
+    return FPaths::ProjectSavedDir() / TEXT("CppTools") / TEXT("Traces");
+}
+
+void CppToolsTrace::LoadHistory(TArray<FCppToolsTraceSummary>& OutSessions, int32 MaxSessions)
+{
+    TArray<FString> TraceFiles;
+    IFileManager::Get().FindFiles(TraceFiles, *(GetTraceDirectory() / TEXT("*.json")), true, false);
+
+    // Newest first
+    TraceFiles.Sort([](const FString& A, const FString& B)
+    {
+        return IFileManager::Get().GetTimeStamp(*(GetTraceDirectory() / A)) > IFileManager::Get().GetTimeStamp(*(GetTraceDirectory() / B));
+    });
+
+    for (const FString& TraceFile : TraceFiles)
+    {
+        if (OutSessions.Num() >= MaxSessions) break;
+
+        FCppToolsTraceSummary Summary;
+        if (LoadSummary(GetTraceDirectory() / TraceFile, Summary))
+        {
+            OutSessions.Add(MoveTemp(Summary));
+        }
+    }
+}
+
+bool CppToolsTrace::WriteTraceFile(const FString& SessionName, const FDateTime& Date, const TArray<FCppToolsTraceEvent>& Events)
+{
+    // Complete ("X") events of the Chrome Trace Event Format, which Perfetto and chrome://tracing both load
+    const uint32 ProcessId = FPlatformProcess::GetCurrentProcessId();
+
+    TArray<TSharedPtr<FJsonValue>> EventValues;
+    EventValues.Reserve(Events.Num());
+    for (const FCppToolsTraceEvent& Event : Events)
+    {
+        TSharedRef<FJsonObject> EventObject = MakeShareable(new FJsonObject);
+        EventObject->SetStringField(TEXT("name"), Event.Name);
+        EventObject->SetStringField(TEXT("cat"), Event.Category);
+        EventObject->SetStringField(TEXT("ph"), TEXT("X"));
+        EventObject->SetNumberField(TEXT("ts"), Event.StartTime * 1000000.0);
+        EventObject->SetNumberField(TEXT("dur"), Event.Duration * 1000000.0);
+        EventObject->SetNumberField(TEXT("pid"), ProcessId);
+        EventObject->SetNumberField(TEXT("tid"), Event.ThreadId);
+        if (!Event.Detail.IsEmpty())
+        {
+            TSharedRef<FJsonObject> Args = MakeShareable(new FJsonObject);
+            Args->SetStringField(TEXT("detail"), Event.Detail);
+            EventObject->SetObjectField(TEXT("args"), Args);
+        }
+        EventValues.Add(MakeShareable(new FJsonValueObject(EventObject)));
+    }
+
+    TSharedRef<FJsonObject> OtherData = MakeShareable(new FJsonObject);
+    OtherData->SetStringField(TEXT("session"), SessionName);
+    OtherData->SetStringField(TEXT("date"), Date.ToIso8601());
+
+    TSharedRef<FJsonObject> Trace = MakeShareable(new FJsonObject);
+    Trace->SetArrayField(TEXT("traceEvents"), EventValues);
+    Trace->SetStringField(TEXT("displayTimeUnit"), TEXT("ms"));
+    Trace->SetObjectField(TEXT("otherData"), OtherData);
+
+    FString TraceText;
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&TraceText);
+    FJsonSerializer::Serialize(Trace, Writer);
+
+    // Named down to the millisecond, with a counter for sessions that still end at the same time, so no trace overwrites another
+    const FString TraceName = FString::Printf(TEXT("%s-%s"), *SessionName, *Date.ToString(TEXT("%Y.%m.%d-%H.%M.%S.%s")));
+    FString TraceFile = GetTraceDirectory() / TraceName + TEXT(".json");
+    for (int32 Counter = 1; IFileManager::Get().FileExists(*TraceFile); Counter++)
+    {
+        TraceFile = GetTraceDirectory() / FString::Printf(TEXT("%s-%d.json"), *TraceName, Counter);
+    }
+    if (!FFileHelper::SaveStringToFile(TraceText, *TraceFile))
+    {
+        UE_LOG(LogCppToolsTrace, Warning, TEXT("Failed to write trace file '%s'"), *TraceFile);
+        return false;
+    }
+
+    UE_LOG(LogCppToolsTrace, Log, TEXT("Wrote trace of %s to '%s'"), *SessionName, *TraceFile);
+    return true;
+}
+
+bool CppToolsTrace::LoadSummary(const FString& TraceFile, FCppToolsTraceSummary& OutSummary)
+{
+    FString TraceText;
+    TSharedPtr<FJsonObject> Trace;
+    if (!FFileHelper::LoadFileToString(TraceText, *TraceFile)) return false;
+
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(TraceText);
+    if (!FJsonSerializer::Deserialize(Reader, Trace) || !Trace.IsValid()) return false;
+
+    const TSharedPtr<FJsonObject>* OtherData;
+    if (!Trace->TryGetObjectField(TEXT("otherData"), OtherData)) return false;
+
+    FString Date;
+    OutSummary.SessionName = (*OtherData)->GetStringField(TEXT("session"));
+    OutSummary.TraceFile = TraceFile;
+    OutSummary.TotalTime = 0.0;
+    if ((*OtherData)->TryGetStringField(TEXT("date"), Date))
+    {
+        FDateTime::ParseIso8601(*Date, OutSummary.Date);
+    }
+
+    for (const TSharedPtr<FJsonValue>& EventValue : Trace->GetArrayField(TEXT("traceEvents")))
+    {
+        const TSharedPtr<FJsonObject>& Event = EventValue->AsObject();
+        if (!Event.IsValid()) continue;
+
+        const FString Category = Event->GetStringField(TEXT("cat"));
+        const double Duration = Event->GetNumberField(TEXT("dur")) / 1000.0;
+        if (Category == TEXT("Session"))
+        {
+            OutSummary.TotalTime = Duration;
+        }
+        else if (Category == TEXT("Stage"))
+        {
+            OutSummary.StageTimes.FindOrAdd(Event->GetStringField(TEXT("name"))) += Duration;
+        }
+    }
+    return true;
+}
+
+FCppToolsScopedTrace::FCppToolsScopedTrace(const TCHAR* InName, const TCHAR* InCategory, const TCHAR* InDetail)
+    : Name(InName)
+    , Category(InCategory)
+    , Detail(InDetail)
+    , StartTime(FPlatformTime::Seconds())
+{
+}
+
+FCppToolsScopedTrace::~FCppToolsScopedTrace()
+{
+    CppToolsTrace::AddEvent(Name, Category, Detail, StartTime, FPlatformTime::Seconds());
+}
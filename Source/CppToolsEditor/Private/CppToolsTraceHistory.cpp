@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsTraceHistory.h"
+
+#include "EditorStyleSet.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/SBoxPanel.h"
+#include "HAL/PlatformProcess.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsTraceHistory"
+
+namespace CppToolsTraceHistoryImpl
+{
+    static const FName SessionColumn(TEXT("Session"));
+    static const FName DateColumn(TEXT("Date"));
+    static const FName TotalColumn(TEXT("Total"));
+
+    /** The number of slowest stages that get their own column. */
+    static const int32 MaxStageColumns = 8;
+
+    static FText FormatMilliseconds(double Milliseconds)
+    {
+        FNumberFormattingOptions Options;
+        Options.SetMaximumFractionalDigits(1);
+        return FText::Format(LOCTEXT("Milliseconds", "{0} ms"), FText::AsNumber(Milliseconds, &Options));
+    }
+}
+
+/** A row of the session list, with one cell per column. */
+class SCppToolsTraceHistoryRow : public SMultiColumnTableRow<TSharedPtr<FCppToolsTraceSummary>>
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsTraceHistoryRow) {}
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FCppToolsTraceSummary> InSession)
+    {
+        Session = InSession;
+        SMultiColumnTableRow<TSharedPtr<FCppToolsTraceSummary>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+    }
+
+    virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+    {
+        using namespace CppToolsTraceHistoryImpl;
+
+        FText Text;
+        if (ColumnName == SessionColumn)
+        {
+            Text = FText::FromString(Session->SessionName);
+        }
+        else if (ColumnName == DateColumn)
+        {
+            Text = FText::AsDateTime(Session->Date);
+        }
+        else if (ColumnName == TotalColumn)
+        {
+            Text = FormatMilliseconds(Session->TotalTime);
+        }
+        else if (const double* StageTime = Session->StageTimes.Find(ColumnName.ToString()))
+        {
+            Text = FormatMilliseconds(*StageTime);
+        }
+
+        return SNew(STextBlock)
+            .Text(Text)
+            .ToolTipText(FText::FromString(Session->TraceFile));
+    }
+
+private:
+
+    TSharedPtr<FCppToolsTraceSummary> Session;
+
+};
+
+void SCppToolsTraceHistory::Construct(const FArguments& InArgs)
+{
+    MaxSessions = InArgs._MaxSessions;
+
+    ChildSlot
+    [
+        SNew(SBorder)
+        .Padding(8)
+        .BorderImage(FEditorStyle::GetBrush("Docking.Tab.ContentAreaBrush"))
+        [
+            SNew(SVerticalBox)
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(0, 0, 0, 8)
+            [
+                SNew(SHorizontalBox)
+
+                + SHorizontalBox::Slot()
+                .FillWidth(1.0f)
+                .VAlign(VAlign_Center)
+                [
+                    SNew(STextBlock)
+                    .Text(LOCTEXT("HistoryDescription", "Stage timings of the most recent C++ Tools operations, in milliseconds."))
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("OpenFolder", "Open Trace Folder"))
+                    .OnClicked(this, &SCppToolsTraceHistory::OpenFolderClicked)
+                ]
+
+                + SHorizontalBox::Slot()
+                .AutoWidth()
+                .Padding(6.0f, 0.0f, 0.0f, 0.0f)
+                [
+                    SNew(SButton)
+                    .Text(LOCTEXT("Refresh", "Refresh"))
+                    .OnClicked(this, &SCppToolsTraceHistory::RefreshClicked)
+                ]
+            ]
+
+            + SVerticalBox::Slot()
+            .FillHeight(1.0f)
+            [
+                SAssignNew(SessionList, SListView<TSharedPtr<FCppToolsTraceSummary>>)
+                .ListItemsSource(&Sessions)
+                .OnGenerateRow(this, &SCppToolsTraceHistory::MakeSessionRow)
+                .HeaderRow(SAssignNew(HeaderRow, SHeaderRow))
+            ]
+        ]
+    ];
+
+    Refresh();
+}
+
+void SCppToolsTraceHistory::Refresh()
+{
+    using namespace CppToolsTraceHistoryImpl;
+
+    TArray<FCppToolsTraceSummary> Summaries;
+    CppToolsTrace::LoadHistory(Summaries, MaxSessions);
+
+    Sessions.Reset();
+    TMap<FString, double> TotalStageTimes;
+    for (FCppToolsTraceSummary& Summary : Summaries)
+    {
+        for (const TPair<FString, double>& StageTime : Summary.StageTimes)
+        {
+            TotalStageTimes.FindOrAdd(StageTime.Key) += StageTime.Value;
+        }
+        Sessions.Add(MakeShareable(new FCppToolsTraceSummary(MoveTemp(Summary))));
+    }
+
+    // Only show the stages that took the most time across all sessions
+    TotalStageTimes.ValueSort([](double A, double B) { return A > B; });
+    TotalStageTimes.GenerateKeyArray(StageColumns);
+    if (StageColumns.Num() > MaxStageColumns)
+    {
+        StageColumns.SetNum(MaxStageColumns);
+    }
+
+    HeaderRow->ClearColumns();
+    HeaderRow->AddColumn(SHeaderRow::Column(SessionColumn).DefaultLabel(LOCTEXT("SessionColumn", "Operation")).FillWidth(1.5f));
+    HeaderRow->AddColumn(SHeaderRow::Column(DateColumn).DefaultLabel(LOCTEXT("DateColumn", "Date")).FillWidth(1.5f));
+    HeaderRow->AddColumn(SHeaderRow::Column(TotalColumn).DefaultLabel(LOCTEXT("TotalColumn", "Total")).FillWidth(1.0f));
+    for (const FString& Stage : StageColumns)
+    {
+        HeaderRow->AddColumn(SHeaderRow::Column(FName(*Stage)).DefaultLabel(FText::FromString(Stage)).FillWidth(1.0f));
+    }
+
+    SessionList->RequestListRefresh();
+}
+
+FReply SCppToolsTraceHistory::RefreshClicked()
+{
+    Refresh();
+    return FReply::Handled();
+}
+
+FReply SCppToolsTraceHistory::OpenFolderClicked()
+{
+    const FString TraceDirectory = FPaths::ConvertRelativePathToFull(CppToolsTrace::GetTraceDirectory());
+    IFileManager::Get().MakeDirectory(*TraceDirectory, true);
+    FPlatformProcess::ExploreFolder(*TraceDirectory);
+    return FReply::Handled();
+}
+
+TSharedRef<ITableRow> SCppToolsTraceHistory::MakeSessionRow(TSharedPtr<FCppToolsTraceSummary> Session, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return SNew(SCppToolsTraceHistoryRow, OwnerTable, Session);
+}
+
+#undef LOCTEXT_NAMESPACE
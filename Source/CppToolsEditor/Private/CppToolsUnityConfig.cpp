@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CppToolsUnityConfig.h"
+
+#include "CppToolsUtil.h"
+#include "CppToolsTrace.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+
+#define LOCTEXT_NAMESPACE "CppToolsUnityConfig"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsUnityConfig, Log, All);
+
+bool CppToolsUnityConfig::ReadGitChurn(const FString& RepositoryDir, int32 HistoryDays, TMap<FString, int32>& OutEdits, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(ReadGitChurn);
+
+    // Git reports paths relative to the root of the repository, which may be above the project
+    FString RepositoryRoot;
+    if (!RunGit(RepositoryDir, TEXT("rev-parse --show-toplevel"), RepositoryRoot, OutFailReason)) return false;
+    RepositoryRoot.TrimStartAndEndInline();
+
+    FString Log;
+    const FString LogArguments = FString::Printf(TEXT("log --since=\"%d days ago\" --no-merges --name-only --pretty=format:"), HistoryDays);
+    if (!RunGit(RepositoryDir, LogArguments, Log, OutFailReason)) return false;
+
+    TArray<FString> Lines;
+    Log.ParseIntoArrayLines(Lines, true);
+    for (const FString& Line : Lines)
+    {
+        FString Filename = FPaths::ConvertRelativePathToFull(RepositoryRoot / Line.TrimStartAndEnd());
+        FPaths::NormalizeFilename(Filename);
+        OutEdits.FindOrAdd(Filename)++;
+    }
+
+    UE_LOG(LogCppToolsUnityConfig, Log, TEXT("Read the edits of %d files over the last %d days from %s"), OutEdits.Num(), HistoryDays, *RepositoryRoot);
+    return true;
+}
+
+TArray<FCppToolsUnityPlan> CppToolsUnityConfig::PlanProjectModules(const TMap<FString, int32>& Edits, const FCppToolsUnitySettings& Settings)
+{
+    CPPTOOLS_TRACE_SCOPE(PlanUnityBuilds);
+
+    TArray<FCppToolsUnityPlan> Plans;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : CppToolsUtil::GetProjectAndPluginModules())
+    {
+        FCppToolsUnityPlan& Plan = Plans.AddDefaulted_GetRef();
+        Plan.ModuleName = Module.Key.ModuleName;
+        Plan.Target = Module.Value;
+
+        TArray<FString> SourceFiles;
+        IFileManager::Get().FindFilesRecursive(SourceFiles, *Module.Key.ModuleSourcePath, TEXT("*.cpp"), true, false, false);
+        Plan.NumSourceFiles = SourceFiles.Num();
+
+        TArray<TPair<FString, int32>> HotFiles;
+        for (FString& SourceFile : SourceFiles)
+        {
+            SourceFile = FPaths::ConvertRelativePathToFull(SourceFile);
+            FPaths::NormalizeFilename(SourceFile);
+
+            const int32* NumEdits = Edits.Find(SourceFile);
+            if (NumEdits != nullptr && *NumEdits >= Settings.MinEditsForHotFile)
+            {
+                HotFiles.Emplace(SourceFile, *NumEdits);
+            }
+        }
+        HotFiles.Sort([](const TPair<FString, int32>& A, const TPair<FString, int32>& B)
+        {
+            return A.Value != B.Value ? A.Value > B.Value : A.Key < B.Key;
+        });
+        for (const TPair<FString, int32>& HotFile : HotFiles)
+        {
+            Plan.HotFiles.Add(HotFile.Key);
+            Plan.HotFileEdits.Add(HotFile.Value);
+        }
+
+        if (Plan.HotFiles.Num() == 0)
+        {
+            // Nobody is iterating on this module, so it only ever gets full builds, which are fastest as unity builds
+            Plan.bUseUnity = true;
+            Plan.MinSourceFilesForUnityBuild = Settings.ColdModuleMinSourceFiles;
+        }
+        else if (Plan.NumSourceFiles > 0 && static_cast<float>(Plan.HotFiles.Num()) / Plan.NumSourceFiles >= Settings.DisableUnityHotFraction)
+        {
+            // Most of the module is being iterated on, so every edit would recompile a large unity file
+            Plan.bUseUnity = false;
+        }
+        else
+        {
+            // Mixed modules keep unity builds, with the hot files recorded as the working set adaptive unity builds compile alone
+            Plan.bUseUnity = true;
+        }
+    }
+    return Plans;
+}
+
+bool CppToolsUnityConfig::ApplyPlan(const FCppToolsUnityPlan& Plan, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(ApplyUnityPlan);
+
+    FString BuildFilePath;
+    if (!CppToolsUtil::GetModuleBuildFilePath(Plan.ModuleName, Plan.Target, BuildFilePath))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("ModuleName"), FText::FromString(Plan.ModuleName));
+        OutFailReason = FText::Format(LOCTEXT("ModuleNotFound", "Could not find the .Build.cs file of module \"{ModuleName}\""), Args);
+        return false;
+    }
+    const FString ModuleDir = FPaths::GetPath(BuildFilePath) / TEXT("");
+
+    TArray<FString> WorkingSetLines;
+    if (Plan.bUseUnity && Plan.HotFiles.Num() > 0)
+    {
+        WorkingSetLines.Add(TEXT("Frequently edited files of this module. Adaptive unity builds compile these on their own while they are modified."));
+        for (FString HotFile : Plan.HotFiles)
+        {
+            FPaths::MakePathRelativeTo(HotFile, *ModuleDir);
+            WorkingSetLines.Add(TEXT("  ") + HotFile);
+        }
+    }
+
+    return CppToolsUtil::UpdateModuleBuildFile(Plan.ModuleName, Plan.Target, [&Plan, &WorkingSetLines](FString& BuildFileContents)
+    {
+        bool bChanged = CppToolsUtil::SetModuleRulesField(BuildFileContents, TEXT("bUseUnity"), Plan.bUseUnity ? TEXT("true") : TEXT("false"));
+        if (Plan.MinSourceFilesForUnityBuild == INDEX_NONE)
+        {
+            bChanged |= CppToolsUtil::RemoveModuleRulesField(BuildFileContents, TEXT("MinSourceFilesForUnityBuildOverride"));
+        }
+        else
+        {
+            bChanged |= CppToolsUtil::SetModuleRulesField(BuildFileContents, TEXT("MinSourceFilesForUnityBuildOverride"),
+                FString::FromInt(Plan.MinSourceFilesForUnityBuild));
+        }
+        bChanged |= CppToolsUtil::SetModuleRulesCommentBlock(BuildFileContents, TEXT("UnityWorkingSet"), WorkingSetLines);
+        return bChanged;
+    }, OutFailReason);
+}
+
+bool CppToolsUnityConfig::RunGit(const FString& WorkingDir, const FString& Arguments, FString& OutOutput, FText& OutFailReason)
+{
+    const FString FullArguments = FString::Printf(TEXT("-C \"%s\" %s"), *FPaths::ConvertRelativePathToFull(WorkingDir), *Arguments);
+
+    int32 ReturnCode = -1;
+    FString StdErr;
+    if (!FPlatformProcess::ExecProcess(TEXT("git"), *FullArguments, &ReturnCode, &OutOutput, &StdErr) || ReturnCode != 0)
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("Arguments"), FText::FromString(Arguments));
+        Args.Add(TEXT("Error"), FText::FromString(StdErr.TrimStartAndEnd()));
+        OutFailReason = FText::Format(LOCTEXT("GitFailed", "Failed to run \"git {Arguments}\": {Error}"), Args);
+        return false;
+    }
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -3,11 +3,388 @@
 
 #include "CppToolsUtil.h"
 
+#include "CppToolsBinaryCache.h"
+#include "CppToolsBuild.h"
+#include "CppToolsDescriptorSession.h"
+#include "CppToolsFileTransaction.h"
+#include "CppToolsMemoryTags.h"
+#include "CppToolsModuleGraph.h"
+#include "CppToolsTemplate.h"
+#include "CppToolsTrace.h"
+
 #include "Editor/EditorPerProjectUserSettings.h"
+#include "Framework/Application/SlateApplication.h"
 #include "Internationalization/Regex.h"
 
 #define LOCTEXT_NAMESPACE "CppToolsUtil"
 
+DEFINE_LOG_CATEGORY_STATIC(LogCppToolsUtil, Log, All);
+
+namespace CppToolsUtilImpl
+{
+    /** Checks if a token is a macro placed between the class keyword and the class name, such as an API macro. */
+    static bool IsDeclarationMacro(const FString& Token)
+    {
+        if (Token.EndsWith(TEXT("_API")) || Token == TEXT("alignas")) return true;
+
+        bool bHasUnderscore = false;
+        for (TCHAR Char : Token)
+        {
+            if (FChar::IsLower(Char)) return false;
+            bHasUnderscore |= Char == TEXT('_');
+        }
+        return bHasUnderscore;
+    }
+
+    /** Creates the forward declaration of the type defined by the tokens of a statement preceding an opening brace, if it can be forward declared. */
+    static FString MakeForwardDeclaration(const TArray<FString>& Statement)
+    {
+        for (const FString& Token : Statement)
+        {
+            if (Token == TEXT("template") || Token == TEXT("typedef") || Token == TEXT("using") || Token == TEXT("friend")) return FString();
+        }
+
+        const int32 KeywordIndex = Statement.IndexOfByPredicate([](const FString& Token)
+        {
+            return Token == TEXT("class") || Token == TEXT("struct") || Token == TEXT("enum");
+        });
+        if (KeywordIndex == INDEX_NONE) return FString();
+
+        const bool bIsEnum = Statement[KeywordIndex] == TEXT("enum");
+        FString Keyword = Statement[KeywordIndex];
+        int32 NameIndex = KeywordIndex + 1;
+        if (bIsEnum && Statement.IsValidIndex(NameIndex) && (Statement[NameIndex] == TEXT("class") || Statement[NameIndex] == TEXT("struct")))
+        {
+            Keyword += TEXT(" ") + Statement[NameIndex++];
+        }
+        while (Statement.IsValidIndex(NameIndex) && IsDeclarationMacro(Statement[NameIndex]))
+        {
+            NameIndex++;
+        }
+        if (!Statement.IsValidIndex(NameIndex) || !(FChar::IsAlpha(Statement[NameIndex][0]) || Statement[NameIndex][0] == TEXT('_'))) return FString();
+
+        const FString& Name = Statement[NameIndex];
+        const int32 AfterNameIndex = NameIndex + 1;
+
+        // Types defined through a qualified name are declared elsewhere
+        if (Statement.IsValidIndex(AfterNameIndex) && Statement[AfterNameIndex] == TEXT("::")) return FString();
+
+        if (bIsEnum)
+        {
+            // Only enums with an explicit underlying type can be forward declared
+            if (!Statement.IsValidIndex(AfterNameIndex + 1) || Statement[AfterNameIndex] != TEXT(":")) return FString();
+
+            TArray<FString> UnderlyingType(Statement.GetData() + AfterNameIndex + 1, Statement.Num() - AfterNameIndex - 1);
+            return Keyword + TEXT(" ") + Name + TEXT(" : ") + FString::Join(UnderlyingType, TEXT(" ")).Replace(TEXT(" :: "), TEXT("::")) + TEXT(";");
+        }
+
+        return Keyword + TEXT(" ") + Name + TEXT(";");
+    }
+
+    /** The dependency lists of a .Build.cs file, public first so the public list alone can be viewed. */
+    static const FStringView DependencyListNames[] = { TEXT("PublicDependencyModuleNames"), TEXT("PrivateDependencyModuleNames") };
+    static const FStringView ExtraModuleListNames[] = { TEXT("ExtraModuleNames") };
+
+    /** An AddRange or Add call of a string list, as offsets into the contents it was found in. */
+    struct FStringListCall
+    {
+        int32 Start;
+        int32 End;
+        int32 ContentsStart;
+        int32 ContentsEnd;
+        bool bIsAdd;
+    };
+
+    static FStringView MakeView(const FString& String)
+    {
+        return FStringView(*String, String.Len());
+    }
+
+    static bool ViewEquals(FStringView A, FStringView B)
+    {
+        return A.Len() == B.Len() && FCString::Strncmp(A.GetData(), B.GetData(), A.Len()) == 0;
+    }
+
+    static bool IsIdentifierChar(TCHAR Char)
+    {
+        return FChar::IsAlnum(Char) || Char == TEXT('_');
+    }
+
+    /** Gets the index after the comment starting at Index, or Index if no comment starts there. */
+    static int32 SkipComment(FStringView Contents, int32 Index)
+    {
+        const TCHAR* Data = Contents.GetData();
+        const int32 Len = Contents.Len();
+        if (Data[Index] != TEXT('/') || Index + 1 >= Len) return Index;
+
+        if (Data[Index + 1] == TEXT('/'))
+        {
+            // The line break is not part of the comment
+            Index += 2;
+            while (Index < Len && Data[Index] != TEXT('\r') && Data[Index] != TEXT('\n')) Index++;
+            return Index;
+        }
+        if (Data[Index + 1] == TEXT('*'))
+        {
+            // An unterminated comment runs to the end of the contents
+            Index += 2;
+            while (Index + 1 < Len && !(Data[Index] == TEXT('*') && Data[Index + 1] == TEXT('/'))) Index++;
+            return FMath::Min(Index + 2, Len);
+        }
+        return Index;
+    }
+
+    /**
+     * Gets the index after the string or character literal starting at Index, or Index if no literal starts there. Literals end
+     * at the line break if they are not terminated, so a stray quote cannot hide the rest of the contents.
+     */
+    static int32 SkipLiteral(FStringView Contents, int32 Index)
+    {
+        const TCHAR* Data = Contents.GetData();
+        const int32 Len = Contents.Len();
+        const TCHAR Quote = Data[Index];
+        if (Quote != TEXT('"') && Quote != TEXT('\'')) return Index;
+
+        // C# verbatim strings have no escape sequences, which matters for paths ending in a backslash
+        const bool bVerbatim = Index > 0 && Data[Index - 1] == TEXT('@');
+        Index++;
+        while (Index < Len && Data[Index] != Quote && Data[Index] != TEXT('\n'))
+        {
+            Index += !bVerbatim && Data[Index] == TEXT('\\') ? 2 : 1;
+        }
+        return FMath::Min(Index + 1, Len);
+    }
+
+    /** Skips whitespace, then consumes the token at Index if it is there. Word tokens must not be followed by an identifier character. */
+    static bool ConsumeToken(FStringView Contents, int32& Index, FStringView Token)
+    {
+        const TCHAR* Data = Contents.GetData();
+        const int32 Len = Contents.Len();
+        int32 TokenStart = Index;
+        while (TokenStart < Len && FChar::IsWhitespace(Data[TokenStart])) TokenStart++;
+
+        const int32 TokenEnd = TokenStart + Token.Len();
+        if (TokenEnd > Len || FCString::Strncmp(Data + TokenStart, Token.GetData(), Token.Len()) != 0) return false;
+        if (IsIdentifierChar(Token[Token.Len() - 1]) && TokenEnd < Len && IsIdentifierChar(Data[TokenEnd])) return false;
+
+        Index = TokenEnd;
+        return true;
+    }
+
+    /** Finds the closing character of a list starting at Index, skipping comments and literals within it. */
+    static int32 FindListEnd(FStringView Contents, int32 Index, TCHAR Closing)
+    {
+        while (Index < Contents.Len())
+        {
+            const int32 Next = SkipLiteral(Contents, SkipComment(Contents, Index));
+            if (Next != Index)
+            {
+                Index = Next;
+                continue;
+            }
+            if (Contents[Index] == Closing) return Index;
+            Index++;
+        }
+        return INDEX_NONE;
+    }
+
+    /** Finds the closing brace of the block whose opening brace is before Index, skipping nested blocks, comments and literals. */
+    static int32 FindBlockEnd(FStringView Contents, int32 Index)
+    {
+        int32 Depth = 0;
+        while (Index < Contents.Len())
+        {
+            const int32 Next = SkipLiteral(Contents, SkipComment(Contents, Index));
+            if (Next != Index)
+            {
+                Index = Next;
+                continue;
+            }
+            if (Contents[Index] == TEXT('{'))
+            {
+                Depth++;
+            }
+            else if (Contents[Index] == TEXT('}') && Depth-- == 0)
+            {
+                return Index;
+            }
+            Index++;
+        }
+        return INDEX_NONE;
+    }
+
+    /** Finds the index after the opening brace of the module rules constructor, following ": base(Target)", ignoring any that is commented out. */
+    static int32 FindConstructorBodyStart(FStringView Contents)
+    {
+        int32 Index = 0;
+        while (Index < Contents.Len())
+        {
+            const int32 Next = SkipLiteral(Contents, SkipComment(Contents, Index));
+            if (Next != Index)
+            {
+                Index = Next;
+                continue;
+            }
+
+            int32 Cursor = Index + 1;
+            if (Contents[Index] == TEXT(':') && ConsumeToken(Contents, Cursor, TEXT("base")) && ConsumeToken(Contents, Cursor, TEXT("(")))
+            {
+                const int32 ArgumentsEnd = FindListEnd(Contents, Cursor, TEXT(')'));
+                Cursor = ArgumentsEnd + 1;
+                if (ArgumentsEnd != INDEX_NONE && ConsumeToken(Contents, Cursor, TEXT("{"))) return Cursor;
+            }
+            Index++;
+        }
+        return INDEX_NONE;
+    }
+
+    /** Parses the AddRange or Add call following the list name ending at NameEnd. */
+    static bool ParseStringListCall(FStringView Contents, int32 Start, int32 NameEnd, FStringListCall& OutCall)
+    {
+        int32 Index = NameEnd;
+        if (!ConsumeToken(Contents, Index, TEXT("."))) return false;
+
+        OutCall.Start = Start;
+        if (ConsumeToken(Contents, Index, TEXT("AddRange")))
+        {
+            if (!ConsumeToken(Contents, Index, TEXT("(")) || !ConsumeToken(Contents, Index, TEXT("new"))) return false;
+            ConsumeToken(Contents, Index, TEXT("string"));
+            if (!ConsumeToken(Contents, Index, TEXT("[")) || !ConsumeToken(Contents, Index, TEXT("]")) || !ConsumeToken(Contents, Index, TEXT("{")))
+            {
+                return false;
+            }
+
+            OutCall.ContentsStart = Index;
+            OutCall.ContentsEnd = FindListEnd(Contents, Index, TEXT('}'));
+            if (OutCall.ContentsEnd == INDEX_NONE) return false;
+            Index = OutCall.ContentsEnd + 1;
+            if (!ConsumeToken(Contents, Index, TEXT(")"))) return false;
+            OutCall.bIsAdd = false;
+        }
+        else if (ConsumeToken(Contents, Index, TEXT("Add")))
+        {
+            if (!ConsumeToken(Contents, Index, TEXT("("))) return false;
+
+            OutCall.ContentsStart = Index;
+            OutCall.ContentsEnd = FindListEnd(Contents, Index, TEXT(')'));
+            if (OutCall.ContentsEnd == INDEX_NONE) return false;
+            Index = OutCall.ContentsEnd + 1;
+            OutCall.bIsAdd = true;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (!ConsumeToken(Contents, Index, TEXT(";"))) return false;
+        OutCall.End = Index;
+        return true;
+    }
+
+    /** Finds the AddRange and Add calls of the named lists in a single pass over the contents, ignoring any that are commented out. */
+    static void FindStringListCalls(FStringView Contents, TArrayView<const FStringView> ListNames, TArray<FStringListCall>& OutCalls)
+    {
+        const TCHAR* Data = Contents.GetData();
+        const int32 Len = Contents.Len();
+        int32 Index = 0;
+        while (Index < Len)
+        {
+            const int32 Next = SkipLiteral(Contents, SkipComment(Contents, Index));
+            if (Next != Index)
+            {
+                Index = Next;
+                continue;
+            }
+            if (!IsIdentifierChar(Data[Index]))
+            {
+                Index++;
+                continue;
+            }
+
+            const int32 NameStart = Index;
+            while (Index < Len && IsIdentifierChar(Data[Index])) Index++;
+
+            const FStringView Name(Data + NameStart, Index - NameStart);
+            FStringListCall Call;
+            if (ListNames.ContainsByPredicate([Name](FStringView ListName) { return ViewEquals(ListName, Name); })
+                && ParseStringListCall(Contents, NameStart, Index, Call))
+            {
+                OutCalls.Add(Call);
+                Index = Call.End;
+            }
+        }
+    }
+
+    /** Parses the strings of a list call, ignoring any that are commented out. */
+    static void ParseStringListCallElements(FStringView Contents, const FStringListCall& Call, TArray<FStringView>& OutStrings)
+    {
+        int32 Index = Call.ContentsStart;
+        while (Index < Call.ContentsEnd)
+        {
+            const int32 AfterComment = SkipComment(Contents, Index);
+            if (AfterComment != Index)
+            {
+                Index = AfterComment;
+                continue;
+            }
+
+            const int32 AfterLiteral = SkipLiteral(Contents, Index);
+            if (AfterLiteral != Index)
+            {
+                // Only terminated, non-empty strings are elements
+                if (Contents[Index] == TEXT('"') && Contents[AfterLiteral - 1] == TEXT('"') && AfterLiteral - Index > 2)
+                {
+                    OutStrings.Add(FStringView(Contents.GetData() + Index + 1, AfterLiteral - Index - 2));
+                }
+                Index = AfterLiteral;
+                continue;
+            }
+            Index++;
+        }
+    }
+
+    static const TCHAR* GetChars(const FString& String)
+    {
+        return *String;
+    }
+
+    static const TCHAR* GetChars(FStringView String)
+    {
+        return String.GetData();
+    }
+
+    /** Gets the length of the comma separated list that AppendStringList creates, so the result can be allocated once. */
+    template <typename StringArrayType>
+    static int32 GetStringListLength(const StringArrayType& StringList, bool bUseQuotes, bool bIncludeSpace)
+    {
+        int32 Length = 0;
+        for (const auto& Element : StringList)
+        {
+            Length += Element.Len() + (bUseQuotes ? 2 : 0);
+        }
+        if (StringList.Num() > 1)
+        {
+            Length += (StringList.Num() - 1) * (bIncludeSpace ? 2 : 1);
+        }
+        return Length;
+    }
+
+    template <typename StringArrayType>
+    static void AppendStringList(FString& Result, const StringArrayType& StringList, bool bUseQuotes, bool bIncludeSpace)
+    {
+        for (int32 I = 0; I < StringList.Num(); I++)
+        {
+            if (I > 0)
+            {
+                Result.AppendChars(TEXT(", "), bIncludeSpace ? 2 : 1);
+            }
+            if (bUseQuotes) Result.AppendChar(TEXT('"'));
+            Result.AppendChars(GetChars(StringList[I]), StringList[I].Len());
+            if (bUseQuotes) Result.AppendChar(TEXT('"'));
+        }
+    }
+}
+
 
 FString CppToolsUtil::CppToolsContentDir() {
     static FString ContentDir = IPluginManager::Get().FindPlugin(TEXT("CppTools"))->GetContentDir();
@@ -16,6 +393,7 @@ FString CppToolsUtil::CppToolsContentDir() {
 
 bool CppToolsUtil::CheckoutFile(const FString& Filename, FText& OutFailReason)
 {
+    CPPTOOLS_TRACE_SCOPE(CheckoutFile);
     // See GameProjectUtils.cpp L3700
     
     if ( !ensure(Filename.Len()) )
@@ -63,7 +441,7 @@ bool CppToolsUtil::CheckoutFile(const FString& Filename, FText& OutFailReason)
     return bSuccessfullyCheckedOut;
 }
 
-void CppToolsUtil::TryMakePluginFileWriteable(const FString& PluginFile)
+void CppToolsUtil::TryMakeFileWriteable(const FString& Filename)
 {
     // See GameProjectUtils.cpp L3629
 
@@ -71,27 +449,57 @@ void CppToolsUtil::TryMakePluginFileWriteable(const FString& PluginFile)
     if ( ISourceControlModule::Get().IsEnabled() )
     {
         FText FailReason;
-        CheckoutFile(PluginFile, FailReason);
+        CheckoutFile(Filename, FailReason);
     }
 
     // Check if it's writable
-    if(FPlatformFileManager::Get().GetPlatformFile().IsReadOnly(*PluginFile))
+    if(FPlatformFileManager::Get().GetPlatformFile().IsReadOnly(*Filename))
     {
-        FText ShouldMakePluginWriteable = LOCTEXT("ShouldMakePluginWriteable_Message", "'{PluginFilename}' is read-only and cannot be updated. Would you like to make it writeable?");
+        if (!IsInteractive())
+        {
+            UE_LOG(LogCppToolsUtil, Warning, TEXT("'%s' is read-only and is being made writeable."), *Filename);
+            FPlatformFileManager::Get().GetPlatformFile().SetReadOnly(*Filename, false);
+            return;
+        }
+
+        FText ShouldMakeFileWriteable = LOCTEXT("ShouldMakeFileWriteable_Message", "'{Filename}' is read-only and cannot be updated. Would you like to make it writeable?");
 
         FFormatNamedArguments Arguments;
-        Arguments.Add( TEXT("PluginFilename"), FText::FromString(PluginFile));
+        Arguments.Add( TEXT("Filename"), FText::FromString(Filename));
 
-        if(FMessageDialog::Open(EAppMsgType::YesNo, FText::Format(ShouldMakePluginWriteable, Arguments)) == EAppReturnType::Yes)
+        if(FMessageDialog::Open(EAppMsgType::YesNo, FText::Format(ShouldMakeFileWriteable, Arguments)) == EAppReturnType::Yes)
         {
-            FPlatformFileManager::Get().GetPlatformFile().SetReadOnly(*PluginFile, false);
+            FPlatformFileManager::Get().GetPlatformFile().SetReadOnly(*Filename, false);
         }
     }
 }
 
+void CppToolsUtil::TryMakePluginFileWriteable(const FString& PluginFile)
+{
+    TryMakeFileWriteable(PluginFile);
+}
+
+bool CppToolsUtil::LoadFileToString(FString& OutFileContents, const FString& Filename)
+{
+    CPPTOOLS_TRACE_FILE_SCOPE(ReadFile, Filename);
+    return FFileHelper::LoadFileToString(OutFileContents, *Filename);
+}
+
+bool CppToolsUtil::SaveStringToFile(const FString& FileContents, const FString& Filename)
+{
+    CPPTOOLS_TRACE_FILE_SCOPE(WriteFile, Filename);
+    return FFileHelper::SaveStringToFile(FileContents, *Filename);
+}
+
+bool CppToolsUtil::WriteOutputFile(const FString& Filename, const FString& FileContents, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_FILE_SCOPE(WriteFile, Filename);
+    return GameProjectUtils::WriteOutputFile(Filename, FileContents, OutFailReason);
+}
+
 bool CppToolsUtil::ReadCustomTemplateFile(const FString& TemplateFileName, FString& OutFileContents, FText& OutFailReason) {
     const FString FullFileName = CppToolsContentDir() / TEXT("Editor") / TEXT("Templates") / TemplateFileName;
-    if (FFileHelper::LoadFileToString(OutFileContents, *FullFileName))
+    if (LoadFileToString(OutFileContents, FullFileName))
     {
         return true;
     }
@@ -104,6 +512,7 @@ bool CppToolsUtil::ReadCustomTemplateFile(const FString& TemplateFileName, FStri
 
 bool CppToolsUtil::FindFileInProject(const FString& InFilename, const FString& InSearchPath, FString& OutPath)
 {
+    CPPTOOLS_TRACE_SCOPE(FindFileInProject);
     // See GameProjectUtils L4094
     TArray<FString> Filenames;
     IFileManager::Get().FindFilesRecursive(Filenames, *InSearchPath, *InFilename, true, false, false);
@@ -120,63 +529,119 @@ bool CppToolsUtil::FindFileInProject(const FString& InFilename, const FString& I
 
 FString CppToolsUtil::StripCStyleComments(const FString& SourceString)
 {
-    FString Result = SourceString;
+    CPPTOOLS_TRACE_SCOPE(StripCStyleComments);
+    using namespace CppToolsUtilImpl;
 
-    const FString BlockCommentPattern = TEXT("(?:\\/\\*(?:[^\\*]*(?:(?!\\*\\/)\\*)*)*\\*\\/)");
-    const FString LineCommentPattern = TEXT("(?:\\/\\/.*)");
-    
-    const FRegexPattern CommentPattern(BlockCommentPattern + "|" + LineCommentPattern);
-    FRegexMatcher CommentMatcher(CommentPattern, Result);
+    const FStringView Source = MakeView(SourceString);
+    FString Result;
+    Result.Reserve(Source.Len());
 
-    while (CommentMatcher.FindNext())
+    // The text between comments is copied in runs, skipping literals so comment markers within strings are kept
+    int32 RunStart = 0;
+    int32 Index = 0;
+    while (Index < Source.Len())
     {
-        int32 start = CommentMatcher.GetMatchBeginning();
-        int32 end = CommentMatcher.GetMatchEnding();
-
-        Result.RemoveAt(start, end - start);
+        const int32 AfterComment = SkipComment(Source, Index);
+        if (AfterComment != Index)
+        {
+            Result.AppendChars(Source.GetData() + RunStart, Index - RunStart);
+            RunStart = Index = AfterComment;
+            continue;
+        }
 
-        CommentMatcher = FRegexMatcher(CommentPattern, Result);
+        const int32 AfterLiteral = SkipLiteral(Source, Index);
+        Index = AfterLiteral != Index ? AfterLiteral : Index + 1;
     }
+    Result.AppendChars(Source.GetData() + RunStart, Source.Len() - RunStart);
 
     return Result;
 }
 
 TArray<FString> CppToolsUtil::ParseStringList(const FString& RawStringList)
 {
-    TArray<FString> Strings;
-    const FRegexPattern StringPattern("\"([^\"]+)\"");
-    FRegexMatcher StringMatcher(StringPattern, RawStringList);
+    TArray<FStringView> Views;
+    ParseStringListViews(CppToolsUtilImpl::MakeView(RawStringList), Views);
 
-    while (StringMatcher.FindNext())
+    TArray<FString> Strings;
+    Strings.Reserve(Views.Num());
+    for (const FStringView& View : Views)
     {
-        Strings.Add(StringMatcher.GetCaptureGroup(1));
+        Strings.Emplace(View.Len(), View.GetData());
     }
-
     return Strings;
 }
 
-FString CppToolsUtil::CombineStringList(const TArray<FString>& StringList, bool bUseQuotes = false, bool bIncludeSpace = true)
+void CppToolsUtil::ParseStringListViews(FStringView RawStringList, TArray<FStringView>& OutStrings)
 {
-    FString Result;
-    for (int32 I = 0; I < StringList.Num(); I++)
+    const TCHAR* Data = RawStringList.GetData();
+    const int32 Len = RawStringList.Len();
+
+    int32 Index = 0;
+    while (Index < Len)
     {
-        FString Element = StringList[I];
-        if (bUseQuotes) Element = "\"" + Element + "\"";
+        if (Data[Index] != TEXT('"'))
+        {
+            Index++;
+            continue;
+        }
 
-        Result += Element;
+        int32 End = Index + 1;
+        while (End < Len && Data[End] != TEXT('"')) End++;
+        if (End == Len) break;
 
-        if (I < StringList.Num() - 1)
+        // An empty pair of quotes is not a string, but its closing quote may open the next one
+        if (End == Index + 1)
         {
-            Result += ",";
-            if (bIncludeSpace) Result += " ";
+            Index = End;
+            continue;
         }
+
+        OutStrings.Add(FStringView(Data + Index + 1, End - Index - 1));
+        Index = End + 1;
     }
+}
+
+FString CppToolsUtil::CombineStringList(const TArray<FString>& StringList, bool bUseQuotes = false, bool bIncludeSpace = true)
+{
+    using namespace CppToolsUtilImpl;
+
+    FString Result;
+    Result.Reserve(GetStringListLength(StringList, bUseQuotes, bIncludeSpace));
+    AppendStringList(Result, StringList, bUseQuotes, bIncludeSpace);
     return Result;
 }
 
+FString CppToolsUtil::CombineStringList(TArrayView<const FStringView> StringList, bool bUseQuotes, bool bIncludeSpace)
+{
+    using namespace CppToolsUtilImpl;
+
+    FString Result;
+    Result.Reserve(GetStringListLength(StringList, bUseQuotes, bIncludeSpace));
+    AppendStringList(Result, StringList, bUseQuotes, bIncludeSpace);
+    return Result;
+}
+
+bool CppToolsUtil::IsInteractive()
+{
+    return !IsRunningCommandlet() && !FApp::IsUnattended() && FSlateApplication::IsInitialized();
+}
+
 void CppToolsUtil::PushNotification(const FText& Text,
                                     const SNotificationItem::ECompletionState& CompletionState = SNotificationItem::ECompletionState::CS_None)
 {
+    if (!IsInteractive())
+    {
+        if (CompletionState == SNotificationItem::CS_Fail)
+        {
+            UE_LOG(LogCppToolsUtil, Error, TEXT("%s"), *Text.ToString());
+        }
+        else
+        {
+            UE_LOG(LogCppToolsUtil, Display, TEXT("%s"), *Text.ToString());
+        }
+        return;
+    }
+
     const FNotificationInfo Notification(Text);
     auto SNotify = FSlateNotificationManager::Get().AddNotification(Notification);
     SNotify->SetCompletionState(CompletionState);
@@ -217,12 +682,22 @@ TArray<TSharedPtr<IPlugin>> CppToolsUtil::GetProjectPlugins()
         // Only get plugins that are a part of the game project
         if (Plugin->GetLoadedFrom() == EPluginLoadedFrom::Project)
         {
-            Plugins.Add(MakeShareable(&Plugin.Get()));
+            Plugins.Add(Plugin);
         }
     }
     return Plugins;
 }
 
+TSharedPtr<IPlugin> CppToolsUtil::FindProjectPlugin(const FString& PluginName)
+{
+    TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(PluginName);
+    if (Plugin.IsValid() && Plugin->GetLoadedFrom() == EPluginLoadedFrom::Project)
+    {
+        return Plugin;
+    }
+    return nullptr;
+}
+
 TArray<FModuleContextInfo> CppToolsUtil::GetProjectModules()
 {
     return GameProjectUtils::GetCurrentProjectModules();
@@ -230,6 +705,7 @@ TArray<FModuleContextInfo> CppToolsUtil::GetProjectModules()
 
 TArray<FModuleContextInfo> CppToolsUtil::GetPluginModules(const TSharedPtr<IPlugin>& Plugin)
 {
+    CPPTOOLS_TRACE_SCOPE(GetPluginModules);
     // See GameProjectUtils.cpp L2609
 
     TArray<FModuleContextInfo> AvailableModules;
@@ -239,6 +715,19 @@ TArray<FModuleContextInfo> CppToolsUtil::GetPluginModules(const TSharedPtr<IPlug
     // Only get plugins that are a part of the game project
     if (Plugin->GetLoadedFrom() == EPluginLoadedFrom::Project)
     {
+        // The plugin source tree is searched once for every .Build.cs file rather than once per module
+        TArray<FString> BuildFiles;
+        IFileManager::Get().FindFilesRecursive(BuildFiles, *Plugin->GetBaseDir(), TEXT("*.Build.cs"), true, false, false);
+        TMap<FString, FString> BuildFilesByModule;
+        for (const FString& BuildFile : BuildFiles)
+        {
+            const FString ModuleName = FPaths::GetCleanFilename(BuildFile).LeftChop(9);
+            if (!BuildFilesByModule.Contains(ModuleName))
+            {
+                BuildFilesByModule.Add(ModuleName, BuildFile);
+            }
+        }
+
         for (const auto& PluginModule : Plugin->GetDescriptor().Modules)
         {
             FModuleContextInfo ModuleInfo;
@@ -246,11 +735,12 @@ TArray<FModuleContextInfo> CppToolsUtil::GetPluginModules(const TSharedPtr<IPlug
             ModuleInfo.ModuleType = PluginModule.Type;
 
             // Try and find the .Build.cs file for this module within the plugin source tree
-            FString TmpPath;
-            if (!FindFileInProject(ModuleInfo.ModuleName + ".Build.cs", Plugin->GetBaseDir(), TmpPath))
+            const FString* BuildFile = BuildFilesByModule.Find(ModuleInfo.ModuleName);
+            if (!BuildFile)
             {
                 continue;
             }
+            const FString& TmpPath = *BuildFile;
 
             // Chop the .Build.cs file off the end of the path
             ModuleInfo.ModuleSourcePath = FPaths::GetPath(TmpPath);
@@ -263,280 +753,1149 @@ TArray<FModuleContextInfo> CppToolsUtil::GetPluginModules(const TSharedPtr<IPlug
     return AvailableModules;
 }
 
-TArray<FString> CppToolsUtil::GetModuleDependencies(const FString& ModuleName, TSharedPtr<IPlugin> Target = nullptr, bool bIncludePrivate = false)
+TArray<TPair<FModuleContextInfo, TSharedPtr<IPlugin>>> CppToolsUtil::GetProjectAndPluginModules()
 {
-    TArray<FString> Result;
-    
-    FString BuildFilePath;
-    if (!GetModuleBuildFilePath(ModuleName, Target, BuildFilePath)) return Result;
-
-    FString FileContents;
-    
-    if (FFileHelper::LoadFileToString(FileContents, *BuildFilePath))
+    TArray<TPair<FModuleContextInfo, TSharedPtr<IPlugin>>> Modules;
+    for (const FModuleContextInfo& Module : GetProjectModules())
     {
-
-        FileContents = StripCStyleComments(FileContents);
-
-        FString DependencySource = "(?:PublicDependencyModuleNames)";
-        if (bIncludePrivate) DependencySource += "|(?:PrivateDependencyModuleNames)";
-        
-        const FString AddRangePattern = DependencySource +
-            "\\.AddRange\\(\\s*new(?:\\s+string)?\\[\\s*\\]\\s*\\{\\s*((?:[^\\}]*(?:\\r\\n|\\r|\\n)?)*)\\s*\\}\\s*\\);";
-        const FString AddPattern = DependencySource + "\\.Add\\(([^\\)]+)\\);";
-        
-        const FRegexPattern DependenciesPattern("(?:" + AddRangePattern + ")|(?:" + AddPattern + ")");
-        FRegexMatcher DependenciesMatcher(DependenciesPattern, FileContents);
-
-        while (DependenciesMatcher.FindNext())
+        Modules.Emplace(Module, nullptr);
+    }
+    for (const TSharedPtr<IPlugin>& Plugin : GetProjectPlugins())
+    {
+        for (const FModuleContextInfo& Module : GetPluginModules(Plugin))
         {
-            Result.Append(ParseStringList(DependenciesMatcher.GetCaptureGroup(1)));
+            Modules.Emplace(Module, Plugin);
         }
     }
-
-    return Result;
+    return Modules;
 }
 
-bool CppToolsUtil::GenerateModuleBuildFile(const FString& NewBuildFileName, const FString& ModuleName, const TArray<FString>& PublicDependencyModuleNames,
-    const TArray<FString>& PrivateDependencyModuleNames, FText& OutFailReason, bool bUseExplicitOrSharedPCHs)
+TArray<FString> CppToolsUtil::GetModuleDependencies(const FString& ModuleName, TSharedPtr<IPlugin> Target = nullptr, bool bIncludePrivate = false)
 {
-    
-    FString Template;
-    if (!ReadCustomTemplateFile(TEXT("Module.Build.cs.template"), Template, OutFailReason))
-    {
-        return false;
-    }
-
-    FString FinalOutput = Template.Replace(TEXT("%COPYRIGHT_LINE%"), *GetCopyrightLine(), ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%PUBLIC_DEPENDENCY_MODULE_NAMES%"), *GameProjectUtils::MakeCommaDelimitedList(PublicDependencyModuleNames), ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%PRIVATE_DEPENDENCY_MODULE_NAMES%"), *GameProjectUtils::MakeCommaDelimitedList(PrivateDependencyModuleNames), ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%MODULE_NAME%"), *ModuleName, ESearchCase::CaseSensitive);
-
-    const FString PCHUsage = bUseExplicitOrSharedPCHs ? TEXT("UseExplicitOrSharedPCHs") : TEXT("UseSharedPCHs");
-    FinalOutput = FinalOutput.Replace(TEXT("%PCH_USAGE%"), *PCHUsage, ESearchCase::CaseSensitive);
+    CPPTOOLS_TRACE_SCOPE(GetModuleDependencies);
 
-    return GameProjectUtils::WriteOutputFile(NewBuildFileName, FinalOutput, OutFailReason);
-}
+    FString FileContents;
+    TArray<FStringView> Views;
+    if (!GetModuleDependencyViews(ModuleName, Target, bIncludePrivate, FileContents, Views)) return TArray<FString>();
 
-bool CppToolsUtil::GenerateModuleHeaderFile(const FString& NewHeaderFileName, const FString& ModuleName, const TArray<FString>& PublicHeaderIncludes, FText& OutFailReason) {
-    FString Template;
-    if (!ReadCustomTemplateFile(TEXT("Module.h.template"), Template, OutFailReason))
+    TArray<FString> Result;
+    Result.Reserve(Views.Num());
+    for (const FStringView& View : Views)
     {
-        return false;
+        Result.Emplace(View.Len(), View.GetData());
     }
+    return Result;
+}
 
-    FString FinalOutput = Template.Replace(TEXT("%COPYRIGHT_LINE%"), *GetCopyrightLine(), ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%MODULE_NAME%"), *ModuleName, ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%CLASS_MODULE_API_MACRO%"), *GetModuleAPIMacro(ModuleName, false), ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%PUBLIC_HEADER_INCLUDES%"), *GameProjectUtils::MakeIncludeList(PublicHeaderIncludes), ESearchCase::CaseSensitive);
+bool CppToolsUtil::GetModuleDependencyViews(const FString& ModuleName, TSharedPtr<IPlugin> Target, bool bIncludePrivate, FString& OutBuildFileContents,
+    TArray<FStringView>& OutDependencies)
+{
+    FString BuildFilePath;
+    if (!GetModuleBuildFilePath(ModuleName, Target, BuildFilePath) || !LoadFileToString(OutBuildFileContents, BuildFilePath)) return false;
 
-    return GameProjectUtils::WriteOutputFile(NewHeaderFileName, FinalOutput, OutFailReason);
+    ParseModuleDependencyViews(CppToolsUtilImpl::MakeView(OutBuildFileContents), bIncludePrivate, OutDependencies);
+    return true;
 }
 
-bool CppToolsUtil::GenerateModuleCPPFile(const FString& NewCPPFileName, const FString& ModuleName, const FString& StartupSourceCode, const FString& ShutdownSourceCode, FText& OutFailReason) {
-    FString Template;
-    if (!ReadCustomTemplateFile(TEXT("Module.cpp.template"), Template, OutFailReason))
-    {
-        return false;
-    }
+TArray<FString> CppToolsUtil::ParseModuleDependencies(const FString& BuildFileContents, bool bIncludePrivate)
+{
+    CPPTOOLS_TRACE_SCOPE(ParseModuleDependencies);
+
+    TArray<FStringView> Views;
+    ParseModuleDependencyViews(CppToolsUtilImpl::MakeView(BuildFileContents), bIncludePrivate, Views);
+
+    TArray<FString> Result;
+    Result.Reserve(Views.Num());
+    for (const FStringView& View : Views)
+    {
+        Result.Emplace(View.Len(), View.GetData());
+    }
+    return Result;
+}
+
+void CppToolsUtil::ParseModuleDependencyViews(FStringView BuildFileContents, bool bIncludePrivate, TArray<FStringView>& OutDependencies)
+{
+    using namespace CppToolsUtilImpl;
+
+    TArray<FStringListCall> Calls;
+    FindStringListCalls(BuildFileContents, MakeArrayView(DependencyListNames, bIncludePrivate ? 2 : 1), Calls);
+    for (const FStringListCall& Call : Calls)
+    {
+        ParseStringListCallElements(BuildFileContents, Call, OutDependencies);
+    }
+}
+
+TArray<FString> CppToolsUtil::ParseIncludes(const FString& SourceContents)
+{
+    TArray<FString> Result;
+
+    TArray<FString> Lines;
+    StripCStyleComments(SourceContents).ParseIntoArrayLines(Lines);
+
+    const FRegexPattern IncludePattern(TEXT("^[ \\t]*#[ \\t]*include[ \\t]*[\"<]([^\">]+)[\">]"));
+    for (const FString& Line : Lines)
+    {
+        FRegexMatcher IncludeMatcher(IncludePattern, Line);
+        if (IncludeMatcher.FindNext())
+        {
+            Result.Add(IncludeMatcher.GetCaptureGroup(1).TrimStartAndEnd());
+        }
+    }
+    return Result;
+}
+
+TArray<FString> CppToolsUtil::GetProjectTargetFiles()
+{
+    TArray<FString> TargetFiles;
+    IFileManager::Get().FindFiles(TargetFiles, *(FPaths::GameSourceDir() / TEXT("*.Target.cs")), true, false);
+    for (FString& TargetFile : TargetFiles)
+    {
+        TargetFile = FPaths::ConvertRelativePathToFull(FPaths::GameSourceDir() / TargetFile);
+    }
+    return TargetFiles;
+}
+
+TArray<FString> CppToolsUtil::ParseTargetExtraModules(const FString& TargetFileContents)
+{
+    using namespace CppToolsUtilImpl;
+
+    const FStringView Contents = MakeView(TargetFileContents);
+    TArray<FStringListCall> Calls;
+    FindStringListCalls(Contents, MakeArrayView(ExtraModuleListNames), Calls);
+
+    TArray<FStringView> Views;
+    for (const FStringListCall& Call : Calls)
+    {
+        ParseStringListCallElements(Contents, Call, Views);
+    }
+
+    TArray<FString> Result;
+    Result.Reserve(Views.Num());
+    for (const FStringView& View : Views)
+    {
+        Result.Emplace(View.Len(), View.GetData());
+    }
+    return Result;
+}
+
+bool CppToolsUtil::RemoveFromStringLists(FString& Contents, TArrayView<const FStringView> ListNames, const FString& Element)
+{
+    CPPTOOLS_TRACE_SCOPE(RemoveFromStringLists);
+    using namespace CppToolsUtilImpl;
+
+    // Edits are made from the last list to the first, so removing text does not move the lists still to be edited
+    struct FListMatch
+    {
+        FStringListCall Call;
+        int32 ElementStart;
+        int32 ElementEnd;
+    };
+    TArray<FListMatch> Matches;
+    {
+        const FStringView ContentsView = MakeView(Contents);
+        const FStringView ElementView = MakeView(Element);
+
+        TArray<FStringListCall> Calls;
+        FindStringListCalls(ContentsView, ListNames, Calls);
+
+        TArray<FStringView> Strings;
+        for (const FStringListCall& Call : Calls)
+        {
+            Strings.Reset();
+            ParseStringListCallElements(ContentsView, Call, Strings);
+            const FStringView* Found = Strings.FindByPredicate([ElementView](FStringView String) { return ViewEquals(String, ElementView); });
+            if (!Found) continue;
+
+            // The element's range includes its quotes
+            const int32 ElementStart = static_cast<int32>(Found->GetData() - ContentsView.GetData()) - 1;
+            Matches.Add({ Call, ElementStart, ElementStart + Found->Len() + 2 });
+        }
+    }
+
+    for (int32 I = Matches.Num() - 1; I >= 0; I--)
+    {
+        const FListMatch& Match = Matches[I];
+        if (Match.Call.bIsAdd)
+        {
+            RemoveStatement(Contents, Match.Call.Start, Match.Call.End);
+            continue;
+        }
+
+        int32 Start = Match.ElementStart;
+        int32 End = Match.ElementEnd;
+
+        int32 Next = End;
+        while (Next < Match.Call.ContentsEnd && FChar::IsWhitespace(Contents[Next])) Next++;
+        if (Next < Match.Call.ContentsEnd && Contents[Next] == TEXT(','))
+        {
+            // Remove the element with the comma after it, and its line if it was on its own
+            End = Next + 1;
+            while (End < Contents.Len() && (Contents[End] == TEXT(' ') || Contents[End] == TEXT('\t'))) End++;
+            int32 LineStart = Start;
+            while (LineStart > 0 && (Contents[LineStart - 1] == TEXT(' ') || Contents[LineStart - 1] == TEXT('\t'))) LineStart--;
+            if (LineStart > 0 && Contents[LineStart - 1] == TEXT('\n') && End < Contents.Len()
+                && (Contents[End] == TEXT('\r') || Contents[End] == TEXT('\n')))
+            {
+                if (Contents[End] == TEXT('\r')) End++;
+                if (End < Contents.Len() && Contents[End] == TEXT('\n')) End++;
+                Start = LineStart;
+            }
+        }
+        else
+        {
+            // The last element takes the comma before it instead
+            int32 Previous = Start;
+            while (Previous > Match.Call.ContentsStart && FChar::IsWhitespace(Contents[Previous - 1])) Previous--;
+            if (Previous > Match.Call.ContentsStart && Contents[Previous - 1] == TEXT(','))
+            {
+                Start = Previous - 1;
+            }
+        }
+        Contents.RemoveAt(Start, End - Start);
+    }
+    return Matches.Num() > 0;
+}
+
+void CppToolsUtil::RemoveStatement(FString& Contents, int32 Start, int32 End)
+{
+    int32 LineStart = Start;
+    while (LineStart > 0 && (Contents[LineStart - 1] == TEXT(' ') || Contents[LineStart - 1] == TEXT('\t'))) LineStart--;
+    int32 LineEnd = End;
+    while (LineEnd < Contents.Len() && (Contents[LineEnd] == TEXT(' ') || Contents[LineEnd] == TEXT('\t'))) LineEnd++;
+    if ((LineStart == 0 || Contents[LineStart - 1] == TEXT('\n')) && LineEnd < Contents.Len()
+        && (Contents[LineEnd] == TEXT('\r') || Contents[LineEnd] == TEXT('\n')))
+    {
+        if (Contents[LineEnd] == TEXT('\r')) LineEnd++;
+        if (LineEnd < Contents.Len() && Contents[LineEnd] == TEXT('\n')) LineEnd++;
+        Start = LineStart;
+        End = LineEnd;
+    }
+
+    Contents.RemoveAt(Start, End - Start);
+}
+
+FString CppToolsUtil::GetModuleFwdHeaderPath(const FString& ModulePath, const FString& ModuleName)
+{
+    return ModulePath / TEXT("Public") / ModuleName + TEXT("Fwd.h");
+}
+
+TArray<FString> CppToolsUtil::ParseForwardDeclarations(const FString& HeaderContents)
+{
+    CPPTOOLS_TRACE_SCOPE(ParseForwardDeclarations);
+    using namespace CppToolsUtilImpl;
+
+    TArray<FString> Result;
+
+    // The enclosing scopes, named after their namespace, or empty for scopes that are not named namespaces
+    TArray<FString> Scopes;
+    // The tokens of the current statement, since the last semicolon or brace, excluding anything within parentheses
+    TArray<FString> Statement;
+    int32 ParenthesesDepth = 0;
+    bool bLineStart = true;
+
+    const TCHAR* Char = *HeaderContents;
+    while (*Char)
+    {
+        if (*Char == TEXT('\n'))
+        {
+            bLineStart = true;
+            Char++;
+        }
+        else if (FChar::IsWhitespace(*Char))
+        {
+            Char++;
+        }
+        else if (Char[0] == TEXT('/') && Char[1] == TEXT('/'))
+        {
+            while (*Char && *Char != TEXT('\n')) Char++;
+        }
+        else if (Char[0] == TEXT('/') && Char[1] == TEXT('*'))
+        {
+            Char += 2;
+            while (*Char && !(Char[0] == TEXT('*') && Char[1] == TEXT('/'))) Char++;
+            if (*Char) Char += 2;
+        }
+        else if (bLineStart && *Char == TEXT('#'))
+        {
+            // Skip preprocessor directives, including any continued lines
+            while (*Char && !(*Char == TEXT('\n') && Char[-1] != TEXT('\\'))) Char++;
+        }
+        else if (*Char == TEXT('"') || *Char == TEXT('\''))
+        {
+            const TCHAR Quote = *Char++;
+            while (*Char && *Char != Quote)
+            {
+                if (*Char == TEXT('\\') && Char[1]) Char++;
+                Char++;
+            }
+            if (*Char) Char++;
+            bLineStart = false;
+        }
+        else if (FChar::IsAlnum(*Char) || *Char == TEXT('_'))
+        {
+            const TCHAR* TokenStart = Char;
+            while (FChar::IsAlnum(*Char) || *Char == TEXT('_')) Char++;
+            if (ParenthesesDepth == 0) Statement.Emplace(static_cast<int32>(Char - TokenStart), TokenStart);
+            bLineStart = false;
+        }
+        else
+        {
+            const TCHAR Punctuation = *Char++;
+            bLineStart = false;
+
+            if (Punctuation == TEXT('('))
+            {
+                ParenthesesDepth++;
+            }
+            else if (Punctuation == TEXT(')'))
+            {
+                ParenthesesDepth = FMath::Max(0, ParenthesesDepth - 1);
+            }
+            else if (ParenthesesDepth > 0)
+            {
+                // Braces and semicolons within parentheses belong to macro arguments or lambdas
+            }
+            else if (Punctuation == TEXT(':'))
+            {
+                if (*Char == TEXT(':'))
+                {
+                    Char++;
+                    Statement.Add(TEXT("::"));
+                }
+                else
+                {
+                    Statement.Add(TEXT(":"));
+                }
+            }
+            else if (Punctuation == TEXT(';'))
+            {
+                Statement.Reset();
+            }
+            else if (Punctuation == TEXT('{'))
+            {
+                if (Statement.Num() >= 2 && Statement[0] == TEXT("namespace"))
+                {
+                    Statement.RemoveAt(0);
+                    Scopes.Add(FString::Join(Statement, TEXT("")));
+                }
+                else
+                {
+                    // Only types at namespace scope can be forward declared
+                    if (!Scopes.Contains(FString()))
+                    {
+                        FString Declaration = MakeForwardDeclaration(Statement);
+                        if (!Declaration.IsEmpty())
+                        {
+                            for (int32 Scope = Scopes.Num() - 1; Scope >= 0; Scope--)
+                            {
+                                Declaration = TEXT("namespace ") + Scopes[Scope] + TEXT(" { ") + Declaration + TEXT(" }");
+                            }
+                            Result.AddUnique(Declaration);
+                        }
+                    }
+                    Scopes.Add(FString());
+                }
+                Statement.Reset();
+            }
+            else if (Punctuation == TEXT('}'))
+            {
+                if (Scopes.Num() > 0) Scopes.Pop();
+                Statement.Reset();
+            }
+        }
+    }
+
+    return Result;
+}
+
+bool CppToolsUtil::GenerateModuleBuildFile(const FString& NewBuildFileName, const FString& ModuleName, const TArray<FString>& PublicDependencyModuleNames,
+    const TArray<FString>& PrivateDependencyModuleNames, FText& OutFailReason, bool bUseExplicitOrSharedPCHs)
+{
+    CPPTOOLS_TRACE_SCOPE(GenerateModuleBuildFile);
+    FString FinalOutput;
+    if (!FillModuleBuildFileTemplate(ModuleName, PublicDependencyModuleNames, PrivateDependencyModuleNames, bUseExplicitOrSharedPCHs, FinalOutput, OutFailReason))
+    {
+        return false;
+    }
+
+    return WriteOutputFile(NewBuildFileName, FinalOutput, OutFailReason);
+}
+
+bool CppToolsUtil::GenerateModuleHeaderFile(const FString& NewHeaderFileName, const FString& ModuleName, const TArray<FString>& PublicHeaderIncludes, FText& OutFailReason,
+    int32 LLMTagIndex) {
+    CPPTOOLS_TRACE_SCOPE(GenerateModuleHeaderFile);
+    FString FinalOutput;
+    if (!FillModuleHeaderTemplate(ModuleName, PublicHeaderIncludes, FinalOutput, OutFailReason, LLMTagIndex))
+    {
+        return false;
+    }
+
+    return WriteOutputFile(NewHeaderFileName, FinalOutput, OutFailReason);
+}
+
+bool CppToolsUtil::GenerateModuleCPPFile(const FString& NewCPPFileName, const FString& ModuleName, const FString& StartupSourceCode, const FString& ShutdownSourceCode, FText& OutFailReason,
+    int32 LLMTagIndex) {
+    CPPTOOLS_TRACE_SCOPE(GenerateModuleCPPFile);
+    FString FinalOutput;
+    if (!FillModuleCPPTemplate(ModuleName, StartupSourceCode, ShutdownSourceCode, FinalOutput, OutFailReason, LLMTagIndex))
+    {
+        return false;
+    }
+
+    return WriteOutputFile(NewCPPFileName, FinalOutput, OutFailReason);
+}
+
+bool CppToolsUtil::FillModuleBuildFileTemplate(const FString& ModuleName, const TArray<FString>& PublicDependencyModuleNames,
+    const TArray<FString>& PrivateDependencyModuleNames, bool bUseExplicitOrSharedPCHs, FString& OutFileContents, FText& OutFailReason)
+{
+    const TSharedPtr<const FCppToolsTemplate> Template = FCppToolsTemplate::Load(TEXT("Module.Build.cs.template"), OutFailReason);
+    if (!Template.IsValid())
+    {
+        return false;
+    }
+
+    OutFileContents = RenderModuleBuildFile(*Template, ModuleName, PublicDependencyModuleNames, PrivateDependencyModuleNames, bUseExplicitOrSharedPCHs);
+    return true;
+}
+
+bool CppToolsUtil::FillModuleHeaderTemplate(const FString& ModuleName, const TArray<FString>& PublicHeaderIncludes, FString& OutFileContents,
+    FText& OutFailReason, int32 LLMTagIndex)
+{
+    const TSharedPtr<const FCppToolsTemplate> Template = FCppToolsTemplate::Load(TEXT("Module.h.template"), OutFailReason);
+    if (!Template.IsValid())
+    {
+        return false;
+    }
+
+    OutFileContents = RenderModuleHeaderFile(*Template, ModuleName, PublicHeaderIncludes, LLMTagIndex);
+    return true;
+}
+
+bool CppToolsUtil::FillModuleCPPTemplate(const FString& ModuleName, const FString& StartupSourceCode, const FString& ShutdownSourceCode,
+    FString& OutFileContents, FText& OutFailReason, int32 LLMTagIndex)
+{
+    const TSharedPtr<const FCppToolsTemplate> Template = FCppToolsTemplate::Load(TEXT("Module.cpp.template"), OutFailReason);
+    if (!Template.IsValid())
+    {
+        return false;
+    }
+
+    OutFileContents = RenderModuleCPPFile(*Template, ModuleName, StartupSourceCode, ShutdownSourceCode, LLMTagIndex);
+    return true;
+}
+
+FString CppToolsUtil::RenderModuleBuildFile(const FCppToolsTemplate& Template, const FString& ModuleName, const TArray<FString>& PublicDependencyModuleNames,
+    const TArray<FString>& PrivateDependencyModuleNames, bool bUseExplicitOrSharedPCHs)
+{
+    TMap<FString, FString> Values;
+    Values.Add(TEXT("COPYRIGHT_LINE"), GetCopyrightLine());
+    Values.Add(TEXT("PUBLIC_DEPENDENCY_MODULE_NAMES"), GameProjectUtils::MakeCommaDelimitedList(PublicDependencyModuleNames));
+    Values.Add(TEXT("PRIVATE_DEPENDENCY_MODULE_NAMES"), GameProjectUtils::MakeCommaDelimitedList(PrivateDependencyModuleNames));
+    Values.Add(TEXT("MODULE_NAME"), ModuleName);
+    Values.Add(TEXT("PCH_USAGE"), bUseExplicitOrSharedPCHs ? TEXT("UseExplicitOrSharedPCHs") : TEXT("UseSharedPCHs"));
+    return Template.Render(Values);
+}
+
+FString CppToolsUtil::RenderModuleHeaderFile(const FCppToolsTemplate& Template, const FString& ModuleName, const TArray<FString>& PublicHeaderIncludes,
+    int32 LLMTagIndex)
+{
+    const bool bLLMTag = LLMTagIndex != INDEX_NONE;
+    TArray<FString> Includes = PublicHeaderIncludes;
+    if (bLLMTag)
+    {
+        Includes.AddUnique(TEXT("HAL/LowLevelMemTracker.h"));
+    }
+
+    TMap<FString, FString> Values;
+    Values.Add(TEXT("COPYRIGHT_LINE"), GetCopyrightLine());
+    Values.Add(TEXT("MODULE_NAME"), ModuleName);
+    Values.Add(TEXT("CLASS_MODULE_API_MACRO"), GetModuleAPIMacro(ModuleName, false));
+    Values.Add(TEXT("PUBLIC_HEADER_INCLUDES"), GameProjectUtils::MakeIncludeList(Includes));
+    Values.Add(TEXT("MODULE_LLM_TAG_DECLARATION"), bLLMTag ? CppToolsMemoryTags::RenderTagDeclaration(ModuleName, LLMTagIndex) : FString());
+    return Template.Render(Values);
+}
+
+FString CppToolsUtil::RenderModuleCPPFile(const FCppToolsTemplate& Template, const FString& ModuleName, const FString& StartupSourceCode,
+    const FString& ShutdownSourceCode, int32 LLMTagIndex)
+{
+    const bool bLLMTag = LLMTagIndex != INDEX_NONE;
+
+    TMap<FString, FString> Values;
+    Values.Add(TEXT("COPYRIGHT_LINE"), GetCopyrightLine());
+    Values.Add(TEXT("MODULE_NAME"), ModuleName);
+    Values.Add(TEXT("MODULE_STARTUP_CODE"), StartupSourceCode);
+    Values.Add(TEXT("MODULE_SHUTDOWN_CODE"), ShutdownSourceCode);
+    Values.Add(TEXT("MODULE_LLM_TAG_DEFINITION"), bLLMTag ? CppToolsMemoryTags::RenderTagDefinition(ModuleName) : FString());
+    Values.Add(TEXT("MODULE_LLM_SCOPE"), bLLMTag ? CppToolsMemoryTags::RenderTagScope(ModuleName) : FString());
+    return Template.Render(Values);
+}
+
+bool CppToolsUtil::GenerateModuleFwdHeaderFile(const FString& NewFwdHeaderFileName, const FString& ModuleName, const FString& ForwardDeclarations,
+    FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(GenerateModuleFwdHeaderFile);
+    FString FinalOutput;
+    if (!FillModuleFwdHeaderTemplate(ModuleName, ForwardDeclarations, FinalOutput, OutFailReason))
+    {
+        return false;
+    }
+
+    return WriteOutputFile(NewFwdHeaderFileName, FinalOutput, OutFailReason);
+}
+
+bool CppToolsUtil::FillModuleFwdHeaderTemplate(const FString& ModuleName, const FString& ForwardDeclarations, FString& OutFileContents,
+    FText& OutFailReason)
+{
+    const TSharedPtr<const FCppToolsTemplate> Template = FCppToolsTemplate::Load(TEXT("ModuleFwd.h.template"), OutFailReason);
+    if (!Template.IsValid())
+    {
+        return false;
+    }
+
+    OutFileContents = RenderModuleFwdHeaderFile(*Template, ModuleName, ForwardDeclarations);
+    return true;
+}
+
+FString CppToolsUtil::RenderModuleFwdHeaderFile(const FCppToolsTemplate& Template, const FString& ModuleName, const FString& ForwardDeclarations)
+{
+    TMap<FString, FString> Values;
+    Values.Add(TEXT("COPYRIGHT_LINE"), GetCopyrightLine());
+    Values.Add(TEXT("MODULE_NAME"), ModuleName);
+    Values.Add(TEXT("FORWARD_DECLARATIONS"), ForwardDeclarations);
+    return Template.Render(Values);
+}
+
+bool CppToolsUtil::InsertDependencyIntoModule(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FString& DependencyName, FText& OutFailReason, bool bPrivate = false)
+{
+    CPPTOOLS_TRACE_SCOPE(InsertDependencyIntoModule);
+    FString FileContents;
+    FString BuildFilePath;
+    if (!GetModuleBuildFilePath(ModuleName, Target, BuildFilePath))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+        OutFailReason = FText::Format(LOCTEXT("FailedToReadBuildFile", "Failed to update \"{ModuleName}.Build.cs\""), Args);
+        return false;
+    }
+    
+    if (LoadFileToString(FileContents, BuildFilePath) && InsertDependencyIntoBuildFile(FileContents, DependencyName, bPrivate))
+    {
+        SaveStringToFile(FileContents, BuildFilePath);
+        return true;
+    }
+
+    // Issue modifying or finding file
+
+    FFormatNamedArguments Args;
+    Args.Add(TEXT("FullFileName"), FText::FromString(BuildFilePath));
+    OutFailReason = FText::Format(LOCTEXT("FailedToReadBuildFile", "Failed to update \"{FullFileName}\""), Args);
+    return false;
+}
+
+bool CppToolsUtil::InsertDependencyIntoBuildFile(FString& BuildFileContents, const FString& DependencyName, bool bPrivate)
+{
+    CPPTOOLS_TRACE_SCOPE(InsertDependencyIntoBuildFile);
+    using namespace CppToolsUtilImpl;
+
+    const FStringView ListName = DependencyListNames[bPrivate ? 1 : 0];
+    const FStringView Contents = MakeView(BuildFileContents);
+
+    TArray<FStringListCall> Calls;
+    FindStringListCalls(Contents, MakeArrayView(&ListName, 1), Calls);
+
+    // Existing dependencies of the same kind, ignoring any that are commented out
+    TArray<FStringView> Dependencies;
+    for (const FStringListCall& Call : Calls)
+    {
+        ParseStringListCallElements(Contents, Call, Dependencies);
+    }
+
+    // Lists are merged back into a single list where the last one was, unless they hold commented out dependencies to keep
+    TArray<int32> MergedCalls;
+    TArray<FStringView> ListStrings;
+    for (int32 I = 0; I < Calls.Num(); I++)
+    {
+        ListStrings.Reset();
+        ParseStringListViews(FStringView(Contents.GetData() + Calls[I].ContentsStart, Calls[I].ContentsEnd - Calls[I].ContentsStart), ListStrings);
+
+        bool bContains = true;
+        for (const FStringView& String : ListStrings)
+        {
+            bContains &= Dependencies.ContainsByPredicate([String](FStringView Dependency) { return ViewEquals(Dependency, String); });
+        }
+        if (bContains)
+        {
+            MergedCalls.Add(I);
+        }
+    }
+
+    if (MergedCalls.Num() == 0) return false;
+
+    const FStringView Dependency = MakeView(DependencyName);
+    if (!Dependencies.ContainsByPredicate([Dependency](FStringView Existing) { return ViewEquals(Existing, Dependency); }))
+    {
+        Dependencies.Add(Dependency);
+    }
+
+    // The views point into the current contents, so the result is built in a separate string sized up front
+    const FStringView InsertionStart = TEXT(".AddRange( new string[] { ");
+    const FStringView InsertionEnd = TEXT(" } );");
+    int32 ResultLength = Contents.Len() + ListName.Len() + InsertionStart.Len() + GetStringListLength(Dependencies, true, true) + InsertionEnd.Len();
+    for (int32 CallIndex : MergedCalls)
+    {
+        ResultLength -= Calls[CallIndex].End - Calls[CallIndex].Start;
+    }
+
+    FString Result;
+    Result.Reserve(ResultLength);
+    int32 Cursor = 0;
+    for (int32 CallIndex : MergedCalls)
+    {
+        const FStringListCall& Call = Calls[CallIndex];
+        Result.AppendChars(Contents.GetData() + Cursor, Call.Start - Cursor);
+        if (CallIndex == MergedCalls.Last())
+        {
+            Result.AppendChars(ListName.GetData(), ListName.Len());
+            Result.AppendChars(InsertionStart.GetData(), InsertionStart.Len());
+            AppendStringList(Result, Dependencies, true, true);
+            Result.AppendChars(InsertionEnd.GetData(), InsertionEnd.Len());
+        }
+        Cursor = Call.End;
+    }
+    Result.AppendChars(Contents.GetData() + Cursor, Contents.Len() - Cursor);
+
+    BuildFileContents = MoveTemp(Result);
+    return true;
+}
+
+bool CppToolsUtil::InsertDependencyIntoTarget(const FString& ModuleName, const bool& bIsEditor, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(InsertDependencyIntoTarget);
+    FString FileContents;
+
+    const FString TargetPath = GetPrimaryTargetFilePath(bIsEditor);
+
+    if (LoadFileToString(FileContents, TargetPath) && InsertModuleIntoTargetFile(FileContents, ModuleName))
+    {
+        SaveStringToFile(FileContents, TargetPath);
+        return true;
+    }
+
+    // Issue modifying or finding file
+
+    FFormatNamedArguments Args;
+    Args.Add(TEXT("FullFileName"), FText::FromString(TargetPath));
+    OutFailReason = FText::Format(LOCTEXT("FailedToReadTargetFile", "Failed to update \"{FullFileName}\""), Args);
+    return false;
+}
+
+FString CppToolsUtil::GetPrimaryTargetFilePath(bool bIsEditor)
+{
+    FString PrimaryGameTargetName = FApp::GetProjectName();
+    if (bIsEditor)
+    {
+        PrimaryGameTargetName += "Editor";
+    }
+
+    return FPaths::GameSourceDir() / PrimaryGameTargetName + ".Target.cs";
+}
+
+bool CppToolsUtil::InsertModuleIntoTargetFile(FString& TargetFileContents, const FString& ModuleName)
+{
+    CPPTOOLS_TRACE_SCOPE(InsertModuleIntoTargetFile);
+    using namespace CppToolsUtilImpl;
+
+    const FStringView Contents = MakeView(TargetFileContents);
+    TArray<FStringListCall> Calls;
+    FindStringListCalls(Contents, MakeArrayView(ExtraModuleListNames), Calls);
+    if (Calls.Num() == 0) return false;
+
+    TArray<FStringView> Modules;
+    for (const FStringListCall& Call : Calls)
+    {
+        ParseStringListCallElements(Contents, Call, Modules);
+    }
+    const FStringView Module = MakeView(ModuleName);
+    if (Modules.ContainsByPredicate([Module](FStringView Existing) { return ViewEquals(Existing, Module); })) return true;
+
+    // Without an AddRange call, the module gets an Add call of its own after the last one
+    const FStringListCall* AddRange = Calls.FindByPredicate([](const FStringListCall& Call) { return !Call.bIsAdd; });
+    if (AddRange == nullptr)
+    {
+        const FStringListCall& LastAdd = Calls.Last();
+        int32 LineStart = LastAdd.Start;
+        while (LineStart > 0 && (Contents[LineStart - 1] == TEXT(' ') || Contents[LineStart - 1] == TEXT('\t'))) LineStart--;
+        const FString Indentation(LastAdd.Start - LineStart, Contents.GetData() + LineStart);
+        TargetFileContents.InsertAt(LastAdd.End, LINE_TERMINATOR + Indentation + FString::Printf(TEXT("ExtraModuleNames.Add(\"%s\");"), *ModuleName));
+        return true;
+    }
+
+    // The module goes after the last element of the list, so comments within it and a trailing comma are kept
+    int32 LastTokenEnd = AddRange->ContentsStart;
+    int32 Index = AddRange->ContentsStart;
+    while (Index < AddRange->ContentsEnd)
+    {
+        const int32 AfterComment = SkipComment(Contents, Index);
+        if (AfterComment != Index)
+        {
+            Index = AfterComment;
+            continue;
+        }
+
+        const int32 AfterLiteral = SkipLiteral(Contents, Index);
+        Index = AfterLiteral != Index ? AfterLiteral : Index + 1;
+        if (!FChar::IsWhitespace(Contents[Index - 1]))
+        {
+            LastTokenEnd = Index;
+        }
+    }
+
+    const bool bNeedsComma = LastTokenEnd > AddRange->ContentsStart && Contents[LastTokenEnd - 1] != TEXT(',');
+    TargetFileContents.InsertAt(LastTokenEnd, FString::Printf(TEXT("%s\"%s\""), bNeedsComma ? TEXT(", ") : TEXT(" "), *ModuleName));
+    return true;
+}
+
+bool CppToolsUtil::RemoveDependencyFromBuildFile(FString& BuildFileContents, const FString& DependencyName)
+{
+    CPPTOOLS_TRACE_SCOPE(RemoveDependencyFromBuildFile);
+    return RemoveFromStringLists(BuildFileContents, MakeArrayView(CppToolsUtilImpl::DependencyListNames), DependencyName);
+}
+
+bool CppToolsUtil::RemoveModuleFromTargetFile(FString& TargetFileContents, const FString& ModuleName)
+{
+    CPPTOOLS_TRACE_SCOPE(RemoveModuleFromTargetFile);
+    return RemoveFromStringLists(TargetFileContents, MakeArrayView(CppToolsUtilImpl::ExtraModuleListNames), ModuleName);
+}
+
+bool CppToolsUtil::RemoveModulesFromDescriptors(const TArray<FString>& ModuleNames, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(RemoveModulesFromDescriptors);
+
+    FCppToolsDescriptorSession Session;
+    return Session.RemoveModules(ModuleNames, OutFailReason) && Session.Commit(OutFailReason);
+}
+
+bool CppToolsUtil::UpdateModuleBuildFile(const FString& ModuleName, TSharedPtr<IPlugin> Target, TFunctionRef<bool(FString&)> Modifier, FText& OutFailReason)
+{
+    CPPTOOLS_TRACE_SCOPE(UpdateModuleBuildFile);
+
+    FString BuildFilePath;
+    FString FileContents;
+    if (!GetModuleBuildFilePath(ModuleName, Target, BuildFilePath) || !LoadFileToString(FileContents, BuildFilePath))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+        OutFailReason = FText::Format(LOCTEXT("FailedToReadModuleBuildFile", "Failed to read the .Build.cs file of module \"{ModuleName}\""), Args);
+        return false;
+    }
+
+    if (!Modifier(FileContents))
+    {
+        return true;
+    }
+
+    TryMakeFileWriteable(BuildFilePath);
+    if (!SaveStringToFile(FileContents, BuildFilePath))
+    {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("FullFileName"), FText::FromString(BuildFilePath));
+        OutFailReason = FText::Format(LOCTEXT("FailedToWriteBuildFile", "Failed to write \"{FullFileName}\""), Args);
+        return false;
+    }
+    return true;
+}
+
+bool CppToolsUtil::FindModuleRulesField(const FString& BuildFileContents, const FString& FieldName, int32& OutStart, int32& OutEnd, FString& OutValue)
+{
+    using namespace CppToolsUtilImpl;
+
+    const FStringView Contents = MakeView(BuildFileContents);
+    const FStringView Field = MakeView(FieldName);
+    const TCHAR* Data = Contents.GetData();
+    const int32 Len = Contents.Len();
+
+    // Assignments within comments and literals are skipped
+    int32 Index = 0;
+    while (Index < Len)
+    {
+        const int32 Next = SkipLiteral(Contents, SkipComment(Contents, Index));
+        if (Next != Index)
+        {
+            Index = Next;
+            continue;
+        }
+        if (!IsIdentifierChar(Data[Index]))
+        {
+            Index++;
+            continue;
+        }
+
+        const int32 NameStart = Index;
+        while (Index < Len && IsIdentifierChar(Data[Index])) Index++;
+
+        // Members of other objects, such as Target.bUseUnity, are not fields of the module rules
+        if (!ViewEquals(FStringView(Data + NameStart, Index - NameStart), Field) || (NameStart > 0 && Data[NameStart - 1] == TEXT('.'))) continue;
+
+        // Only a lone equals sign is an assignment, not a comparison or a lambda
+        int32 ValueStart = Index;
+        if (!ConsumeToken(Contents, ValueStart, TEXT("=")) || (ValueStart < Len && (Data[ValueStart] == TEXT('=') || Data[ValueStart] == TEXT('>')))) continue;
+
+        const int32 StatementEnd = FindListEnd(Contents, ValueStart, TEXT(';'));
+        if (StatementEnd == INDEX_NONE) return false;
+
+        OutStart = NameStart;
+        OutEnd = StatementEnd + 1;
+        OutValue = FString(StatementEnd - ValueStart, Data + ValueStart).TrimStartAndEnd();
+        return true;
+    }
+    return false;
+}
+
+FString CppToolsUtil::GetModuleRulesIndentation(const FString& BuildFileContents)
+{
+    const FRegexPattern ConstructorPattern(TEXT(":\\s*base\\s*\\(\\s*\\w+\\s*\\)\\s*\\{[ \\t]*\\r?\\n(?:[ \\t]*\\r?\\n)*([ \\t]*)\\S"));
+    FRegexMatcher ConstructorMatcher(ConstructorPattern, BuildFileContents);
+    if (ConstructorMatcher.FindNext() && !ConstructorMatcher.GetCaptureGroup(1).IsEmpty())
+    {
+        return ConstructorMatcher.GetCaptureGroup(1);
+    }
+    return TEXT("\t\t");
+}
+
+bool CppToolsUtil::GetModuleRulesField(const FString& BuildFileContents, const FString& FieldName, FString& OutValue)
+{
+    int32 Start;
+    int32 End;
+    return FindModuleRulesField(BuildFileContents, FieldName, Start, End, OutValue);
+}
+
+bool CppToolsUtil::SetModuleRulesField(FString& BuildFileContents, const FString& FieldName, const FString& Value)
+{
+    CPPTOOLS_TRACE_SCOPE(SetModuleRulesField);
+    using namespace CppToolsUtilImpl;
+
+    const FString Statement = FieldName + TEXT(" = ") + Value + TEXT(";");
+
+    int32 Start;
+    int32 End;
+    FString CurrentValue;
+    if (FindModuleRulesField(BuildFileContents, FieldName, Start, End, CurrentValue))
+    {
+        if (CurrentValue == Value) return false;
+
+        BuildFileContents.RemoveAt(Start, End - Start);
+        BuildFileContents.InsertAt(Start, Statement);
+        return true;
+    }
+
+    // Add the assignment at the start of the constructor
+    const int32 ConstructorStart = FindConstructorBodyStart(MakeView(BuildFileContents));
+    if (ConstructorStart == INDEX_NONE) return false;
+
+    BuildFileContents.InsertAt(ConstructorStart, LINE_TERMINATOR + GetModuleRulesIndentation(BuildFileContents) + Statement);
+    return true;
+}
+
+bool CppToolsUtil::RemoveModuleRulesField(FString& BuildFileContents, const FString& FieldName)
+{
+    CPPTOOLS_TRACE_SCOPE(RemoveModuleRulesField);
+
+    int32 Start;
+    int32 End;
+    FString CurrentValue;
+    if (!FindModuleRulesField(BuildFileContents, FieldName, Start, End, CurrentValue)) return false;
+
+    RemoveStatement(BuildFileContents, Start, End);
+    return true;
+}
+
+bool CppToolsUtil::SetModuleRulesCommentBlock(FString& BuildFileContents, const FString& BlockName, const TArray<FString>& Lines)
+{
+    CPPTOOLS_TRACE_SCOPE(SetModuleRulesCommentBlock);
+    using namespace CppToolsUtilImpl;
+
+    const FString Indentation = GetModuleRulesIndentation(BuildFileContents);
+    const FString BeginMarker = TEXT("// BEGIN CppTools ") + BlockName;
+    const FString EndMarker = TEXT("// END CppTools ") + BlockName;
+
+    FString Block;
+    if (Lines.Num() > 0)
+    {
+        Block += Indentation + BeginMarker + LINE_TERMINATOR;
+        for (const FString& Line : Lines)
+        {
+            Block += Indentation + TEXT("// ") + Line + LINE_TERMINATOR;
+        }
+        Block += Indentation + EndMarker + LINE_TERMINATOR;
+    }
+
+    // Replace the existing block, including its indentation and line ending
+    const int32 BeginIndex = BuildFileContents.Find(BeginMarker, ESearchCase::CaseSensitive);
+    const int32 EndIndex = BeginIndex != INDEX_NONE ? BuildFileContents.Find(EndMarker, ESearchCase::CaseSensitive, ESearchDir::FromStart, BeginIndex) : INDEX_NONE;
+    if (BeginIndex != INDEX_NONE && EndIndex != INDEX_NONE)
+    {
+        int32 Start = BeginIndex;
+        while (Start > 0 && BuildFileContents[Start - 1] != TEXT('\n')) Start--;
+        int32 End = BuildFileContents.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, EndIndex);
+        End = End == INDEX_NONE ? BuildFileContents.Len() : End + 1;
+
+        if (BuildFileContents.Mid(Start, End - Start) == Block) return false;
+
+        BuildFileContents.RemoveAt(Start, End - Start);
+        BuildFileContents.InsertAt(Start, Block);
+        return true;
+    }
+
+    if (Block.IsEmpty()) return false;
 
-    FString FinalOutput = Template.Replace(TEXT("%COPYRIGHT_LINE%"), *GetCopyrightLine(), ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%MODULE_NAME%"), *ModuleName, ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%MODULE_STARTUP_CODE%"), *StartupSourceCode, ESearchCase::CaseSensitive);
-    FinalOutput = FinalOutput.Replace(TEXT("%MODULE_SHUTDOWN_CODE%"), *StartupSourceCode, ESearchCase::CaseSensitive);
+    // Add the block at the end of the constructor body
+    const FStringView Contents = MakeView(BuildFileContents);
+    const int32 ConstructorStart = FindConstructorBodyStart(Contents);
+    const int32 ConstructorEnd = ConstructorStart != INDEX_NONE ? FindBlockEnd(Contents, ConstructorStart) : INDEX_NONE;
+    if (ConstructorEnd == INDEX_NONE) return false;
 
-    return GameProjectUtils::WriteOutputFile(NewCPPFileName, FinalOutput, OutFailReason);
+    int32 InsertIndex = ConstructorEnd;
+    while (InsertIndex > 0 && BuildFileContents[InsertIndex - 1] != TEXT('\n')) InsertIndex--;
+    BuildFileContents.InsertAt(InsertIndex, LINE_TERMINATOR + Block);
+    return true;
 }
 
-bool CppToolsUtil::InsertDependencyIntoModule(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FString& DependencyName, FText& OutFailReason, bool bPrivate = false)
+bool CppToolsUtil::UpdateModuleFwdHeader(const FString& ModuleName, TSharedPtr<IPlugin> Target, FText& OutFailReason)
 {
-    FString FileContents;
+    CPPTOOLS_TRACE_SCOPE(UpdateModuleFwdHeader);
+
     FString BuildFilePath;
     if (!GetModuleBuildFilePath(ModuleName, Target, BuildFilePath))
     {
         FFormatNamedArguments Args;
         Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
-        OutFailReason = FText::Format(LOCTEXT("FailedToReadBuildFile", "Failed to update \"{ModuleName}.Build.cs\""), Args);
+        OutFailReason = FText::Format(LOCTEXT("ModuleNotFound", "Could not find the .Build.cs file of module \"{ModuleName}\""), Args);
         return false;
     }
-    
-    TArray<FString> Dependencies = GetModuleDependencies(ModuleName, Target, false);
-    
-    if (FFileHelper::LoadFileToString(FileContents, *BuildFilePath))
-    {
 
-        FString DependencySource = "(?:PublicDependencyModuleNames)";
-        
-        const FString AddRangePattern = DependencySource +
-            "\\.AddRange\\(\\s*new(?:\\s+string)?\\[\\s*\\]\\s*\\{\\s*((?:[^\\}]*(?:\\r\\n|\\r|\\n)?)*)\\s*\\}\\s*\\);";
-        const FString AddPattern = DependencySource + "\\.Add\\(([^\\)]+)\\);";
-        
-        const FRegexPattern DependenciesPattern("(?:" + AddRangePattern + ")|(?:" + AddPattern + ")");
-        FRegexMatcher DependenciesMatcher(DependenciesPattern, FileContents);
+    const FString ModulePath = FPaths::GetPath(BuildFilePath);
+    const FString FwdHeaderPath = GetModuleFwdHeaderPath(ModulePath, ModuleName);
+
+    TArray<FString> HeaderFiles;
+    IFileManager::Get().FindFilesRecursive(HeaderFiles, *(ModulePath / TEXT("Public")), TEXT("*.h"), true, false, false);
+    HeaderFiles.Remove(FwdHeaderPath);
+    HeaderFiles.Sort();
+
+    // Group the declarations by the header they were found in, so changes to the file are easy to review
+    FString ForwardDeclarations;
+    TSet<FString> DeclaredTypes;
+    for (const FString& HeaderFile : HeaderFiles)
+    {
+        FString HeaderContents;
+        if (!LoadFileToString(HeaderContents, HeaderFile)) continue;
 
-        int32 lastStart = -1;
-        while (DependenciesMatcher.FindNext())
+        FString HeaderDeclarations;
+        for (const FString& Declaration : ParseForwardDeclarations(HeaderContents))
         {
-            int32 start = DependenciesMatcher.GetMatchBeginning();
-            int32 end = DependenciesMatcher.GetMatchEnding();
-            
-            TArray<FString> List = ParseStringList(DependenciesMatcher.GetCaptureGroup(1));
-            bool bContains = true;
-            for (FString Dependency : List)
-            {
-                bContains &= Dependencies.Contains(Dependency);
-            }
-            
-            if (bContains)
+            bool bAlreadyDeclared;
+            DeclaredTypes.Add(Declaration, &bAlreadyDeclared);
+            if (!bAlreadyDeclared)
             {
-                lastStart = start;
-                FileContents.RemoveAt(start, end - start);
+                HeaderDeclarations += Declaration + LINE_TERMINATOR;
             }
-
-            DependenciesMatcher = FRegexMatcher(DependenciesPattern, FileContents);
         }
 
-        Dependencies.Add(DependencyName);
-
-        if (lastStart != -1)
+        if (!HeaderDeclarations.IsEmpty())
         {
-            
-            FString InsertionText = TEXT("PublicDependencyModuleNames.AddRange( new string[] { MODULES } );");
-            InsertionText = InsertionText.Replace(TEXT("MODULES"),
-                *CombineStringList(Dependencies, true, true), ESearchCase::CaseSensitive);
-            
-            FileContents.InsertAt(lastStart, InsertionText);
-
-            FFileHelper::SaveStringToFile(FileContents, *BuildFilePath);
-
-            return true;
+            FString RelativeHeaderFile = HeaderFile;
+            FPaths::MakePathRelativeTo(RelativeHeaderFile, *(ModulePath / TEXT("Public") / TEXT("")));
+            ForwardDeclarations += TEXT("// ") + RelativeHeaderFile + LINE_TERMINATOR + HeaderDeclarations + LINE_TERMINATOR;
         }
     }
+    ForwardDeclarations.TrimEndInline();
 
-    // Issue modifying or finding file
+    // Leave the file untouched if nothing changed, so it does not trigger a rebuild of everything including it
+    FString ExpectedContents;
+    if (!FillModuleFwdHeaderTemplate(ModuleName, ForwardDeclarations, ExpectedContents, OutFailReason))
+    {
+        return false;
+    }
 
-    FFormatNamedArguments Args;
-    Args.Add(TEXT("FullFileName"), FText::FromString(BuildFilePath));
-    OutFailReason = FText::Format(LOCTEXT("FailedToReadBuildFile", "Failed to update \"{FullFileName}\""), Args);
-    return false;
+    FString CurrentContents;
+    if (LoadFileToString(CurrentContents, FwdHeaderPath) && CurrentContents == ExpectedContents)
+    {
+        return true;
+    }
+
+    if (FPaths::FileExists(FwdHeaderPath))
+    {
+        TryMakeFileWriteable(FwdHeaderPath);
+    }
+    return GenerateModuleFwdHeaderFile(FwdHeaderPath, ModuleName, ForwardDeclarations, OutFailReason);
 }
 
-bool CppToolsUtil::InsertDependencyIntoTarget(const FString& ModuleName, const bool& bIsEditor, FText& OutFailReason)
+int32 CppToolsUtil::UpdateProjectFwdHeaders(FText& OutFailReason)
 {
-    FString FileContents;
-    
-    FString PrimaryGameTargetName = FApp::GetProjectName();
-    if (bIsEditor)
+    CPPTOOLS_TRACE_SCOPE(UpdateProjectFwdHeaders);
+
+    int32 NumUpdated = 0;
+    for (const TPair<FModuleContextInfo, TSharedPtr<IPlugin>>& Module : GetProjectAndPluginModules())
     {
-        PrimaryGameTargetName += "Editor";
+        if (!FPaths::FileExists(GetModuleFwdHeaderPath(Module.Key.ModuleSourcePath, Module.Key.ModuleName))) continue;
+
+        if (!UpdateModuleFwdHeader(Module.Key.ModuleName, Module.Value, OutFailReason))
+        {
+            return INDEX_NONE;
+        }
+        NumUpdated++;
     }
-    
-    const FString TargetPath = FPaths::GameSourceDir() / PrimaryGameTargetName + ".Target.cs";
-    
-    if (FFileHelper::LoadFileToString(FileContents, *TargetPath))
-    {
+    return NumUpdated;
+}
 
-        // Check for existing ExtraModuleNames.AddRange command
-        const FRegexPattern ExtraModulesPattern(
-            TEXT("ExtraModuleNames\\.AddRange\\([\\s]*new(?:\\s+string)?\\[\\s*\\][\\s]*\\{[\\s]*((?:[^\\}]*\\S(?=\\s*\\}))|\\s*)[\\s]*\\}[\\s]*\\);"));
-        FRegexMatcher ExtraModulesMatcher(ExtraModulesPattern, FileContents);
+FString CppToolsUtil::GetNewModulePath(const FString& ModuleName, TSharedPtr<IPlugin> Target)
+{
+    FString Path = (!Target.IsValid()) ? FPaths::GameSourceDir() : Target->GetBaseDir() / "Source";
+    return FPaths::ConvertRelativePathToFull(Path / ModuleName / "");
+}
 
-        if (ExtraModulesMatcher.FindNext())
-        {
-            int32 start = ExtraModulesMatcher.GetMatchBeginning();
-            int32 end = ExtraModulesMatcher.GetMatchEnding();
+bool CppToolsUtil::IsValidNewModuleName(const FString& ModuleName, FText& OutFailReason)
+{
+    FString IllegalNameCharacters;
 
-            FileContents.RemoveAt(start, end - start);
-            
-            FString InsertionText = TEXT("ExtraModuleNames.AddRange( new string[] { MODULES } );");
-            FString ModuleList = ExtraModulesMatcher.GetCaptureGroup(1).TrimEnd();
-            
-            if (ModuleList.IsEmpty()) ModuleList = "\"" + ModuleName + "\"";
-            else ModuleList += ", \"" + ModuleName + "\"";
-            
-            InsertionText = InsertionText.Replace(TEXT("MODULES"), *ModuleList, ESearchCase::CaseSensitive);
-            
-            FileContents.InsertAt(start, InsertionText);
+    if (ModuleName.IsEmpty()) {
+        OutFailReason = LOCTEXT("ModuleNameEmpty", "You must enter a name to create a new module");
+        return false;
+    }
+    else if (!GameProjectUtils::NameContainsOnlyLegalCharacters(ModuleName, IllegalNameCharacters)) {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("IllegalNameCharacters"), FText::FromString(IllegalNameCharacters));
+        OutFailReason = FText::Format(LOCTEXT("ModuleNameContainsIllegalCharacters", "The module name may not contain the following characters: '{IllegalNameCharacters}'"), Args);
+        return false;
+    }
 
-            FFileHelper::SaveStringToFile(FileContents, *TargetPath);
+    if (!GameProjectUtils::ProjectHasCodeFiles()) {
+        OutFailReason = LOCTEXT("ProjectHasNoCode", "A new module may not be added to a non-C++ project. Convert the project from Blueprint to C++ by adding a C++ class in the editor.");
+        return false;
+    }
 
-            return true;
-        }
-        
-        // Insert new ExtraModuleNames.AddRange command if not found
-        /*const FRegexPattern TargetConstructorPattern(TEXT("public[\\s]+") + PrimaryGameTargetName
-            + TEXT("[\\s]*\\(.*\\)[\\s]*:[\\s]*base\\(.*\\)[\\s]*\\{.*\\}"));
-        FRegexMatcher TargetConstructorMatcher(TargetConstructorPattern, FileContents);
+    if (FModuleManager::Get().ModuleExists(*ModuleName)) {
+        FFormatNamedArguments Args;
+        Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
+        OutFailReason = FText::Format(LOCTEXT("ModuleNameWarning", "Module '{ModuleName}' already exists. If this module was manually deleted, clean and rebuild the project."), Args);
+        return false;
+    }
 
-        if (TargetConstructorMatcher.FindNext())
-        {
-            int32 end = TargetConstructorMatcher.GetMatchEnding();
-            
-            FString InsertionText = TEXT("\tExtraModuleNames.AddRange( new string[] { MODULES } );");
-            InsertionText += LINE_TERMINATOR;
-            InsertionText += "\t";
-            InsertionText = InsertionText.Replace(TEXT("MODULES"),
-                *(PrimaryGameTargetName + ", " + ModuleName), ESearchCase::CaseSensitive);
-            
-            FileContents.InsertAt(end - 1, InsertionText);
+    return true;
+}
 
-            FFileHelper::SaveStringToFile(FileContents, *TargetPath);
+void CppToolsUtil::GetNewModuleDependencies(TArray<FString>& OutPublicDependencies, TArray<FString>& OutPrivateDependencies)
+{
+    OutPublicDependencies.Reset();
+    OutPublicDependencies.Add(TEXT("Core"));
+    OutPublicDependencies.Add(TEXT("CoreUObject"));
+    OutPublicDependencies.Add(TEXT("Engine"));
+    OutPublicDependencies.Add(TEXT("InputCore"));
+    OutPrivateDependencies.Reset();
+}
 
-            return true;
-        }*/
+FString CppToolsUtil::GetNewModuleOwner(TSharedPtr<IPlugin> Target, EHostType::Type Type)
+{
+    FString OwningModule;
+    if (!Target.IsValid())
+    {
+        OwningModule = FApp::GetProjectName();
+        if (Type == EHostType::Editor) OwningModule += "Editor";
     }
+    else
+    {
+        FString ExpectedOwner = Target->GetName();
+        if (Type == EHostType::Editor) ExpectedOwner += "Editor";
+        bool bFoundOwner = false;
 
-    // Issue modifying or finding file
-
-    FFormatNamedArguments Args;
-    Args.Add(TEXT("FullFileName"), FText::FromString(TargetPath));
-    OutFailReason = FText::Format(LOCTEXT("FailedToReadTargetFile", "Failed to update \"{FullFileName}\""), Args);
-    return false;
+        // Search for a compatible module
+        // TODO: Replace this with specifying users during module creation
+        
+        TArray<FModuleContextInfo> Modules = GetPluginModules(Target);
+        if (Modules.Num() > 0)
+        {
+            for (FModuleContextInfo Module : Modules)
+            {
+                if (Module.ModuleName == ExpectedOwner)
+                {
+                    OwningModule = ExpectedOwner;
+                    bFoundOwner = true;
+                    break;
+                }
+            }
+            if (!bFoundOwner)
+            {
+                for (FModuleContextInfo Module : Modules)
+                {
+                    if (Module.ModuleType == Type)
+                    {
+                        OwningModule = Module.ModuleName;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    // Only add to the build if the module expected to use it exists
+    if (OwningModule.IsEmpty() || !FModuleManager::Get().ModuleExists(*OwningModule))
+    {
+        return FString();
+    }
+    return OwningModule;
 }
 
 GameProjectUtils::EAddCodeToProjectResult CppToolsUtil::GenerateModule(const FString& ModulePath, TSharedPtr<IPlugin> Target,
     const FString& ModuleName, const EHostType::Type& Type, const ELoadingPhase::Type& LoadingPhase, bool bUsePCH,
-    TArray<FString>& CreatedFiles, FText& OutFailReason)
+    TArray<FString>& CreatedFiles, FText& OutFailReason, bool bGenerateFwdHeader, int32 LLMTagIndex, ECppToolsModuleTemplate ModuleTemplate)
 {
 
     //TODO: Add data validation
 
+    CPPTOOLS_TRACE_SESSION(TEXT("GenerateModule"));
+    CPPTOOLS_TRACE_SCOPE(GenerateModule);
+
     TArray<FModuleDescriptor> GeneratedModules;
 
     FScopedSlowTask SlowTask(11, LOCTEXT("AddingModuleToProject", "Adding module to project..."));
-    SlowTask.MakeDialog();
+    if (IsInteractive())
+    {
+        SlowTask.MakeDialog();
+    }
 
     SlowTask.EnterProgressFrame();
 
+    // Every file is staged in memory first and written together once all of them were generated, so a failure at any
+    // step leaves the project untouched
+    FCppToolsFileTransaction Transaction;
+
     // Module.Build.cs
     {
         const FString BuildFilename = ModulePath / ModuleName + TEXT(".Build.cs");
         TArray<FString> PublicDependencyModuleNames;
-        PublicDependencyModuleNames.Add(TEXT("Core"));
-        PublicDependencyModuleNames.Add(TEXT("CoreUObject"));
-        PublicDependencyModuleNames.Add(TEXT("Engine"));
-        PublicDependencyModuleNames.Add(TEXT("InputCore"));
         TArray<FString> PrivateDependencyModuleNames;
-        if (CppToolsUtil::GenerateModuleBuildFile(BuildFilename, ModuleName, PublicDependencyModuleNames, PrivateDependencyModuleNames, OutFailReason, bUsePCH)) {
-            GeneratedModules.Add(FModuleDescriptor(*ModuleName, Type, LoadingPhase));
-            CreatedFiles.Add(BuildFilename);
-        }
-        else {
-            GameProjectUtils::DeleteCreatedFiles(ModulePath, CreatedFiles);
+        GetNewModuleDependencies(PublicDependencyModuleNames, PrivateDependencyModuleNames);
+        FString Contents;
+        if (!FillModuleBuildFileTemplate(ModuleName, PublicDependencyModuleNames, PrivateDependencyModuleNames, bUsePCH, Contents, OutFailReason)
+            || !Transaction.StageCreate(BuildFilename, Contents, OutFailReason))
+        {
             return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
         }
+        GeneratedModules.Add(FModuleDescriptor(*ModuleName, Type, LoadingPhase));
     }
 
     SlowTask.EnterProgressFrame();
 
+    TArray<FString> PublicHeaderIncludes;
+    FString StartupSource;
+    FString ShutdownSource;
+    CppToolsModuleTemplates::GetModuleCode(ModuleTemplate, ModuleName, PublicHeaderIncludes, StartupSource, ShutdownSource);
+
     // Module Header
     {
         const FString HeaderFilename = ModulePath / "Public" / ModuleName + TEXT(".h");
-        TArray<FString> PublicHeaderIncludes;
-        if (CppToolsUtil::GenerateModuleHeaderFile(HeaderFilename, ModuleName, PublicHeaderIncludes, OutFailReason)) {
-            CreatedFiles.Add(HeaderFilename);
-        }
-        else {
-            GameProjectUtils::DeleteCreatedFiles(ModulePath, CreatedFiles);
+        FString Contents;
+        if (!FillModuleHeaderTemplate(ModuleName, PublicHeaderIncludes, Contents, OutFailReason, LLMTagIndex)
+            || !Transaction.StageCreate(HeaderFilename, Contents, OutFailReason))
+        {
             return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
         }
     }
@@ -546,67 +1905,67 @@ GameProjectUtils::EAddCodeToProjectResult CppToolsUtil::GenerateModule(const FSt
     // Module Source
     {
         const FString SourceFilename = ModulePath / "Private" / ModuleName + TEXT(".cpp");
-        FString StartupSource;
-        FString ShutdownSource;
-        if (CppToolsUtil::GenerateModuleCPPFile(SourceFilename, ModuleName, StartupSource, ShutdownSource, OutFailReason)) {
-            CreatedFiles.Add(SourceFilename);
-        }
-        else {
-            GameProjectUtils::DeleteCreatedFiles(ModulePath, CreatedFiles);
+        FString Contents;
+        if (!FillModuleCPPTemplate(ModuleName, StartupSource, ShutdownSource, Contents, OutFailReason, LLMTagIndex)
+            || !Transaction.StageCreate(SourceFilename, Contents, OutFailReason))
+        {
             return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
         }
     }
 
-    SlowTask.EnterProgressFrame();
+    // Module forward declaration header, filled in by UpdateModuleFwdHeader as types are added to the module
+    if (bGenerateFwdHeader)
+    {
+        const FString FwdHeaderFilename = GetModuleFwdHeaderPath(ModulePath, ModuleName);
+        FString Contents;
+        if (!FillModuleFwdHeaderTemplate(ModuleName, FString(), Contents, OutFailReason)
+            || !Transaction.StageCreate(FwdHeaderFilename, Contents, OutFailReason))
+        {
+            return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
+        }
+    }
 
-    // Add to appropriate module .Build.cs
+    // Files the module template adds, such as the allocators of the high-performance runtime template
     {
-        FString OwningModule;
-        if (!Target.IsValid())
+        TArray<FCppToolsModuleTemplateFile> TemplateFiles;
+        if (!CppToolsModuleTemplates::RenderFiles(ModuleTemplate, ModulePath, ModuleName, TemplateFiles, OutFailReason))
         {
-            OwningModule = FApp::GetProjectName();
-            if (Type == EHostType::Editor) OwningModule += "Editor";
+            return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
         }
-        else
+        for (const FCppToolsModuleTemplateFile& File : TemplateFiles)
         {
-            FString ExpectedOwner = Target->GetName();
-            if (Type == EHostType::Editor) ExpectedOwner += "Editor";
-            bool bFoundOwner = false;
-
-            // Search for a compatible module
-            // TODO: Replace this with specifying users during module creation
-            
-            TArray<FModuleContextInfo> Modules = GetPluginModules(Target);
-            if (Modules.Num() > 0)
+            if (!Transaction.StageCreate(File.Filename, File.Contents, OutFailReason))
             {
-                for (FModuleContextInfo Module : Modules)
-                {
-                    if (Module.ModuleName == ExpectedOwner)
-                    {
-                        OwningModule = ExpectedOwner;
-                        bFoundOwner = true;
-                        break;
-                    }
-                }
-                if (!bFoundOwner)
-                {
-                    for (FModuleContextInfo Module : Modules)
-                    {
-                        if (Module.ModuleType == Type)
-                        {
-                            OwningModule = Module.ModuleName;
-                            break;
-                        }
-                    }
-                }
+                return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
             }
         }
-        // Only add to the build if the module expected to use it exists
-        if (FModuleManager::Get().ModuleExists(*OwningModule) &&
-            !InsertDependencyIntoModule(OwningModule, Target, ModuleName, OutFailReason, false))
+    }
+
+    SlowTask.EnterProgressFrame();
+
+    // Add to appropriate module .Build.cs
+    {
+        CPPTOOLS_TRACE_SCOPE(UpdateOwnerBuildFile);
+
+        const FString OwningModule = GetNewModuleOwner(Target, Type);
+        FString OwnerBuildFilePath;
+        if (!OwningModule.IsEmpty() && GetModuleBuildFilePath(OwningModule, Target, OwnerBuildFilePath))
         {
-            GameProjectUtils::DeleteCreatedFiles(ModulePath, CreatedFiles);
-            return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
+            bool bInserted = false;
+            if (!Transaction.StageModify(OwnerBuildFilePath, [&ModuleName, &bInserted](FString& Contents)
+                {
+                    return bInserted = InsertDependencyIntoBuildFile(Contents, ModuleName, false);
+                }, OutFailReason))
+            {
+                return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
+            }
+            if (!bInserted)
+            {
+                FFormatNamedArguments Args;
+                Args.Add(TEXT("FullFileName"), FText::FromString(OwnerBuildFilePath));
+                OutFailReason = FText::Format(LOCTEXT("FailedToInsertDependency", "Failed to update \"{FullFileName}\", it has no dependency list"), Args);
+                return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
+            }
         }
     }
     
@@ -614,56 +1973,89 @@ GameProjectUtils::EAddCodeToProjectResult CppToolsUtil::GenerateModule(const FSt
 
     // Add to project target
     if (!Target.IsValid()) {
-        if (!InsertDependencyIntoTarget(ModuleName, Type == EHostType::Editor, OutFailReason))
+        CPPTOOLS_TRACE_SCOPE(UpdateProjectTarget);
+
+        // Modules that game targets do not build, such as developer and uncooked modules, go into the editor target
+        const FString TargetPath = GetPrimaryTargetFilePath(!CppToolsModuleGraph::IsModuleTypeInTarget(Type, false));
+        bool bInserted = false;
+        if (!Transaction.StageModify(TargetPath, [&ModuleName, &bInserted](FString& Contents)
+            {
+                return bInserted = InsertModuleIntoTargetFile(Contents, ModuleName);
+            }, OutFailReason) || !bInserted)
         {
-            GameProjectUtils::DeleteCreatedFiles(ModulePath, CreatedFiles);
+            FFormatNamedArguments Args;
+            Args.Add(TEXT("FullFileName"), FText::FromString(TargetPath));
+            OutFailReason = FText::Format(LOCTEXT("FailedToReadTargetFile", "Failed to update \"{FullFileName}\""), Args);
             return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
         }
     }
 
-    SlowTask.EnterProgressFrame();
-
-    if (!Target.IsValid())
     {
-        // Update .uproject file
-        auto Modifier = FProjectDescriptorModifier::CreateLambda(
-            [&GeneratedModules](FProjectDescriptor& Descriptor)
-            {
-                // See GameProjectUtils.cpp L3920
-                bool bNeedsUpdate = false;
+        CPPTOOLS_TRACE_SCOPE(WriteModuleFiles);
+        if (!Transaction.Commit(OutFailReason))
+        {
+            return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
+        }
+        CreatedFiles.Append(Transaction.GetCreatedFiles());
+    }
 
-                bNeedsUpdate |= AppendProjectModules(Descriptor, &GeneratedModules);
-                //bNeedsUpdate |= UpdateRequiredAdditionalDependencies(Descriptor, RequiredDependencies, ModuleInfo.ModuleName);
+    SlowTask.EnterProgressFrame();
 
-                return bNeedsUpdate;
-            });
+    // The descriptor is saved by the engine, so it is backed up in the transaction's journal to be rolled back with the files
+    bool bUpdatedDescriptor;
+    {
+        CPPTOOLS_TRACE_SCOPE(UpdateDescriptor);
 
-        UpdateGameProject(&Modifier);
+        FCppToolsDescriptorSession Session;
+        bUpdatedDescriptor = Session.AppendModules(Target, GeneratedModules, OutFailReason) && Session.Commit(OutFailReason, &Transaction);
     }
-    else
+
+    FFormatNamedArguments DescriptorArgs;
+    DescriptorArgs.Add(TEXT("ShortFilename"), FText::FromString(FPaths::GetCleanFilename(Target.IsValid() ? Target->GetDescriptorFileName() : FPaths::GetProjectFilePath())));
+    if (!bUpdatedDescriptor)
     {
-        // Update .uplugin file
-        auto Modifier = FPluginDescriptorModifier::CreateLambda(
-            [&GeneratedModules, &Target](FPluginDescriptor& Descriptor)
-            {
-                bool bNeedsUpdate = false;
-                bNeedsUpdate |= AppendPluginModules(Descriptor, Target, &GeneratedModules);
-                return bNeedsUpdate;
-            });
+        DescriptorArgs.Add(TEXT("FailReason"), OutFailReason);
+        PushNotification(FText::Format(LOCTEXT("DescriptorUpdateFailed", "{ShortFilename} failed to update. {FailReason}"), DescriptorArgs), SNotificationItem::CS_Fail);
 
-        UpdatePlugin(Target, &Modifier);
+        FText RollbackFailReason;
+        if (!Transaction.Rollback(RollbackFailReason))
+        {
+            PushNotification(RollbackFailReason, SNotificationItem::CS_Fail);
+        }
+        CreatedFiles.Reset();
+        return GameProjectUtils::EAddCodeToProjectResult::FailedToAddCode;
     }
+    PushNotification(FText::Format(LOCTEXT("DescriptorUpdateComplete", "{ShortFilename} was successfully updated."), DescriptorArgs), SNotificationItem::CS_Success);
+    Transaction.Finish();
 
     SlowTask.EnterProgressFrame();
 
-    // Rebuild project
+    // Rebuild project, unless binaries built from identical sources can be restored from the binary cache
 
-    FString ProjectFileName = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*FPaths::GetProjectFilePath());
-    //FString Arguments = FString::Printf(TEXT("%s %s %s -Plugin=\"%s\" -Project=\"%s\" -Progress -NoHotReloadFromIDE"), FPlatformMisc::GetUBTTargetName(), FModuleManager::Get().GetUBTConfiguration(), FPlatformMisc::GetUBTPlatform(), *UPluginFilePath, *ProjectFileName);
-    FString Arguments = FString::Printf(TEXT("%s %s %s -Project=\"%s\" -Progress -NoHotReloadFromIDE"), FPlatformMisc::GetUBTTargetName(), FModuleManager::Get().GetUBTConfiguration(), FPlatformMisc::GetUBTPlatform(), *ProjectFileName);
-
-    if (!FDesktopPlatformModule::Get()->RunUnrealBuildTool(LOCTEXT("Compiling", "Compiling..."), FPaths::RootDir(), Arguments, GWarn)) {
-        // Failed to compile
+    bool bRestoredFromCache;
+    {
+        CPPTOOLS_TRACE_SCOPE(RestoreFromBinaryCache);
+        bRestoredFromCache = CppToolsBinaryCache::TryRestoreModule(ModuleName, Target);
+    }
+    if (!bRestoredFromCache)
+    {
+        double BuildSeconds;
+        FText BuildFailReason;
+        if (!CppToolsBuild::RunUnrealBuildTool(FString(), BuildSeconds, BuildFailReason)) {
+            // Failed to compile
+        }
+    }
+    else if (IsRunningCommandlet())
+    {
+        // Without an editor to hot reload into, the owner module whose .Build.cs changed is built here instead
+        const FString OwningModule = GetNewModuleOwner(Target, Type);
+        double BuildSeconds;
+        FText BuildFailReason;
+        if (!OwningModule.IsEmpty() && !CppToolsBuild::BuildModules({ OwningModule }, BuildSeconds, BuildFailReason))
+        {
+            OutFailReason = BuildFailReason;
+            return GameProjectUtils::EAddCodeToProjectResult::FailedToHotReload;
+        }
     }
 
     FModuleManager::Get().ResetModulePathsCache();
@@ -683,199 +2075,75 @@ GameProjectUtils::EAddCodeToProjectResult CppToolsUtil::GenerateModule(const FSt
     ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
     if (ISourceControlModule::Get().IsEnabled() && SourceControlProvider.IsAvailable())
     {
+        CPPTOOLS_TRACE_SCOPE(SourceControl);
         SourceControlProvider.Execute(ISourceControlOperation::Create<FMarkForAdd>(), CreatedFilesForExternalAppRead);
     }
 
     SlowTask.EnterProgressFrame();
 
     // Attempt to add files to solution
-    if (!FSourceCodeNavigation::AddSourceFiles(CreatedFilesForExternalAppRead))
-	{
-		// Generate project files if we happen to be using a project file.
-		if ( !FDesktopPlatformModule::Get()->GenerateProjectFiles(FPaths::RootDir(), FPaths::GetProjectFilePath(), GWarn) )
-		{
-			OutFailReason = LOCTEXT("FailedToGenerateProjectFiles", "Failed to generate project files.");
-			return GameProjectUtils::EAddCodeToProjectResult::FailedToHotReload;
-		}
-	}
+    {
+        CPPTOOLS_TRACE_SCOPE(GenerateProjectFiles);
+        if (!FSourceCodeNavigation::AddSourceFiles(CreatedFilesForExternalAppRead))
+        {
+            // Generate project files if we happen to be using a project file.
+            if ( !FDesktopPlatformModule::Get()->GenerateProjectFiles(FPaths::RootDir(), FPaths::GetProjectFilePath(), GWarn) )
+            {
+                OutFailReason = LOCTEXT("FailedToGenerateProjectFiles", "Failed to generate project files.");
+                return GameProjectUtils::EAddCodeToProjectResult::FailedToHotReload;
+            }
+        }
+    }
 
     SlowTask.EnterProgressFrame(1.0f, LOCTEXT("CompilingCPlusPlusCode", "Compiling new C++ code.  Please wait..."));
 
     // Hot reload files
     // See: GameProjectUtils.cpp L4043
     
-    IHotReloadInterface& HotReloadSupport = FModuleManager::LoadModuleChecked<IHotReloadInterface>("HotReload");
-    if (!HotReloadSupport.RecompileModule(*ModuleName, *GWarn, ERecompileModuleFlags::ReloadAfterRecompile))
+    if (IsRunningCommandlet())
     {
-        OutFailReason = LOCTEXT("FailedToCompileNewModule", "Failed to compile newly created module.");
-        return GameProjectUtils::EAddCodeToProjectResult::FailedToHotReload;
-    }
-
-    FSourceCodeNavigation::AccessOnNewModuleAdded().Broadcast(*ModuleName);
-
-    return GameProjectUtils::EAddCodeToProjectResult::Succeeded;
-}
-
-bool CppToolsUtil::UpdateGameProjectFile(const FString& ProjectFile, const FString& EngineIdentifier, const FProjectDescriptorModifier* Modifier, FText& OutFailReason) {
-
-    // See GameProjectUtils.cpp L3661
-
-    GameProjectUtils::TryMakeProjectFileWriteable(ProjectFile);
-
-    FProjectDescriptor Descriptor;
-    if (Descriptor.Load(ProjectFile, OutFailReason)) {
-        if (Modifier && Modifier->IsBound() && !Modifier->Execute(Descriptor)) {
-            return true;
-        }
-        return Descriptor.Save(ProjectFile, OutFailReason) && FDesktopPlatformModule::Get()->SetEngineIdentifierForProject(ProjectFile, EngineIdentifier);
-    }
-    return false;
-}
-
-bool CppToolsUtil::UpdateGameProject(const FProjectDescriptorModifier* Modifier) {
-
-    // See GameProjectUtils.cpp L3568
-
-    const FString& ProjectFilename = FPaths::GetProjectFilePath();
-    const FString& ShortFilename = FPaths::GetCleanFilename(ProjectFilename);
-
-    FText FailReason;
-    FText UpdateMessage;
-    SNotificationItem::ECompletionState NewCompletionState;
-
-    if (UpdateGameProjectFile(ProjectFilename, FDesktopPlatformModule::Get()->GetCurrentEngineIdentifier(), Modifier, FailReason)) {
-        // Project Updated Successfully
-        FFormatNamedArguments Args;
-        Args.Add(TEXT("ShortFilename"), FText::FromString(ShortFilename));
-        UpdateMessage = FText::Format(LOCTEXT("ProjectFileUpdateComplete", "{ShortFilename} was successfully updated."), Args);
-        NewCompletionState = SNotificationItem::CS_Success;
-        PushNotification(UpdateMessage, NewCompletionState);
-        return true;
-    }
-    else {
-        // The user chose to update, but the update failed. Notify the user.
-        FFormatNamedArguments Args;
-        Args.Add(TEXT("ShortFilename"), FText::FromString(ShortFilename));
-        Args.Add(TEXT("FailReason"), FailReason);
-        UpdateMessage = FText::Format(LOCTEXT("ProjectFileUpdateFailed", "{ShortFilename} failed to update. {FailReason}"), Args);
-        NewCompletionState = SNotificationItem::CS_Fail;
-        PushNotification(UpdateMessage, NewCompletionState);
-        return false;
+        // Nothing to hot reload into, the module is loaded the next time the editor starts
     }
-}
-
-bool CppToolsUtil::AppendProjectModules(FProjectDescriptor& Descriptor, const TArray<FModuleDescriptor>* Modules) {
-    // See GameProjectUtils.cpp L1070
-    if (Modules == nullptr) return false;
-
-    for (int32 Idx = 0; Idx < Modules->Num(); Idx++)
+    else if (bRestoredFromCache)
     {
-        auto Element = (*Modules)[Idx];
-        bool bContains = false;
-        bool bUpdatedPrimary = false;
-        for (int32 I = 0; I < Descriptor.Modules.Num(); I++) {
-            if (!bContains && Descriptor.Modules[I].Name == Element.Name) {
-                bContains = true;
-                if (bUpdatedPrimary) break;
-            }
-            if (!bUpdatedPrimary && Descriptor.Modules[I].Name.ToString() == (FString(FApp::GetProjectName())
-                + (Element.Type == EHostType::Editor ? "Editor" : "")))
-            {
-                auto& AdditionalDependencies = Descriptor.Modules[I].AdditionalDependencies;
-                if (!AdditionalDependencies.Contains(Element.Name.ToString()))
-                {
-                    AdditionalDependencies.Add(Element.Name.ToString());
-                }
-                bUpdatedPrimary = true;
-                if (bContains) break;
-            }
+        CPPTOOLS_TRACE_SCOPE(LoadModule);
+        if (!FModuleManager::Get().LoadModule(*ModuleName))
+        {
+            OutFailReason = LOCTEXT("FailedToLoadCachedModule", "Failed to load newly created module from the binary cache.");
+            return GameProjectUtils::EAddCodeToProjectResult::FailedToHotReload;
         }
-        if (!bContains) Descriptor.Modules.Add(Element);
-    }
-
-    GameProjectUtils::ResetCurrentProjectModulesCache();
-
-    return true;
-}
-
-bool CppToolsUtil::UpdatePluginFile(const FString& PluginFile, const FPluginDescriptorModifier* Modifier, FText& OutFailReason)
-{
-    TryMakePluginFileWriteable(PluginFile);
 
-    FPluginDescriptor Descriptor;
-    if (Descriptor.Load(PluginFile, OutFailReason)) {
-        if (Modifier && Modifier->IsBound() && !Modifier->Execute(Descriptor)) {
-            return true;
+        // The cache only had the new module, the owner's .Build.cs now depends on it and has to be compiled again
+        const FString OwningModule = GetNewModuleOwner(Target, Type);
+        IHotReloadInterface& HotReloadSupport = FModuleManager::LoadModuleChecked<IHotReloadInterface>("HotReload");
+        if (!OwningModule.IsEmpty() && !HotReloadSupport.RecompileModule(*OwningModule, *GWarn, ERecompileModuleFlags::ReloadAfterRecompile))
+        {
+            OutFailReason = FText::Format(LOCTEXT("FailedToCompileOwnerModule", "Failed to compile {0}, which the new module was added to."),
+                FText::FromString(OwningModule));
+            return GameProjectUtils::EAddCodeToProjectResult::FailedToHotReload;
         }
-        return Descriptor.Save(PluginFile, OutFailReason);
-    }
-    return false;
-}
-
-bool CppToolsUtil::UpdatePlugin(const TSharedPtr<IPlugin>& Plugin, const FPluginDescriptorModifier* Modifier)
-{
-    if (!Plugin.IsValid()) return false;
-    
-    const FString& PluginFilename = Plugin->GetDescriptorFileName();
-    const FString& ShortFilename = FPaths::GetCleanFilename(PluginFilename);
-
-    FText FailReason;
-    FText UpdateMessage;
-    SNotificationItem::ECompletionState NewCompletionState;
-
-    if (UpdatePluginFile(PluginFilename, Modifier, FailReason)) {
-        // Plugin Updated Successfully
-        FFormatNamedArguments Args;
-        Args.Add(TEXT("ShortFilename"), FText::FromString(ShortFilename));
-        UpdateMessage = FText::Format(LOCTEXT("PluginFileUpdateComplete", "{ShortFilename} was successfully updated."), Args);
-        NewCompletionState = SNotificationItem::CS_Success;
-        PushNotification(UpdateMessage, NewCompletionState);
-        return true;
     }
-    else {
-        // The user chose to update, but the update failed. Notify the user.
-        FFormatNamedArguments Args;
-        Args.Add(TEXT("ShortFilename"), FText::FromString(ShortFilename));
-        Args.Add(TEXT("FailReason"), FailReason);
-        UpdateMessage = FText::Format(LOCTEXT("PluginFileUpdateFailed", "{ShortFilename} failed to update. {FailReason}"), Args);
-        NewCompletionState = SNotificationItem::CS_Fail;
-        PushNotification(UpdateMessage, NewCompletionState);
-        return false;
-    }
-}
-
-bool CppToolsUtil::AppendPluginModules(FPluginDescriptor& Descriptor, TSharedPtr<IPlugin> Plugin, const TArray<FModuleDescriptor>* Modules)
-{
-    if (Modules == nullptr) return false;
-
-    for (int32 Idx = 0; Idx < Modules->Num(); Idx++)
+    else
     {
-        auto Element = (*Modules)[Idx];
-        bool bContains = false;
-        bool bUpdatedPrimary = false;
-        for (int32 I = 0; I < Descriptor.Modules.Num(); I++) {
-            if (!bContains && Descriptor.Modules[I].Name == Element.Name) {
-                bContains = true;
-                if (bUpdatedPrimary) break;
-            }
-            if (!bUpdatedPrimary && Descriptor.Modules[I].Name.ToString() == (Plugin->GetName()
-                + (Element.Type == EHostType::Editor ? "Editor" : "")))
-            {
-                auto& AdditionalDependencies = Descriptor.Modules[I].AdditionalDependencies;
-                if (!AdditionalDependencies.Contains(Element.Name.ToString()))
-                {
-                    AdditionalDependencies.Add(Element.Name.ToString());
-                }
-                bUpdatedPrimary = true;
-                if (bContains) break;
-            }
+        CPPTOOLS_TRACE_SCOPE(HotReload);
+        IHotReloadInterface& HotReloadSupport = FModuleManager::LoadModuleChecked<IHotReloadInterface>("HotReload");
+        if (!HotReloadSupport.RecompileModule(*ModuleName, *GWarn, ERecompileModuleFlags::ReloadAfterRecompile))
+        {
+            OutFailReason = LOCTEXT("FailedToCompileNewModule", "Failed to compile newly created module.");
+            return GameProjectUtils::EAddCodeToProjectResult::FailedToHotReload;
+        }
+
+        if (CppToolsBinaryCache::IsEnabled())
+        {
+            CPPTOOLS_TRACE_SCOPE(StoreInBinaryCache);
+            FText CacheFailReason;
+            CppToolsBinaryCache::StoreModule(ModuleName, Target, CacheFailReason);
         }
-        if (!bContains) Descriptor.Modules.Add(Element);
     }
 
-    GameProjectUtils::ResetCurrentProjectModulesCache();
+    FSourceCodeNavigation::AccessOnNewModuleAdded().Broadcast(*ModuleName);
 
-    return true;
+    return GameProjectUtils::EAddCodeToProjectResult::Succeeded;
 }
 
 #undef LOCTEXT_NAMESPACE
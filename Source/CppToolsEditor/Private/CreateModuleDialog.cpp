@@ -3,6 +3,10 @@
 
 #include "CreateModuleDialog.h"
 
+#include "CppToolsMemoryTags.h"
+
+#include "Algo/Sort.h"
+
 #define LOCTEXT_NAMESPACE "CppToolsModuleDialog"
 
 //BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
@@ -11,6 +15,10 @@ void SCreateModuleDialog::Construct(const FArguments& InArgs) {
     ModuleTarget = InArgs._ModuleTarget;
     ModuleType = InArgs._ModuleType;
     ModuleLoadingPhase = InArgs._ModuleLoadingPhase;
+    bGenerateFwdHeader = false;
+    bAddLLMTag = false;
+    LLMTagIndex = INDEX_NONE;
+    SelectedPreviewFile = 0;
 
     const float EditableTextHeight = 26.0f;
 
@@ -30,20 +38,16 @@ void SCreateModuleDialog::Construct(const FArguments& InArgs) {
     }
     if (ModuleLoadingPhase == NULL) ModuleLoadingPhase = AvailableModuleLoadingPhases[6]; // Set default loading phase
 
-    // Create array of module targets
-    AvailableTargets.Add(MakeShareable(new FCreateModuleTarget));
-    AvailableTargets[0]->Plugin = NULL;
-
-    // Get all plugins
-    for (const auto& Plugin : IPluginManager::Get().GetDiscoveredPlugins()) {
-        // Only use plugins from this game project
-        if (Plugin->GetLoadedFrom() == EPluginLoadedFrom::Project) {
-            // Add each plugin to list of available targets
-            int32 i = AvailableTargets.Add(MakeShareable(new FCreateModuleTarget));
-            AvailableTargets[i]->Plugin = Plugin;
-        }
+    // Create array of module template options
+    AvailableModuleTemplates.Reserve(static_cast<int32>(ECppToolsModuleTemplate::Num));
+    for (int i = 0; i < static_cast<int32>(ECppToolsModuleTemplate::Num); i++) {
+        AvailableModuleTemplates.Emplace(MakeShareable(new ECppToolsModuleTemplate(static_cast<ECppToolsModuleTemplate>(i))));
     }
-    if (ModuleTarget == NULL) ModuleTarget = AvailableTargets[0]; // Set default module target
+    ModuleTemplate = AvailableModuleTemplates[0];
+
+    // The plugins are only listed and indexed once the target picker opens, so the dialog opens without walking them
+    if (ModuleTarget == NULL) ModuleTarget = MakeModuleTarget(NULL); // Set default module target
+    else if (ModuleTarget->DisplayText.IsEmpty()) ModuleTarget = MakeModuleTarget(ModuleTarget->Plugin);
 
     //SNewClassDialog.cpp as reference
 
@@ -222,12 +226,10 @@ void SCreateModuleDialog::Construct(const FArguments& InArgs) {
                                             .AutoWidth()
                                             .Padding(6.0f, 0.0f, 0.0f, 0.0f)
                                             [
-                                                SAssignNew(ModuleTargetsCombo, SComboBox<TSharedPtr<FCreateModuleTarget>>)
+                                                SAssignNew(ModuleTargetButton, SComboButton)
                                                 .ToolTipText(LOCTEXT("ModuleTargetComboToolTip", "Choose the target location for your new module"))
-                                                .OptionsSource(&AvailableTargets)
-                                                .InitiallySelectedItem(ModuleTarget)
-                                                .OnSelectionChanged(this, &SCreateModuleDialog::OnModuleTargetChanged)
-                                                .OnGenerateWidget(this, &SCreateModuleDialog::MakeWidgetForModuleTargetCombo)
+                                                .OnGetMenuContent(this, &SCreateModuleDialog::OnGetModuleTargetMenuContent)
+                                                .ButtonContent()
                                                 [
                                                     SNew(STextBlock)
                                                     .Text(this, &SCreateModuleDialog::OnGetModuleTargetComboText)
@@ -292,6 +294,69 @@ void SCreateModuleDialog::Construct(const FArguments& InArgs) {
                                             .Text(this, &SCreateModuleDialog::OnGetModulePathText)
                                         ]
                                     ]
+
+                                    + SGridPanel::Slot(0, 2)
+                                    .VAlign(VAlign_Center)
+                                    .Padding(0, 0, 12, 0)
+                                    [
+                                        SNew(STextBlock)
+                                        .TextStyle(FEditorStyle::Get(), "NewClassDialog.SelectedParentClassLabel")
+                                        .Text(LOCTEXT("TemplateLabel", "Template"))
+                                    ]
+
+                                    + SGridPanel::Slot(1, 2)
+                                    .Padding(0.0f, 3.0f)
+                                    .VAlign(VAlign_Center)
+                                    .HAlign(HAlign_Left)
+                                    [
+                                        SAssignNew(ModuleTemplatesCombo, SComboBox<TSharedPtr<ECppToolsModuleTemplate>>)
+                                        .ToolTipText(this, &SCreateModuleDialog::OnGetModuleTemplateToolTipText)
+                                        .OptionsSource(&AvailableModuleTemplates)
+                                        .InitiallySelectedItem(ModuleTemplate)
+                                        .OnSelectionChanged(this, &SCreateModuleDialog::OnModuleTemplateChanged)
+                                        .OnGenerateWidget(this, &SCreateModuleDialog::MakeWidgetForModuleTemplateCombo)
+                                        [
+                                            SNew(STextBlock)
+                                            .Text(this, &SCreateModuleDialog::OnGetModuleTemplateComboText)
+                                        ]
+                                    ]
+
+                                    + SGridPanel::Slot(0, 3)
+                                    .VAlign(VAlign_Center)
+                                    .Padding(0, 0, 12, 0)
+                                    [
+                                        SNew(STextBlock)
+                                        .TextStyle(FEditorStyle::Get(), "NewClassDialog.SelectedParentClassLabel")
+                                        .Text(LOCTEXT("OptionsLabel", "Options"))
+                                    ]
+
+                                    + SGridPanel::Slot(1, 3)
+                                    .Padding(0.0f, 3.0f)
+                                    .VAlign(VAlign_Center)
+                                    [
+                                        SNew(SCheckBox)
+                                        .IsChecked(this, &SCreateModuleDialog::IsGenerateFwdHeaderChecked)
+                                        .OnCheckStateChanged(this, &SCreateModuleDialog::OnGenerateFwdHeaderChanged)
+                                        .ToolTipText(LOCTEXT("GenerateFwdHeaderToolTip", "Adds a header forward declaring the module's public types, which other modules can include instead of the full headers"))
+                                        [
+                                            SNew(STextBlock)
+                                            .Text(LOCTEXT("GenerateFwdHeader", "Generate forward declaration header"))
+                                        ]
+                                    ]
+
+                                    + SGridPanel::Slot(1, 4)
+                                    .Padding(0.0f, 3.0f)
+                                    .VAlign(VAlign_Center)
+                                    [
+                                        SNew(SCheckBox)
+                                        .IsChecked(this, &SCreateModuleDialog::IsAddLLMTagChecked)
+                                        .OnCheckStateChanged(this, &SCreateModuleDialog::OnAddLLMTagChanged)
+                                        .ToolTipText(LOCTEXT("AddLLMTagToolTip", "Defines a Low-Level Memory Tracker tag named after the module and scopes StartupModule under it, so the module's memory shows up in LLM reports and the Module Memory window"))
+                                        [
+                                            SNew(STextBlock)
+                                            .Text(LOCTEXT("AddLLMTag", "Add LLM memory tag"))
+                                        ]
+                                    ]
                                 ]
                             ]
                         ]
@@ -305,12 +370,46 @@ void SCreateModuleDialog::Construct(const FArguments& InArgs) {
                             .BorderImage(FEditorStyle::GetBrush("DetailsView.CategoryBottom"))
                             .BorderBackgroundColor(FLinearColor(0.6f, 0.6f, 0.6f, 1.0f))
                         ]
+
+                        // Preview of the files to create and the edits to existing files
+                        + SVerticalBox::Slot()
+                        .FillHeight(1.0f)
+                        .Padding(0.0f, 10.0f, 0.0f, 0.0f)
+                        [
+                            SNew(SSplitter)
+                            .Orientation(Orient_Horizontal)
+
+                            + SSplitter::Slot()
+                            .Value(0.3f)
+                            [
+                                SAssignNew(PreviewFileList, SListView<TSharedPtr<FCppToolsPreviewFile>>)
+                                .ListItemsSource(&PreviewFiles)
+                                .SelectionMode(ESelectionMode::Single)
+                                .OnGenerateRow(this, &SCreateModuleDialog::MakePreviewFileRow)
+                                .OnSelectionChanged(this, &SCreateModuleDialog::OnPreviewFileSelected)
+                            ]
+
+                            + SSplitter::Slot()
+                            .Value(0.7f)
+                            [
+                                SAssignNew(PreviewTextBox, SMultiLineEditableTextBox)
+                                .IsReadOnly(true)
+                                .Font(FCoreStyle::GetDefaultFontStyle("Mono", 9))
+                            ]
+                        ]
                     ]
                 ]
             ]
         ]
     ];
     UpdateInputValidity();
+
+    FText PreviewFailReason;
+    if (!Preview.Initialize(PreviewFailReason))
+    {
+        PreviewTextBox->SetText(PreviewFailReason);
+    }
+    UpdatePreview();
 }
 
 void SCreateModuleDialog::CancelClicked() {
@@ -332,7 +431,8 @@ void SCreateModuleDialog::FinishClicked() {
     FText OutFailReason;
 
     GameProjectUtils::EAddCodeToProjectResult AddModuleResult = CppToolsUtil::GenerateModule(GetModulePath(),
-        ModuleTarget->Plugin, ModuleName, *ModuleType, *ModuleLoadingPhase, false, CreatedFiles, OutFailReason);
+        ModuleTarget->Plugin, ModuleName, *ModuleType, *ModuleLoadingPhase, false, CreatedFiles, OutFailReason, bGenerateFwdHeader,
+        bAddLLMTag ? LLMTagIndex : INDEX_NONE, *ModuleTemplate);
     if (AddModuleResult == GameProjectUtils::EAddCodeToProjectResult::Succeeded) {
 
         OnCreateModule.ExecuteIfBound(ModuleName, *ModuleTarget, *ModuleType);
@@ -375,6 +475,34 @@ void SCreateModuleDialog::FinishClicked() {
     CloseContainingWindow();
 }
 
+ECheckBoxState SCreateModuleDialog::IsGenerateFwdHeaderChecked() const {
+    return bGenerateFwdHeader ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SCreateModuleDialog::OnGenerateFwdHeaderChanged(ECheckBoxState NewState) {
+    bGenerateFwdHeader = NewState == ECheckBoxState::Checked;
+    UpdatePreview();
+}
+
+ECheckBoxState SCreateModuleDialog::IsAddLLMTagChecked() const {
+    return bAddLLMTag ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SCreateModuleDialog::OnAddLLMTagChanged(ECheckBoxState NewState) {
+    bAddLLMTag = NewState == ECheckBoxState::Checked;
+    if (bAddLLMTag && LLMTagIndex == INDEX_NONE)
+    {
+        // Reading every module header is only worth it once the option is used
+        LLMTagIndex = CppToolsMemoryTags::FindFreeTagIndex(CppToolsMemoryTags::GetProjectTags());
+        if (LLMTagIndex == INDEX_NONE)
+        {
+            bAddLLMTag = false;
+            CppToolsUtil::PushNotification(LOCTEXT("NoFreeLLMTag", "Every LLM project tag is used by a module already"), SNotificationItem::CS_Fail);
+        }
+    }
+    UpdatePreview();
+}
+
 EVisibility SCreateModuleDialog::GetGlobalErrorLabelVisibility() const {
     return GetGlobalErrorLabelText().IsEmpty() ? EVisibility::Collapsed : EVisibility::Visible;
 }
@@ -411,6 +539,7 @@ FText SCreateModuleDialog::OnGetModuleNameText() const {
 void SCreateModuleDialog::OnModuleNameTextChanged(const FText& NewText) {
     ModuleName = NewText.ToString();
     UpdateInputValidity();
+    UpdatePreview();
 }
 
 void SCreateModuleDialog::OnModuleNameTextCommitted(const FText& NewText, ETextCommit::Type CommitType) {
@@ -426,16 +555,163 @@ void SCreateModuleDialog::OnModuleNameTextCommitted(const FText& NewText, ETextC
 
 
 FText SCreateModuleDialog::OnGetModuleTargetComboText() const {
-    return FText::FromString(ModuleTarget->Plugin == NULL ? FString(FApp::GetProjectName()) + " (Game)" : ModuleTarget->Plugin->GetDescriptor().FriendlyName + " (Plugin)");
+    return ModuleTarget->DisplayText;
+}
+
+TSharedRef<SWidget> SCreateModuleDialog::OnGetModuleTargetMenuContent() {
+    BuildModuleTargetIndex();
+
+    TargetFilter.Reset();
+    TargetIndex.Filter(TargetFilter, TargetMatches);
+    FilteredTargets.Reset(TargetMatches.Num());
+    for (int32 Match : TargetMatches) {
+        FilteredTargets.Add(AvailableTargets[Match]);
+    }
+
+    TSharedRef<SWidget> MenuContent = SNew(SBox)
+        .MinDesiredWidth(300.0f)
+        .MaxDesiredHeight(400.0f)
+        [
+            SNew(SVerticalBox)
+
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(4.0f)
+            [
+                SAssignNew(ModuleTargetSearchBox, SSearchBox)
+                .HintText(LOCTEXT("ModuleTargetSearchHint", "Search plugins"))
+                .OnTextChanged(this, &SCreateModuleDialog::OnModuleTargetFilterChanged)
+                .OnTextCommitted(this, &SCreateModuleDialog::OnModuleTargetFilterCommitted)
+            ]
+
+            + SVerticalBox::Slot()
+            .FillHeight(1.0f)
+            [
+                SAssignNew(ModuleTargetList, SListView<TSharedPtr<FCreateModuleTarget>>)
+                .ListItemsSource(&FilteredTargets)
+                .SelectionMode(ESelectionMode::Single)
+                .OnGenerateRow(this, &SCreateModuleDialog::MakeModuleTargetRow)
+                .OnSelectionChanged(this, &SCreateModuleDialog::OnModuleTargetChanged)
+            ]
+        ];
+
+    ModuleTargetList->SetItemSelection(ModuleTarget, true, ESelectInfo::Direct);
+    ModuleTargetList->RequestScrollIntoView(ModuleTarget);
+    ModuleTargetButton->SetMenuContentWidgetToFocus(ModuleTargetSearchBox);
+    return MenuContent;
+}
+
+void SCreateModuleDialog::OnModuleTargetFilterChanged(const FText& NewText) {
+    const FString NewFilter = NewText.ToString().ToLower();
+    // Typing another character can only remove matches, so only the current matches are searched again
+    if (!TargetFilter.IsEmpty() && NewFilter.StartsWith(TargetFilter)) {
+        const TArray<int32> Candidates = MoveTemp(TargetMatches);
+        TargetIndex.Filter(NewFilter, TargetMatches, &Candidates);
+    }
+    else {
+        TargetIndex.Filter(NewFilter, TargetMatches);
+    }
+    TargetFilter = NewFilter;
+
+    FilteredTargets.Reset(TargetMatches.Num());
+    for (int32 Match : TargetMatches) {
+        FilteredTargets.Add(AvailableTargets[Match]);
+    }
+    ModuleTargetList->RequestListRefresh();
+    if (FilteredTargets.Num() > 0) {
+        ModuleTargetList->RequestScrollIntoView(FilteredTargets[0]);
+    }
+}
+
+void SCreateModuleDialog::OnModuleTargetFilterCommitted(const FText& NewText, ETextCommit::Type CommitType) {
+    if (CommitType == ETextCommit::OnEnter && FilteredTargets.Num() > 0) {
+        OnModuleTargetChanged(FilteredTargets[0], ESelectInfo::OnKeyPress);
+    }
+}
+
+FText SCreateModuleDialog::OnGetModuleTargetFilterText() const {
+    return FText::FromString(TargetFilter);
 }
 
 void SCreateModuleDialog::OnModuleTargetChanged(TSharedPtr<FCreateModuleTarget> Value, ESelectInfo::Type SelectInfo) {
+    if (!Value.IsValid() || SelectInfo == ESelectInfo::Direct) return;
+
     ModuleTarget = Value;
+    // Moving through the list with the arrow keys keeps the picker open
+    if (SelectInfo != ESelectInfo::OnNavigation) {
+        ModuleTargetButton->SetIsOpen(false);
+    }
+    UpdatePreview();
 }
 
-TSharedRef<SWidget> SCreateModuleDialog::MakeWidgetForModuleTargetCombo(TSharedPtr<FCreateModuleTarget> Value) {
-    return SNew(STextBlock)
-        .Text(FText::FromString(Value->Plugin == NULL ? FString(FApp::GetProjectName()) + "(Game)" : Value->Plugin->GetDescriptor().FriendlyName + " (Plugin)"));
+TSharedRef<ITableRow> SCreateModuleDialog::MakeModuleTargetRow(TSharedPtr<FCreateModuleTarget> Value, const TSharedRef<STableViewBase>& OwnerTable) {
+    return SNew(STableRow<TSharedPtr<FCreateModuleTarget>>, OwnerTable)
+        .Padding(FMargin(4.0f, 2.0f))
+        [
+            SNew(SHorizontalBox)
+
+            + SHorizontalBox::Slot()
+            .FillWidth(1.0f)
+            [
+                SNew(STextBlock)
+                .Text(Value->DisplayText)
+                .HighlightText(this, &SCreateModuleDialog::OnGetModuleTargetFilterText)
+            ]
+
+            + SHorizontalBox::Slot()
+            .AutoWidth()
+            .Padding(12.0f, 0.0f, 0.0f, 0.0f)
+            [
+                SNew(STextBlock)
+                .Text(Value->Category)
+                .ColorAndOpacity(FSlateColor::UseSubduedForeground())
+            ]
+        ];
+}
+
+void SCreateModuleDialog::BuildModuleTargetIndex() {
+    if (AvailableTargets.Num() > 0) return;
+
+    // Keep the selected target, so it is selected in the list
+    TArray<TSharedPtr<FCreateModuleTarget>> PluginTargets;
+    for (const TSharedPtr<IPlugin>& Plugin : CppToolsUtil::GetProjectPlugins()) {
+        PluginTargets.Add(Plugin == ModuleTarget->Plugin ? ModuleTarget : MakeModuleTarget(Plugin));
+    }
+    Algo::Sort(PluginTargets, [](const TSharedPtr<FCreateModuleTarget>& A, const TSharedPtr<FCreateModuleTarget>& B) {
+        return A->DisplayText.CompareToCaseIgnored(B->DisplayText) < 0;
+    });
+
+    // The game comes first, followed by the plugins by name
+    AvailableTargets.Add(ModuleTarget->Plugin == NULL ? ModuleTarget : MakeModuleTarget(NULL));
+    AvailableTargets.Append(PluginTargets);
+
+    TargetIndex.Reset();
+    for (const TSharedPtr<FCreateModuleTarget>& Target : AvailableTargets) {
+        if (Target->Plugin == NULL) {
+            TargetIndex.Add(FApp::GetProjectName(), Target->Category.ToString());
+            continue;
+        }
+        // Plugins whose friendly name differs from their name can be found by either
+        const FString& FriendlyName = Target->Plugin->GetDescriptor().FriendlyName;
+        const FString PluginName = Target->Plugin->GetName();
+        TargetIndex.Add(FriendlyName.IsEmpty() || FriendlyName == PluginName ? PluginName : FriendlyName + TEXT(" ") + PluginName,
+            Target->Category.ToString());
+    }
+}
+
+TSharedPtr<FCreateModuleTarget> SCreateModuleDialog::MakeModuleTarget(TSharedPtr<IPlugin> Plugin) {
+    TSharedPtr<FCreateModuleTarget> Target = MakeShareable(new FCreateModuleTarget);
+    Target->Plugin = Plugin;
+    if (Plugin == NULL) {
+        Target->DisplayText = FText::FromString(FString(FApp::GetProjectName()) + " (Game)");
+        Target->Category = LOCTEXT("GameCategory", "Game");
+    }
+    else {
+        const FPluginDescriptor& Descriptor = Plugin->GetDescriptor();
+        Target->DisplayText = FText::FromString((Descriptor.FriendlyName.IsEmpty() ? Plugin->GetName() : Descriptor.FriendlyName) + " (Plugin)");
+        Target->Category = FText::FromString(Descriptor.Category);
+    }
+    return Target;
 }
 
 
@@ -450,6 +726,7 @@ void SCreateModuleDialog::OnModuleTypeChanged(TSharedPtr<EHostType::Type> Value,
         OnModuleLoadingPhaseChanged(AvailableModuleLoadingPhases[8], ESelectInfo::Direct);
     }
     ModuleType = Value;
+    UpdatePreview();
 }
 
 TSharedRef<SWidget> SCreateModuleDialog::MakeWidgetForModuleTypeCombo(TSharedPtr<EHostType::Type> Value) {
@@ -466,6 +743,7 @@ void SCreateModuleDialog::OnModuleLoadingPhaseChanged(TSharedPtr<ELoadingPhase::
     ESelectInfo::Type SelectInfo)
 {
     ModuleLoadingPhase = Value;
+    UpdatePreview();
 }
 
 TSharedRef<SWidget> SCreateModuleDialog::MakeWidgetForModuleLoadingPhaseCombo(TSharedPtr<ELoadingPhase::Type> Value)
@@ -475,47 +753,99 @@ TSharedRef<SWidget> SCreateModuleDialog::MakeWidgetForModuleLoadingPhaseCombo(TS
 }
 
 
+FText SCreateModuleDialog::OnGetModuleTemplateComboText() const
+{
+    return CppToolsModuleTemplates::GetDisplayName(*ModuleTemplate);
+}
+
+FText SCreateModuleDialog::OnGetModuleTemplateToolTipText() const
+{
+    return CppToolsModuleTemplates::GetDescription(*ModuleTemplate);
+}
+
+void SCreateModuleDialog::OnModuleTemplateChanged(TSharedPtr<ECppToolsModuleTemplate> Value, ESelectInfo::Type SelectInfo)
+{
+    // The high-performance template hooks into the frame loop, which only runtime modules are guaranteed to be loaded for
+    if (*Value == ECppToolsModuleTemplate::HighPerformanceRuntime && *ModuleType != EHostType::Runtime)
+    {
+        ModuleTypesCombo->SetSelectedItem(AvailableModuleTypes[EHostType::Runtime]);
+    }
+    ModuleTemplate = Value;
+    UpdatePreview();
+}
+
+TSharedRef<SWidget> SCreateModuleDialog::MakeWidgetForModuleTemplateCombo(TSharedPtr<ECppToolsModuleTemplate> Value)
+{
+    return SNew(STextBlock)
+        .Text(CppToolsModuleTemplates::GetDisplayName(*Value))
+        .ToolTipText(CppToolsModuleTemplates::GetDescription(*Value));
+}
+
+
 FText SCreateModuleDialog::OnGetModulePathText() const {
     return FText::FromString(GetModulePath());
 }
 
 FString SCreateModuleDialog::GetModulePath() const {
-    FString Path = (ModuleTarget->Plugin == NULL) ? FPaths::GameSourceDir() : ModuleTarget->Plugin->GetBaseDir() / "Source";
-    return FPaths::ConvertRelativePathToFull(Path / ModuleName / "");
+    return CppToolsUtil::GetNewModulePath(ModuleName, ModuleTarget->Plugin);
 }
 
 
 void SCreateModuleDialog::UpdateInputValidity() {
-    bLastInputValidityCheckSuccessful = true;
-    FString IllegalNameCharacters;
+    bLastInputValidityCheckSuccessful = CppToolsUtil::IsValidNewModuleName(ModuleName, LastInputValidityErrorText);
+}
 
-    if (ModuleName.IsEmpty()) {
-        bLastInputValidityCheckSuccessful = false;
-        LastInputValidityErrorText = FText::FromString(TEXT("You must enter a name to create a new module"));
-        return;
-    }
-    else if (!GameProjectUtils::NameContainsOnlyLegalCharacters(ModuleName, IllegalNameCharacters)) {
-        bLastInputValidityCheckSuccessful = false;
-        FFormatNamedArguments Args;
-        Args.Add(TEXT("IllegalNameCharacters"), FText::FromString(IllegalNameCharacters));
-        LastInputValidityErrorText = FText::Format(LOCTEXT("ModuleNameContainsIllegalCharacters", "The module name may not contain the following characters: '{IllegalNameCharacters}'"), Args);
-        return;
-    }
-    
-    if (!GameProjectUtils::ProjectHasCodeFiles()) {
-        bLastInputValidityCheckSuccessful = false;
-        LastInputValidityErrorText = FText::FromString(TEXT("A new module may not be added to a non-C++ project. Convert the project from Blueprint to C++ by adding a C++ class in the editor."));
-        return;
+void SCreateModuleDialog::UpdatePreview() {
+    if (!PreviewFileList.IsValid()) return;
+
+    FCppToolsNewModuleSettings Settings;
+    Settings.ModuleName = ModuleName;
+    Settings.Target = ModuleTarget->Plugin;
+    Settings.Type = *ModuleType;
+    Settings.LoadingPhase = *ModuleLoadingPhase;
+    Settings.bGenerateFwdHeader = bGenerateFwdHeader;
+    Settings.LLMTagIndex = bAddLLMTag ? LLMTagIndex : INDEX_NONE;
+    Settings.ModuleTemplate = *ModuleTemplate;
+    if (!Preview.Update(Settings)) return;
+
+    PreviewFiles = Preview.GetFiles();
+    PreviewFileList->RequestListRefresh();
+    if (PreviewFiles.Num() > 0)
+    {
+        SelectedPreviewFile = FMath::Clamp(SelectedPreviewFile, 0, PreviewFiles.Num() - 1);
+        PreviewFileList->SetSelection(PreviewFiles[SelectedPreviewFile], ESelectInfo::Direct);
     }
+    ShowSelectedPreviewFile();
+}
 
-    if (FModuleManager::Get().ModuleExists(*ModuleName)) {
-        bLastInputValidityCheckSuccessful = false;
-        FFormatNamedArguments Args;
-        Args.Add(TEXT("ModuleName"), FText::FromString(ModuleName));
-        LastInputValidityErrorText = FText::Format(LOCTEXT("ModuleNameWarning", "Module '{ModuleName}' already exists. If this module was manually deleted, clean and rebuild the project."), Args);
-        return;
+void SCreateModuleDialog::ShowSelectedPreviewFile() {
+    const FText FailReason = Preview.GetFailReason();
+    FString Text = PreviewFiles.IsValidIndex(SelectedPreviewFile) ? PreviewFiles[SelectedPreviewFile]->Text : FString();
+    if (!FailReason.IsEmpty())
+    {
+        Text = FailReason.ToString() + TEXT("\n\n") + Text;
     }
+    PreviewTextBox->SetText(FText::FromString(Text));
+}
+
+void SCreateModuleDialog::OnPreviewFileSelected(TSharedPtr<FCppToolsPreviewFile> Value, ESelectInfo::Type SelectInfo) {
+    if (!Value.IsValid()) return;
 
+    SelectedPreviewFile = PreviewFiles.IndexOfByKey(Value);
+    ShowSelectedPreviewFile();
+}
+
+TSharedRef<ITableRow> SCreateModuleDialog::MakePreviewFileRow(TSharedPtr<FCppToolsPreviewFile> Value, const TSharedRef<STableViewBase>& OwnerTable) {
+    const FText Label = Value->bCreate
+        ? FText::Format(LOCTEXT("PreviewCreatedFile", "{0} (new)"), FText::FromString(FPaths::GetCleanFilename(Value->Filename)))
+        : FText::Format(LOCTEXT("PreviewModifiedFile", "{0} (modified)"), FText::FromString(FPaths::GetCleanFilename(Value->Filename)));
+
+    return SNew(STableRow<TSharedPtr<FCppToolsPreviewFile>>, OwnerTable)
+        [
+            SNew(STextBlock)
+            .Text(Label)
+            .ToolTipText(FText::FromString(Value->Filename))
+        ];
 }
 
 
@@ -0,0 +1,245 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Automation tests of the text routines of CppToolsUtil, which the Benchmark operation only measures.
+// Run them from the Session Frontend, or with -ExecCmds="Automation RunTests CppTools.Util".
+
+#include "CppToolsUtil.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CppToolsUtilTestsImpl
+{
+    static const TCHAR* BuildFile = TEXT(
+        "using UnrealBuildTool;\n"
+        "\n"
+        "public class TestModule : ModuleRules\n"
+        "{\n"
+        "\tpublic TestModule(ReadOnlyTargetRules Target) : base(Target)\n"
+        "\t{\n"
+        "\t\tPublicDependencyModuleNames.AddRange(new string[] { \"Core\", \"Engine\" });\n"
+        "\t\t// PublicDependencyModuleNames.Add(\"LineCommented\");\n"
+        "\t\t/* PrivateDependencyModuleNames.Add(\"BlockCommented\"); */\n"
+        "\t\tPrivateDependencyModuleNames.AddRange(new string[] {\n"
+        "\t\t\t\"Slate\",\n"
+        "\t\t\t\"SlateCore\"\n"
+        "\t\t});\n"
+        "\t}\n"
+        "}\n");
+
+    static FString JoinDependencies(const FString& BuildFileContents, bool bIncludePrivate)
+    {
+        return FString::Join(CppToolsUtil::ParseModuleDependencies(BuildFileContents, bIncludePrivate), TEXT(","));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsStripCStyleCommentsTest, "CppTools.Util.StripCStyleComments",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsStripCStyleCommentsTest::RunTest(const FString& Parameters)
+{
+    TestEqual(TEXT("Line comments are removed up to the line break"),
+        CppToolsUtil::StripCStyleComments(TEXT("int A; // comment\nint B;")), FString(TEXT("int A; \nint B;")));
+    TestEqual(TEXT("Block comments are removed"),
+        CppToolsUtil::StripCStyleComments(TEXT("int A; /* one\ntwo */int B;")), FString(TEXT("int A; int B;")));
+    TestEqual(TEXT("Block comments do not nest"),
+        CppToolsUtil::StripCStyleComments(TEXT("/* /* */int A; */")), FString(TEXT("int A; */")));
+    TestEqual(TEXT("Comment markers within strings are kept"),
+        CppToolsUtil::StripCStyleComments(TEXT("S = \"// /* */\"; // comment")), FString(TEXT("S = \"// /* */\"; ")));
+    TestEqual(TEXT("Escaped quotes do not end strings"),
+        CppToolsUtil::StripCStyleComments(TEXT("S = \"\\\" // \"; // comment")), FString(TEXT("S = \"\\\" // \"; ")));
+    TestEqual(TEXT("Unterminated block comments run to the end"),
+        CppToolsUtil::StripCStyleComments(TEXT("int A; /* open")), FString(TEXT("int A; ")));
+    TestEqual(TEXT("Source without comments is unchanged"),
+        CppToolsUtil::StripCStyleComments(TEXT("int A = 4 / 2;")), FString(TEXT("int A = 4 / 2;")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsParseStringListTest, "CppTools.Util.ParseStringList",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsParseStringListTest::RunTest(const FString& Parameters)
+{
+    TestEqual(TEXT("Quoted strings are parsed"),
+        FString::Join(CppToolsUtil::ParseStringList(TEXT("\"A\", \"B\",\n\t\"C\"")), TEXT(",")), FString(TEXT("A,B,C")));
+    TestEqual(TEXT("Unquoted text is ignored"),
+        FString::Join(CppToolsUtil::ParseStringList(TEXT("{ \"A\" } B")), TEXT(",")), FString(TEXT("A")));
+    TestEqual(TEXT("Unterminated strings are ignored"),
+        FString::Join(CppToolsUtil::ParseStringList(TEXT("\"A\", \"B")), TEXT(",")), FString(TEXT("A")));
+    TestEqual(TEXT("Empty lists have no strings"), CppToolsUtil::ParseStringList(TEXT("")).Num(), 0);
+
+    TArray<FStringView> Views;
+    const FString RawStringList = TEXT("\"A\", \"BC\"");
+    CppToolsUtil::ParseStringListViews(FStringView(*RawStringList, RawStringList.Len()), Views);
+    TestEqual(TEXT("Views are parsed"), Views.Num(), 2);
+    TestTrue(TEXT("Views point into the list"), Views.Num() == 2 && Views[1].GetData() == *RawStringList + 6 && Views[1].Len() == 2);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsCombineStringListTest, "CppTools.Util.CombineStringList",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsCombineStringListTest::RunTest(const FString& Parameters)
+{
+    const TArray<FString> Strings = { TEXT("A"), TEXT("B"), TEXT("C") };
+    TestEqual(TEXT("Strings are quoted and spaced"), CppToolsUtil::CombineStringList(Strings, true, true), FString(TEXT("\"A\", \"B\", \"C\"")));
+    TestEqual(TEXT("Strings are combined without quotes or spaces"), CppToolsUtil::CombineStringList(Strings, false, false), FString(TEXT("A,B,C")));
+    TestEqual(TEXT("Empty lists combine to nothing"), CppToolsUtil::CombineStringList(TArray<FString>(), true, true), FString());
+
+    const FStringView Views[] = { TEXT("A"), TEXT("B") };
+    TestEqual(TEXT("Views are combined like strings"), CppToolsUtil::CombineStringList(MakeArrayView(Views), true, false), FString(TEXT("\"A\",\"B\"")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsParseModuleDependenciesTest, "CppTools.Util.ParseModuleDependencies",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsParseModuleDependenciesTest::RunTest(const FString& Parameters)
+{
+    using namespace CppToolsUtilTestsImpl;
+
+    TestEqual(TEXT("Public dependencies are parsed"), JoinDependencies(BuildFile, false), FString(TEXT("Core,Engine")));
+    TestEqual(TEXT("Private dependencies are parsed, ignoring commented out lists"), JoinDependencies(BuildFile, true),
+        FString(TEXT("Core,Engine,Slate,SlateCore")));
+    TestEqual(TEXT("Commented out elements are ignored"),
+        JoinDependencies(TEXT("PublicDependencyModuleNames.AddRange(new string[] { \"Core\", /* \"Hidden\", */ \"Engine\" });"), false),
+        FString(TEXT("Core,Engine")));
+    TestEqual(TEXT("Single dependencies are parsed"), JoinDependencies(TEXT("PublicDependencyModuleNames.Add(\"Core\");"), false), FString(TEXT("Core")));
+    TestEqual(TEXT("Lists with similar names are ignored"),
+        JoinDependencies(TEXT("MyPublicDependencyModuleNames.Add(\"Core\");"), false), FString());
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsEditBuildFileTest, "CppTools.Util.EditBuildFile",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsEditBuildFileTest::RunTest(const FString& Parameters)
+{
+    using namespace CppToolsUtilTestsImpl;
+
+    FString Contents = BuildFile;
+    TestTrue(TEXT("Public dependencies are inserted"), CppToolsUtil::InsertDependencyIntoBuildFile(Contents, TEXT("Json"), false));
+    TestEqual(TEXT("The inserted dependency is parsed"), JoinDependencies(Contents, false), FString(TEXT("Core,Engine,Json")));
+    TestTrue(TEXT("Commented out lists are kept"), Contents.Contains(TEXT("LineCommented")) && Contents.Contains(TEXT("BlockCommented")));
+
+    TestTrue(TEXT("Existing dependencies can be inserted again"), CppToolsUtil::InsertDependencyIntoBuildFile(Contents, TEXT("Core"), false));
+    TestEqual(TEXT("Existing dependencies are not duplicated"), JoinDependencies(Contents, false), FString(TEXT("Core,Engine,Json")));
+
+    TestTrue(TEXT("Private dependencies are inserted"), CppToolsUtil::InsertDependencyIntoBuildFile(Contents, TEXT("InputCore"), true));
+    TestEqual(TEXT("The inserted private dependency is parsed"), JoinDependencies(Contents, true), FString(TEXT("Core,Engine,Json,Slate,SlateCore,InputCore")));
+
+    TestTrue(TEXT("Dependencies are removed"), CppToolsUtil::RemoveDependencyFromBuildFile(Contents, TEXT("Engine")));
+    TestTrue(TEXT("The last dependency of a list is removed"), CppToolsUtil::RemoveDependencyFromBuildFile(Contents, TEXT("InputCore")));
+    TestEqual(TEXT("Removed dependencies are not parsed"), JoinDependencies(Contents, true), FString(TEXT("Core,Json,Slate,SlateCore")));
+    TestFalse(TEXT("Missing dependencies are not removed"), CppToolsUtil::RemoveDependencyFromBuildFile(Contents, TEXT("Missing")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsModuleRulesFieldsTest, "CppTools.Util.ModuleRulesFields",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsModuleRulesFieldsTest::RunTest(const FString& Parameters)
+{
+    const FString RulesFile = TEXT(
+        "public class TestModule : ModuleRules\n"
+        "{\n"
+        "\tpublic TestModule(ReadOnlyTargetRules Target) : base(Target)\n"
+        "\t{\n"
+        "\t\t// bUseUnity = true;\n"
+        "\t\tif (Target.bUseUnity == false) { PCHUsage = PCHUsageMode.NoSharedPCHs; }\n"
+        "\t\tstring Note = \"bUseUnity = true;\";\n"
+        "\t\tbUseUnity = false;\n"
+        "\t}\n"
+        "\n"
+        "\tprivate void Helper()\n"
+        "\t{\n"
+        "\t}\n"
+        "}\n");
+
+    FString Value;
+    TestTrue(TEXT("Fields are found"), CppToolsUtil::GetModuleRulesField(RulesFile, TEXT("bUseUnity"), Value));
+    TestEqual(TEXT("Comments, literals, comparisons and members of other objects are skipped"), Value, FString(TEXT("false")));
+    TestTrue(TEXT("Fields within nested blocks are found"), CppToolsUtil::GetModuleRulesField(RulesFile, TEXT("PCHUsage"), Value));
+    TestEqual(TEXT("Field values are trimmed"), Value, FString(TEXT("PCHUsageMode.NoSharedPCHs")));
+    TestFalse(TEXT("Missing fields are not found"), CppToolsUtil::GetModuleRulesField(RulesFile, TEXT("bEnforceIWYU"), Value));
+
+    FString Contents = RulesFile;
+    TestTrue(TEXT("Missing fields are added"), CppToolsUtil::SetModuleRulesField(Contents, TEXT("MinSourceFilesForUnityBuildOverride"), TEXT("2")));
+    TestTrue(TEXT("Added fields are found"), CppToolsUtil::GetModuleRulesField(Contents, TEXT("MinSourceFilesForUnityBuildOverride"), Value) && Value == TEXT("2"));
+    TestTrue(TEXT("Existing fields are replaced"), CppToolsUtil::SetModuleRulesField(Contents, TEXT("bUseUnity"), TEXT("true")));
+    TestTrue(TEXT("The commented out assignment is kept"), Contents.Contains(TEXT("// bUseUnity = true;")));
+    TestTrue(TEXT("Fields are removed"), CppToolsUtil::RemoveModuleRulesField(Contents, TEXT("bUseUnity")));
+    TestFalse(TEXT("Removed fields are not found"), CppToolsUtil::GetModuleRulesField(Contents, TEXT("bUseUnity"), Value));
+
+    const TArray<FString> Lines = { TEXT("A.cpp") };
+    TestTrue(TEXT("Comment blocks are added"), CppToolsUtil::SetModuleRulesCommentBlock(Contents, TEXT("WorkingSet"), Lines));
+    const int32 BlockIndex = Contents.Find(TEXT("// BEGIN CppTools WorkingSet"));
+    TestTrue(TEXT("Comment blocks are added to the constructor"), BlockIndex > Contents.Find(TEXT("bUseUnity"))
+        && BlockIndex < Contents.Find(TEXT("private void Helper")));
+    TestFalse(TEXT("Unchanged comment blocks are not rewritten"), CppToolsUtil::SetModuleRulesCommentBlock(Contents, TEXT("WorkingSet"), Lines));
+    TestTrue(TEXT("Empty comment blocks are removed"), CppToolsUtil::SetModuleRulesCommentBlock(Contents, TEXT("WorkingSet"), TArray<FString>()));
+    TestFalse(TEXT("Removed comment blocks are gone"), Contents.Contains(TEXT("WorkingSet")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsParseIncludesTest, "CppTools.Util.ParseIncludes",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsParseIncludesTest::RunTest(const FString& Parameters)
+{
+    const FString Source = TEXT(
+        "#include \"A.h\"\n"
+        "  #  include <B/C.h>\n"
+        "// #include \"Commented.h\"\n"
+        "/*\n#include \"BlockCommented.h\"\n*/\n"
+        "#include \"D.h\" // trailing comment\n");
+    TestEqual(TEXT("Includes are parsed, ignoring commented out ones"), FString::Join(CppToolsUtil::ParseIncludes(Source), TEXT(",")),
+        FString(TEXT("A.h,B/C.h,D.h")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsParseTargetExtraModulesTest, "CppTools.Util.ParseTargetExtraModules",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsParseTargetExtraModulesTest::RunTest(const FString& Parameters)
+{
+    const FString TargetFile = TEXT(
+        "\t\tExtraModuleNames.AddRange( new string[] { \"Game\", \"GameTools\" } );\n"
+        "\t\t// ExtraModuleNames.Add(\"Commented\");\n"
+        "\t\tExtraModuleNames.Add(\"GameExtra\");\n");
+    TestEqual(TEXT("Extra modules are parsed, ignoring commented out ones"), FString::Join(CppToolsUtil::ParseTargetExtraModules(TargetFile), TEXT(",")),
+        FString(TEXT("Game,GameTools,GameExtra")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCppToolsInsertModuleIntoTargetFileTest, "CppTools.Util.InsertModuleIntoTargetFile",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCppToolsInsertModuleIntoTargetFileTest::RunTest(const FString& Parameters)
+{
+    FString TargetFile = TEXT(
+        "\t\t// ExtraModuleNames.AddRange( new string[] { \"Commented\" } );\n"
+        "\t\tExtraModuleNames.AddRange( new string[] { \"Game\", // The game module\n"
+        "\t\t} );\n");
+    TestTrue(TEXT("A module is inserted into the AddRange list"), CppToolsUtil::InsertModuleIntoTargetFile(TargetFile, TEXT("GameTools")));
+    TestEqual(TEXT("The module goes after the last element, keeping the comment and ignoring the commented out list"), TargetFile, FString(TEXT(
+        "\t\t// ExtraModuleNames.AddRange( new string[] { \"Commented\" } );\n"
+        "\t\tExtraModuleNames.AddRange( new string[] { \"Game\", \"GameTools\" // The game module\n"
+        "\t\t} );\n")));
+
+    const FString Unchanged = TargetFile;
+    TestTrue(TEXT("A module already in the list is not inserted again"), CppToolsUtil::InsertModuleIntoTargetFile(TargetFile, TEXT("Game")));
+    TestEqual(TEXT("The target file is unchanged"), TargetFile, Unchanged);
+
+    TargetFile = TEXT("\t\tExtraModuleNames.Add(\"Game\");\n");
+    TestTrue(TEXT("A module is inserted next to an Add call"), CppToolsUtil::InsertModuleIntoTargetFile(TargetFile, TEXT("GameTools")));
+    TestEqual(TEXT("The module gets its own Add call"), TargetFile,
+        FString(TEXT("\t\tExtraModuleNames.Add(\"Game\");")) + LINE_TERMINATOR + TEXT("\t\tExtraModuleNames.Add(\"GameTools\");\n"));
+
+    TargetFile = TEXT("\t\t// ExtraModuleNames.Add(\"Game\");\n");
+    TestFalse(TEXT("A target file with only commented out lists is not changed"), CppToolsUtil::InsertModuleIntoTargetFile(TargetFile, TEXT("GameTools")));
+    return true;
+}
+
+#endif
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The measurements of a single benchmark. */
+struct FCppToolsBenchmarkResult
+{
+    FString Name;
+    int32 Iterations = 0;
+    double SecondsPerIteration = 0.0;
+    /** The size of the input processed by one iteration, used to compute throughput. */
+    int64 BytesPerIteration = 0;
+    double AllocationsPerIteration = 0.0;
+    double AllocatedBytesPerIteration = 0.0;
+
+    /** Gets the throughput of the benchmark in megabytes per second. */
+    double GetThroughput() const
+    {
+        return SecondsPerIteration > 0.0 ? (BytesPerIteration / (1024.0 * 1024.0)) / SecondsPerIteration : 0.0;
+    }
+};
+
+/**
+ * Benchmarks and stress tests the text and file routines of CppToolsUtil against generated fixtures, and compares the
+ * results against the baseline checked in to Content/Editor/Benchmarks so regressions can be caught.
+ */
+class CPPTOOLSEDITOR_API CppToolsBenchmark
+{
+public:
+
+    /**
+     * Runs every benchmark whose name contains the filter. The iteration scale multiplies the number of iterations of each
+     * benchmark, use values below 1 for a quick smoke test and above 1 for more stable measurements.
+     */
+    static void RunBenchmarks(const FString& Filter, float IterationScale, TArray<FCppToolsBenchmarkResult>& OutResults);
+
+    // --- Baselines ---
+
+    /** Gets the baseline file the results are compared against. */
+    static FString GetBaselineFile();
+    /** Loads the baseline results, by benchmark name, and the tolerance allowed before a result counts as a regression. */
+    static bool LoadBaseline(TMap<FString, FCppToolsBenchmarkResult>& OutBaseline, float& OutTolerance);
+    /** Replaces the baseline results with the specified results. */
+    static bool SaveBaseline(const TArray<FCppToolsBenchmarkResult>& Results, float Tolerance);
+    /**
+     * Compares the results against the baseline, returning a description of every regression.
+     * Results missing from the baseline are not regressions and are returned by name in OutMissingBaselines instead.
+     */
+    static TArray<FString> FindRegressions(const TArray<FCppToolsBenchmarkResult>& Results, const TMap<FString, FCppToolsBenchmarkResult>& Baseline,
+        float Tolerance, TArray<FString>& OutMissingBaselines);
+
+    // --- Fixtures ---
+
+    /** Generates a .Build.cs file with the specified number of public and private dependencies. */
+    static FString MakeBuildFileFixture(int32 NumDependencies, bool bWithComments);
+    /** Generates source with comment openers, closers and line comments stacked to the specified depth. */
+    static FString MakeNestedCommentFixture(int32 Depth);
+    /** Generates a block comment full of asterisks that never closes, so the comment scanner runs to the end looking for the closer. */
+    static FString MakeUnterminatedCommentFixture(int32 Length);
+    /** Generates a long string list ending in an unterminated quote, so the list scanner has to give up on the last string cleanly. */
+    static FString MakeUnterminatedStringListFixture(int32 NumStrings);
+    /** Generates a directory tree of plugins, each containing modules with a .Build.cs file. */
+    static bool MakeSyntheticPluginTree(const FString& RootDir, int32 NumPlugins, int32 ModulesPerPlugin, int32 DependenciesPerModule);
+
+private:
+
+    /** Runs the function the specified number of times after a warm up, measuring its time and heap allocations. */
+    static FCppToolsBenchmarkResult Measure(const FString& Name, int32 Iterations, int64 BytesPerIteration, TFunctionRef<void()> Function);
+
+};
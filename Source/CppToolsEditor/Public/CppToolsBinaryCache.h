@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+
+/**
+ * A local cache of compiled module binaries and intermediates. Entries are keyed by a hash of the module's sources,
+ * its .Build.cs file, its resolved dependencies and the engine/toolchain version, so a module whose inputs have not
+ * changed can be restored from the cache instead of being compiled again.
+ */
+class CPPTOOLSEDITOR_API CppToolsBinaryCache
+{
+public:
+
+    /** Checks if the binary cache is enabled. Controlled by [CppTools] bEnableBinaryCache in the editor per project user settings. */
+    static bool IsEnabled();
+
+    /**
+     * Gets the directory the cache stores its entries in. Controlled by [CppTools] BinaryCacheDirectory in the editor per project
+     * user settings, and defaults to a directory in the user's settings folder so it is shared between projects on this machine.
+     */
+    static FString GetCacheDirectory();
+
+    /** Computes the cache key of the specified module. Returns an empty string if the module's .Build.cs file could not be found. */
+    static FString ComputeModuleHash(const FString& ModuleName, TSharedPtr<IPlugin> Target);
+
+    /** Copies the current binaries and intermediates of the specified module into the cache. */
+    static bool StoreModule(const FString& ModuleName, TSharedPtr<IPlugin> Target, FText& OutFailReason);
+
+    /**
+     * Restores the binaries and intermediates of the specified module if the cache contains an entry matching its current hash.
+     * The files are staged next to the module's files and renamed over them, so binaries the editor has loaded are never written to.
+     */
+    static bool TryRestoreModule(const FString& ModuleName, TSharedPtr<IPlugin> Target);
+
+    /**
+     * Restores every project module with stale binaries that has a matching cache entry, and stores every project module whose
+     * binaries are stamped with its current hash that is missing from the cache. Returns the number of modules that were restored.
+     */
+    static int32 SyncProjectModules();
+
+private:
+
+    /** Computes the hash of a module, reusing the hashes of any project modules it depends on that were already computed. */
+    static FString ComputeModuleHash(const FString& ModuleName, TSharedPtr<IPlugin> Target, TMap<FString, FString>& HashedModules);
+
+    /** Finds the plugin containing the specified project module. Returns false if the module is not part of this project. */
+    static bool FindProjectModule(const FString& ModuleName, TSharedPtr<IPlugin>& OutTarget, FString& OutBuildFilePath);
+
+    /** Gets the directory containing the Binaries and Intermediate folders of the specified target. */
+    static FString GetTargetRootDir(const TSharedPtr<IPlugin>& Target);
+
+    /** Gets every binary and intermediate file produced for a module, relative to the target root directory. */
+    static void GatherModuleOutputs(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, TArray<FString>& OutFiles);
+
+    /** Deletes the binaries of a module that restores replaced while they were loaded. */
+    static void DeleteReplacedFiles(const FString& ModuleName, const TSharedPtr<IPlugin>& Target);
+
+    /** Gets the file recording the hash the module's current binaries were built or restored from. */
+    static FString GetModuleStampFile(const FString& ModuleName, const TSharedPtr<IPlugin>& Target);
+
+    /** Checks if the module's binaries were built or restored from the specified hash, the only proof that they match a cache entry. */
+    static bool IsModuleStampCurrent(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, const FString& Hash);
+
+    /**
+     * Checks if the module's binaries are newer than its own sources, for binaries built outside of CppTools that have no stamp. This
+     * says nothing of the dependencies they were built against, so it is only used to leave such binaries alone, never to cache them.
+     */
+    static bool AreModuleBinariesNewerThanSources(const FString& ModuleName, const TSharedPtr<IPlugin>& Target);
+
+    /** Gets the .modules manifest of the running target and configuration in the target's binaries directory. */
+    static FString GetModulesManifestPath(const TSharedPtr<IPlugin>& Target);
+    /** Reads and writes the module's entry in the .modules manifest of the running target and configuration. */
+    static bool GetModulesManifestEntry(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, FString& OutFileName);
+    static bool SetModulesManifestEntry(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, const FString& FileName);
+
+};
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Runs Unreal Build Tool on the project's targets and measures how long builds take. Measurements always build the game target,
+ * since the binaries of the current target are loaded by the running editor or commandlet.
+ */
+class CPPTOOLSEDITOR_API CppToolsBuild
+{
+public:
+
+    /** Gets the target, configuration, platform and project arguments of the project's current target. */
+    static FString GetTargetArguments();
+    /** Gets the arguments that build the current target, configuration and platform of the project. */
+    static FString GetBuildArguments();
+    /**
+     * Gets the target, configuration, platform and project arguments of the project's game target, which no running editor or
+     * commandlet has loaded. Fails if the project has no game target.
+     */
+    static bool GetGameTargetArguments(FString& OutArguments, FText& OutFailReason);
+
+    /** Runs Unreal Build Tool with the build arguments followed by the extra arguments, measuring how long it took. */
+    static bool RunUnrealBuildTool(const FString& ExtraArguments, double& OutSeconds, FText& OutFailReason);
+
+    /**
+     * Runs Unreal Build Tool on the game target with the extra arguments, measuring how long it took. Use this for builds that
+     * must not relink the binaries the running editor or commandlet has loaded. Fails if the project has no game target.
+     */
+    static bool RunGameTargetBuild(const FString& ExtraArguments, double& OutSeconds, FText& OutFailReason);
+
+    /** Builds only the specified modules of the current target, with one -Module argument each. */
+    static bool BuildModules(const TArray<FString>& ModuleNames, double& OutSeconds, FText& OutFailReason);
+
+    /**
+     * Cleans the game target, then measures how long it takes to build it from scratch. The current target is never cleaned,
+     * as its binaries are in use by the running editor or commandlet.
+     */
+    static bool MeasureFullBuild(double& OutSeconds, FText& OutFailReason);
+    /** Touches the specified source files, then measures how long it takes to build the game target. */
+    static bool MeasureIncrementalBuild(const TArray<FString>& ChangedFiles, double& OutSeconds, FText& OutFailReason);
+    /**
+     * Touches the specified source files, then measures how long it takes to build only the specified module of the game target,
+     * less the time Unreal Build Tool takes to find the module up to date.
+     */
+    static bool MeasureModuleBuild(const FString& ModuleName, const TArray<FString>& ChangedFiles, double& OutSeconds, FText& OutFailReason);
+
+private:
+
+    /** Runs Unreal Build Tool with the specified arguments only, measuring how long it took. */
+    static bool RunUnrealBuildToolWithArguments(const FString& Arguments, double& OutSeconds, FText& OutFailReason);
+
+};
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "IDirectoryWatcher.h"
+#include "HAL/PlatformProcess.h"
+
+enum class ECppToolsWatchedModuleState : uint8
+{
+    /** The module has not changed since the watcher started or since it was last built. */
+    UpToDate,
+    /** A source file of the module was saved, and the module will be built once its files stop changing. */
+    Pending,
+    Building,
+    Failed
+};
+
+/** A project or plugin module whose sources the build watcher watches. */
+struct FCppToolsWatchedModule
+{
+    FString Name;
+    /** The plugin owning the module, or NULL for the game project. */
+    TSharedPtr<IPlugin> Plugin;
+    /** The full path of the module's source directory, with a trailing slash. */
+    FString Path;
+    ECppToolsWatchedModuleState State = ECppToolsWatchedModuleState::UpToDate;
+    /** The platform time a source file of the module was last saved at. */
+    double LastChangeTime = 0.0;
+    /** When the module was last built, or the default date if it has not been built since the watcher started. */
+    FDateTime LastBuildTime;
+    double LastBuildSeconds = 0.0;
+    /** The first error Unreal Build Tool reported for the module's last build. */
+    FString Message;
+};
+
+/**
+ * Builds the project and plugin modules whose sources are saved in the background, so their binaries are up to date by the time
+ * the user restarts the editor or triggers a hot reload. The editor has the modules' binaries loaded, so they are linked under new
+ * names with a suffix, the way hot reload does, and the target's .modules manifest points the next editor start to them. The builds
+ * pass -NoHotReloadFromIDE, so they never reload modules into the running editor themselves. Saved files are mapped to their module by its source directory, and once a module's files stop
+ * changing for a moment, every pending module is built by a single Unreal Build Tool run with lowered priority and a bounded
+ * number of parallel actions. Only one build runs at a time; modules saved while it runs are built by the next one.
+ *
+ * The watcher is opt-in, with bEnableBuildWatcher under [CppTools] in EditorPerProjectUserSettings.ini, and BuildWatcherMaxJobs
+ * and BuildWatcherDelaySeconds set the number of parallel actions and how long files must stop changing for.
+ */
+class CPPTOOLSEDITOR_API FCppToolsBuildWatcher
+{
+public:
+
+    ~FCppToolsBuildWatcher();
+
+    static bool IsEnabledInSettings();
+    static void SetEnabledInSettings(bool bEnabled);
+    /** Gets the number of actions Unreal Build Tool may run in parallel, a quarter of the logical cores by default. */
+    static int32 GetMaxJobs();
+    /** Gets how long the files of a module must stop changing for before it is built. */
+    static double GetDelaySeconds();
+
+    /** Indexes the project and plugin modules and starts watching their source directories. */
+    void Start();
+    /** Stops watching and cancels the running build, if any. */
+    void Stop();
+    bool IsRunning() const { return TickerHandle.IsValid(); }
+
+    bool IsBuilding() const { return BuildingModules.Num() > 0; }
+    /**
+     * Builds the pending modules right away and waits for every build to finish, such as before the editor restarts. Returns
+     * whether all of them succeeded.
+     */
+    bool WaitForBuild();
+
+    /** Finds the module whose source directory contains the specified file, or NULL if it is not in a watched module. */
+    TSharedPtr<FCppToolsWatchedModule> FindModuleForFile(const FString& Filename) const;
+
+    /** Gets the watched modules, sorted by name. */
+    const TArray<TSharedPtr<FCppToolsWatchedModule>>& GetModules() const { return Modules; }
+
+    /** Broadcast whenever the state of a module changes or the watcher starts or stops. */
+    FSimpleMulticastDelegate& OnStateChanged() { return StateChangedEvent; }
+
+private:
+
+    void IndexModules();
+    void OnDirectoryChanged(const TArray<FFileChangeData>& Changes);
+    bool Tick(float DeltaTime);
+
+    void StartBuild();
+    /** Reads the output of the running build, recording the errors of each module. */
+    void ReadBuildOutput();
+    void FinishBuild(bool bSucceeded);
+    void CloseBuildProcess();
+
+    TArray<TSharedPtr<FCppToolsWatchedModule>> Modules;
+    /** The watched modules, innermost first, so a file maps to the module nested deepest among those containing it. */
+    TArray<TSharedPtr<FCppToolsWatchedModule>> ModulesByPath;
+
+    /** The watched source directories, with the handle of their callback. */
+    TMap<FString, FDelegateHandle> WatchedDirectories;
+    FDelegateHandle TickerHandle;
+
+    FProcHandle BuildProcess;
+    void* ReadPipe = nullptr;
+    void* WritePipe = nullptr;
+    TArray<TSharedPtr<FCppToolsWatchedModule>> BuildingModules;
+    double BuildStartTime = 0.0;
+    /** The output of the running build that does not end with a line break yet. */
+    FString PartialOutputLine;
+    /** The first error of the running build that is not in the sources of a module, such as a failure of Unreal Build Tool itself. */
+    FString FirstBuildError;
+
+    FSimpleMulticastDelegate StateChangedEvent;
+
+};
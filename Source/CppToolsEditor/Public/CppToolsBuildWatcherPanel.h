@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "Widgets/Views/SHeaderRow.h"
+
+#include "CppToolsBuildWatcher.h"
+
+/**
+ * Turns the background build watcher on and off, and shows the build state of every module it watches.
+ */
+class SCppToolsBuildWatcherPanel : public SCompoundWidget
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsBuildWatcherPanel)
+        : _Watcher(nullptr)
+    {}
+
+    /** The watcher to show, which must outlive this widget. */
+    SLATE_ARGUMENT(FCppToolsBuildWatcher*, Watcher)
+
+    SLATE_END_ARGS()
+
+    virtual ~SCppToolsBuildWatcherPanel();
+
+    /** Constructs this widget with InArgs */
+    void Construct(const FArguments& InArgs);
+
+private:
+
+    /** Copies the modules of the watcher into the list. */
+    void Refresh();
+
+    void OnEnabledChanged(ECheckBoxState NewState);
+    FText GetSummaryText() const;
+
+    /** Create the widget to use as the row for the given module */
+    TSharedRef<ITableRow> MakeModuleRow(TSharedPtr<FCppToolsWatchedModule> Module, const TSharedRef<STableViewBase>& OwnerTable);
+
+
+    FCppToolsBuildWatcher* Watcher;
+    FDelegateHandle StateChangedHandle;
+
+    TSharedPtr<SListView<TSharedPtr<FCppToolsWatchedModule>>> ModuleList;
+
+    TArray<TSharedPtr<FCppToolsWatchedModule>> Modules;
+
+};
@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Dom/JsonObject.h"
+
+#include "CppToolsScaleTest.h"
+
+#include "CppToolsCommandlet.generated.h"
+
+/**
+ * Runs CppTools operations without the editor UI, for use on build machines.
+ *
+ * Operations can be passed on the command line:
+ *     UE4Editor-Cmd <Project> -run=CppTools -Operation=GenerateModule -Name=MyModule -Type=Runtime -nullrhi -unattended
+ * or as a JSON file containing an "Operations" array of objects with the same keys:
+ *     UE4Editor-Cmd <Project> -run=CppTools -Input=Operations.json -Output=Results.json -nullrhi -unattended
+ *
+ * The results are written as JSON to the -Output file, or to stdout if no output file is specified.
+ * The commandlet returns 0 if every operation succeeded.
+ */
+UCLASS()
+class UCppToolsCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UCppToolsCommandlet();
+
+    //~ Begin UCommandlet Interface
+    virtual int32 Main(const FString& Params) override;
+    //~ End UCommandlet Interface
+
+private:
+
+    typedef bool (UCppToolsCommandlet::*FOperation)(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+
+    /** Runs a single operation, storing its results and any errors in OutResult. */
+    bool RunOperation(const TSharedRef<FJsonObject>& Arguments, FJsonObject& OutResult);
+
+    /**
+     * Creates new modules. Arguments: Name (comma separated for multiple modules), Plugin, Type, LoadingPhase, UsePCH, FwdHeader, LLMTag,
+     * Template (Basic or HighPerformanceRuntime).
+     */
+    bool GenerateModule(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /** Adds a public dependency to a module. Arguments: Module, Plugin, Dependency, Private. */
+    bool AddDependency(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Applies a dependency change to the .Build.cs file of every matching module and reports a unified diff of the edits, which
+     * are only written with Apply. Arguments: Change (Add, Remove, Move or Replace), Dependency, Replacement, Private, Type, Module, Apply.
+     */
+    bool RefactorDependencies(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /** Adds a module to the project's primary target. Arguments: Module, Editor. */
+    bool UpdateTargets(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /** Reports the project's modules and their dependencies. Arguments: Module (comma separated, optional), Plugin. */
+    bool Analyze(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Regenerates forward declaration headers. Arguments: Module (comma separated, optional), Plugin.
+     * Without a Module, every module that already has a forward declaration header is updated.
+     */
+    bool UpdateFwdHeaders(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Finds the modules built by the project's targets that are unreachable from their roots, or only reachable through
+     * dependencies that are never included, and optionally removes them from the targets, .Build.cs files and descriptors.
+     * Arguments: Roots, Cleanup, RemoveUnusedDependencies.
+     */
+    bool FindDeadModules(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Works out which of the project's targets need each module on a platform, reporting the modules that targets list in
+     * ExtraModuleNames without needing them and the dependencies that pull modules into targets that should not build them.
+     * The misplaced modules are removed from every .Target.cs file in one transaction with Apply. Arguments: Platform, Apply.
+     */
+    bool AnalyzeTargets(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Counts the symbols each module's Linux shared object exports and how many no other module imports, and proposes how to
+     * narrow the classes exported as a whole through their API macro. Arguments: Module (comma separated, optional), Plugin,
+     * Platform, MaxReferencedFraction.
+     */
+    bool AuditExports(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Estimates the load cost of every module's Linux shared object and finds clusters of small, tightly coupled modules worth
+     * merging, optionally merging the clusters containing the modules passed with Merge. Arguments: Platform, MaxCodeBytes,
+     * MillisecondsPerModule, MicrosecondsPerRelocation, MicrosecondsPerImport, Merge.
+     */
+    bool ConsolidateModules(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Reconciles the project with a module manifest, reporting a unified diff of the edits, which are only written with Apply,
+     * after which only the changed modules are built unless Build is false. With Capture, the manifest is written from the
+     * project as it is instead. Arguments: Manifest, Capture, Apply, Build.
+     */
+    bool ReconcileManifest(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Chooses unity build settings for every module from the git history, and optionally writes them and measures full and
+     * incremental build times before and after. Measurements build the game target, never the running editor target.
+     * Arguments: Days, MinEdits, HotFraction, ColdMinFiles, Apply, Measure, TouchFiles.
+     */
+    bool ConfigureUnity(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Generates, regenerates or removes the private precompiled header of every module from the stable headers its source files
+     * include most, keeping it only if a measured build shows it saves time.
+     * Arguments: Module, Plugin, Days, MinEdits, MinIncludeFraction, MaxHeaders, MinSourceFiles, MaxDrift, MinBuildGain.
+     */
+    bool UpdatePCH(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Converts modules that rely on monolithic headers to include-what-you-use, reporting a unified diff of the edits, which are
+     * only written with Apply, and optionally checking that every header compiles on its own and measuring the build time before
+     * and after. Arguments: Module, Plugin, Apply, CheckHeaders, Measure, MonolithicHeaders.
+     */
+    bool ConvertToIWYU(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Computes the critical path of the build from the module dependency graph and the estimated or measured build time of each
+     * module, the build time with each number of cores, and which modules on the critical path are worth splitting.
+     * Arguments: Measure, Cores, TargetCores, SplitParts, MinSplitFraction, MaxSuggestions, SecondsPerKilobyte.
+     */
+    bool CriticalPath(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Reports the compile time, most expensive headers and most expensive template instantiations of each module from the clang
+     * -ftime-trace files in the intermediate directories, optionally rebuilding with -ftime-trace first. Arguments: Build, Module, Top.
+     */
+    bool TimeTrace(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Benchmarks the text and file routines and fails if any regressed against the baseline.
+     * Arguments: Filter, IterationScale, Tolerance, UpdateBaseline.
+     */
+    bool Benchmark(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Generates a synthetic project of plugins and modules.
+     * Arguments: Plugins, ModulesPerPlugin, Shape (Chain, Tree or RandomDAG), MaxDependencies, FilesPerModule, LinesPerFile, Seed, Root.
+     */
+    bool GenerateSyntheticProject(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+    /**
+     * Times the plugin's operations against synthetic projects of increasing size and writes the measurements as CSV.
+     * Arguments: the same as GenerateSyntheticProject, with Plugins as a comma separated list of sizes, and Csv.
+     */
+    bool ScaleTest(const FJsonObject& Arguments, FJsonObject& OutResult, FText& OutFailReason);
+
+    /** Reads a string, list or boolean argument, which may be passed as a JSON value or as a command line string. */
+    static FString GetStringArgument(const FJsonObject& Arguments, const FString& Name, const FString& Default = FString());
+    static TArray<FString> GetListArgument(const FJsonObject& Arguments, const FString& Name);
+    static bool GetBoolArgument(const FJsonObject& Arguments, const FString& Name, bool bDefault = false);
+    static double GetNumberArgument(const FJsonObject& Arguments, const FString& Name, double Default = 0.0);
+
+    /** Gets the plugin specified by the Plugin argument. Returns false if a plugin was specified but could not be found. */
+    static bool GetTargetArgument(const FJsonObject& Arguments, TSharedPtr<IPlugin>& OutTarget, FText& OutFailReason);
+    /** Gets the synthetic project settings specified by the arguments, other than the number of plugins. */
+    static bool GetSyntheticProjectArguments(const FJsonObject& Arguments, FCppToolsSyntheticProjectSettings& OutSettings, FText& OutFailReason);
+
+    /** The operations this commandlet supports, by name. */
+    TMap<FString, FOperation> Operations;
+
+};
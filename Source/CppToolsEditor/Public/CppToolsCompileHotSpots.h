@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+#include "CppToolsTimeTrace.h"
+
+/**
+ * Shows the compile time of each module from its clang time traces, with the most expensive headers and template
+ * instantiations of the selected module.
+ */
+class SCppToolsCompileHotSpots : public SCompoundWidget
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsCompileHotSpots)
+        : _MaxEntries(25)
+    {}
+
+    /** The number of headers and templates to show per module. */
+    SLATE_ARGUMENT(int32, MaxEntries)
+
+    SLATE_END_ARGS()
+
+    /** Constructs this widget with InArgs */
+    void Construct(const FArguments& InArgs);
+
+private:
+
+    /** Reloads the traces from the intermediate directories. */
+    void Refresh();
+
+    /** Handler for when refresh is clicked */
+    FReply RefreshClicked();
+    /** Handler for when build is clicked */
+    FReply BuildClicked();
+    /** Handler for when a module is selected */
+    void OnModuleSelected(TSharedPtr<FCppToolsModuleCompileProfile> Module, ESelectInfo::Type SelectInfo);
+
+    /** Create the widget to use as the row for the given module */
+    TSharedRef<ITableRow> MakeModuleRow(TSharedPtr<FCppToolsModuleCompileProfile> Module, const TSharedRef<STableViewBase>& OwnerTable);
+    /** Create the widget to use as the row for the given header or template */
+    TSharedRef<ITableRow> MakeEntryRow(TSharedPtr<FCppToolsTimeTraceEntry> Entry, const TSharedRef<STableViewBase>& OwnerTable);
+
+
+    int32 MaxEntries;
+
+    TSharedPtr<SListView<TSharedPtr<FCppToolsModuleCompileProfile>>> ModuleList;
+    TSharedPtr<SListView<TSharedPtr<FCppToolsTimeTraceEntry>>> HeaderList;
+    TSharedPtr<SListView<TSharedPtr<FCppToolsTimeTraceEntry>>> TemplateList;
+
+    TArray<TSharedPtr<FCppToolsModuleCompileProfile>> Modules;
+    TArray<TSharedPtr<FCppToolsTimeTraceEntry>> Headers;
+    TArray<TSharedPtr<FCppToolsTimeTraceEntry>> Templates;
+
+};
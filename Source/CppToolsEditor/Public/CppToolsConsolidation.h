@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "ModuleDescriptor.h"
+
+#include "CppToolsExportAudit.h"
+#include "CppToolsModuleGraph.h"
+
+/** The options of finding modules to merge, and the model estimating what loading a module costs when the editor starts. */
+struct FCppToolsConsolidationSettings
+{
+    /** The platform whose shared objects are read, which names the directory of the binaries. */
+    FString Platform = TEXT("Linux");
+    /** Modules with more code than this are not small enough to merge. */
+    int64 MaxCodeBytes = 256 * 1024;
+    /** The fixed cost of a module: opening its shared object, registering it with the module manager and starting it up. */
+    double MillisecondsPerModule = 1.0;
+    /** The cost of each dynamic relocation the loader applies. */
+    double MicrosecondsPerRelocation = 0.05;
+    /** The cost of resolving each symbol imported from another shared object, which searches the ones already loaded. */
+    double MicrosecondsPerImport = 0.5;
+};
+
+/** What loading a module's shared object costs, from its measured size and symbol tables. */
+struct FCppToolsModuleLoadCost
+{
+    FString ModuleName;
+    FString Binary;
+    FCppToolsElfLoadInfo LoadInfo;
+    int32 NumImports = 0;
+    int32 NumExports = 0;
+    double EstimatedMilliseconds = 0.0;
+};
+
+/** Small modules of the same owner, host type and loading phase that depend on each other and can be merged into one. */
+struct FCppToolsModuleCluster
+{
+    /** The module the others are merged into, which the most modules of the cluster depend on. */
+    FString TargetModule;
+    /** Every module of the cluster, including the target module. */
+    TArray<FString> Modules;
+    TSharedPtr<IPlugin> Plugin;
+    EHostType::Type Type = EHostType::Runtime;
+    ELoadingPhase::Type LoadingPhase = ELoadingPhase::Default;
+    int64 CodeBytes = 0;
+    /** The symbols the modules import from each other, which merging binds when linking instead of when loading. */
+    int32 NumInternalImports = 0;
+    double EstimatedSavingsMilliseconds = 0.0;
+};
+
+/** The load cost of every built module of the project and the clusters worth merging. */
+struct FCppToolsConsolidationReport
+{
+    TMap<FString, FCppToolsModuleNode> Modules;
+    /** The modules with a shared object, most expensive first. */
+    TArray<FCppToolsModuleLoadCost> LoadCosts;
+    double TotalMilliseconds = 0.0;
+    /** The clusters, largest savings first. */
+    TArray<FCppToolsModuleCluster> Clusters;
+};
+
+/**
+ * Every module is a shared object of its own, so editor startup pays for opening, relocating and starting each of them. Finds
+ * clusters of small, tightly coupled modules that load together anyway, estimates what merging each saves, and merges them by
+ * moving their sources into one module and rewriting the .Build.cs, .Target.cs and descriptor entries that refer to them.
+ */
+class CPPTOOLSEDITOR_API CppToolsConsolidation
+{
+public:
+
+    /**
+     * Reads the shared object of every project and plugin module in parallel and estimates its load cost, then clusters the
+     * small modules connected by used dependencies that share a plugin, host type, loading phase and platforms. Clusters that
+     * would form a dependency cycle with another module once merged are left out, as are modules with startup code.
+     */
+    static FCppToolsConsolidationReport Analyze(const FCppToolsConsolidationSettings& Settings);
+
+    /** Finds the cluster containing a module. Returns null if the module is not part of one. */
+    static const FCppToolsModuleCluster* FindCluster(const FCppToolsConsolidationReport& Report, const FString& ModuleName);
+
+    /**
+     * Merges the modules of a cluster into its target module in a single transaction. Their sources move into the target module,
+     * keeping their paths relative to the module directory, with their API macros renamed and IMPLEMENT_MODULE removed. Their
+     * dependencies are added to the target module, the modules depending on them depend on the target module instead, and they
+     * are replaced by it in ExtraModuleNames. Their entries are removed from the descriptors, and the script packages of modules
+     * declaring reflected types are redirected to the target module's in DefaultEngine.ini.
+     */
+    static bool MergeCluster(const FCppToolsConsolidationReport& Report, const FCppToolsModuleCluster& Cluster, FText& OutFailReason);
+
+};
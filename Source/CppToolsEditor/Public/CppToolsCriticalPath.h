@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A project module as a task of the build, which can start once the modules it depends on are built. */
+struct FCppToolsModuleBuildTask
+{
+    FString Name;
+    FString Path;
+    /** How long the module takes to compile and link, measured or estimated from the size of its sources. */
+    double Seconds = 0.0;
+    bool bMeasured = false;
+    /** The project modules that are built before this one. */
+    TArray<FString> Dependencies;
+    /** The earliest time the module can be finished with unlimited cores. */
+    double EarliestFinish = 0.0;
+};
+
+/** How long the build takes with a number of cores. */
+struct FCppToolsParallelism
+{
+    int32 Cores = 1;
+    double Seconds = 0.0;
+    /** The speedup over building with a single core. */
+    double Speedup = 1.0;
+    /** The fraction of the time the cores are busy. */
+    double Efficiency = 1.0;
+};
+
+/** The projected effect of splitting a module on the critical path into independent modules. */
+struct FCppToolsSplitSuggestion
+{
+    FString ModuleName;
+    double ModuleSeconds = 0.0;
+    int32 Parts = 2;
+    double SecondsBefore = 0.0;
+    double SecondsAfter = 0.0;
+
+    double GetProjectedSpeedup() const { return SecondsAfter > 0.0 ? SecondsBefore / SecondsAfter : 1.0; }
+};
+
+struct FCppToolsCriticalPathSettings
+{
+    /** The core counts to show the build time for. */
+    TArray<int32> Cores = { 1, 2, 4, 8, 16, 32 };
+    /** The core count split suggestions are projected for. */
+    int32 TargetCores = 8;
+    /** The number of modules an oversized module is split into. */
+    int32 SplitParts = 2;
+    /** The fraction of the critical path a module must take to be suggested for splitting. */
+    float MinSplitFraction = 0.2f;
+    int32 MaxSuggestions = 5;
+    /** The compile time per kilobyte of source used to estimate modules that were not measured. */
+    double SecondsPerKilobyte = 0.05;
+};
+
+struct FCppToolsCriticalPathReport
+{
+    TMap<FString, FCppToolsModuleBuildTask> Tasks;
+    /** The longest chain of dependent modules, from the first built to the last. */
+    TArray<FString> CriticalPath;
+    double CriticalPathSeconds = 0.0;
+    /** The total time of every module, which is the build time with a single core. */
+    double TotalSeconds = 0.0;
+    TArray<FCppToolsParallelism> Parallelism;
+    TArray<FCppToolsSplitSuggestion> Suggestions;
+};
+
+/**
+ * Combines the module dependency graph of the project with the time each module takes to build to find the critical path of
+ * the build, how well it uses a number of cores, and which oversized modules on the critical path are worth splitting.
+ */
+class CPPTOOLSEDITOR_API CppToolsCriticalPath
+{
+public:
+
+    /** Reads the project and plugin modules with their dependencies, estimating their build times from the size of their sources. */
+    static TMap<FString, FCppToolsModuleBuildTask> ReadBuildTasks(double SecondsPerKilobyte);
+    /** Measures the build time of each module by touching its source files and building it on its own. */
+    static bool MeasureBuildTasks(TMap<FString, FCppToolsModuleBuildTask>& Tasks, FText& OutFailReason);
+
+    /** Simulates building the tasks with a number of cores, always starting the ready task with the longest path after it. */
+    static double Schedule(const TMap<FString, FCppToolsModuleBuildTask>& Tasks, int32 Cores);
+
+    /** Computes the critical path, the build time with each number of cores and the split suggestions. */
+    static FCppToolsCriticalPathReport Analyze(const TMap<FString, FCppToolsModuleBuildTask>& Tasks, const FCppToolsCriticalPathSettings& Settings);
+
+private:
+
+    /** Orders the tasks so every task comes after its dependencies, ignoring the dependencies that form cycles. */
+    static TArray<FString> SortTopologically(const TMap<FString, FCppToolsModuleBuildTask>& Tasks);
+
+};
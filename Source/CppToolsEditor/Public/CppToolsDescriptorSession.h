@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "ProjectDescriptor.h"
+
+class FCppToolsFileTransaction;
+
+/**
+ * Edits the .uproject file and the .uplugin files of the project's plugins. Each descriptor is loaded the first time it is
+ * edited and its modules are indexed by name, any number of edits are applied in memory, and every changed descriptor is saved
+ * once when the session is committed, after which the module caches are reset once.
+ */
+class CPPTOOLSEDITOR_API FCppToolsDescriptorSession
+{
+public:
+
+    /** Applies a modification to the .uproject file. The modifier returns true if it changed the descriptor. */
+    bool ModifyProject(TFunctionRef<bool(FProjectDescriptor&)> Modifier, FText& OutFailReason);
+    /** Applies a modification to the .uplugin file of a project plugin. The modifier returns true if it changed the descriptor. */
+    bool ModifyPlugin(const TSharedPtr<IPlugin>& Plugin, TFunctionRef<bool(FPluginDescriptor&)> Modifier, FText& OutFailReason);
+
+    /**
+     * Adds modules to the .uproject file, or to the .uplugin file of the specified plugin, that it does not list yet. Each module
+     * becomes an additional dependency of the descriptor's primary game or editor module, if it has one.
+     */
+    bool AppendModules(const TSharedPtr<IPlugin>& Plugin, const TArray<FModuleDescriptor>& Modules, FText& OutFailReason);
+    /** Removes modules from the .uproject file and the .uplugin files of the project's plugins, along with any additional dependencies on them. */
+    bool RemoveModules(const TArray<FString>& ModuleNames, FText& OutFailReason);
+
+    /** Gets the modules listed by the .uproject file, or by the .uplugin file of the specified plugin, including edits not committed yet. */
+    const TArray<FModuleDescriptor>* GetModules(const TSharedPtr<IPlugin>& Plugin, FText& OutFailReason);
+    /** Gets the descriptor files that were changed and are saved on commit. */
+    TArray<FString> GetModifiedFiles() const;
+    /**
+     * Saves every changed descriptor. If a transaction is passed, the descriptors are backed up into its journal first so
+     * rolling it back restores them.
+     */
+    bool Commit(FText& OutFailReason, FCppToolsFileTransaction* Transaction = nullptr);
+
+private:
+
+    /** A loaded descriptor with the index of each of its modules by name. */
+    struct FOpenDescriptor
+    {
+        FString Filename;
+        /** The plugin the descriptor belongs to, or null for the .uproject file. */
+        TSharedPtr<IPlugin> Plugin;
+        FProjectDescriptor ProjectDescriptor;
+        FPluginDescriptor PluginDescriptor;
+        TMap<FName, int32> ModuleIndices;
+        bool bModified = false;
+
+        TArray<FModuleDescriptor>& GetModules() { return Plugin.IsValid() ? PluginDescriptor.Modules : ProjectDescriptor.Modules; }
+    };
+
+    /** Gets the descriptor of the specified plugin, or of the project for null, loading it if it was not loaded yet. */
+    FOpenDescriptor* Open(const TSharedPtr<IPlugin>& Plugin, FText& OutFailReason);
+    /** Rebuilds the module index of a descriptor after its modules were changed. */
+    static void IndexModules(FOpenDescriptor& Descriptor);
+
+    /** The loaded descriptors, by file name. */
+    TMap<FString, FOpenDescriptor> Descriptors;
+
+};
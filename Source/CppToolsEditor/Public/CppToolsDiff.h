@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Containers/StringView.h"
+
+/**
+ * Compares versions of a text file line by line, to preview the edits made to existing files before they are written.
+ */
+class CPPTOOLSEDITOR_API CppToolsDiff
+{
+public:
+
+    /** Splits text into lines without their line terminators. The lines point into the text. */
+    static void SplitLines(const FString& Text, TArray<FStringView>& OutLines);
+
+    /**
+     * Makes a unified diff of two versions of a file, with the specified number of unchanged lines around each change.
+     * Returns an empty string if the versions are equal.
+     */
+    static FString MakeUnifiedDiff(const FString& Filename, const FString& OldContents, const FString& NewContents, int32 ContextLines = 3);
+
+};
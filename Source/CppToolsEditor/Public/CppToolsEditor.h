@@ -7,6 +7,7 @@
 #include "Interfaces/IMainFrameModule.h"
 
 #include "CreateModuleDialog.h"
+#include "CppToolsBuildWatcher.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(CppToolsLog, Log, All);
 
@@ -22,7 +23,14 @@ private:
 	void AddMenuEntry(FMenuBuilder& MenuBuilder);
 
 	void OnNewCppModule();
+	void OnUpdateFwdHeaders();
+	void OnShowRefactorDependencies();
+	void OnShowIWYUWizard();
 	void RestartEditor();
+	void OnShowTraceHistory();
+	void OnShowCompileHotSpots();
+	void OnShowBuildWatcher();
+	void OnShowMemoryReport();
 
     void CreateNewModule(FString Name, FCreateModuleTarget Target, EHostType::Type Type);
 
@@ -30,4 +38,7 @@ private:
 
     TSharedPtr<SWindow> CreateModuleWindow;
 
+    /** Builds edited modules in the background while it is enabled. */
+    TUniquePtr<FCppToolsBuildWatcher> BuildWatcher;
+
 };
\ No newline at end of file
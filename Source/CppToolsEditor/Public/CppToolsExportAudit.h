@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+
+/** A symbol of the dynamic symbol table of an ELF shared object. */
+struct FCppToolsElfSymbol
+{
+    FString Name;
+    /** Whether the shared object defines and exports the symbol, rather than importing it from another one. */
+    bool bDefined = false;
+};
+
+/** What loading an ELF shared object costs the dynamic loader, read from its section headers. */
+struct FCppToolsElfLoadInfo
+{
+    int64 FileBytes = 0;
+    /** The size of the executable sections. */
+    int64 CodeBytes = 0;
+    /** The relocations the dynamic loader applies when it loads the shared object. */
+    int64 NumRelocations = 0;
+};
+
+/** The options of auditing the exported symbols of modules. */
+struct FCppToolsExportAuditSettings
+{
+    /** The platform whose shared objects are read, which names the directory of the binaries. */
+    FString Platform = TEXT("Linux");
+    /** The largest fraction of a class's exports that other modules may reference for exporting them one by one to be proposed. */
+    float MaxReferencedFraction = 0.25f;
+};
+
+/** A class that a module exports as a whole by putting its API macro on the class. */
+struct FCppToolsExportedClass
+{
+    FString Name;
+    /** The header declaring the class, relative to the module directory. */
+    FString Header;
+    /** Whether the class is a UCLASS, which can be narrowed to MinimalAPI. */
+    bool bReflected = false;
+    int32 NumExports = 0;
+    /** The exports of the class that other modules import. */
+    int32 NumReferencedExports = 0;
+    /** The exported members of the class that other modules reference. */
+    TArray<FString> ReferencedMembers;
+    /**
+     * How to narrow the exports: Unexport to remove the API macro, MinimalAPI to make the UCLASS MinimalAPI, PerFunction to move
+     * the API macro onto the referenced members, or Keep.
+     */
+    FString Proposal;
+};
+
+/** The exported symbols of a module's shared object. */
+struct FCppToolsModuleExports
+{
+    FString ModuleName;
+    FString Binary;
+    int32 NumExports = 0;
+    /** The exported C++ symbols that none of the other modules import. */
+    int32 NumUnreferencedExports = 0;
+    /** The classes the module exports as a whole, with the most exports first. */
+    TArray<FCppToolsExportedClass> Classes;
+};
+
+/**
+ * Audits what the project's modules export, by reading the dynamic symbol tables of their Linux shared objects together with
+ * their headers. Exports that no other module imports bloat the symbol tables and slow down linking and loading the modules,
+ * so classes exporting everything through their API macro are proposed to export less.
+ */
+class CPPTOOLSEDITOR_API CppToolsExportAudit
+{
+public:
+
+    /** Reads the dynamic symbol table of an ELF shared object, leaving out local and hidden symbols. Only 64 bit files are read. */
+    static bool ReadDynamicSymbols(const FString& Filename, TArray<FCppToolsElfSymbol>& OutSymbols, FText& OutFailReason);
+    /** Reads the code size and number of dynamic relocations of an ELF shared object. */
+    static bool ReadLoadInfo(const FString& Filename, FCppToolsElfLoadInfo& OutInfo, FText& OutFailReason);
+
+    /**
+     * Gets the classes enclosing a symbol and the name of the member it is from its Itanium mangled name. Constructors are named
+     * after their class, destructors with a leading ~, and vtables and type information are named vtable and typeinfo. Returns
+     * false for names that are not mangled or use substitutions.
+     */
+    static bool ParseMangledName(const FString& Symbol, TArray<FString>& OutScope, FString& OutMember);
+
+    /** Parses the classes that the contents of a header export as a whole with the specified API macro, and whether each is a UCLASS. */
+    static TArray<TPair<FString, bool>> ParseExportedClasses(const FString& HeaderContents, const FString& APIMacro);
+
+    /** Finds the newest shared object of a module built for the platform, or an empty string if it was not built. */
+    static FString FindModuleBinary(const FString& ModuleName, const TSharedPtr<IPlugin>& Target, const FString& Platform);
+
+    /**
+     * Reads the shared objects of every project and plugin module in parallel and audits the exports of the modules in the filter,
+     * or of every module if it is empty. Symbols count as referenced if the shared object of any other module imports them.
+     */
+    static TArray<FCppToolsModuleExports> AuditModules(const TArray<FString>& ModuleFilter, const FCppToolsExportAuditSettings& Settings);
+
+};
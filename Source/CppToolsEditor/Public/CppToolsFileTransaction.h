@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A file created or modified by a transaction. */
+struct FCppToolsStagedFile
+{
+    FString Filename;
+    /** The contents the file is written with when the transaction is committed. */
+    FString Contents;
+    /** Whether the file is created by the transaction, rather than replacing an existing file. */
+    bool bCreate = false;
+    /** Whether the file is deleted by the transaction, in which case it is backed up but not written. */
+    bool bDelete = false;
+    /** When the replaced file was last written at the time it was staged, to detect changes made outside the transaction. */
+    FDateTime TimeStamp;
+};
+
+/**
+ * Collects file creations, modifications and deletions in memory and writes them in one pass when committed. Every file is written to
+ * a temporary file next to it and then renamed over it, and a journal backing up the replaced files is kept until the
+ * transaction is finished, so all of its changes can be rolled back. Journals left behind by an editor that stopped before
+ * finishing a transaction are rolled back the next time it starts.
+ */
+class CPPTOOLSEDITOR_API FCppToolsFileTransaction
+{
+public:
+
+    /** Stages the creation of a file. Fails if the file already exists or was already staged. */
+    bool StageCreate(const FString& Filename, const FString& Contents, FText& OutFailReason);
+    /**
+     * Stages a modification of a file, reading it the first time it is staged. The modifier returns true if it changed the
+     * contents; a file that was never changed is not written.
+     */
+    bool StageModify(const FString& Filename, TFunctionRef<bool(FString&)> Modifier, FText& OutFailReason);
+    /**
+     * Stages the replacement of a file that was already read and edited, such as by a bulk edit running on several threads.
+     * The time stamp is when the file was last written at the time it was read, so changes made since then fail the commit.
+     */
+    bool StageReplace(const FString& Filename, const FString& Contents, const FDateTime& TimeStamp, FText& OutFailReason);
+    /** Stages the deletion of a file, such as the old location of a moved file. Fails if the file does not exist or was already staged. */
+    bool StageDelete(const FString& Filename, FText& OutFailReason);
+    /**
+     * Backs up a file that is about to be written by something other than the transaction, such as a descriptor saved by the
+     * engine, so rolling back restores it.
+     */
+    bool BackupExternalWrite(const FString& Filename, FText& OutFailReason);
+
+    /** Checks that the staged files can still be written: created files must not exist and modified files must not have changed. */
+    bool Validate(FText& OutFailReason) const;
+    /** Validates and writes every staged file. If any file fails to be written, the files written so far are rolled back. */
+    bool Commit(FText& OutFailReason);
+    /** Undoes every change made by the transaction, deleting the created files and restoring the replaced files. */
+    bool Rollback(FText& OutFailReason);
+    /** Deletes the journal, after which the changes can no longer be rolled back. */
+    void Finish();
+
+    /** Gets the files the transaction created, or will create when committed. */
+    TArray<FString> GetCreatedFiles() const;
+    bool IsCommitted() const { return bCommitted; }
+
+    /** Gets the directory the journals of unfinished transactions are kept in. */
+    static FString GetJournalRootDirectory();
+    /** Rolls back every transaction that was left unfinished. Returns the number of transactions that were rolled back. */
+    static int32 RecoverUnfinishedTransactions();
+
+private:
+
+    /** A file the journal can restore, with the name of its backup within the journal directory, or empty if it was created. */
+    struct FJournalEntry
+    {
+        FString Filename;
+        FString Backup;
+    };
+
+    /** Creates the journal directory if it does not exist yet. */
+    bool OpenJournal(FText& OutFailReason);
+    /** Backs up a file into the journal, or records that it is created if it does not exist. */
+    bool AddJournalEntry(const FString& Filename, FText& OutFailReason);
+    /** Writes the journal file, which lists the entries and the directories to delete on rollback. */
+    bool WriteJournal(FText& OutFailReason) const;
+    /** Restores the files recorded in a journal and deletes the journal. */
+    static bool RollbackJournal(const FString& JournalDirectory, FText& OutFailReason);
+
+    /** Gets the temporary file a staged file is written to before it is renamed. */
+    static FString GetTemporaryFilename(const FString& Filename);
+
+    TArray<FCppToolsStagedFile> StagedFiles;
+
+    FString JournalDirectory;
+    TArray<FJournalEntry> JournalEntries;
+    /** Directories created by the transaction, deleted on rollback if they are empty. */
+    TArray<FString> CreatedDirectories;
+
+    bool bCommitted = false;
+
+};
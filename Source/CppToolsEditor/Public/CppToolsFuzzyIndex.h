@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Matches typed queries against a fixed set of names and categories, such as the targets of a picker. Everything a query does
+ * not depend on is prepared when entries are added, so filtering only scans lower case characters and is cheap enough to run
+ * on every keystroke.
+ */
+struct CPPTOOLSEDITOR_API FCppToolsFuzzyIndex
+{
+    /** Adds an entry and returns its index, which entries are counted from in the order they are added. */
+    int32 Add(const FString& Name, const FString& Category);
+    void Reset();
+
+    /**
+     * Finds the entries whose name or category contains the characters of the query in order, best match first. A match scores
+     * higher for consecutive characters, characters starting a word and matching the name rather than the category. An empty
+     * query matches every entry in the order they were added. If candidates are specified, only those are searched, which
+     * narrows the matches of a shorter query down as the query is typed.
+     */
+    void Filter(const FString& Query, TArray<int32>& OutMatches, const TArray<int32>* Candidates = nullptr) const;
+
+    /** Scores how well a query matches a string, or returns a negative score if it does not contain the characters of the query in order. */
+    static int32 Score(const FString& LowerQuery, const FString& LowerText, const TArray<bool>& WordStarts);
+
+    int32 Num() const { return Entries.Num(); }
+
+private:
+
+    struct FEntry
+    {
+        FString Name;
+        FString Category;
+        TArray<bool> NameWordStarts;
+        TArray<bool> CategoryWordStarts;
+        /** The characters appearing in the name or category, so entries lacking a character of the query are skipped without scanning them. */
+        uint64 CharacterMask = 0;
+    };
+
+    TArray<FEntry> Entries;
+};
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+
+#include "CppToolsRefactor.h"
+
+struct FCppToolsHeaderIndex;
+
+/** The options of converting a module to include-what-you-use. */
+struct FCppToolsIWYUSettings
+{
+    /** The headers that include whole modules, which are replaced by the headers declaring what each file uses. */
+    TArray<FString> MonolithicHeaders = { TEXT("Engine.h"), TEXT("EngineMinimal.h"), TEXT("UnrealEd.h"), TEXT("CoreUObject.h"), TEXT("Core.h") };
+};
+
+/**
+ * Maps the types, macros and globals declared by the headers that the monolithic headers include to the include path of the
+ * header declaring each, so uses of them can be replaced by specific includes.
+ */
+struct CPPTOOLSEDITOR_API FCppToolsSymbolIndex
+{
+    /**
+     * Indexes every header included, directly or not, by the monolithic headers. The headers are parsed in parallel, one level
+     * of includes at a time. Symbols declared by the headers CoreMinimal.h includes map to CoreMinimal.h.
+     */
+    void Build(const TArray<FString>& MonolithicHeaders, const FCppToolsHeaderIndex& HeaderIndex);
+    /** Gets the include path of the header declaring a symbol, or null if the symbol is not indexed. */
+    const FString* FindInclude(const FString& Symbol) const;
+
+    int32 Num() const { return Includes.Num(); }
+
+private:
+
+    /** The include paths of the declaring headers, by symbol. */
+    TMap<FString, FString> Includes;
+};
+
+/** The outcome of converting a module to include-what-you-use. */
+struct FCppToolsIWYUResult
+{
+    FString ModuleName;
+    /** The edits of the module's source files and .Build.cs file. */
+    TArray<FCppToolsFileEdit> Edits;
+    /** Whether the headers were compiled on their own. */
+    bool bCheckedHeaders = false;
+    int32 NumCheckedHeaders = 0;
+    /** The headers of the module that do not compile on their own, relative to the module directory. */
+    TArray<FString> NonSelfContainedHeaders;
+    /** Whether the module failed to build without precompiled headers and unity builds for reasons other than its headers. */
+    bool bSourcesFailed = false;
+    /** The module's build time before and after the conversion, if measured. */
+    double SecondsBefore = 0.0;
+    double SecondsAfter = 0.0;
+};
+
+/**
+ * Converts legacy modules that rely on monolithic includes such as Engine.h to include-what-you-use: every monolithic include
+ * is replaced with the headers declaring the symbols the file uses, and the module switches to explicit or shared precompiled
+ * headers with bEnforceIWYU. The module's headers are then compiled on their own to check that each is self-contained.
+ */
+class CPPTOOLSEDITOR_API CppToolsIWYU
+{
+public:
+
+    /**
+     * Parses the symbols declared at namespace scope in the contents of a header: defined classes, structs, enums and unions,
+     * typedefs and aliases, namespaces, macros and extern globals.
+     */
+    static TArray<FString> ParseDeclaredSymbols(const FString& HeaderContents);
+    /**
+     * Parses the identifiers the contents of a source file use outside of comments, literals and preprocessor directives. Members
+     * accessed through ., -> or :: and types named after class, struct or enum, which are forward declarations, are left out.
+     */
+    static TSet<FString> ParseUsedSymbols(const FString& SourceContents);
+    /** Gets the path other modules include a header by, relative to the Public or Classes directory of its module. */
+    static bool GetIncludePath(const FString& HeaderFilename, FString& OutInclude);
+
+    /**
+     * Replaces the monolithic includes in the contents of a file with CoreMinimal.h and the headers declaring the symbols it uses.
+     * Files that only get the monolithic headers through one of the module's own headers get the specific includes after that
+     * header's include. Returns true if the contents changed.
+     */
+    static bool ReplaceMonolithicIncludes(FString& Contents, const TArray<FString>& MonolithicIncludes, const TArray<FString>& LegacyIncludes,
+        const FString& OwnInclude, const FCppToolsSymbolIndex& SymbolIndex);
+
+    /** Computes the edits converting a module without writing anything. */
+    static bool PlanConversion(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FCppToolsHeaderIndex& HeaderIndex,
+        const FCppToolsSymbolIndex& SymbolIndex, const FCppToolsIWYUSettings& Settings, TArray<FCppToolsFileEdit>& OutEdits, FText& OutFailReason);
+
+    /**
+     * Compiles every header of a module on its own, through a generated stub source file per header that only includes it. The
+     * stubs are generated in the module's Intermediate directory and compiled together with the module without precompiled headers,
+     * unity builds or linking, so Unreal Build Tool compiles them in parallel and leaves the loaded module binaries alone. If that
+     * build fails, the headers that are not self-contained are found from the compiler errors in its log. The stubs and the log are
+     * deleted afterwards.
+     */
+    static bool CheckSelfContainedHeaders(const FString& ModuleName, TSharedPtr<IPlugin> Target, FCppToolsIWYUResult& OutResult, FText& OutFailReason);
+
+    /**
+     * Plans the conversion of a module and, when applying, writes it in a single transaction. The headers are checked after the
+     * edits are written, and measuring rebuilds the module before and after them.
+     */
+    static bool ConvertModule(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FCppToolsHeaderIndex& HeaderIndex,
+        const FCppToolsSymbolIndex& SymbolIndex, const FCppToolsIWYUSettings& Settings, bool bApply, bool bCheckHeaders, bool bMeasure,
+        FCppToolsIWYUResult& OutResult, FText& OutFailReason);
+
+};
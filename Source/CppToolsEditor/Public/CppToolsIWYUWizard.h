@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Input/SComboBox.h"
+#include "Widgets/Input/SMultiLineEditableTextBox.h"
+#include "Widgets/Text/STextBlock.h"
+
+#include "CppToolsIWYU.h"
+#include "CppToolsPCH.h"
+
+/**
+ * Converts a module that relies on monolithic headers to include-what-you-use, previewing the edits of its files as a unified
+ * diff first, and reports which of its headers do not compile on their own and how its build time changed.
+ */
+class SCppToolsIWYUWizard : public SCompoundWidget
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsIWYUWizard) {}
+    SLATE_END_ARGS()
+
+    /** Constructs this widget with InArgs */
+    void Construct(const FArguments& InArgs);
+
+private:
+
+    /** Handler for when preview is clicked */
+    FReply PreviewClicked();
+    /** Handler for when convert is clicked */
+    FReply ConvertClicked();
+    /** Returns true if there is a previewed conversion to write */
+    bool CanConvert() const;
+
+    /** Discards the previewed edits, which no longer match once another module is selected */
+    void ClearPreview();
+    /** Builds the header and symbol indices the first time they are needed, as they take a while to build */
+    void BuildIndices();
+
+    /** Get the combo box text for the currently selected module */
+    FText OnGetModuleComboText() const;
+    /** Called when the currently selected module is changed */
+    void OnModuleChanged(TSharedPtr<FString> Value, ESelectInfo::Type SelectInfo);
+    /** Create the widget to use as the combo box entry for the given module */
+    TSharedRef<SWidget> MakeWidgetForModuleCombo(TSharedPtr<FString> Value);
+
+
+    TSharedPtr<FString> SelectedModule;
+    TArray<TSharedPtr<FString>> AvailableModules;
+    /** The plugin of each module, or null for the game's modules, by module name. */
+    TMap<FString, TSharedPtr<IPlugin>> ModuleTargets;
+
+    bool bCheckHeaders = true;
+    bool bMeasure = false;
+
+    TSharedPtr<SMultiLineEditableTextBox> DiffTextBox;
+    TSharedPtr<STextBlock> StatusTextBlock;
+
+    FCppToolsIWYUSettings Settings;
+    bool bIndicesBuilt = false;
+    FCppToolsHeaderIndex HeaderIndex;
+    FCppToolsSymbolIndex SymbolIndex;
+
+    /** The edits of the last preview. */
+    TArray<FCppToolsFileEdit> Edits;
+
+};
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "ModuleDescriptor.h"
+
+#include "CppToolsRefactor.h"
+
+class FCppToolsDescriptorSession;
+
+/** A module as the manifest declares it. Dependencies and targets the manifest leaves out are left as they are. */
+struct FCppToolsManifestModule
+{
+    FString Name;
+    /** The name of the plugin owning the module, or empty for the game project. */
+    FString Plugin;
+    EHostType::Type Type = EHostType::Runtime;
+    ELoadingPhase::Type LoadingPhase = ELoadingPhase::Default;
+    /** Whether the manifest lists the module's dependencies, in which case its .Build.cs lists exactly these. */
+    bool bHasDependencies = false;
+    TArray<FString> PublicDependencies;
+    TArray<FString> PrivateDependencies;
+    /** Whether the manifest lists the module's targets, in which case exactly these .Target.cs files list it in ExtraModuleNames. */
+    bool bHasTargets = false;
+    TArray<FString> Targets;
+};
+
+/** The module layout of the project, as declared by a manifest file. */
+struct FCppToolsManifest
+{
+    TArray<FCppToolsManifestModule> Modules;
+};
+
+/** The edits that make the project match a manifest. A plan without edits means the project already matches it. */
+struct FCppToolsManifestPlan
+{
+    /** The files of the modules the manifest declares that do not exist yet, each diffed against an empty file. */
+    TArray<FCppToolsFileEdit> CreatedFiles;
+    /** The edits of existing .Build.cs and .Target.cs files. */
+    TArray<FCppToolsFileEdit> Edits;
+    /** The modules whose descriptor entry is added or whose type or loading phase changes. */
+    TArray<FCppToolsManifestModule> DescriptorModules;
+    /** A unified diff of the module lists of the changed descriptors. */
+    FString DescriptorDiff;
+    /** The modules the edits affect, which are the only ones built once the plan is applied, with the plugin owning each. */
+    TMap<FString, FString> ChangedModules;
+    /** The modules of the project the manifest does not declare, which are left as they are. */
+    TArray<FString> UnlistedModules;
+
+    bool IsEmpty() const { return CreatedFiles.Num() == 0 && Edits.Num() == 0 && DescriptorModules.Num() == 0; }
+    /** Joins the diffs of every created file, edit and descriptor into a single unified diff. */
+    FString GetDiff() const;
+};
+
+/**
+ * Declares the project's modules, their owners, host types, loading phases, dependencies and target membership in one JSON
+ * manifest, and reconciles the project with it. Only the entries that differ from the manifest are edited, so reconciling a
+ * project that already matches it writes nothing and builds nothing.
+ */
+class CPPTOOLSEDITOR_API CppToolsManifest
+{
+public:
+
+    /** Gets the manifest file of the project, CppToolsManifest.json in the project directory. */
+    static FString GetDefaultManifestPath();
+
+    /** Reads a manifest file, checking that every module has a valid name, type, loading phase and owner. */
+    static bool ReadManifest(const FString& Filename, FCppToolsManifest& OutManifest, FText& OutFailReason);
+    /** Writes a manifest file, with the modules sorted by owner and name so the file diffs well. */
+    static bool WriteManifest(const FString& Filename, const FCppToolsManifest& Manifest, FText& OutFailReason);
+    /** Describes every project and plugin module as it currently is, with its dependencies and, for game modules, its targets. */
+    static bool CaptureManifest(FCppToolsManifest& OutManifest, FText& OutFailReason);
+
+    /**
+     * Computes the edits that make the project match the manifest without writing anything. Modules that do not exist are
+     * created from the module templates with the dependencies the manifest declares, and are added to the primary target if
+     * the manifest does not list targets for them. Existing modules have the dependencies, targets and descriptor entries that
+     * differ changed one by one, leaving the rest of their files as they are. Modules cannot move to another owner.
+     */
+    static bool PlanReconcile(const FCppToolsManifest& Manifest, FCppToolsManifestPlan& OutPlan, FText& OutFailReason);
+
+    /**
+     * Writes a plan in a single transaction, which fails without writing anything if any of the files changed since it was
+     * planned, and optionally builds the changed modules, restoring the ones the binary cache has instead. Returns the modules
+     * that were built.
+     */
+    static bool ApplyPlan(const FCppToolsManifestPlan& Plan, bool bBuild, TArray<FString>& OutBuiltModules, FText& OutFailReason);
+
+private:
+
+    /** Adds the modules of a plan to the descriptors of a session, or changes the type and loading phase of the ones listed already. */
+    static bool StageDescriptorModules(FCppToolsDescriptorSession& Session, const TArray<FCppToolsManifestModule>& Modules, FText& OutFailReason);
+
+};
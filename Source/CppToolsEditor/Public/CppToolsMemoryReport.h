@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "Widgets/Views/SHeaderRow.h"
+
+#include "CppToolsMemoryTags.h"
+
+/**
+ * Shows the live and peak memory of every project module with an LLM tag, sampled from the Low-Level Memory Tracker while the
+ * widget is open, and saves snapshots of it to CSV files.
+ */
+class SCppToolsMemoryReport : public SCompoundWidget
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsMemoryReport)
+        : _SampleInterval(1.0f)
+    {}
+
+    /** How often the memory of each module is sampled, in seconds. */
+    SLATE_ARGUMENT(float, SampleInterval)
+
+    SLATE_END_ARGS()
+
+    /** Constructs this widget with InArgs */
+    void Construct(const FArguments& InArgs);
+
+private:
+
+    /** Finds the modules with a tag again, which resets their peaks. */
+    void Refresh();
+    /** Samples the memory of every module, largest first. */
+    EActiveTimerReturnType Sample(double InCurrentTime, float InDeltaTime);
+
+    FText GetStatusText() const;
+
+    /** Handler for when refresh is clicked */
+    FReply RefreshClicked();
+    /** Handler for when reset peaks is clicked */
+    FReply ResetPeaksClicked();
+    /** Handler for when save snapshot is clicked */
+    FReply SaveSnapshotClicked();
+    /** Handler for when open folder is clicked */
+    FReply OpenFolderClicked();
+
+    /** Create the widget to use as the row for the given module */
+    TSharedRef<ITableRow> MakeModuleRow(TSharedPtr<FCppToolsModuleMemory> Module, const TSharedRef<STableViewBase>& OwnerTable);
+
+
+    TSharedPtr<SListView<TSharedPtr<FCppToolsModuleMemory>>> ModuleList;
+
+    TArray<TSharedPtr<FCppToolsModuleMemory>> Modules;
+    /** The file the last snapshot was saved to. */
+    FString LastSnapshotFile;
+
+};
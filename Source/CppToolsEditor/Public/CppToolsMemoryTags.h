@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The memory a module's Low-Level Memory Tracker tag accounts for. */
+struct FCppToolsModuleMemory
+{
+    FString ModuleName;
+    /** The index of the module's tag among the project tags, counted from ELLMTag::ProjectTagStart. */
+    int32 TagIndex = INDEX_NONE;
+    int64 LiveBytes = 0;
+    /** The most memory the tag accounted for in any sample since sampling started or the peaks were reset. */
+    int64 PeakBytes = 0;
+};
+
+/**
+ * Generates and finds the Low-Level Memory Tracker tags of project modules. A module with a tag defines <MODULE>_LLM_TAG in its
+ * module header as one of the project tags, registers it in StartupModule and scopes StartupModule under it, so the memory its
+ * allocations use shows up under the module's name in LLM reports and in the Module Memory window.
+ */
+class CPPTOOLSEDITOR_API CppToolsMemoryTags
+{
+public:
+
+    /** The number of project tags the engine reserves, from ELLMTag::ProjectTagStart on. */
+    static const int32 MaxProjectTags = 100;
+
+    /** Gets the name of the macro naming the tag of a module. */
+    static FString GetTagMacroName(const FString& ModuleName);
+
+    /** Parses the tag index a module header defines, or returns INDEX_NONE if it defines no tag. */
+    static int32 ParseTagIndex(const FString& HeaderContents, const FString& ModuleName);
+    /** Reads the module header of every project and plugin module, and gets the tag index of each module that has a tag. */
+    static TMap<FString, int32> GetProjectTags();
+    /** Finds the lowest tag index that no module uses yet, or INDEX_NONE if every project tag is taken. */
+    static int32 FindFreeTagIndex(const TMap<FString, int32>& UsedTags);
+
+    /** Gets the definition of the tag macro that goes into the module header. */
+    static FString RenderTagDeclaration(const FString& ModuleName, int32 TagIndex);
+    /** Gets the stat the tag is reported under, which goes into the module source. */
+    static FString RenderTagDefinition(const FString& ModuleName);
+    /** Gets the code that registers the tag and scopes the rest of StartupModule under it. */
+    static FString RenderTagScope(const FString& ModuleName);
+
+    /** Checks if the editor tracks memory by tag, which it does when it is started with -LLM. */
+    static bool IsTrackingEnabled();
+    /** Updates the live memory of a module from the tracker, raising its peak. The module keeps its last values if tracking is not enabled. */
+    static void Sample(FCppToolsModuleMemory& Module);
+
+    /** Gets the directory memory snapshots are saved to, Saved/CppTools/Memory. */
+    static FString GetSnapshotDirectory();
+    /**
+     * Writes the memory of every module to a CSV file named after the build configuration and the time, so snapshots of
+     * different builds can be compared side by side.
+     */
+    static bool WriteSnapshot(const TArray<FCppToolsModuleMemory>& Modules, FString& OutFilename, FText& OutFailReason);
+
+};
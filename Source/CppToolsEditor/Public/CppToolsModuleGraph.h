@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "ModuleDescriptor.h"
+
+#include "CppToolsRefactor.h"
+
+/** A module of the game project or one of its plugins, with its dependencies on other project modules. */
+struct FCppToolsModuleNode
+{
+    FString Name;
+    TSharedPtr<IPlugin> Plugin;
+    EHostType::Type Type = EHostType::Runtime;
+    FString Path;
+    /** Why the module is used on its own, or empty if it is only used through modules depending on it. */
+    FString RootReason;
+    /** The project modules in the module's public and private dependency lists. */
+    TArray<FString> Dependencies;
+    /** The dependencies none of the module's files include a public header of. */
+    TArray<FString> UnusedDependencies;
+};
+
+/** A .Target.cs file of the game project. */
+struct FCppToolsTargetInfo
+{
+    FString Name;
+    FString Filename;
+    /** The TargetType the file declares, such as Game, Client, Server, Editor or Program. */
+    FString Type;
+    bool bEditor = false;
+    TArray<FString> ExtraModuleNames;
+};
+
+/** The modules and dependencies of the project that no target uses. */
+struct FCppToolsDeadModuleReport
+{
+    TArray<FCppToolsTargetInfo> Targets;
+    TMap<FString, FCppToolsModuleNode> Modules;
+    /** The modules each target builds, by target name. */
+    TMap<FString, TArray<FString>> TargetModules;
+    /** The modules each target builds that are reachable from a root through used dependencies, by target name. */
+    TMap<FString, TArray<FString>> LiveModules;
+    /** The modules that are built by at least one target but live in none. */
+    TArray<FString> DeadModules;
+};
+
+/** A module a target builds without needing it, or a dependency that pulls a module into targets it is not meant for. */
+struct FCppToolsTargetMembershipIssue
+{
+    FString Target;
+    FString Module;
+    /** Misplaced for a module the target lists in ExtraModuleNames but does not need, IncompatibleDependency for a needed module depending on one the target should not build. */
+    FString Kind;
+    FString Reason;
+    /** Whether removing the module from the target's ExtraModuleNames fixes the issue. */
+    bool bFixable = false;
+};
+
+/** Which targets need each module of the project, for one platform. */
+struct FCppToolsTargetMembershipReport
+{
+    FString Platform;
+    TArray<FCppToolsTargetInfo> Targets;
+    TMap<FString, FCppToolsModuleNode> Modules;
+    /** The targets that need each module, by module name. */
+    TMap<FString, TArray<FString>> ModuleTargets;
+    /** The modules each target builds without needing them, by target name. */
+    TMap<FString, TArray<FString>> UnneededModules;
+    TArray<FCppToolsTargetMembershipIssue> Issues;
+};
+
+/**
+ * Walks the dependency graph of the project's modules from the roots of each target to find the modules that are built
+ * but unreachable, or only reachable through dependencies that are never included, and removes them from the targets,
+ * .Build.cs files and descriptors. Also works out which targets need each module, to keep modules out of the targets that
+ * do not.
+ */
+class CPPTOOLSEDITOR_API CppToolsModuleGraph
+{
+public:
+
+    /** Reads the .Target.cs files of the game project. */
+    static TArray<FCppToolsTargetInfo> ReadProjectTargets();
+
+    /**
+     * Reads every project and plugin module with its dependencies on other project modules, and finds which of those
+     * dependencies are used by including a public header of the dependency.
+     */
+    static TMap<FString, FCppToolsModuleNode> BuildGraph();
+
+    /** Gets the descriptor entry of every module of the graph, by module name. */
+    static TMap<FString, FModuleDescriptor> GetModuleDescriptors(const TMap<FString, FCppToolsModuleNode>& Modules);
+
+    /** Checks if a module of the specified type is built by an editor or game target. */
+    static bool IsModuleTypeInTarget(EHostType::Type Type, bool bEditorTarget);
+    /** Checks if a module of the specified type is built by a target of the specified TargetType, such as Server or Client. */
+    static bool IsModuleTypeInTargetType(EHostType::Type Type, const FString& TargetType);
+
+    /**
+     * Finds the modules that are dead in every target. Roots are the primary game and plugin modules, modules with startup code
+     * or reflected types, and the extra roots specified.
+     */
+    static FCppToolsDeadModuleReport FindDeadModules(const TArray<FString>& ExtraRoots);
+
+    /**
+     * Removes the dead modules from the .Target.cs files, the dependency lists of the remaining modules and the project and plugin
+     * descriptors in one transaction, optionally also removing the unused dependencies between the remaining modules. If any file
+     * fails to be written, every change is rolled back. The sources of the dead modules are left in place.
+     */
+    static bool RemoveDeadModules(const FCppToolsDeadModuleReport& Report, bool bRemoveUnusedDependencies, FText& OutFailReason);
+
+    /**
+     * Works out which targets need each module on the specified platform. A target needs the modules of the descriptors that
+     * its type builds and whose WhitelistPlatforms and BlacklistPlatforms allow the platform, and everything they depend on.
+     * Modules a target only builds because its ExtraModuleNames lists them are misplaced, and dependencies on modules the target
+     * should not build are reported for the depending module's .Build.cs to guard.
+     */
+    static FCppToolsTargetMembershipReport AnalyzeTargetMembership(const FString& Platform);
+
+    /** Computes the edits removing the misplaced modules from every .Target.cs file without writing anything. */
+    static bool PlanTargetMembershipFixes(const FCppToolsTargetMembershipReport& Report, TArray<FCppToolsFileEdit>& OutEdits, FText& OutFailReason);
+
+private:
+
+    /** Gets why a module is used on its own, from the contents of its source files, or an empty string. */
+    static FString GetModuleRootReason(const FCppToolsModuleNode& Module);
+
+};
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "ModuleDescriptor.h"
+
+#include "CppToolsDescriptorSession.h"
+#include "CppToolsModuleTemplates.h"
+
+class FCppToolsTemplate;
+
+/** A file shown in the preview of a new module. */
+struct FCppToolsPreviewFile
+{
+    FString Filename;
+    /** The contents of a created file, or a unified diff of a modified file. */
+    FString Text;
+    /** Whether the file is created, rather than an existing file being modified. */
+    bool bCreate = false;
+};
+
+/** The settings a new module is created with. */
+struct FCppToolsNewModuleSettings
+{
+    FString ModuleName;
+    /** The plugin to add the module to, or null to add it to the game project. */
+    TSharedPtr<IPlugin> Target;
+    EHostType::Type Type = EHostType::Runtime;
+    ELoadingPhase::Type LoadingPhase = ELoadingPhase::Default;
+    bool bGenerateFwdHeader = false;
+    /** The index of the module's LLM tag among the project tags, or INDEX_NONE if it gets no tag. */
+    int32 LLMTagIndex = INDEX_NONE;
+    ECppToolsModuleTemplate ModuleTemplate = ECppToolsModuleTemplate::Basic;
+};
+
+/**
+ * Renders the files a new module would create and the edits it would make to the owning .Build.cs file, the project's
+ * .Target.cs file and the module's descriptor, without writing anything. The templates are parsed once and every existing
+ * file is read the first time it is needed, and each previewed file is only rendered again when a setting it depends on
+ * changes, so the preview can follow every keystroke in the new module dialog.
+ */
+class CPPTOOLSEDITOR_API FCppToolsModulePreview
+{
+public:
+
+    /** Loads the module templates. Must succeed before the preview is updated. */
+    bool Initialize(FText& OutFailReason);
+    /** Renders the files affected by the settings that changed since the last update. Returns true if any previewed file changed. */
+    bool Update(const FCppToolsNewModuleSettings& Settings);
+
+    /** Gets the previewed files, with the created files first. */
+    const TArray<TSharedPtr<FCppToolsPreviewFile>>& GetFiles() const { return Files; }
+    /** Gets the reason a file could not be previewed in the last update, or an empty text if every file was previewed. */
+    FText GetFailReason() const;
+
+private:
+
+    enum class EPreviewFile : uint8
+    {
+        BuildFile,
+        HeaderFile,
+        SourceFile,
+        FwdHeaderFile,
+        OwnerBuildFile,
+        TargetFile,
+        Descriptor,
+        Num
+    };
+
+    /** A previewed file with the settings it was last rendered for. */
+    struct FSection
+    {
+        /** The settings the file depends on, joined into a string. */
+        FString Key;
+        /** The rendered file, or null if the module does not create or modify it. */
+        TSharedPtr<FCppToolsPreviewFile> File;
+        FText FailReason;
+    };
+
+    /** Renders a file again if the settings it depends on changed. Returns true if it was rendered. */
+    bool UpdateSection(EPreviewFile Section, const FString& Key, TFunctionRef<TSharedPtr<FCppToolsPreviewFile>(FText&)> Render);
+    /** Renders the files the module template adds again if the template, name or path changed. Returns true if they were rendered. */
+    bool UpdateTemplateFiles(const FCppToolsNewModuleSettings& Settings, const FString& ModulePath);
+
+    TSharedPtr<FCppToolsPreviewFile> RenderOwnerBuildFile(const FCppToolsNewModuleSettings& Settings, FText& OutFailReason);
+    TSharedPtr<FCppToolsPreviewFile> RenderTargetFile(const FCppToolsNewModuleSettings& Settings, FText& OutFailReason);
+    TSharedPtr<FCppToolsPreviewFile> RenderDescriptor(const FCppToolsNewModuleSettings& Settings, FText& OutFailReason);
+
+    /** Gets the contents of an existing file, reading it the first time. Returns null if it cannot be read. */
+    const FString* GetFileContents(const FString& Filename);
+
+    TSharedPtr<const FCppToolsTemplate> BuildFileTemplate;
+    TSharedPtr<const FCppToolsTemplate> HeaderTemplate;
+    TSharedPtr<const FCppToolsTemplate> SourceTemplate;
+    TSharedPtr<const FCppToolsTemplate> FwdHeaderTemplate;
+
+    /** The contents of the existing files that were read, by file name. */
+    TMap<FString, FString> FileContents;
+    /** The existing files that could not be read, which are not tried again. */
+    TSet<FString> UnreadableFiles;
+    /** The .Build.cs file of the module that owns a new module of each target and type, which is empty if there is none. */
+    TMap<FString, FString> OwnerBuildFiles;
+    /** The descriptors as they are on disk, which are copied before the new module is added to them. */
+    FCppToolsDescriptorSession Descriptors;
+
+    FSection Sections[static_cast<int32>(EPreviewFile::Num)];
+    /** The files the module template adds, which go after the fixed sections of created files. */
+    FString TemplateFilesKey;
+    TArray<TSharedPtr<FCppToolsPreviewFile>> TemplateFiles;
+    FText TemplateFilesFailReason;
+    TArray<TSharedPtr<FCppToolsPreviewFile>> Files;
+
+};
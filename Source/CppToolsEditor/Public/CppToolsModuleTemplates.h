@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The variants of a new module, which decide the code it starts with beyond the module class. */
+enum class ECppToolsModuleTemplate : uint8
+{
+    /** Only the module class, with empty StartupModule and ShutdownModule. */
+    Basic,
+    /**
+     * Adds allocation helpers for code that runs every frame: a linear arena reset at the end of each frame, a fixed-size object
+     * pool, containers with inline storage and stats counters for them, along with automation tests and a benchmark against FMemory.
+     */
+    HighPerformanceRuntime,
+    Num
+};
+
+/** A file that a module template adds to a new module. */
+struct FCppToolsModuleTemplateFile
+{
+    /** The full path of the file. */
+    FString Filename;
+    FString Contents;
+};
+
+/**
+ * Describes the module templates and renders the files and module code each of them adds to a new module. The files are
+ * rendered from the templates under Content/Editor/Templates/<Template>, which can be customized like the module templates.
+ */
+class CPPTOOLSEDITOR_API CppToolsModuleTemplates
+{
+public:
+
+    /** Gets the name of a template, as used by the commandlet. */
+    static FString ToString(ECppToolsModuleTemplate Template);
+    /** Parses the name of a template. Returns false if it is not a template. */
+    static bool FromString(const FString& Name, ECppToolsModuleTemplate& OutTemplate);
+
+    static FText GetDisplayName(ECppToolsModuleTemplate Template);
+    static FText GetDescription(ECppToolsModuleTemplate Template);
+
+    /** Gets the headers the module header of a new module includes, and the code its StartupModule and ShutdownModule run. */
+    static void GetModuleCode(ECppToolsModuleTemplate Template, const FString& ModuleName, TArray<FString>& OutPublicHeaderIncludes,
+        FString& OutStartupCode, FString& OutShutdownCode);
+    /** Renders the files a template adds to a new module, besides the files every module has. */
+    static bool RenderFiles(ECppToolsModuleTemplate Template, const FString& ModulePath, const FString& ModuleName,
+        TArray<FCppToolsModuleTemplateFile>& OutFiles, FText& OutFailReason);
+
+};
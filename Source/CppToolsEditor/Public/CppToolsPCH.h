@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+
+/** The thresholds used to decide which headers go into a module's generated precompiled header, and when it is worth having. */
+struct FCppToolsPCHSettings
+{
+    /** The fraction of a module's source files that must include a header for it to be considered. */
+    float MinIncludeFraction = 0.25f;
+    /** The maximum number of headers in a generated precompiled header. */
+    int32 MaxHeaders = 24;
+    /** The number of source files a module needs before a precompiled header is considered. */
+    int32 MinSourceFiles = 8;
+    /** The number of edits within the git history after which a header is no longer considered stable. */
+    int32 MinEditsForUnstableHeader = 3;
+    /** The fraction of the precompiled header's includes that may differ from the current profile before it is regenerated. */
+    float MaxDrift = 0.25f;
+    /** The fraction of build time a precompiled header must save for it to be kept. */
+    float MinBuildGain = 0.1f;
+};
+
+/** A header included by the source files of a module. */
+struct FCppToolsIncludeProfileEntry
+{
+    /** The path as written in the include directive. */
+    FString Include;
+    /** The resolved path of the header. */
+    FString Filename;
+    int64 Size = 0;
+    int32 NumIncludingFiles = 0;
+
+    /** Headers that are included by many files and expensive to parse save the most when precompiled. */
+    double GetScore() const { return static_cast<double>(NumIncludingFiles) * Size; }
+};
+
+/** Resolves include directives to header files by matching them against an index of the headers in a set of directories. */
+struct CPPTOOLSEDITOR_API FCppToolsHeaderIndex
+{
+    /** Indexes every header within the specified directories. */
+    void Build(const TArray<FString>& Directories);
+    /** Resolves an include directive, preferring headers within the preferred directory. */
+    bool Resolve(const FString& Include, const FString& PreferredDirectory, FString& OutFilename) const;
+
+private:
+
+    /** The indexed headers, by their lower case file name. */
+    TMultiMap<FString, FString> Headers;
+};
+
+/** The outcome of updating the precompiled header of a module. */
+struct FCppToolsPCHResult
+{
+    FString ModuleName;
+    /** What was done: Skipped, UpToDate, Generated, Regenerated or Removed. */
+    FString Status;
+    FString Reason;
+    TArray<FCppToolsIncludeProfileEntry> Profile;
+    float Drift = 0.0f;
+    /** Whether the module was built with and without the precompiled header, which happens whenever one is generated. */
+    bool bMeasured = false;
+    double SecondsWithoutPCH = 0.0;
+    double SecondsWithPCH = 0.0;
+};
+
+/**
+ * Generates private precompiled headers for modules from the stable headers their source files include most, and keeps them
+ * in sync as the modules' includes change.
+ */
+class CPPTOOLSEDITOR_API CppToolsPCH
+{
+public:
+
+    /** Gets the directories searched when resolving includes: the engine's sources and every project and plugin module. */
+    static TArray<FString> GetIncludeSearchDirectories();
+
+    /**
+     * Measures which headers the source files of a module include, returning the stable ones that are included often enough,
+     * highest scoring first.
+     */
+    static TArray<FCppToolsIncludeProfileEntry> ProfileModuleIncludes(const FString& ModuleName, TSharedPtr<IPlugin> Target,
+        const FCppToolsHeaderIndex& HeaderIndex, const TMap<FString, int32>& Edits, const FCppToolsPCHSettings& Settings, int32& OutNumSourceFiles);
+
+    /** Gets the file the generated precompiled header of a module is written to. */
+    static FString GetModulePCHPath(const FString& ModulePath, const FString& ModuleName);
+    /** Reads the includes of a generated precompiled header. Returns false if the file does not exist or was not generated. */
+    static bool ReadGeneratedPCHIncludes(const FString& PCHFilename, TArray<FString>& OutIncludes);
+    /** Gets the fraction of includes that differ between two sets of includes. */
+    static float GetProfileDrift(const TArray<FString>& A, const TArray<FString>& B);
+
+    /**
+     * Writes the precompiled header of a module and enables it in the module's .Build.cs file, recording the module's PCHUsage in
+     * the header so it can be restored. Fails if the .Build.cs file already sets PrivatePCHHeaderFile to another header.
+     */
+    static bool GeneratePCH(const FString& ModuleName, TSharedPtr<IPlugin> Target, const TArray<FCppToolsIncludeProfileEntry>& Profile,
+        FText& OutFailReason);
+    /** Deletes the generated precompiled header of a module, disables it and restores the PCHUsage it recorded in the module's .Build.cs file. */
+    static bool RemovePCH(const FString& ModuleName, TSharedPtr<IPlugin> Target, FText& OutFailReason);
+
+    /**
+     * Profiles a module and generates or regenerates its precompiled header if it has none or its profile drifted. The module is
+     * then rebuilt with and without the precompiled header, and it is removed again unless it saves enough build time.
+     */
+    static bool UpdateModulePCH(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FCppToolsHeaderIndex& HeaderIndex,
+        const TMap<FString, int32>& Edits, const FCppToolsPCHSettings& Settings, FCppToolsPCHResult& OutResult, FText& OutFailReason);
+
+};
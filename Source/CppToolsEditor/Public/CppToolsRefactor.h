@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "ModuleDescriptor.h"
+
+/** The kinds of change that can be made to the dependency lists of every matching module. */
+enum class ECppToolsDependencyChangeType : uint8
+{
+    /** Adds the dependency to the public list, or to the private list if private, of modules that do not depend on it yet. */
+    Add,
+    /** Removes the dependency from both lists. */
+    Remove,
+    /** Moves the dependency from the public to the private list if private, or from the private to the public list otherwise. */
+    Move,
+    /** Replaces the dependency with the replacement, in the same list it was in. */
+    Replace
+};
+
+/** A change to the dependency lists of the .Build.cs files of the project's modules. */
+struct FCppToolsDependencyChange
+{
+    ECppToolsDependencyChangeType Type = ECppToolsDependencyChangeType::Add;
+    FString Dependency;
+    /** The module replacing the dependency, for Replace changes. */
+    FString Replacement;
+    /** Whether the dependency is added to, or moved into, the private list. */
+    bool bPrivate = false;
+    /** The types of the modules to change, or every module if empty. */
+    TArray<EHostType::Type> ModuleTypes;
+    /** The names of the modules to change, or every module if empty. */
+    TArray<FString> ModuleNames;
+};
+
+/** The edit of a single file, previewed as a unified diff before it is written. */
+struct FCppToolsFileEdit
+{
+    /** The module the file belongs to. */
+    FString ModuleName;
+    FString Filename;
+    FString NewContents;
+    /** A unified diff of the edit. */
+    FString Diff;
+    /** When the file was last written at the time it was read, to detect changes made before the edit is written. */
+    FDateTime TimeStamp;
+};
+
+/**
+ * Applies a dependency change to the .Build.cs file of every matching project and plugin module. The files are read, edited
+ * and diffed in memory in parallel, and only the files that changed are written, together in a single transaction.
+ */
+class CPPTOOLSEDITOR_API CppToolsRefactor
+{
+public:
+
+    /** Gets the name of a change type, as used by the commandlet. */
+    static FString ChangeTypeToString(ECppToolsDependencyChangeType Type);
+    /** Parses the name of a change type. Returns false if it is not a change type. */
+    static bool ChangeTypeFromString(const FString& Name, ECppToolsDependencyChangeType& OutType);
+
+    /** Checks that the change names the modules it needs. */
+    static bool IsValidChange(const FCppToolsDependencyChange& Change, FText& OutFailReason);
+
+    /** Applies a change to the contents of a .Build.cs file of the specified module. Returns true if the contents changed. */
+    static bool ApplyToBuildFile(FString& BuildFileContents, const FString& ModuleName, const FCppToolsDependencyChange& Change);
+
+    /** Computes the edit of every matching module's .Build.cs file without writing anything. Modules that do not change are left out. */
+    static bool PreviewChange(const FCppToolsDependencyChange& Change, TArray<FCppToolsFileEdit>& OutEdits, FText& OutFailReason);
+    /** Writes previewed edits. Fails without writing anything if any of the files changed since they were previewed. */
+    static bool ApplyEdits(const TArray<FCppToolsFileEdit>& Edits, FText& OutFailReason);
+
+    /** Joins the diffs of the edits into a single unified diff. */
+    static FString JoinDiffs(const TArray<FCppToolsFileEdit>& Edits);
+
+};
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Input/SComboBox.h"
+#include "Widgets/Input/SMultiLineEditableTextBox.h"
+#include "Widgets/Text/STextBlock.h"
+
+#include "CppToolsRefactor.h"
+
+/**
+ * Previews a dependency change across the .Build.cs files of every matching module as a unified diff, and writes the
+ * previewed edits once they are applied.
+ */
+class SCppToolsRefactorDependencies : public SCompoundWidget
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsRefactorDependencies) {}
+    SLATE_END_ARGS()
+
+    /** Constructs this widget with InArgs */
+    void Construct(const FArguments& InArgs);
+
+private:
+
+    /** Handler for when preview is clicked */
+    FReply PreviewClicked();
+    /** Handler for when apply is clicked */
+    FReply ApplyClicked();
+    /** Returns true if there are previewed edits to apply */
+    bool CanApply() const;
+
+    /** Discards the previewed edits, which no longer match the change once it is edited */
+    void ClearPreview();
+
+    /** Get the combo box text for the currently selected change type */
+    FText OnGetChangeTypeComboText() const;
+    /** Called when the currently selected change type is changed */
+    void OnChangeTypeChanged(TSharedPtr<ECppToolsDependencyChangeType> Value, ESelectInfo::Type SelectInfo);
+    /** Create the widget to use as the combo box entry for the given change type */
+    TSharedRef<SWidget> MakeWidgetForChangeTypeCombo(TSharedPtr<ECppToolsDependencyChangeType> Value);
+
+    /** Get the combo box text for the currently selected module type filter */
+    FText OnGetModuleTypeComboText() const;
+    /** Called when the currently selected module type filter is changed */
+    void OnModuleTypeChanged(TSharedPtr<int32> Value, ESelectInfo::Type SelectInfo);
+    /** Create the widget to use as the combo box entry for the given module type filter */
+    TSharedRef<SWidget> MakeWidgetForModuleTypeCombo(TSharedPtr<int32> Value);
+
+    /** Gets the name of a module type filter, where EHostType::Max stands for every module */
+    static FText GetModuleTypeText(int32 ModuleType);
+
+
+    FCppToolsDependencyChange Change;
+    /** The module type the change is limited to, or EHostType::Max for every module. */
+    TSharedPtr<int32> ModuleType;
+    TSharedPtr<ECppToolsDependencyChangeType> ChangeType;
+
+    TArray<TSharedPtr<ECppToolsDependencyChangeType>> AvailableChangeTypes;
+    TArray<TSharedPtr<int32>> AvailableModuleTypes;
+
+    TSharedPtr<SMultiLineEditableTextBox> DiffTextBox;
+    TSharedPtr<STextBlock> StatusTextBlock;
+
+    /** The edits of the last preview, which are written when applied. */
+    TArray<FCppToolsFileEdit> Edits;
+
+};
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The shape of the dependency graph between the modules of a synthetic project. */
+enum class ECppToolsDependencyShape : uint8
+{
+    /** Every module depends on the module generated before it. */
+    Chain,
+    /** Every module depends on its parent in a tree with MaxDependencies children per module. */
+    Tree,
+    /** Every module depends on up to MaxDependencies randomly chosen modules generated before it. */
+    RandomDAG
+};
+
+/** The settings used to generate a synthetic project. */
+struct FCppToolsSyntheticProjectSettings
+{
+    /**
+     * The directory the plugins are generated in. It must be within the project's Plugins or Intermediate folder, and should be
+     * within Plugins for them to be discovered.
+     */
+    FString RootDir;
+    int32 NumPlugins = 10;
+    int32 ModulesPerPlugin = 4;
+    ECppToolsDependencyShape Shape = ECppToolsDependencyShape::RandomDAG;
+    /** The number of dependencies of each module in a random DAG, or the number of children of each module in a tree. */
+    int32 MaxDependencies = 4;
+    /** The number of additional header and source file pairs in each module. */
+    int32 FilesPerModule = 4;
+    /** The number of lines in each additional header and source file. */
+    int32 LinesPerFile = 100;
+    /** The seed used to generate a random DAG, so the same project can be generated again. */
+    int32 Seed = 0;
+};
+
+/** A module generated in a synthetic project. */
+struct FCppToolsSyntheticModule
+{
+    FString ModuleName;
+    FString PluginName;
+    TArray<FString> Dependencies;
+};
+
+/** The time taken by one stage of a scale test, for a project of a given size. */
+struct FCppToolsScaleMeasurement
+{
+    FString Stage;
+    int32 NumPlugins = 0;
+    int32 NumModules = 0;
+    int32 Samples = 0;
+    double TotalSeconds = 0.0;
+    double MaxSeconds = 0.0;
+
+    double GetMeanSeconds() const { return Samples > 0 ? TotalSeconds / Samples : 0.0; }
+};
+
+/**
+ * Generates synthetic projects of configurable size and dependency shape, and times the plugin's operations against them so
+ * their scaling can be measured before a real project grows to that size.
+ */
+class CPPTOOLSEDITOR_API CppToolsScaleTest
+{
+public:
+
+    /** Gets the directory synthetic plugins are generated in by default, within the project's Plugins folder. */
+    static FString GetDefaultRootDir();
+    /** Gets the directory scale test results are written to. */
+    static FString GetResultsDirectory();
+
+    /** Parses a dependency shape from its name. Returns false if the name is not a valid shape. */
+    static bool ParseDependencyShape(const FString& ShapeName, ECppToolsDependencyShape& OutShape);
+    /** Gets the name of a dependency shape. */
+    static FString GetDependencyShapeName(ECppToolsDependencyShape Shape);
+
+    /** Checks that a synthetic project can be generated in a directory: it must be below the project's Plugins or Intermediate folder. */
+    static bool IsValidRootDir(const FString& RootDir, FText& OutFailReason);
+
+    /**
+     * Generates the plugins and modules of a synthetic project, replacing any that were generated in the root directory
+     * before. A marker file is written to the root directory, and a root directory that has contents but no marker is never
+     * replaced. The plugins are disabled by default so they are discovered by the editor without being built or loaded.
+     */
+    static bool GenerateSyntheticProject(const FCppToolsSyntheticProjectSettings& Settings, TArray<FCppToolsSyntheticModule>& OutModules,
+        FText& OutFailReason);
+    /**
+     * Deletes the generated plugins of a synthetic project and refreshes the list of discovered plugins. Only the generated
+     * plugin directories and the marker file are deleted, and the root directory only once nothing else is left in it.
+     */
+    static bool DeleteSyntheticProject(const FString& RootDir, FText& OutFailReason);
+
+    /**
+     * Generates a synthetic project for each of the specified plugin counts and times dialog open, name validation, module
+     * listing, dependency queries and module generation against it. Each project is deleted once it has been measured.
+     */
+    static bool RunScaleTest(const FCppToolsSyntheticProjectSettings& Settings, const TArray<int32>& PluginCounts,
+        TArray<FCppToolsScaleMeasurement>& OutMeasurements, FText& OutFailReason);
+
+    /** Writes measurements as CSV, with one row per stage and project size, so scaling curves can be plotted. */
+    static bool SaveMeasurements(const TArray<FCppToolsScaleMeasurement>& Measurements, const FString& Filename);
+
+private:
+
+    /** Gets the indices of the modules the specified module depends on. Only modules generated before it are used, so the graph is acyclic. */
+    static TArray<int32> MakeDependencyIndices(int32 ModuleIndex, const FCppToolsSyntheticProjectSettings& Settings, FRandomStream& Random);
+
+    /** Generates the additional header and source files of a synthetic module. */
+    static bool GenerateSyntheticSourceFiles(const FString& ModuleDir, const FCppToolsSyntheticModule& Module, int32 NumFiles, int32 NumLines,
+        FText& OutFailReason);
+
+    /** Times the stages of a scale test against the synthetic project that was just generated. */
+    static void MeasureStages(const FCppToolsSyntheticProjectSettings& Settings, const TArray<FCppToolsSyntheticModule>& Modules,
+        TArray<FCppToolsScaleMeasurement>& OutMeasurements);
+
+};
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A file template split into its literal text and its %TOKEN% placeholders, so it can be filled in repeatedly without
+ * searching the template again. Templates are loaded from the plugin's Content/Editor/Templates directory once and kept in
+ * memory until the file changes.
+ */
+class CPPTOOLSEDITOR_API FCppToolsTemplate
+{
+public:
+
+    /** Splits the contents of a template into literal text and placeholders. */
+    static FCppToolsTemplate Parse(const FString& TemplateContents);
+    /** Gets a parsed template file, reading it only if it was not read yet or changed since it was last read. */
+    static TSharedPtr<const FCppToolsTemplate> Load(const FString& TemplateFileName, FText& OutFailReason);
+
+    /**
+     * Fills in the template, replacing each placeholder with its value by token name, without the percent signs.
+     * Placeholders without a value are kept as they are.
+     */
+    FString Render(const TMap<FString, FString>& Values) const;
+
+private:
+
+    /** A literal piece of the template, or a placeholder if it has a token. */
+    struct FSegment
+    {
+        FString Text;
+        FString Token;
+    };
+
+    TArray<FSegment> Segments;
+    /** The length of the literal text, used to size the rendered output. */
+    int32 LiteralLength = 0;
+
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** The compile time spent on a header or template, summed over translation units. */
+struct FCppToolsTimeTraceEntry
+{
+    FString Name;
+    double Milliseconds = 0.0;
+    /** The number of times it was parsed or instantiated. */
+    int32 Count = 0;
+};
+
+/** The compile time of a single translation unit, read from its clang -ftime-trace file. */
+struct FCppToolsTranslationUnitTrace
+{
+    FString TraceFile;
+    FString ModuleName;
+    double TotalMilliseconds = 0.0;
+    double FrontendMilliseconds = 0.0;
+    double BackendMilliseconds = 0.0;
+    /** The time spent parsing each header, including the headers it includes, by path. */
+    TMap<FString, FCppToolsTimeTraceEntry> Headers;
+    /** The time spent instantiating each template, by name. */
+    TMap<FString, FCppToolsTimeTraceEntry> Templates;
+};
+
+/** The compile time hot spots of a module, aggregated from the traces of its translation units. */
+struct FCppToolsModuleCompileProfile
+{
+    FString ModuleName;
+    int32 NumTranslationUnits = 0;
+    double TotalMilliseconds = 0.0;
+    double FrontendMilliseconds = 0.0;
+    double BackendMilliseconds = 0.0;
+    FString SlowestTranslationUnit;
+    double SlowestTranslationUnitMilliseconds = 0.0;
+    /** The most expensive headers, slowest first. */
+    TArray<FCppToolsTimeTraceEntry> Headers;
+    /** The most expensive template instantiations, slowest first. */
+    TArray<FCppToolsTimeTraceEntry> Templates;
+};
+
+/**
+ * Builds the project with clang's -ftime-trace and aggregates the resulting per translation unit traces into the frontend and
+ * backend time, most expensive headers and most expensive template instantiations of each module.
+ */
+class CPPTOOLSEDITOR_API CppToolsTimeTrace
+{
+public:
+
+    /** Builds the game target with -ftime-trace passed to the compiler, which writes a trace next to every object file. */
+    static bool BuildWithTimeTrace(double& OutSeconds, FText& OutFailReason);
+
+    /** Gets the intermediate build directories of the project and its plugins, which the traces are written to. */
+    static TArray<FString> GetTraceDirectories();
+
+    /** Reads the trace of a translation unit. Returns false if the file is not a clang time trace. */
+    static bool ReadTraceFile(const FString& TraceFile, FCppToolsTranslationUnitTrace& OutTrace);
+
+    /** Reads every trace within the intermediate directories and aggregates them by module, slowest module first. */
+    static TArray<FCppToolsModuleCompileProfile> IngestTraces(int32 MaxEntries);
+
+};
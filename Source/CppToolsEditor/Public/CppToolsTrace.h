@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/** A single timed scope recorded during a trace session. */
+struct FCppToolsTraceEvent
+{
+    FString Name;
+    FString Category;
+    /** Extra information about the event, such as the file that was read or written. */
+    FString Detail;
+    /** Start time and duration in seconds, relative to the start of the session. */
+    double StartTime;
+    double Duration;
+    uint32 ThreadId;
+};
+
+/** The timings of a previous trace session, loaded from its trace file. */
+struct FCppToolsTraceSummary
+{
+    FString SessionName;
+    FDateTime Date;
+    FString TraceFile;
+    /** Total duration of the session in milliseconds. */
+    double TotalTime;
+    /** Summed duration of every stage in milliseconds, by stage name. */
+    TMap<FString, double> StageTimes;
+};
+
+/**
+ * Records the time spent in each stage of a CppTools operation and in every file it reads or writes. When the outermost
+ * session ends, the events are written as a Chrome/Perfetto compatible trace to Saved/CppTools/Traces. Every scope is
+ * also emitted as a CPU profiler event so it shows up in Unreal Insights.
+ */
+class CPPTOOLSEDITOR_API CppToolsTrace
+{
+public:
+
+    /** Starts a trace session. Sessions may be nested, only the outermost session writes a trace file. */
+    static void BeginSession(const FString& SessionName);
+    /** Ends the current trace session, writing the trace file if this was the outermost session. */
+    static void EndSession();
+    /** Checks if there is a trace session recording events. */
+    static bool IsSessionActive();
+
+    /** Records an event in the current trace session. Does nothing, without locking or allocating, if no session is active. */
+    static void AddEvent(const TCHAR* Name, const TCHAR* Category, const TCHAR* Detail, double StartTime, double EndTime);
+
+    /** Gets the directory trace files are written to. */
+    static FString GetTraceDirectory();
+
+    /** Loads the summaries of the most recent trace sessions, newest first. */
+    static void LoadHistory(TArray<FCppToolsTraceSummary>& OutSessions, int32 MaxSessions = 20);
+
+private:
+
+    /** Writes the recorded events of the current session to a new trace file. */
+    static bool WriteTraceFile(const FString& SessionName, const FDateTime& Date, const TArray<FCppToolsTraceEvent>& Events);
+
+    /** Reads the summary of a single trace file. */
+    static bool LoadSummary(const FString& TraceFile, FCppToolsTraceSummary& OutSummary);
+
+};
+
+/**
+ * Times the enclosing scope and records it in the current trace session. The detail is only copied if a session is active
+ * when the scope ends, so it must outlive the scope.
+ */
+class CPPTOOLSEDITOR_API FCppToolsScopedTrace
+{
+public:
+
+    FCppToolsScopedTrace(const TCHAR* InName, const TCHAR* InCategory, const TCHAR* InDetail = TEXT(""));
+    ~FCppToolsScopedTrace();
+
+private:
+
+    const TCHAR* Name;
+    const TCHAR* Category;
+    const TCHAR* Detail;
+    double StartTime;
+
+};
+
+/** Starts a trace session for the lifetime of the enclosing scope. */
+class CPPTOOLSEDITOR_API FCppToolsScopedTraceSession
+{
+public:
+
+    explicit FCppToolsScopedTraceSession(const FString& SessionName) { CppToolsTrace::BeginSession(SessionName); }
+    ~FCppToolsScopedTraceSession() { CppToolsTrace::EndSession(); }
+
+};
+
+/** Records the enclosing scope as a trace session, if one is not already running. */
+#define CPPTOOLS_TRACE_SESSION(Name) \
+    FCppToolsScopedTraceSession ANONYMOUS_VARIABLE(CppToolsTraceSession_)(Name)
+
+/** Records the enclosing scope as a stage of the current operation. */
+#define CPPTOOLS_TRACE_SCOPE(Name) \
+    TRACE_CPUPROFILER_EVENT_SCOPE(CppTools_##Name); \
+    FCppToolsScopedTrace ANONYMOUS_VARIABLE(CppToolsTrace_)(TEXT(#Name), TEXT("Stage"))
+
+/** Records the enclosing scope as an access to the specified file. */
+#define CPPTOOLS_TRACE_FILE_SCOPE(Name, Filename) \
+    TRACE_CPUPROFILER_EVENT_SCOPE(CppTools_##Name); \
+    FCppToolsScopedTrace ANONYMOUS_VARIABLE(CppToolsTrace_)(TEXT(#Name), TEXT("File"), *(Filename))
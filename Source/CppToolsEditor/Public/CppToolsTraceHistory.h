@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "Widgets/Views/SHeaderRow.h"
+
+#include "CppToolsTrace.h"
+
+/**
+ * Shows the stage timings of recent CppTools operations, as recorded in their trace files.
+ */
+class SCppToolsTraceHistory : public SCompoundWidget
+{
+public:
+
+    SLATE_BEGIN_ARGS(SCppToolsTraceHistory)
+        : _MaxSessions(20)
+    {}
+
+    /** The number of recent sessions to show. */
+    SLATE_ARGUMENT(int32, MaxSessions)
+
+    SLATE_END_ARGS()
+
+    /** Constructs this widget with InArgs */
+    void Construct(const FArguments& InArgs);
+
+private:
+
+    /** Reloads the sessions from the trace directory and rebuilds the columns. */
+    void Refresh();
+
+    /** Handler for when refresh is clicked */
+    FReply RefreshClicked();
+    /** Handler for when open folder is clicked */
+    FReply OpenFolderClicked();
+
+    /** Create the widget to use as the row for the given session */
+    TSharedRef<ITableRow> MakeSessionRow(TSharedPtr<FCppToolsTraceSummary> Session, const TSharedRef<STableViewBase>& OwnerTable);
+
+
+    int32 MaxSessions;
+
+    TSharedPtr<SHeaderRow> HeaderRow;
+    TSharedPtr<SListView<TSharedPtr<FCppToolsTraceSummary>>> SessionList;
+
+    TArray<TSharedPtr<FCppToolsTraceSummary>> Sessions;
+    /** The stages shown as columns, slowest first. */
+    TArray<FString> StageColumns;
+
+};
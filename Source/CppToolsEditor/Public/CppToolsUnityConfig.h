@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Interfaces/IPluginManager.h"
+
+/** The thresholds used to decide the unity build settings of each module from its edit history. */
+struct FCppToolsUnitySettings
+{
+    /** How far back the git history is read, in days. */
+    int32 HistoryDays = 30;
+    /** The number of edits within the history after which a source file counts as frequently edited. */
+    int32 MinEditsForHotFile = 3;
+    /** The fraction of a module's source files that must be frequently edited for unity builds to be disabled for it. */
+    float DisableUnityHotFraction = 0.5f;
+    /** The number of source files a module without frequently edited files needs for it to be built as a unity build. */
+    int32 ColdModuleMinSourceFiles = 2;
+};
+
+/** The unity build settings chosen for a module. */
+struct FCppToolsUnityPlan
+{
+    FString ModuleName;
+    TSharedPtr<IPlugin> Target;
+    int32 NumSourceFiles = 0;
+    /** The frequently edited source files of the module, most edited first. */
+    TArray<FString> HotFiles;
+    /** The number of edits of each hot file. */
+    TArray<int32> HotFileEdits;
+    bool bUseUnity = true;
+    /** The source file count before unity builds are used, or INDEX_NONE to use the engine default. */
+    int32 MinSourceFilesForUnityBuild = INDEX_NONE;
+};
+
+/**
+ * Chooses per-module unity build settings from how often each source file was edited in the local git history, so modules
+ * that are iterated on compile their frequently edited files on their own while the rest of the project keeps the
+ * full build speed of unity builds.
+ */
+class CPPTOOLSEDITOR_API CppToolsUnityConfig
+{
+public:
+
+    /** Counts the commits touching each file within the history, by absolute path. */
+    static bool ReadGitChurn(const FString& RepositoryDir, int32 HistoryDays, TMap<FString, int32>& OutEdits, FText& OutFailReason);
+
+    /** Chooses the unity build settings of every project and plugin module. */
+    static TArray<FCppToolsUnityPlan> PlanProjectModules(const TMap<FString, int32>& Edits, const FCppToolsUnitySettings& Settings);
+
+    /**
+     * Writes the bUseUnity and MinSourceFilesForUnityBuildOverride settings of a plan into the module's .Build.cs file, along
+     * with a comment block listing its working set of frequently edited files.
+     */
+    static bool ApplyPlan(const FCppToolsUnityPlan& Plan, FText& OutFailReason);
+
+private:
+
+    /** Runs git in the specified directory, returning its standard output. */
+    static bool RunGit(const FString& WorkingDir, const FString& Arguments, FString& OutOutput, FText& OutFailReason);
+
+};
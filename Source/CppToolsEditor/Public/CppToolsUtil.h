@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 
+#include "Containers/StringView.h"
+
 #include "Interfaces/IPluginManager.h"
 
 #include "DesktopPlatformModule.h"
@@ -27,7 +29,9 @@
 
 #include "Widgets/Notifications/SNotificationList.h"
 
-DECLARE_DELEGATE_RetVal_OneParam(bool, FPluginDescriptorModifier, FPluginDescriptor&);
+#include "CppToolsModuleTemplates.h"
+
+class FCppToolsTemplate;
 
 /**
  * A class used to contain static utility functions for extending editor functionality for programmers.
@@ -43,9 +47,21 @@ public:
 
     /** Checks out the specified file from source control. */
     static bool CheckoutFile(const FString& Filename, FText& OutFailReason);
+    /**
+     * Attempts to check out the file and make it writable if it is not already. The user is asked before a read-only file is
+     * made writable, unless the editor is running without a user to ask, in which case it is made writable.
+     */
+    static void TryMakeFileWriteable(const FString& Filename);
     /** Attempts to check out the .uplugin file and make it writable if it is not already. */
     static void TryMakePluginFileWriteable(const FString& PluginFile);
 
+    /** Reads a text file, recording the access in the current trace session. */
+    static bool LoadFileToString(FString& OutFileContents, const FString& Filename);
+    /** Writes a text file, recording the access in the current trace session. */
+    static bool SaveStringToFile(const FString& FileContents, const FString& Filename);
+    /** Writes a generated file, creating its directory and checking it out of source control if needed. */
+    static bool WriteOutputFile(const FString& Filename, const FString& FileContents, FText& OutFailReason);
+
     /** Reads in a custom template file from the CppTools Content folder. */
     static bool ReadCustomTemplateFile(const FString& TemplateFileName, FString& OutFileContents, FText& OutFailReason);
 
@@ -58,12 +74,18 @@ public:
     static FString StripCStyleComments(const FString& SourceString);
     /** Parses a string containing a list of strings into an array of individual strings. */
     static TArray<FString> ParseStringList(const FString& RawStringList);
+    /** Parses a string containing a list of strings into views of the individual strings, which point into RawStringList. */
+    static void ParseStringListViews(FStringView RawStringList, TArray<FStringView>& OutStrings);
     /** Creates a single comma separated list of strings from an array of strings. */
     static FString CombineStringList(const TArray<FString>& StringList, bool bUseQuotes, bool bIncludeSpace);
+    /** Creates a single comma separated list of strings from an array of string views. */
+    static FString CombineStringList(TArrayView<const FStringView> StringList, bool bUseQuotes, bool bIncludeSpace);
     
     // --- Editor utilities ---
-    
-    /** Pushes a new notification to the editor. */
+
+    /** Checks if there is a user to show dialogs and notifications to, which is not the case in commandlets and unattended runs. */
+    static bool IsInteractive();
+    /** Pushes a new notification to the editor, or logs it if the editor is not interactive. */
     static void PushNotification(const FText& Text, const SNotificationItem::ECompletionState& CompletionState);
 
     // --- Templating getters ---
@@ -83,6 +105,8 @@ public:
 
     /** Gets all of the plugins with their source contained in this project. */
     static TArray<TSharedPtr<IPlugin>> GetProjectPlugins();
+    /** Finds the plugin with the specified name among the plugins contained in this project. */
+    static TSharedPtr<IPlugin> FindProjectPlugin(const FString& PluginName);
 
     /** Gets the context information for every module in the game project. */
     static TArray<FModuleContextInfo> GetProjectModules();
@@ -91,44 +115,154 @@ public:
      * The specified plugin must be contained within this project.
      */
     static TArray<FModuleContextInfo> GetPluginModules(const TSharedPtr<IPlugin>& Plugin);
+    /** Gets every module of the game project and of the plugins contained in it, paired with the plugin containing it, or NULL for the game. */
+    static TArray<TPair<FModuleContextInfo, TSharedPtr<IPlugin>>> GetProjectAndPluginModules();
 
     /** Gets the list of public module dependencies of the specified module. */
     static TArray<FString> GetModuleDependencies(const FString& ModuleName, TSharedPtr<IPlugin> Target, bool bIncludePrivate);
+    /**
+     * Gets the list of public, and optionally private, module dependencies of the specified module as views into the contents
+     * of its .Build.cs file, which are read into OutBuildFileContents.
+     */
+    static bool GetModuleDependencyViews(const FString& ModuleName, TSharedPtr<IPlugin> Target, bool bIncludePrivate, FString& OutBuildFileContents,
+        TArray<FStringView>& OutDependencies);
+    /** Parses the list of public, and optionally private, module dependencies from the contents of a .Build.cs file. */
+    static TArray<FString> ParseModuleDependencies(const FString& BuildFileContents, bool bIncludePrivate);
+    /** Parses the module dependencies like ParseModuleDependencies, as views into the contents instead of copies. */
+    static void ParseModuleDependencyViews(FStringView BuildFileContents, bool bIncludePrivate, TArray<FStringView>& OutDependencies);
+    /** Parses the paths included by the #include directives in the contents of a source file, ignoring any that are commented out. */
+    static TArray<FString> ParseIncludes(const FString& SourceContents);
+
+    /** Gets the .Target.cs files of the game project. */
+    static TArray<FString> GetProjectTargetFiles();
+    /** Parses the modules added to ExtraModuleNames in the contents of a .Target.cs file. */
+    static TArray<FString> ParseTargetExtraModules(const FString& TargetFileContents);
+
+    /** Gets the forward declaration header of the module in the specified source directory. */
+    static FString GetModuleFwdHeaderPath(const FString& ModulePath, const FString& ModuleName);
+    /**
+     * Parses forward declarations of the classes, structs and enums with an underlying type that are defined at namespace scope
+     * in the contents of a header. Templates, nested types and types in anonymous namespaces are skipped.
+     */
+    static TArray<FString> ParseForwardDeclarations(const FString& HeaderContents);
 
     // --- File generation functions ---
     
     static bool GenerateModuleBuildFile(const FString& NewBuildFileName, const FString& ModuleName, const TArray<FString>& PublicDependencyModuleNames,
         const TArray<FString>& PrivateDependencyModuleNames, FText& OutFailReason, bool bUseExplicitOrSharedPCHs);
     static bool GenerateModuleHeaderFile(const FString& NewHeaderFileName, const FString& ModuleName, const TArray<FString>& PublicHeaderIncludes,
-        FText& OutFailReason);
+        FText& OutFailReason, int32 LLMTagIndex = INDEX_NONE);
     static bool GenerateModuleCPPFile(const FString& NewCPPFileName, const FString& ModuleName, const FString& StartupSourceCode,
-        const FString& ShutdownSourceCode, FText& OutFailReason);
+        const FString& ShutdownSourceCode, FText& OutFailReason, int32 LLMTagIndex = INDEX_NONE);
+    static bool GenerateModuleFwdHeaderFile(const FString& NewFwdHeaderFileName, const FString& ModuleName, const FString& ForwardDeclarations,
+        FText& OutFailReason);
+    /** Fills in a parsed .Build.cs template of a new module. */
+    static FString RenderModuleBuildFile(const FCppToolsTemplate& Template, const FString& ModuleName, const TArray<FString>& PublicDependencyModuleNames,
+        const TArray<FString>& PrivateDependencyModuleNames, bool bUseExplicitOrSharedPCHs);
+    /** Fills in a parsed module header template, defining the module's LLM tag if a tag index is specified. */
+    static FString RenderModuleHeaderFile(const FCppToolsTemplate& Template, const FString& ModuleName, const TArray<FString>& PublicHeaderIncludes,
+        int32 LLMTagIndex = INDEX_NONE);
+    /** Fills in a parsed module source template, registering the module's LLM tag and scoping StartupModule under it if a tag index is specified. */
+    static FString RenderModuleCPPFile(const FCppToolsTemplate& Template, const FString& ModuleName, const FString& StartupSourceCode,
+        const FString& ShutdownSourceCode, int32 LLMTagIndex = INDEX_NONE);
+    /** Fills in a parsed forward declaration header template. */
+    static FString RenderModuleFwdHeaderFile(const FCppToolsTemplate& Template, const FString& ModuleName, const FString& ForwardDeclarations);
 
     // --- File modification functions ---
 
     static bool InsertDependencyIntoModule(const FString& ModuleName, TSharedPtr<IPlugin> Target, const FString& DependencyName, FText& OutFailReason, bool bPrivate);
+    /** Inserts a dependency into the contents of a .Build.cs file. Returns false if the file has no dependency list to insert it into. */
+    static bool InsertDependencyIntoBuildFile(FString& BuildFileContents, const FString& DependencyName, bool bPrivate);
     static bool InsertDependencyIntoTarget(const FString& ModuleName, const bool& bIsEditor, FText& OutFailReason);
+    /** Gets the .Target.cs file of the game or editor target named after the project. */
+    static FString GetPrimaryTargetFilePath(bool bIsEditor);
+    /** Adds a module to the ExtraModuleNames list in the contents of a .Target.cs file. Returns false if the file has no list to add it to. */
+    static bool InsertModuleIntoTargetFile(FString& TargetFileContents, const FString& ModuleName);
+    /** Removes a dependency from the public and private dependency lists in the contents of a .Build.cs file. Returns true if the contents changed. */
+    static bool RemoveDependencyFromBuildFile(FString& BuildFileContents, const FString& DependencyName);
+    /** Removes a module from ExtraModuleNames in the contents of a .Target.cs file. Returns true if the contents changed. */
+    static bool RemoveModuleFromTargetFile(FString& TargetFileContents, const FString& ModuleName);
+    /**
+     * Removes modules from the .uproject file and the .uplugin files of the project's plugins, along with any additional
+     * dependencies on them.
+     */
+    static bool RemoveModulesFromDescriptors(const TArray<FString>& ModuleNames, FText& OutFailReason);
+
+    /**
+     * Applies a modification to the contents of a module's .Build.cs file. The modifier returns true if it changed the contents,
+     * in which case the file is checked out and saved.
+     */
+    static bool UpdateModuleBuildFile(const FString& ModuleName, TSharedPtr<IPlugin> Target, TFunctionRef<bool(FString&)> Modifier, FText& OutFailReason);
+    /** Gets the value assigned to a ModuleRules field, such as bUseUnity, in the contents of a .Build.cs file. */
+    static bool GetModuleRulesField(const FString& BuildFileContents, const FString& FieldName, FString& OutValue);
+    /**
+     * Assigns a value to a ModuleRules field in the contents of a .Build.cs file, replacing the existing assignment or adding one
+     * at the start of the constructor. Returns true if the contents changed.
+     */
+    static bool SetModuleRulesField(FString& BuildFileContents, const FString& FieldName, const FString& Value);
+    /** Removes the assignment of a ModuleRules field from the contents of a .Build.cs file. Returns true if the contents changed. */
+    static bool RemoveModuleRulesField(FString& BuildFileContents, const FString& FieldName);
+    /**
+     * Replaces the comment block with the specified name in the contents of a .Build.cs file, adding it at the end of the
+     * constructor if it does not exist, or removing it if there are no lines. Returns true if the contents changed.
+     */
+    static bool SetModuleRulesCommentBlock(FString& BuildFileContents, const FString& BlockName, const TArray<FString>& Lines);
+    /**
+     * Regenerates the forward declaration header of a module from the types defined in its Public headers, creating it if
+     * it does not exist. The file is only written if its contents changed.
+     */
+    static bool UpdateModuleFwdHeader(const FString& ModuleName, TSharedPtr<IPlugin> Target, FText& OutFailReason);
+    /** Updates the forward declaration header of every project and plugin module that has one. Returns the number of headers that were checked. */
+    static int32 UpdateProjectFwdHeaders(FText& OutFailReason);
 
     // --- Primary functionality ---
+
+    /** Gets the directory a new module with the specified name is created in. */
+    static FString GetNewModulePath(const FString& ModuleName, TSharedPtr<IPlugin> Target);
+    /** Checks if a new module can be created with the specified name. */
+    static bool IsValidNewModuleName(const FString& ModuleName, FText& OutFailReason);
+    /** Gets the dependencies written into the .Build.cs file of a new module. */
+    static void GetNewModuleDependencies(TArray<FString>& OutPublicDependencies, TArray<FString>& OutPrivateDependencies);
+    /**
+     * Gets the existing module of the game project or plugin that a new module of the specified type is added to as a dependency,
+     * or an empty string if it has none.
+     */
+    static FString GetNewModuleOwner(TSharedPtr<IPlugin> Target, EHostType::Type Type);
     
+    /**
+     * Creates a new module and adds it to its owner. If an LLM tag index is specified, the module gets a Low-Level Memory Tracker
+     * tag with that index, which should be one CppToolsMemoryTags::FindFreeTagIndex found. The module template decides the code
+     * the module starts with beyond the module class.
+     */
     static GameProjectUtils::EAddCodeToProjectResult GenerateModule(const FString& ModulePath, TSharedPtr<IPlugin> Target,
         const FString& ModuleName, const EHostType::Type& Type, const ELoadingPhase::Type& LoadingPhase, bool bUsePCH,
-        TArray<FString>& CreatedFiles, FText& OutFailReason);
+        TArray<FString>& CreatedFiles, FText& OutFailReason, bool bGenerateFwdHeader = false, int32 LLMTagIndex = INDEX_NONE,
+        ECppToolsModuleTemplate ModuleTemplate = ECppToolsModuleTemplate::Basic);
     
 private:
 
-    // --- Manage UProject ---
-
-    static bool UpdateGameProjectFile(const FString& ProjectFile, const FString& EngineIdentifier, const FProjectDescriptorModifier* Modifier, FText& OutFailReason);
-    static bool UpdateGameProject(const FProjectDescriptorModifier* Modifier);
-
-    static bool AppendProjectModules(FProjectDescriptor& Descriptor, const TArray<FModuleDescriptor>* Modules);
-
-    // --- Manage UPlugin ---
-    
-    static bool UpdatePluginFile(const FString& PluginFile, const FPluginDescriptorModifier* Modifier, FText& OutFailReason);
-    static bool UpdatePlugin(const TSharedPtr<IPlugin>&, const FPluginDescriptorModifier* Modifier);
-
-    static bool AppendPluginModules(FPluginDescriptor& Descriptor, TSharedPtr<IPlugin> Plugin, const TArray<FModuleDescriptor>* Modules);
+    /**
+     * Removes a string from the AddRange and Add calls of the specified lists. Add calls of the string are removed entirely,
+     * while AddRange calls are kept even when emptied so later insertions have a list to go into.
+     */
+    static bool RemoveFromStringLists(FString& Contents, TArrayView<const FStringView> ListNames, const FString& Element);
+    /** Removes a statement, along with its line if nothing else is on it. */
+    static void RemoveStatement(FString& Contents, int32 Start, int32 End);
+    /** Finds the assignment of a ModuleRules field that is not commented out, returning the range of the whole statement. */
+    static bool FindModuleRulesField(const FString& BuildFileContents, const FString& FieldName, int32& OutStart, int32& OutEnd, FString& OutValue);
+    /** Gets the indentation of the statements within the ModuleRules constructor. */
+    static FString GetModuleRulesIndentation(const FString& BuildFileContents);
+    /** Fills in the .Build.cs template of a new module. */
+    static bool FillModuleBuildFileTemplate(const FString& ModuleName, const TArray<FString>& PublicDependencyModuleNames,
+        const TArray<FString>& PrivateDependencyModuleNames, bool bUseExplicitOrSharedPCHs, FString& OutFileContents, FText& OutFailReason);
+    /** Fills in the module header template. */
+    static bool FillModuleHeaderTemplate(const FString& ModuleName, const TArray<FString>& PublicHeaderIncludes, FString& OutFileContents,
+        FText& OutFailReason, int32 LLMTagIndex = INDEX_NONE);
+    /** Fills in the module source template. */
+    static bool FillModuleCPPTemplate(const FString& ModuleName, const FString& StartupSourceCode, const FString& ShutdownSourceCode,
+        FString& OutFileContents, FText& OutFailReason, int32 LLMTagIndex = INDEX_NONE);
+    /** Fills in the forward declaration header template. */
+    static bool FillModuleFwdHeaderTemplate(const FString& ModuleName, const FString& ForwardDeclarations, FString& OutFileContents,
+        FText& OutFailReason);
 
 };
@@ -8,6 +8,12 @@
 #include "Widgets/Layout/SSeparator.h"
 #include "Widgets/SBoxPanel.h"
 #include "Widgets/Layout/SGridPanel.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SComboButton.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Input/SMultiLineEditableTextBox.h"
+#include "Widgets/Layout/SSplitter.h"
+#include "Widgets/Views/SListView.h"
 #include "SourceCodeNavigation.h"
 #include "EditorStyleSet.h"
 
@@ -21,9 +27,15 @@
 #include "GameProjectUtils.h"
 
 #include "CppToolsUtil.h"
+#include "CppToolsModulePreview.h"
+#include "CppToolsFuzzyIndex.h"
 
 struct FCreateModuleTarget {
     TSharedPtr<IPlugin> Plugin;
+    /** The text shown for the target, made once so the picker does not format it every frame. */
+    FText DisplayText;
+    /** The category of the plugin, or Game for the game project. */
+    FText Category;
 };
 
 DECLARE_DELEGATE_ThreeParams(FOnCreateModule, FString, FCreateModuleTarget, EHostType::Type);
@@ -96,12 +108,24 @@ private:
     void OnModuleNameTextCommitted(const FText& NewText, ETextCommit::Type CommitType);
 
 
-    /** Get the combo box text for the currently selected module target */
+    /** Get the picker text for the currently selected module target */
     FText OnGetModuleTargetComboText() const;
+    /** Creates the menu of the module target picker, indexing the targets the first time it opens */
+    TSharedRef<SWidget> OnGetModuleTargetMenuContent();
+    /** Handler for when the text in the module target search box has changed */
+    void OnModuleTargetFilterChanged(const FText& NewText);
+    /** Handler for when the text in the module target search box is committed, which selects the best match on enter */
+    void OnModuleTargetFilterCommitted(const FText& NewText, ETextCommit::Type CommitType);
+    /** Gets the text in the module target search box, which is highlighted in the target names */
+    FText OnGetModuleTargetFilterText() const;
     /** Called when the currently selected module target is changed */
     void OnModuleTargetChanged(TSharedPtr<FCreateModuleTarget> Value, ESelectInfo::Type SelectInfo);
-    /** Create the widget to use as the combo box entry for the given module target */
-    TSharedRef<SWidget> MakeWidgetForModuleTargetCombo(TSharedPtr<FCreateModuleTarget> Value);
+    /** Create the widget to use as the module target list entry for the given module target */
+    TSharedRef<ITableRow> MakeModuleTargetRow(TSharedPtr<FCreateModuleTarget> Value, const TSharedRef<STableViewBase>& OwnerTable);
+    /** Lists the game and every project plugin as module targets and indexes their names and categories */
+    void BuildModuleTargetIndex();
+    /** Creates a module target for the game, if the plugin is null, or a plugin */
+    static TSharedPtr<FCreateModuleTarget> MakeModuleTarget(TSharedPtr<IPlugin> Plugin);
 
 
     /** Get the combo box text for the currently selected module type */
@@ -119,7 +143,27 @@ private:
     /** Create the widget to use as the combo box entry for the given module loading phase */
     TSharedRef<SWidget> MakeWidgetForModuleLoadingPhaseCombo(TSharedPtr<ELoadingPhase::Type> Value);
 
+
+    /** Get the combo box text for the currently selected module template */
+    FText OnGetModuleTemplateComboText() const;
+    /** Gets the description of the currently selected module template */
+    FText OnGetModuleTemplateToolTipText() const;
+    /** Called when the currently selected module template is changed, which makes the module a runtime module if the template needs one */
+    void OnModuleTemplateChanged(TSharedPtr<ECppToolsModuleTemplate> Value, ESelectInfo::Type SelectInfo);
+    /** Create the widget to use as the combo box entry for the given module template */
+    TSharedRef<SWidget> MakeWidgetForModuleTemplateCombo(TSharedPtr<ECppToolsModuleTemplate> Value);
+
     
+    /** Returns whether a forward declaration header will be generated */
+    ECheckBoxState IsGenerateFwdHeaderChecked() const;
+    /** Handler for when the generate forward declaration header checkbox is changed */
+    void OnGenerateFwdHeaderChanged(ECheckBoxState NewState);
+    /** Returns whether the module will get an LLM tag */
+    ECheckBoxState IsAddLLMTagChecked() const;
+    /** Handler for when the LLM tag checkbox is changed, which picks a free project tag the first time it is checked */
+    void OnAddLLMTagChanged(ECheckBoxState NewState);
+
+
     /** Returns the text in the module path box */
     FText OnGetModulePathText() const;
 
@@ -129,6 +173,15 @@ private:
     /** Checks the current module name for validity and updates cached values accordingly */
     void UpdateInputValidity();
 
+    /** Renders the preview files affected by the settings that changed and refreshes the preview pane */
+    void UpdatePreview();
+    /** Shows the selected preview file in the preview text box */
+    void ShowSelectedPreviewFile();
+    /** Called when a file is selected in the preview file list */
+    void OnPreviewFileSelected(TSharedPtr<FCppToolsPreviewFile> Value, ESelectInfo::Type SelectInfo);
+    /** Create the widget to use as the preview file list entry for the given file */
+    TSharedRef<ITableRow> MakePreviewFileRow(TSharedPtr<FCppToolsPreviewFile> Value, const TSharedRef<STableViewBase>& OwnerTable);
+
     /** Closes the window that contains this widget */
     void CloseContainingWindow();
 
@@ -143,19 +196,48 @@ private:
     TSharedPtr<SComboBox<TSharedPtr<EHostType::Type>>> ModuleTypesCombo;
     /** The combobox for selecting the module loading phase. */
     TSharedPtr<SComboBox<TSharedPtr<ELoadingPhase::Type>>> ModuleLoadingPhasesCombo;
-    /** The combobox for selecting the module target. */
-    TSharedPtr<SComboBox<TSharedPtr<FCreateModuleTarget>>> ModuleTargetsCombo;
+    /** The combobox for selecting the module template. */
+    TSharedPtr<SComboBox<TSharedPtr<ECppToolsModuleTemplate>>> ModuleTemplatesCombo;
+    /** The picker for selecting the module target. */
+    TSharedPtr<SComboButton> ModuleTargetButton;
+    /** The search box filtering the targets in the picker. */
+    TSharedPtr<SSearchBox> ModuleTargetSearchBox;
+    /** The list of the targets matching the search, which only creates rows for the visible targets. */
+    TSharedPtr<SListView<TSharedPtr<FCreateModuleTarget>>> ModuleTargetList;
 
 
     TArray<TSharedPtr<EHostType::Type>> AvailableModuleTypes;
     TArray<TSharedPtr<ELoadingPhase::Type>> AvailableModuleLoadingPhases;
+    TArray<TSharedPtr<ECppToolsModuleTemplate>> AvailableModuleTemplates;
     TArray<TSharedPtr<FCreateModuleTarget>> AvailableTargets;
+    /** The targets matching the search, best match first. */
+    TArray<TSharedPtr<FCreateModuleTarget>> FilteredTargets;
+    /** The names and categories of the available targets, built the first time the picker opens. */
+    FCppToolsFuzzyIndex TargetIndex;
+    /** The indices of the targets matching the search, which the next keystroke narrows down. */
+    TArray<int32> TargetMatches;
+    FString TargetFilter;
 
 
     FString ModuleName;
     TSharedPtr<FCreateModuleTarget> ModuleTarget;
     TSharedPtr<EHostType::Type> ModuleType;
     TSharedPtr<ELoadingPhase::Type> ModuleLoadingPhase;
+    TSharedPtr<ECppToolsModuleTemplate> ModuleTemplate;
+    /** Should a forward declaration header be generated for the module? */
+    bool bGenerateFwdHeader;
+    /** Should the module get a Low-Level Memory Tracker tag? */
+    bool bAddLLMTag;
+    /** The project tag the module gets if it has an LLM tag, found the first time the option is checked. */
+    int32 LLMTagIndex;
+
+    /** Renders the files the module would create and the edits it would make from the current settings. */
+    FCppToolsModulePreview Preview;
+    TArray<TSharedPtr<FCppToolsPreviewFile>> PreviewFiles;
+    TSharedPtr<SListView<TSharedPtr<FCppToolsPreviewFile>>> PreviewFileList;
+    TSharedPtr<SMultiLineEditableTextBox> PreviewTextBox;
+    /** The index of the selected preview file, kept when the files are rendered again. */
+    int32 SelectedPreviewFile;
 
     /** Was the last input validity check successful? */
     bool bLastInputValidityCheckSuccessful;